@@ -0,0 +1,49 @@
+#----------------------------------------------------------------
+# Generated CMake target import file for configuration "Debug".
+#----------------------------------------------------------------
+
+# Commands may need to know the format version.
+set(CMAKE_IMPORT_FILE_VERSION 1)
+
+# Import target "ns3::libmtp" for configuration "Debug"
+set_property(TARGET ns3::libmtp APPEND PROPERTY IMPORTED_CONFIGURATIONS DEBUG)
+set_target_properties(ns3::libmtp PROPERTIES
+  IMPORTED_LOCATION_DEBUG "${_IMPORT_PREFIX}/lib/libns3-dev-mtp-debug.so"
+  IMPORTED_SONAME_DEBUG "libns3-dev-mtp-debug.so"
+  )
+
+list(APPEND _cmake_import_check_targets ns3::libmtp )
+list(APPEND _cmake_import_check_files_for_ns3::libmtp "${_IMPORT_PREFIX}/lib/libns3-dev-mtp-debug.so" )
+
+# Import target "ns3::libnetwork" for configuration "Debug"
+set_property(TARGET ns3::libnetwork APPEND PROPERTY IMPORTED_CONFIGURATIONS DEBUG)
+set_target_properties(ns3::libnetwork PROPERTIES
+  IMPORTED_LOCATION_DEBUG "${_IMPORT_PREFIX}/lib/libns3-dev-network-debug.so"
+  IMPORTED_SONAME_DEBUG "libns3-dev-network-debug.so"
+  )
+
+list(APPEND _cmake_import_check_targets ns3::libnetwork )
+list(APPEND _cmake_import_check_files_for_ns3::libnetwork "${_IMPORT_PREFIX}/lib/libns3-dev-network-debug.so" )
+
+# Import target "ns3::libcore" for configuration "Debug"
+set_property(TARGET ns3::libcore APPEND PROPERTY IMPORTED_CONFIGURATIONS DEBUG)
+set_target_properties(ns3::libcore PROPERTIES
+  IMPORTED_LOCATION_DEBUG "${_IMPORT_PREFIX}/lib/libns3-dev-core-debug.so"
+  IMPORTED_SONAME_DEBUG "libns3-dev-core-debug.so"
+  )
+
+list(APPEND _cmake_import_check_targets ns3::libcore )
+list(APPEND _cmake_import_check_files_for_ns3::libcore "${_IMPORT_PREFIX}/lib/libns3-dev-core-debug.so" )
+
+# Import target "ns3::libstats" for configuration "Debug"
+set_property(TARGET ns3::libstats APPEND PROPERTY IMPORTED_CONFIGURATIONS DEBUG)
+set_target_properties(ns3::libstats PROPERTIES
+  IMPORTED_LOCATION_DEBUG "${_IMPORT_PREFIX}/lib/libns3-dev-stats-debug.so"
+  IMPORTED_SONAME_DEBUG "libns3-dev-stats-debug.so"
+  )
+
+list(APPEND _cmake_import_check_targets ns3::libstats )
+list(APPEND _cmake_import_check_files_for_ns3::libstats "${_IMPORT_PREFIX}/lib/libns3-dev-stats-debug.so" )
+
+# Commands beyond this point should not need to know the version.
+set(CMAKE_IMPORT_FILE_VERSION)
@@ -0,0 +1,8 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/run-introspected-command-line"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/run-introspected-command-line.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
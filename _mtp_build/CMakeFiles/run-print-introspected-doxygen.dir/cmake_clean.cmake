@@ -0,0 +1,8 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/run-print-introspected-doxygen"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang )
+  include(CMakeFiles/run-print-introspected-doxygen.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1 @@
+#include "/root/repo/src/network/helper/packet-socket-helper.h"
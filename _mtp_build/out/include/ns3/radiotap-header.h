@@ -0,0 +1 @@
+#include "/root/repo/src/network/utils/radiotap-header.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/core/model/watchdog.h"
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../out/scratch/ns3-dev-scratch-simulator-debug"
+  "../out/scratch/ns3-dev-scratch-simulator-debug.pdb"
+  "CMakeFiles/scratch_scratch-simulator.dir/scratch-simulator.cc.o"
+  "CMakeFiles/scratch_scratch-simulator.dir/scratch-simulator.cc.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/scratch_scratch-simulator.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
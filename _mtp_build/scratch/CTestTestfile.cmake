@@ -0,0 +1,11 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo/scratch
+# Build directory: /root/repo/_mtp_build/scratch
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(ctest-scratch_scratch-simulator "ns3-dev-scratch-simulator-debug")
+set_tests_properties(ctest-scratch_scratch-simulator PROPERTIES  WORKING_DIRECTORY "/root/repo/_mtp_build/out/scratch/" _BACKTRACE_TRIPLES "/root/repo/build-support/macros-and-definitions.cmake;1641;add_test;/root/repo/build-support/macros-and-definitions.cmake;1716;set_runtime_outputdirectory;/root/repo/scratch/CMakeLists.txt;57;build_exec;/root/repo/scratch/CMakeLists.txt;69;create_scratch;/root/repo/scratch/CMakeLists.txt;0;")
+add_test(ctest-scratch_subdir_scratch-subdir "ns3-dev-scratch-subdir-debug")
+set_tests_properties(ctest-scratch_subdir_scratch-subdir PROPERTIES  WORKING_DIRECTORY "/root/repo/_mtp_build/out/scratch/subdir/" _BACKTRACE_TRIPLES "/root/repo/build-support/macros-and-definitions.cmake;1641;add_test;/root/repo/build-support/macros-and-definitions.cmake;1716;set_runtime_outputdirectory;/root/repo/scratch/CMakeLists.txt;57;build_exec;/root/repo/scratch/CMakeLists.txt;99;create_scratch;/root/repo/scratch/CMakeLists.txt;0;")
+subdirs("nested-subdir")
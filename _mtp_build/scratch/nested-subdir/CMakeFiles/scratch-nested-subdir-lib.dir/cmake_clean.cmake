@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../../out/lib/libscratch-nested-subdir-lib.a"
+  "../../out/lib/libscratch-nested-subdir-lib.pdb"
+  "CMakeFiles/scratch-nested-subdir-lib.dir/lib/scratch-nested-subdir-library-source.cc.o"
+  "CMakeFiles/scratch-nested-subdir-lib.dir/lib/scratch-nested-subdir-library-source.cc.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/scratch-nested-subdir-lib.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,89 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/core/helper/csv-reader.cc" "src/core/CMakeFiles/libcore-obj.dir/helper/csv-reader.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/helper/csv-reader.cc.o.d"
+  "/root/repo/src/core/helper/event-garbage-collector.cc" "src/core/CMakeFiles/libcore-obj.dir/helper/event-garbage-collector.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/helper/event-garbage-collector.cc.o.d"
+  "/root/repo/src/core/helper/random-variable-stream-helper.cc" "src/core/CMakeFiles/libcore-obj.dir/helper/random-variable-stream-helper.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/helper/random-variable-stream-helper.cc.o.d"
+  "/root/repo/src/core/model/ascii-file.cc" "src/core/CMakeFiles/libcore-obj.dir/model/ascii-file.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/ascii-file.cc.o.d"
+  "/root/repo/src/core/model/attribute-construction-list.cc" "src/core/CMakeFiles/libcore-obj.dir/model/attribute-construction-list.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/attribute-construction-list.cc.o.d"
+  "/root/repo/src/core/model/attribute.cc" "src/core/CMakeFiles/libcore-obj.dir/model/attribute.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/attribute.cc.o.d"
+  "/root/repo/src/core/model/boolean.cc" "src/core/CMakeFiles/libcore-obj.dir/model/boolean.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/boolean.cc.o.d"
+  "/root/repo/src/core/model/breakpoint.cc" "src/core/CMakeFiles/libcore-obj.dir/model/breakpoint.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/breakpoint.cc.o.d"
+  "/root/repo/src/core/model/calendar-scheduler.cc" "src/core/CMakeFiles/libcore-obj.dir/model/calendar-scheduler.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/calendar-scheduler.cc.o.d"
+  "/root/repo/src/core/model/callback.cc" "src/core/CMakeFiles/libcore-obj.dir/model/callback.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/callback.cc.o.d"
+  "/root/repo/src/core/model/command-line.cc" "src/core/CMakeFiles/libcore-obj.dir/model/command-line.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/command-line.cc.o.d"
+  "/root/repo/src/core/model/config.cc" "src/core/CMakeFiles/libcore-obj.dir/model/config.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/config.cc.o.d"
+  "/root/repo/src/core/model/default-simulator-impl.cc" "src/core/CMakeFiles/libcore-obj.dir/model/default-simulator-impl.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/default-simulator-impl.cc.o.d"
+  "/root/repo/src/core/model/des-metrics.cc" "src/core/CMakeFiles/libcore-obj.dir/model/des-metrics.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/des-metrics.cc.o.d"
+  "/root/repo/src/core/model/double.cc" "src/core/CMakeFiles/libcore-obj.dir/model/double.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/double.cc.o.d"
+  "/root/repo/src/core/model/enum.cc" "src/core/CMakeFiles/libcore-obj.dir/model/enum.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/enum.cc.o.d"
+  "/root/repo/src/core/model/environment-variable.cc" "src/core/CMakeFiles/libcore-obj.dir/model/environment-variable.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/environment-variable.cc.o.d"
+  "/root/repo/src/core/model/event-id.cc" "src/core/CMakeFiles/libcore-obj.dir/model/event-id.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/event-id.cc.o.d"
+  "/root/repo/src/core/model/event-impl.cc" "src/core/CMakeFiles/libcore-obj.dir/model/event-impl.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/event-impl.cc.o.d"
+  "/root/repo/src/core/model/fatal-impl.cc" "src/core/CMakeFiles/libcore-obj.dir/model/fatal-impl.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/fatal-impl.cc.o.d"
+  "/root/repo/src/core/model/global-value.cc" "src/core/CMakeFiles/libcore-obj.dir/model/global-value.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/global-value.cc.o.d"
+  "/root/repo/src/core/model/hash-crc32c.cc" "src/core/CMakeFiles/libcore-obj.dir/model/hash-crc32c.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/hash-crc32c.cc.o.d"
+  "/root/repo/src/core/model/hash-fnv.cc" "src/core/CMakeFiles/libcore-obj.dir/model/hash-fnv.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/hash-fnv.cc.o.d"
+  "/root/repo/src/core/model/hash-function.cc" "src/core/CMakeFiles/libcore-obj.dir/model/hash-function.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/hash-function.cc.o.d"
+  "/root/repo/src/core/model/hash-jenkins.cc" "src/core/CMakeFiles/libcore-obj.dir/model/hash-jenkins.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/hash-jenkins.cc.o.d"
+  "/root/repo/src/core/model/hash-murmur3.cc" "src/core/CMakeFiles/libcore-obj.dir/model/hash-murmur3.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/hash-murmur3.cc.o.d"
+  "/root/repo/src/core/model/hash.cc" "src/core/CMakeFiles/libcore-obj.dir/model/hash.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/hash.cc.o.d"
+  "/root/repo/src/core/model/heap-scheduler.cc" "src/core/CMakeFiles/libcore-obj.dir/model/heap-scheduler.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/heap-scheduler.cc.o.d"
+  "/root/repo/src/core/model/int64x64-128.cc" "src/core/CMakeFiles/libcore-obj.dir/model/int64x64-128.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/int64x64-128.cc.o.d"
+  "/root/repo/src/core/model/int64x64.cc" "src/core/CMakeFiles/libcore-obj.dir/model/int64x64.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/int64x64.cc.o.d"
+  "/root/repo/src/core/model/integer.cc" "src/core/CMakeFiles/libcore-obj.dir/model/integer.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/integer.cc.o.d"
+  "/root/repo/src/core/model/ladder-scheduler.cc" "src/core/CMakeFiles/libcore-obj.dir/model/ladder-scheduler.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/ladder-scheduler.cc.o.d"
+  "/root/repo/src/core/model/length.cc" "src/core/CMakeFiles/libcore-obj.dir/model/length.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/length.cc.o.d"
+  "/root/repo/src/core/model/list-scheduler.cc" "src/core/CMakeFiles/libcore-obj.dir/model/list-scheduler.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/list-scheduler.cc.o.d"
+  "/root/repo/src/core/model/log.cc" "src/core/CMakeFiles/libcore-obj.dir/model/log.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/log.cc.o.d"
+  "/root/repo/src/core/model/make-event.cc" "src/core/CMakeFiles/libcore-obj.dir/model/make-event.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/make-event.cc.o.d"
+  "/root/repo/src/core/model/map-scheduler.cc" "src/core/CMakeFiles/libcore-obj.dir/model/map-scheduler.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/map-scheduler.cc.o.d"
+  "/root/repo/src/core/model/matrix-array.cc" "src/core/CMakeFiles/libcore-obj.dir/model/matrix-array.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/matrix-array.cc.o.d"
+  "/root/repo/src/core/model/names.cc" "src/core/CMakeFiles/libcore-obj.dir/model/names.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/names.cc.o.d"
+  "/root/repo/src/core/model/node-printer.cc" "src/core/CMakeFiles/libcore-obj.dir/model/node-printer.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/node-printer.cc.o.d"
+  "/root/repo/src/core/model/object-base.cc" "src/core/CMakeFiles/libcore-obj.dir/model/object-base.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/object-base.cc.o.d"
+  "/root/repo/src/core/model/object-factory.cc" "src/core/CMakeFiles/libcore-obj.dir/model/object-factory.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/object-factory.cc.o.d"
+  "/root/repo/src/core/model/object-ptr-container.cc" "src/core/CMakeFiles/libcore-obj.dir/model/object-ptr-container.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/object-ptr-container.cc.o.d"
+  "/root/repo/src/core/model/object.cc" "src/core/CMakeFiles/libcore-obj.dir/model/object.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/object.cc.o.d"
+  "/root/repo/src/core/model/pointer.cc" "src/core/CMakeFiles/libcore-obj.dir/model/pointer.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/pointer.cc.o.d"
+  "/root/repo/src/core/model/priority-queue-scheduler.cc" "src/core/CMakeFiles/libcore-obj.dir/model/priority-queue-scheduler.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/priority-queue-scheduler.cc.o.d"
+  "/root/repo/src/core/model/random-variable-stream.cc" "src/core/CMakeFiles/libcore-obj.dir/model/random-variable-stream.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/random-variable-stream.cc.o.d"
+  "/root/repo/src/core/model/realtime-simulator-impl.cc" "src/core/CMakeFiles/libcore-obj.dir/model/realtime-simulator-impl.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/realtime-simulator-impl.cc.o.d"
+  "/root/repo/src/core/model/rng-seed-manager.cc" "src/core/CMakeFiles/libcore-obj.dir/model/rng-seed-manager.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/rng-seed-manager.cc.o.d"
+  "/root/repo/src/core/model/rng-stream.cc" "src/core/CMakeFiles/libcore-obj.dir/model/rng-stream.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/rng-stream.cc.o.d"
+  "/root/repo/src/core/model/scheduler.cc" "src/core/CMakeFiles/libcore-obj.dir/model/scheduler.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/scheduler.cc.o.d"
+  "/root/repo/src/core/model/show-progress.cc" "src/core/CMakeFiles/libcore-obj.dir/model/show-progress.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/show-progress.cc.o.d"
+  "/root/repo/src/core/model/simulator-impl.cc" "src/core/CMakeFiles/libcore-obj.dir/model/simulator-impl.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/simulator-impl.cc.o.d"
+  "/root/repo/src/core/model/simulator.cc" "src/core/CMakeFiles/libcore-obj.dir/model/simulator.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/simulator.cc.o.d"
+  "/root/repo/src/core/model/string.cc" "src/core/CMakeFiles/libcore-obj.dir/model/string.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/string.cc.o.d"
+  "/root/repo/src/core/model/synchronizer.cc" "src/core/CMakeFiles/libcore-obj.dir/model/synchronizer.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/synchronizer.cc.o.d"
+  "/root/repo/src/core/model/system-path.cc" "src/core/CMakeFiles/libcore-obj.dir/model/system-path.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/system-path.cc.o.d"
+  "/root/repo/src/core/model/system-wall-clock-ms.cc" "src/core/CMakeFiles/libcore-obj.dir/model/system-wall-clock-ms.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/system-wall-clock-ms.cc.o.d"
+  "/root/repo/src/core/model/system-wall-clock-timestamp.cc" "src/core/CMakeFiles/libcore-obj.dir/model/system-wall-clock-timestamp.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/system-wall-clock-timestamp.cc.o.d"
+  "/root/repo/src/core/model/test.cc" "src/core/CMakeFiles/libcore-obj.dir/model/test.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/test.cc.o.d"
+  "/root/repo/src/core/model/time-printer.cc" "src/core/CMakeFiles/libcore-obj.dir/model/time-printer.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/time-printer.cc.o.d"
+  "/root/repo/src/core/model/time.cc" "src/core/CMakeFiles/libcore-obj.dir/model/time.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/time.cc.o.d"
+  "/root/repo/src/core/model/timer.cc" "src/core/CMakeFiles/libcore-obj.dir/model/timer.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/timer.cc.o.d"
+  "/root/repo/src/core/model/trace-source-accessor.cc" "src/core/CMakeFiles/libcore-obj.dir/model/trace-source-accessor.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/trace-source-accessor.cc.o.d"
+  "/root/repo/src/core/model/trickle-timer.cc" "src/core/CMakeFiles/libcore-obj.dir/model/trickle-timer.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/trickle-timer.cc.o.d"
+  "/root/repo/src/core/model/type-id.cc" "src/core/CMakeFiles/libcore-obj.dir/model/type-id.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/type-id.cc.o.d"
+  "/root/repo/src/core/model/uinteger.cc" "src/core/CMakeFiles/libcore-obj.dir/model/uinteger.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/uinteger.cc.o.d"
+  "/root/repo/src/core/model/unix-fd-reader.cc" "src/core/CMakeFiles/libcore-obj.dir/model/unix-fd-reader.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/unix-fd-reader.cc.o.d"
+  "/root/repo/src/core/model/vector.cc" "src/core/CMakeFiles/libcore-obj.dir/model/vector.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/vector.cc.o.d"
+  "/root/repo/src/core/model/wall-clock-synchronizer.cc" "src/core/CMakeFiles/libcore-obj.dir/model/wall-clock-synchronizer.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/wall-clock-synchronizer.cc.o.d"
+  "/root/repo/src/core/model/watchdog.cc" "src/core/CMakeFiles/libcore-obj.dir/model/watchdog.cc.o" "gcc" "src/core/CMakeFiles/libcore-obj.dir/model/watchdog.cc.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,9 @@
+file(REMOVE_RECURSE
+  "../../out/lib/libns3-dev-mtp-debug.pdb"
+  "../../out/lib/libns3-dev-mtp-debug.so"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/libmtp.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,55 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/libstats-obj.dir/helper/file-helper.cc.o"
+  "CMakeFiles/libstats-obj.dir/helper/file-helper.cc.o.d"
+  "CMakeFiles/libstats-obj.dir/helper/gnuplot-helper.cc.o"
+  "CMakeFiles/libstats-obj.dir/helper/gnuplot-helper.cc.o.d"
+  "CMakeFiles/libstats-obj.dir/model/basic-data-calculators.cc.o"
+  "CMakeFiles/libstats-obj.dir/model/basic-data-calculators.cc.o.d"
+  "CMakeFiles/libstats-obj.dir/model/boolean-probe.cc.o"
+  "CMakeFiles/libstats-obj.dir/model/boolean-probe.cc.o.d"
+  "CMakeFiles/libstats-obj.dir/model/data-calculator.cc.o"
+  "CMakeFiles/libstats-obj.dir/model/data-calculator.cc.o.d"
+  "CMakeFiles/libstats-obj.dir/model/data-collection-object.cc.o"
+  "CMakeFiles/libstats-obj.dir/model/data-collection-object.cc.o.d"
+  "CMakeFiles/libstats-obj.dir/model/data-collector.cc.o"
+  "CMakeFiles/libstats-obj.dir/model/data-collector.cc.o.d"
+  "CMakeFiles/libstats-obj.dir/model/data-output-interface.cc.o"
+  "CMakeFiles/libstats-obj.dir/model/data-output-interface.cc.o.d"
+  "CMakeFiles/libstats-obj.dir/model/double-probe.cc.o"
+  "CMakeFiles/libstats-obj.dir/model/double-probe.cc.o.d"
+  "CMakeFiles/libstats-obj.dir/model/file-aggregator.cc.o"
+  "CMakeFiles/libstats-obj.dir/model/file-aggregator.cc.o.d"
+  "CMakeFiles/libstats-obj.dir/model/get-wildcard-matches.cc.o"
+  "CMakeFiles/libstats-obj.dir/model/get-wildcard-matches.cc.o.d"
+  "CMakeFiles/libstats-obj.dir/model/gnuplot-aggregator.cc.o"
+  "CMakeFiles/libstats-obj.dir/model/gnuplot-aggregator.cc.o.d"
+  "CMakeFiles/libstats-obj.dir/model/gnuplot.cc.o"
+  "CMakeFiles/libstats-obj.dir/model/gnuplot.cc.o.d"
+  "CMakeFiles/libstats-obj.dir/model/histogram.cc.o"
+  "CMakeFiles/libstats-obj.dir/model/histogram.cc.o.d"
+  "CMakeFiles/libstats-obj.dir/model/omnet-data-output.cc.o"
+  "CMakeFiles/libstats-obj.dir/model/omnet-data-output.cc.o.d"
+  "CMakeFiles/libstats-obj.dir/model/probe.cc.o"
+  "CMakeFiles/libstats-obj.dir/model/probe.cc.o.d"
+  "CMakeFiles/libstats-obj.dir/model/sqlite-data-output.cc.o"
+  "CMakeFiles/libstats-obj.dir/model/sqlite-data-output.cc.o.d"
+  "CMakeFiles/libstats-obj.dir/model/sqlite-output.cc.o"
+  "CMakeFiles/libstats-obj.dir/model/sqlite-output.cc.o.d"
+  "CMakeFiles/libstats-obj.dir/model/time-data-calculators.cc.o"
+  "CMakeFiles/libstats-obj.dir/model/time-data-calculators.cc.o.d"
+  "CMakeFiles/libstats-obj.dir/model/time-probe.cc.o"
+  "CMakeFiles/libstats-obj.dir/model/time-probe.cc.o.d"
+  "CMakeFiles/libstats-obj.dir/model/time-series-adaptor.cc.o"
+  "CMakeFiles/libstats-obj.dir/model/time-series-adaptor.cc.o.d"
+  "CMakeFiles/libstats-obj.dir/model/uinteger-16-probe.cc.o"
+  "CMakeFiles/libstats-obj.dir/model/uinteger-16-probe.cc.o.d"
+  "CMakeFiles/libstats-obj.dir/model/uinteger-32-probe.cc.o"
+  "CMakeFiles/libstats-obj.dir/model/uinteger-32-probe.cc.o.d"
+  "CMakeFiles/libstats-obj.dir/model/uinteger-8-probe.cc.o"
+  "CMakeFiles/libstats-obj.dir/model/uinteger-8-probe.cc.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/libstats-obj.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
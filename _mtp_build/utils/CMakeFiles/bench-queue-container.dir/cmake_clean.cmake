@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../out/utils/ns3-dev-bench-queue-container-debug"
+  "../out/utils/ns3-dev-bench-queue-container-debug.pdb"
+  "CMakeFiles/bench-queue-container.dir/bench-queue-container.cc.o"
+  "CMakeFiles/bench-queue-container.dir/bench-queue-container.cc.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/bench-queue-container.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../out/utils/ns3-dev-print-introspected-doxygen-debug"
+  "../out/utils/ns3-dev-print-introspected-doxygen-debug.pdb"
+  "CMakeFiles/print-introspected-doxygen.dir/print-introspected-doxygen.cc.o"
+  "CMakeFiles/print-introspected-doxygen.dir/print-introspected-doxygen.cc.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/print-introspected-doxygen.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
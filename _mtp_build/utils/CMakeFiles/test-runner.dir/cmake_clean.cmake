@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../out/utils/ns3-dev-test-runner-debug"
+  "../out/utils/ns3-dev-test-runner-debug.pdb"
+  "CMakeFiles/test-runner.dir/test-runner.cc.o"
+  "CMakeFiles/test-runner.dir/test-runner.cc.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/test-runner.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1 @@
+#include "/root/repo/src/internet/helper/ipv4-global-routing-helper.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/traffic-control/model/log-histogram.h"
@@ -53,6 +53,10 @@ DefaultSimulatorImpl::GetTypeId()
 }
 
 DefaultSimulatorImpl::DefaultSimulatorImpl()
+    : m_eventsWithContext(EVENTS_WITH_CONTEXT_CAPACITY),
+      m_eventsWithContextTail(0),
+      m_eventsWithContextHead(0),
+      m_eventsWithContextOverflowing(false)
 {
     NS_LOG_FUNCTION(this);
     m_stop = false;
@@ -62,7 +66,10 @@ DefaultSimulatorImpl::DefaultSimulatorImpl()
     m_currentContext = Simulator::NO_CONTEXT;
     m_unscheduledEvents = 0;
     m_eventCount = 0;
-    m_eventsWithContextEmpty = true;
+    for (std::size_t i = 0; i < EVENTS_WITH_CONTEXT_CAPACITY; i++)
+    {
+        m_eventsWithContext[i].sequence.store(i, std::memory_order_relaxed);
+    }
     m_mainThreadId = std::this_thread::get_id();
 }
 
@@ -153,36 +160,96 @@ DefaultSimulatorImpl::IsFinished() const
     return m_events->IsEmpty() || m_stop;
 }
 
-void
-DefaultSimulatorImpl::ProcessEventsWithContext()
+bool
+DefaultSimulatorImpl::PushEventWithContext(const EventWithContext& ev)
 {
-    if (m_eventsWithContextEmpty)
+    constexpr std::size_t mask = EVENTS_WITH_CONTEXT_CAPACITY - 1;
+    std::size_t pos = m_eventsWithContextTail.load(std::memory_order_relaxed);
+
+    while (true)
     {
-        return;
+        EventWithContextSlot& slot = m_eventsWithContext[pos & mask];
+        std::size_t seq = slot.sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+        if (diff == 0)
+        {
+            // the slot is free, try to claim it
+            if (m_eventsWithContextTail.compare_exchange_weak(pos,
+                                                              pos + 1,
+                                                              std::memory_order_relaxed))
+            {
+                slot.event = ev;
+                slot.sequence.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            // the slot still holds the event appended a whole ring ago
+            return false;
+        }
+        else
+        {
+            // another thread claimed the slot
+            pos = m_eventsWithContextTail.load(std::memory_order_relaxed);
+        }
     }
+}
 
-    // swap queues
-    EventsWithContext eventsWithContext;
+void
+DefaultSimulatorImpl::ProcessEventsWithContext()
+{
+    constexpr std::size_t mask = EVENTS_WITH_CONTEXT_CAPACITY - 1;
+
+    // move all the events in the ring buffer, in the order they were
+    // appended; the first slot which is not ready (either free or still being
+    // written) ends the batch
+    while (true)
     {
-        std::unique_lock lock{m_eventsWithContextMutex};
-        m_eventsWithContext.swap(eventsWithContext);
-        m_eventsWithContextEmpty = true;
+        EventWithContextSlot& slot = m_eventsWithContext[m_eventsWithContextHead & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != m_eventsWithContextHead + 1)
+        {
+            break;
+        }
+        EventWithContext event = slot.event;
+        slot.sequence.store(m_eventsWithContextHead + EVENTS_WITH_CONTEXT_CAPACITY,
+                            std::memory_order_release);
+        m_eventsWithContextHead++;
+        InsertEventWithContext(event);
     }
-    while (!eventsWithContext.empty())
+
+    // the events in the overflow container were appended after those in the
+    // ring buffer, hence they are moved last, once no slot of the ring buffer
+    // is being written
+    if (m_eventsWithContextOverflowing.load(std::memory_order_acquire) &&
+        m_eventsWithContextTail.load(std::memory_order_acquire) == m_eventsWithContextHead)
     {
-        EventWithContext event = eventsWithContext.front();
-        eventsWithContext.pop_front();
-        Scheduler::Event ev;
-        ev.impl = event.event;
-        ev.key.m_ts = m_currentTs + event.timestamp;
-        ev.key.m_context = event.context;
-        ev.key.m_uid = m_uid;
-        m_uid++;
-        m_unscheduledEvents++;
-        m_events->Insert(ev);
+        std::vector<EventWithContext> eventsWithContext;
+        {
+            std::unique_lock lock{m_eventsWithContextMutex};
+            m_eventsWithContextOverflow.swap(eventsWithContext);
+            m_eventsWithContextOverflowing.store(false, std::memory_order_release);
+        }
+        for (const auto& event : eventsWithContext)
+        {
+            InsertEventWithContext(event);
+        }
     }
 }
 
+void
+DefaultSimulatorImpl::InsertEventWithContext(const EventWithContext& event)
+{
+    Scheduler::Event ev;
+    ev.impl = event.event;
+    ev.key.m_ts = m_currentTs + event.timestamp;
+    ev.key.m_context = event.context;
+    ev.key.m_uid = m_uid;
+    m_uid++;
+    m_unscheduledEvents++;
+    m_events->Insert(ev);
+}
+
 void
 DefaultSimulatorImpl::Run()
 {
@@ -264,10 +331,15 @@ DefaultSimulatorImpl::ScheduleWithContext(uint32_t context, const Time& delay, E
         // Current time added in ProcessEventsWithContext()
         ev.timestamp = delay.GetTimeStep();
         ev.event = event;
+        // once an event has overflowed, keep appending to the overflow
+        // container until it is emptied, so that the events of this thread
+        // are not reordered
+        if (m_eventsWithContextOverflowing.load(std::memory_order_acquire) ||
+            !PushEventWithContext(ev))
         {
             std::unique_lock lock{m_eventsWithContextMutex};
-            m_eventsWithContext.push_back(ev);
-            m_eventsWithContextEmpty = false;
+            m_eventsWithContextOverflow.push_back(ev);
+            m_eventsWithContextOverflowing.store(true, std::memory_order_release);
         }
     }
 }
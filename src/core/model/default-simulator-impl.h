@@ -22,9 +22,11 @@
 
 #include "simulator-impl.h"
 
+#include <atomic>
 #include <list>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 /**
  * \file
@@ -97,16 +99,57 @@ class DefaultSimulatorImpl : public SimulatorImpl
         EventImpl* event;
     };
 
-    /** Container type for the events from a different context. */
-    typedef std::list<EventWithContext> EventsWithContext;
-    /** The container of events from a different context. */
-    EventsWithContext m_eventsWithContext;
     /**
-     * Flag \c true if all events with context have been moved to the
-     * primary event queue.
+     * Insert an event from a different context into the main event queue.
+     *
+     * \param [in] event The event.
      */
-    bool m_eventsWithContextEmpty;
-    /** Mutex to control access to the list of events with context. */
+    void InsertEventWithContext(const EventWithContext& event);
+
+    /**
+     * Append an event from a different context to the ring buffer.
+     *
+     * \param [in] ev The event.
+     * \returns \c false if the ring buffer is full.
+     */
+    bool PushEventWithContext(const EventWithContext& ev);
+
+    /** A slot of the ring buffer of events from a different context. */
+    struct EventWithContextSlot
+    {
+        /**
+         * The sequence number of the slot: equal to the enqueue position when
+         * the slot is free, to the enqueue position plus one when it holds an
+         * event which has not been moved to the main event queue yet.
+         */
+        std::atomic<std::size_t> sequence;
+        /** The event. */
+        EventWithContext event;
+    };
+
+    /** Capacity of the ring buffer of events from a different context (a power of two). */
+    static constexpr std::size_t EVENTS_WITH_CONTEXT_CAPACITY = 4096;
+
+    /**
+     * Bounded multi-producer single-consumer ring buffer of events from a
+     * different context: any thread appends events without locking, the
+     * main thread moves them to the main event queue in batches.
+     */
+    std::vector<EventWithContextSlot> m_eventsWithContext;
+    /** Position of the next event appended to the ring buffer. */
+    alignas(64) std::atomic<std::size_t> m_eventsWithContextTail;
+    /** Position of the next event moved out of the ring buffer (main thread only). */
+    alignas(64) std::size_t m_eventsWithContextHead;
+    /**
+     * Events from a different context which did not fit in the ring buffer.
+     * Once this container is not empty, all events from a different context
+     * are appended here until the main thread moves them to the main event
+     * queue, so as to preserve the order of the events of each thread.
+     */
+    std::vector<EventWithContext> m_eventsWithContextOverflow;
+    /** Flag \c true if the overflow container is not empty. */
+    std::atomic<bool> m_eventsWithContextOverflowing;
+    /** Mutex to control access to the overflow container. */
     std::mutex m_eventsWithContextMutex;
 
     /** Container type for the events to run at Simulator::Destroy() */
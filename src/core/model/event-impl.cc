@@ -21,6 +21,8 @@
 
 #include "log.h"
 
+#include <atomic>
+
 /**
  * \file
  * \ingroup events
@@ -32,6 +34,126 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("EventImpl");
 
+namespace
+{
+
+/** Number of size classes of the event pools. */
+constexpr std::size_t POOL_CLASSES = EventImpl::POOL_MAX_SIZE / EventImpl::POOL_GRANULARITY;
+/** Maximum number of free blocks kept by a pool for each size class. */
+constexpr uint32_t POOL_MAX_FREE_BLOCKS = 1 << 14;
+
+/** Whether the memory of the events is reused. */
+std::atomic<bool> g_poolEnabled{true};
+
+/**
+ * \ingroup events
+ * Free blocks of memory for the events, one list for each size class.
+ *
+ * Blocks are allocated on the heap individually, so that a block allocated
+ * by a thread can be released to the pool of another thread (e.g., when an
+ * event scheduled by a thread is executed by the main thread).
+ */
+struct EventPool
+{
+    /** A free block, which stores the pointer to the next free block. */
+    struct FreeBlock
+    {
+        FreeBlock* next; //!< The next free block of the same size class
+    };
+
+    FreeBlock* heads[POOL_CLASSES] = {}; //!< The free blocks of each size class
+    uint32_t counts[POOL_CLASSES] = {};  //!< The number of free blocks of each size class
+
+    ~EventPool();
+};
+
+/**
+ * Whether the pool of the calling thread has been destroyed (i.e., the thread
+ * is exiting). It is trivially destructible, hence it can be read at any time.
+ */
+thread_local bool t_poolDestroyed = false;
+/** The pool of the calling thread. */
+thread_local EventPool t_pool;
+
+EventPool::~EventPool()
+{
+    t_poolDestroyed = true;
+    for (std::size_t i = 0; i < POOL_CLASSES; i++)
+    {
+        while (FreeBlock* block = heads[i])
+        {
+            heads[i] = block->next;
+            ::operator delete(block);
+        }
+        counts[i] = 0;
+    }
+}
+
+} // namespace
+
+void*
+EventImpl::operator new(std::size_t size)
+{
+    if (size > POOL_MAX_SIZE)
+    {
+        return ::operator new(size);
+    }
+
+    // the size of a block is the upper bound of its size class, even if the
+    // pool is disabled, so that the block can be reused once released
+    std::size_t sizeClass = (size - 1) / POOL_GRANULARITY;
+    if (!t_poolDestroyed && g_poolEnabled.load(std::memory_order_relaxed))
+    {
+        EventPool& pool = t_pool;
+        if (EventPool::FreeBlock* block = pool.heads[sizeClass])
+        {
+            pool.heads[sizeClass] = block->next;
+            pool.counts[sizeClass]--;
+            return block;
+        }
+    }
+    return ::operator new((sizeClass + 1) * POOL_GRANULARITY);
+}
+
+void*
+EventImpl::operator new(std::size_t size, std::align_val_t align)
+{
+    return ::operator new(size, align);
+}
+
+void
+EventImpl::operator delete(void* p, std::size_t size)
+{
+    if (size <= POOL_MAX_SIZE && !t_poolDestroyed &&
+        g_poolEnabled.load(std::memory_order_relaxed))
+    {
+        std::size_t sizeClass = (size - 1) / POOL_GRANULARITY;
+        EventPool& pool = t_pool;
+        if (pool.counts[sizeClass] < POOL_MAX_FREE_BLOCKS)
+        {
+            auto block = static_cast<EventPool::FreeBlock*>(p);
+            block->next = pool.heads[sizeClass];
+            pool.heads[sizeClass] = block;
+            pool.counts[sizeClass]++;
+            return;
+        }
+    }
+    ::operator delete(p);
+}
+
+void
+EventImpl::operator delete(void* p, std::size_t /* size */, std::align_val_t align)
+{
+    ::operator delete(p, align);
+}
+
+void
+EventImpl::SetPoolEnabled(bool enabled)
+{
+    NS_LOG_FUNCTION(enabled);
+    g_poolEnabled.store(enabled, std::memory_order_relaxed);
+}
+
 EventImpl::~EventImpl()
 {
     NS_LOG_FUNCTION(this);
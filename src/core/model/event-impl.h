@@ -21,6 +21,8 @@
 
 #include "simple-ref-count.h"
 
+#include <cstddef>
+#include <new>
 #include <stdint.h>
 
 /**
@@ -41,6 +43,14 @@ namespace ns3
  * when it reaches the time associated to this event. Most subclasses
  * are usually created by one of the many Simulator::Schedule
  * methods.
+ *
+ * Events are allocated and freed at a very high rate, hence the memory for
+ * the instances of all the subclasses is taken from per-thread pools of
+ * free blocks, one for each size class (multiple of POOL_GRANULARITY bytes,
+ * up to POOL_MAX_SIZE bytes). Since the bound function and arguments are
+ * stored within the event itself, scheduling an event does not allocate
+ * memory once the pool of the calling thread is warm. Larger events are
+ * allocated on the heap.
  */
 class EventImpl : public SimpleRefCount<EventImpl>
 {
@@ -67,6 +77,52 @@ class EventImpl : public SimpleRefCount<EventImpl>
      */
     bool IsCancelled();
 
+    /**
+     * Allocate memory for an event, from the pool of the calling thread if
+     * the event is not larger than POOL_MAX_SIZE.
+     *
+     * \param [in] size The size of the event.
+     * \returns A pointer to the allocated memory.
+     */
+    static void* operator new(std::size_t size);
+    /**
+     * Allocate memory for an over-aligned event, on the heap.
+     *
+     * \param [in] size The size of the event.
+     * \param [in] align The alignment of the event.
+     * \returns A pointer to the allocated memory.
+     */
+    static void* operator new(std::size_t size, std::align_val_t align);
+    /**
+     * Release the memory of an event to the pool of the calling thread.
+     *
+     * \param [in] p The pointer to the memory of the event.
+     * \param [in] size The size of the event.
+     */
+    static void operator delete(void* p, std::size_t size);
+    /**
+     * Release the memory of an over-aligned event.
+     *
+     * \param [in] p The pointer to the memory of the event.
+     * \param [in] size The size of the event.
+     * \param [in] align The alignment of the event.
+     */
+    static void operator delete(void* p, std::size_t size, std::align_val_t align);
+
+    /**
+     * Enable or disable the reuse of the memory of the events. When pooling
+     * is disabled, events are allocated on the heap and released to the heap.
+     * This is mainly meant to measure the benefits of pooling.
+     *
+     * \param [in] enabled Whether the memory of the events is reused.
+     */
+    static void SetPoolEnabled(bool enabled);
+
+    /** The granularity of the size classes of the pools, in bytes. */
+    static constexpr std::size_t POOL_GRANULARITY = 16;
+    /** The size of the largest events taken from the pools, in bytes. */
+    static constexpr std::size_t POOL_MAX_SIZE = 256;
+
   protected:
     /**
      * Implementation for Invoke().
@@ -0,0 +1,97 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "hash-crc32c.h"
+
+#include "log.h"
+
+#include <array>
+
+/**
+ * \file
+ * \ingroup hash
+ * \brief ns3::Hash::Function::Crc32c implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("Hash-Crc32c");
+
+namespace Hash
+{
+
+namespace Function
+{
+
+namespace Crc32cImplementation
+{
+
+/**
+ * \ingroup hash
+ * Build the lookup table of the reflected Castagnoli polynomial
+ *
+ * \return the lookup table
+ */
+constexpr std::array<uint32_t, 256>
+MakeTable()
+{
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        uint32_t crc = i;
+        for (int k = 0; k < 8; k++)
+        {
+            crc = (crc & 1) ? (crc >> 1) ^ 0x82f63b78 : crc >> 1;
+        }
+        table[i] = crc;
+    }
+    return table;
+}
+
+/** Lookup table */
+constexpr std::array<uint32_t, 256> crcTable = MakeTable();
+
+} // namespace Crc32cImplementation
+
+Crc32c::Crc32c()
+{
+    clear();
+}
+
+uint32_t
+Crc32c::GetHash32(const char* buffer, const std::size_t size)
+{
+    const auto* p = reinterpret_cast<const uint8_t*>(buffer);
+    uint32_t crc = m_crc;
+    for (std::size_t i = 0; i < size; i++)
+    {
+        crc = Crc32cImplementation::crcTable[(crc ^ p[i]) & 0xff] ^ (crc >> 8);
+    }
+    m_crc = crc;
+    return ~crc;
+}
+
+void
+Crc32c::clear()
+{
+    m_crc = 0xffffffff;
+}
+
+} // namespace Function
+
+} // namespace Hash
+
+} // namespace ns3
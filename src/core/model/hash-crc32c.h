@@ -0,0 +1,86 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef HASH_CRC32C_H
+#define HASH_CRC32C_H
+
+#include "hash-function.h"
+
+/**
+ * \file
+ * \ingroup hash
+ * \brief ns3::Hash::Function::Crc32c declaration.
+ */
+
+namespace ns3
+{
+
+namespace Hash
+{
+
+namespace Function
+{
+
+/**
+ *  \ingroup hash
+ *
+ *  \brief CRC32C hash function implementation
+ *
+ *  This is the CRC-32 with the Castagnoli polynomial (0x1EDC6F41), as
+ *  used by iSCSI and SCTP.  It is computed with a table driven, byte at
+ *  a time algorithm, which is cheap on the short buffers (e.g., the 5-tuple
+ *  of a packet) it is intended for.
+ *
+ *  Only the 32-bit hash is provided.
+ */
+class Crc32c : public Implementation
+{
+  public:
+    /**
+     * Constructor
+     */
+    Crc32c();
+    /**
+     * Compute 32-bit hash of a byte buffer
+     *
+     * Call clear () between calls to GetHash32() to reset the
+     * internal state and hash each buffer separately.
+     *
+     * If you don't call clear() between calls to GetHash32,
+     * you can hash successive buffers.  The final return value
+     * will be the CRC of the concatenation of all the buffers.
+     *
+     * \param [in] buffer pointer to the beginning of the buffer
+     * \param [in] size length of the buffer, in bytes
+     * \return 32-bit hash of the buffer
+     */
+    uint32_t GetHash32(const char* buffer, const std::size_t size) override;
+    /**
+     * Restore initial state
+     */
+    void clear() override;
+
+  private:
+    uint32_t m_crc; //!< Current (non-inverted) CRC value, for incremental hashing.
+
+}; // class Crc32c
+
+} // namespace Function
+
+} // namespace Hash
+
+} // namespace ns3
+
+#endif /* HASH_CRC32C_H */
@@ -0,0 +1,225 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "hash-jenkins.h"
+
+#include "log.h"
+
+/**
+ * \file
+ * \ingroup hash
+ * \brief ns3::Hash::Function::Jenkins implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("Hash-Jenkins");
+
+namespace Hash
+{
+
+namespace Function
+{
+
+namespace JenkinsImplementation
+{
+
+/**
+ * \ingroup hash
+ * Rotate a 32-bit word left
+ *
+ * \param [in] x the word
+ * \param [in] k the number of bits to rotate by
+ * \return the rotated word
+ */
+inline uint32_t
+rol32(uint32_t x, int k)
+{
+    return (x << k) | (x >> (32 - k));
+}
+
+/**
+ * \ingroup hash
+ * Mix three 32-bit values reversibly
+ *
+ * \param [in,out] a first value
+ * \param [in,out] b second value
+ * \param [in,out] c third value
+ */
+inline void
+mix(uint32_t& a, uint32_t& b, uint32_t& c)
+{
+    a -= c;
+    a ^= rol32(c, 4);
+    c += b;
+    b -= a;
+    b ^= rol32(a, 6);
+    a += c;
+    c -= b;
+    c ^= rol32(b, 8);
+    b += a;
+    a -= c;
+    a ^= rol32(c, 16);
+    c += b;
+    b -= a;
+    b ^= rol32(a, 19);
+    a += c;
+    c -= b;
+    c ^= rol32(b, 4);
+    b += a;
+}
+
+/**
+ * \ingroup hash
+ * Final mixing of three 32-bit values into c
+ *
+ * \param [in,out] a first value
+ * \param [in,out] b second value
+ * \param [in,out] c third value
+ */
+inline void
+final(uint32_t& a, uint32_t& b, uint32_t& c)
+{
+    c ^= b;
+    c -= rol32(b, 14);
+    a ^= c;
+    a -= rol32(c, 11);
+    b ^= a;
+    b -= rol32(a, 25);
+    c ^= b;
+    c -= rol32(b, 16);
+    a ^= c;
+    a -= rol32(c, 4);
+    b ^= a;
+    b -= rol32(a, 14);
+    c ^= b;
+    c -= rol32(b, 24);
+}
+
+/**
+ * \ingroup hash
+ * Read a little endian 32-bit word
+ *
+ * \param [in] k pointer to the first byte of the word
+ * \return the word
+ */
+inline uint32_t
+load32(const uint8_t* k)
+{
+    return k[0] | (k[1] << 8) | (k[2] << 16) | (static_cast<uint32_t>(k[3]) << 24);
+}
+
+/**
+ * \ingroup hash
+ * Compute the lookup3 hash (hashlittle) of a byte buffer
+ *
+ * \param [in] key the buffer
+ * \param [in] length the length of the buffer, in bytes
+ * \param [in] initval the initial value
+ * \return the 32-bit hash
+ */
+uint32_t
+hashlittle(const uint8_t* key, std::size_t length, uint32_t initval)
+{
+    uint32_t a;
+    uint32_t b;
+    uint32_t c;
+    a = b = c = 0xdeadbeef + static_cast<uint32_t>(length) + initval;
+
+    while (length > 12)
+    {
+        a += load32(key);
+        b += load32(key + 4);
+        c += load32(key + 8);
+        mix(a, b, c);
+        length -= 12;
+        key += 12;
+    }
+
+    // the last block is affected by all 32 bits of c
+    switch (length)
+    {
+    case 12:
+        c += static_cast<uint32_t>(key[11]) << 24;
+        [[fallthrough]];
+    case 11:
+        c += static_cast<uint32_t>(key[10]) << 16;
+        [[fallthrough]];
+    case 10:
+        c += static_cast<uint32_t>(key[9]) << 8;
+        [[fallthrough]];
+    case 9:
+        c += key[8];
+        [[fallthrough]];
+    case 8:
+        b += static_cast<uint32_t>(key[7]) << 24;
+        [[fallthrough]];
+    case 7:
+        b += static_cast<uint32_t>(key[6]) << 16;
+        [[fallthrough]];
+    case 6:
+        b += static_cast<uint32_t>(key[5]) << 8;
+        [[fallthrough]];
+    case 5:
+        b += key[4];
+        [[fallthrough]];
+    case 4:
+        a += static_cast<uint32_t>(key[3]) << 24;
+        [[fallthrough]];
+    case 3:
+        a += static_cast<uint32_t>(key[2]) << 16;
+        [[fallthrough]];
+    case 2:
+        a += static_cast<uint32_t>(key[1]) << 8;
+        [[fallthrough]];
+    case 1:
+        a += key[0];
+        final(a, b, c);
+        break;
+    case 0:
+        // zero length strings require no mixing
+        break;
+    }
+    return c;
+}
+
+} // namespace JenkinsImplementation
+
+Jenkins::Jenkins(uint32_t initval)
+    : m_initval(initval)
+{
+    clear();
+}
+
+uint32_t
+Jenkins::GetHash32(const char* buffer, const std::size_t size)
+{
+    m_hash32 =
+        JenkinsImplementation::hashlittle(reinterpret_cast<const uint8_t*>(buffer), size, m_hash32);
+    return m_hash32;
+}
+
+void
+Jenkins::clear()
+{
+    m_hash32 = m_initval;
+}
+
+} // namespace Function
+
+} // namespace Hash
+
+} // namespace ns3
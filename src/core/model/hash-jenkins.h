@@ -0,0 +1,90 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef HASH_JENKINS_H
+#define HASH_JENKINS_H
+
+#include "hash-function.h"
+
+/**
+ * \file
+ * \ingroup hash
+ * \brief ns3::Hash::Function::Jenkins declaration.
+ */
+
+namespace ns3
+{
+
+namespace Hash
+{
+
+namespace Function
+{
+
+/**
+ *  \ingroup hash
+ *
+ *  \brief Jenkins lookup3 hash function implementation
+ *
+ *  This is Bob Jenkins' lookup3 hash (hashlittle), which is also the
+ *  jhash() function of the Linux kernel.  Bytes are consumed in little
+ *  endian order, hence the result is the same on every platform and
+ *  matches the value computed by jhash() on a little endian host.
+ *
+ *  Only the 32-bit hash is provided.
+ */
+class Jenkins : public Implementation
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param [in] initval the initial value (the seed) of the hash
+     */
+    Jenkins(uint32_t initval = 0);
+    /**
+     * Compute 32-bit hash of a byte buffer
+     *
+     * Call clear () between calls to GetHash32() to reset the
+     * internal state and hash each buffer separately.
+     *
+     * If you don't call clear() between calls to GetHash32,
+     * each buffer is hashed using the previous hash value as
+     * initial value, hence the final return value depends on all
+     * the buffers, but differs from the hash of their concatenation.
+     *
+     * \param [in] buffer pointer to the beginning of the buffer
+     * \param [in] size length of the buffer, in bytes
+     * \return 32-bit hash of the buffer
+     */
+    uint32_t GetHash32(const char* buffer, const std::size_t size) override;
+    /**
+     * Restore initial state
+     */
+    void clear() override;
+
+  private:
+    uint32_t m_initval; //!< Initial value
+    uint32_t m_hash32;  //!< Cache last hash value, for incremental hashing.
+
+}; // class Jenkins
+
+} // namespace Function
+
+} // namespace Hash
+
+} // namespace ns3
+
+#endif /* HASH_JENKINS_H */
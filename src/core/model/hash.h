@@ -21,8 +21,10 @@
 #define HASH_H
 
 #include "assert.h"
+#include "hash-crc32c.h"
 #include "hash-fnv.h"
 #include "hash-function.h"
+#include "hash-jenkins.h"
 #include "hash-murmur3.h"
 #include "ptr.h"
 
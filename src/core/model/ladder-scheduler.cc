@@ -0,0 +1,331 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+
+#include "assert.h"
+#include "event-impl.h"
+#include "log.h"
+
+#include <algorithm>
+#include <limits>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::LadderScheduler class.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("LadderScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED(LadderScheduler);
+
+TypeId
+LadderScheduler::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::LadderScheduler")
+                            .SetParent<Scheduler>()
+                            .SetGroupName("Core")
+                            .AddConstructor<LadderScheduler>();
+    return tid;
+}
+
+LadderScheduler::LadderScheduler()
+    : m_topMin(std::numeric_limits<uint64_t>::max()),
+      m_topMax(0),
+      m_topStart(0),
+      m_nRungs(0),
+      m_bottomHead(0),
+      m_count(0)
+{
+    NS_LOG_FUNCTION(this);
+    m_rungs.reserve(MAX_RUNGS);
+}
+
+LadderScheduler::~LadderScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+uint64_t
+LadderScheduler::CurrentStart(const Rung& rung)
+{
+    return rung.start + rung.current * rung.width;
+}
+
+std::size_t
+LadderScheduler::FindRung(uint64_t ts) const
+{
+    // each rung covers the range of timestamps of the current bucket of the
+    // previous rung, hence the first rung whose current bucket starts not later
+    // than the given timestamp is the one including the timestamp
+    for (std::size_t i = 0; i < m_nRungs; i++)
+    {
+        if (ts >= CurrentStart(m_rungs[i]))
+        {
+            return i;
+        }
+    }
+    return m_nRungs;
+}
+
+void
+LadderScheduler::AddRung(uint64_t start, uint64_t end, const Bucket& events)
+{
+    NS_LOG_FUNCTION(this << start << end << events.size());
+    NS_ASSERT(start < end && !events.empty() && m_nRungs < MAX_RUNGS);
+
+    if (m_nRungs == m_rungs.size())
+    {
+        m_rungs.emplace_back();
+    }
+    Rung& rung = m_rungs[m_nRungs++];
+
+    // one bucket per event, on average
+    uint64_t span = end - start;
+    uint64_t n = events.size();
+    rung.start = start;
+    rung.width = span / n + (span % n != 0);
+    rung.nBuckets = span / rung.width + (span % rung.width != 0);
+    rung.current = 0;
+    rung.count = events.size();
+    if (rung.buckets.size() < rung.nBuckets)
+    {
+        rung.buckets.resize(rung.nBuckets);
+    }
+
+    for (const auto& ev : events)
+    {
+        NS_ASSERT(ev.key.m_ts >= start && ev.key.m_ts < end);
+        rung.buckets[(ev.key.m_ts - start) / rung.width].push_back(ev);
+    }
+}
+
+void
+LadderScheduler::FillBottom(const Bucket& events)
+{
+    NS_LOG_FUNCTION(this << events.size());
+    NS_ASSERT(m_bottom.empty());
+    m_bottom.assign(events.begin(), events.end());
+    std::sort(m_bottom.begin(), m_bottom.end());
+}
+
+void
+LadderScheduler::Refill()
+{
+    NS_LOG_FUNCTION(this);
+
+    while (m_bottomHead == m_bottom.size() && m_count > 0)
+    {
+        m_bottom.clear();
+        m_bottomHead = 0;
+
+        if (m_nRungs == 0)
+        {
+            // the ladder is empty, move the events in the Top to the ladder
+            NS_ASSERT(!m_top.empty());
+            uint64_t min = m_topMin;
+            m_topStart = m_topMax + 1;
+            m_topMin = std::numeric_limits<uint64_t>::max();
+            m_topMax = 0;
+            m_scratch.swap(m_top);
+            if (m_scratch.size() <= THRESHOLD || min + 1 == m_topStart)
+            {
+                FillBottom(m_scratch);
+            }
+            else
+            {
+                AddRung(min, m_topStart, m_scratch);
+            }
+            m_scratch.clear();
+            continue;
+        }
+
+        Rung& rung = m_rungs[m_nRungs - 1];
+        if (rung.count == 0)
+        {
+            m_nRungs--;
+            continue;
+        }
+
+        while (rung.buckets[rung.current].empty())
+        {
+            rung.current++;
+        }
+        NS_ASSERT(rung.current < rung.nBuckets);
+
+        // take the events out of the current bucket, which is no longer part of
+        // the range covered by the rung
+        uint64_t end = CurrentStart(rung) + rung.width;
+        m_scratch.swap(rung.buckets[rung.current]);
+        rung.count -= m_scratch.size();
+        rung.current++;
+
+        if (m_scratch.size() > THRESHOLD && m_nRungs < MAX_RUNGS)
+        {
+            auto [minIt, maxIt] = std::minmax_element(m_scratch.begin(), m_scratch.end());
+            if (minIt->key.m_ts != maxIt->key.m_ts)
+            {
+                // split the events over a new rung
+                AddRung(minIt->key.m_ts, end, m_scratch);
+                m_scratch.clear();
+                continue;
+            }
+        }
+        FillBottom(m_scratch);
+        m_scratch.clear();
+    }
+}
+
+void
+LadderScheduler::Insert(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << &ev);
+
+    m_count++;
+    uint64_t ts = ev.key.m_ts;
+
+    if (ts >= m_topStart)
+    {
+        m_top.push_back(ev);
+        m_topMin = std::min(m_topMin, ts);
+        m_topMax = std::max(m_topMax, ts);
+        Refill();
+        return;
+    }
+
+    std::size_t i = FindRung(ts);
+    if (i < m_nRungs)
+    {
+        Rung& rung = m_rungs[i];
+        std::size_t index = (ts - rung.start) / rung.width;
+        NS_ASSERT(index < rung.nBuckets);
+        rung.buckets[index].push_back(ev);
+        rung.count++;
+        return;
+    }
+
+    // insert the event in the Bottom, after discarding the removed events
+    if (m_bottomHead >= THRESHOLD && 2 * m_bottomHead >= m_bottom.size())
+    {
+        m_bottom.erase(m_bottom.begin(), m_bottom.begin() + m_bottomHead);
+        m_bottomHead = 0;
+    }
+    m_bottom.insert(std::upper_bound(m_bottom.begin() + m_bottomHead, m_bottom.end(), ev), ev);
+
+    // if the Bottom has grown too large, split its events over a new rung
+    if (m_bottom.size() - m_bottomHead > THRESHOLD && m_nRungs < MAX_RUNGS &&
+        m_bottom[m_bottomHead].key.m_ts != m_bottom.back().key.m_ts)
+    {
+        uint64_t end = (m_nRungs > 0 ? CurrentStart(m_rungs[m_nRungs - 1]) : m_topStart);
+        uint64_t start = m_bottom[m_bottomHead].key.m_ts;
+        m_scratch.assign(m_bottom.begin() + m_bottomHead, m_bottom.end());
+        m_bottom.clear();
+        m_bottomHead = 0;
+        AddRung(start, end, m_scratch);
+        m_scratch.clear();
+        Refill();
+    }
+}
+
+bool
+LadderScheduler::IsEmpty() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_count == 0;
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext() const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+    return m_bottom[m_bottomHead];
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!IsEmpty());
+
+    Event next = m_bottom[m_bottomHead++];
+    m_count--;
+    if (m_bottomHead == m_bottom.size())
+    {
+        m_bottom.clear();
+        m_bottomHead = 0;
+        Refill();
+    }
+    return next;
+}
+
+void
+LadderScheduler::Remove(const Event& ev)
+{
+    NS_LOG_FUNCTION(this << &ev);
+    NS_ASSERT(!IsEmpty());
+
+    uint64_t ts = ev.key.m_ts;
+    // events are located based on their timestamp as upon insertion
+    Bucket* bucket = &m_bottom;
+    std::size_t i = m_nRungs;
+
+    if (ts >= m_topStart)
+    {
+        bucket = &m_top;
+    }
+    else if ((i = FindRung(ts)) < m_nRungs)
+    {
+        Rung& rung = m_rungs[i];
+        bucket = &rung.buckets[(ts - rung.start) / rung.width];
+    }
+
+    if (bucket != &m_bottom)
+    {
+        // the order of the events in the Top and in the buckets does not matter
+        auto it = std::find(bucket->begin(), bucket->end(), ev);
+        NS_ASSERT(it != bucket->end() && it->impl == ev.impl);
+        *it = bucket->back();
+        bucket->pop_back();
+        if (m_top.empty())
+        {
+            m_topMin = std::numeric_limits<uint64_t>::max();
+            m_topMax = 0;
+        }
+        if (i < m_nRungs)
+        {
+            m_rungs[i].count--;
+        }
+        m_count--;
+        return;
+    }
+
+    auto it = std::lower_bound(m_bottom.begin() + m_bottomHead, m_bottom.end(), ev);
+    NS_ASSERT(it != m_bottom.end() && it->key == ev.key && it->impl == ev.impl);
+    m_bottom.erase(it);
+    m_count--;
+    if (m_bottomHead == m_bottom.size())
+    {
+        m_bottom.clear();
+        m_bottomHead = 0;
+        Refill();
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,184 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * ns3::LadderScheduler declaration.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup scheduler
+ * \brief a ladder queue event scheduler
+ *
+ * This event scheduler is an implementation of the Ladder Queue described in
+ * W. T. Tang, R. S. M. Goh and I. L.-J. Thng, "Ladder Queue: An O(1) Priority
+ * Queue Structure for Large-Scale Discrete Event Simulation", ACM TOMACS 2005.
+ *
+ * Events are stored in three tiers:
+ *  - the Top, an unsorted array collecting the events far in the future,
+ *    i.e., those whose timestamp is not smaller than a threshold (the start
+ *    of the Top);
+ *  - the Ladder, made of (up to MAX_RUNGS) rungs. Each rung is an array of
+ *    buckets of equal width covering a range of timestamps, and the events
+ *    are stored unsorted in the bucket including their timestamp. Each rung
+ *    covers the range of timestamps of a bucket of the previous rung;
+ *  - the Bottom, a sorted array including the earliest events.
+ *
+ * When the Bottom is empty, the events of the first non-empty bucket of the
+ * last rung are sorted and moved to the Bottom, unless they exceed THRESHOLD,
+ * in which case a new rung is created to split them. When the Ladder is empty,
+ * the events in the Top are spread over a new rung. Since every event is
+ * moved across a bounded number of rungs and sorting only involves small
+ * sets of events, insert and remove-next operations take amortized constant
+ * time. Unlike the CalendarScheduler, the buckets are never resized as a
+ * whole: each rung is sized upon creation based on the events it receives.
+ *
+ * All the tiers are stored in `std::vector`s which are cleared (rather
+ * than deallocated) when they are emptied, so that no memory is allocated
+ * once the scheduler has reached its steady state.
+ *
+ * \par Time Complexity
+ *
+ * Operation    | Amortized %Time | Reason
+ * :----------- | :-------------- | :-----
+ * Insert()     | Constant        | Append to Top or to a bucket
+ * IsEmpty()    | Constant        | Explicit queue size
+ * PeekNext()   | Constant        | Bottom kept non-empty and sorted
+ * Remove()     | Linear          | Search within the Top, a bucket or the Bottom
+ * RemoveNext() | Constant        | Events moved across a bounded number of rungs
+ *
+ * \par Memory Complexity
+ *
+ * Category  | Memory                           | Reason
+ * :-------- | :------------------------------- | :-----
+ * Overhead  | 4 x 24 + 72 bytes per rung       | Top, Bottom, scratch and rung `std::vector`s
+ * Per Event | 0                                | Events stored in `std::vector`s directly
+ */
+class LadderScheduler : public Scheduler
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    LadderScheduler();
+    /** Destructor. */
+    ~LadderScheduler() override;
+
+    // Inherited
+    void Insert(const Scheduler::Event& ev) override;
+    bool IsEmpty() const override;
+    Scheduler::Event PeekNext() const override;
+    Scheduler::Event RemoveNext() override;
+    void Remove(const Scheduler::Event& ev) override;
+
+    /// Maximum number of events moved from a bucket to the Bottom without being split
+    static constexpr std::size_t THRESHOLD = 50;
+    /// Maximum number of rungs
+    static constexpr std::size_t MAX_RUNGS = 8;
+
+  private:
+    /** Bucket type: vector of unsorted Events. */
+    typedef std::vector<Scheduler::Event> Bucket;
+
+    /** A rung of the ladder. */
+    struct Rung
+    {
+        uint64_t start;              //!< The start of the range of timestamps of the rung
+        uint64_t width;              //!< The width of each bucket
+        std::size_t nBuckets;        //!< The number of buckets in use
+        std::size_t current;         //!< The index of the next bucket to process
+        std::size_t count;           //!< The number of events in the rung
+        std::vector<Bucket> buckets; //!< The buckets (nBuckets of which are used)
+    };
+
+    /**
+     * Get the start of the range of timestamps covered by the unprocessed
+     * buckets of a rung.
+     *
+     * \param [in] rung The rung.
+     * \returns The timestamp of the start of the current bucket.
+     */
+    static uint64_t CurrentStart(const Rung& rung);
+
+    /**
+     * Find the rung whose unprocessed buckets include the given timestamp.
+     *
+     * \param [in] ts The timestamp.
+     * \returns The index of the rung, or the number of rungs in use if the
+     *          timestamp belongs to the Bottom.
+     */
+    std::size_t FindRung(uint64_t ts) const;
+
+    /**
+     * Add a rung covering the given range of timestamps and spread the given
+     * events over its buckets.
+     *
+     * \param [in] start The start of the range of timestamps.
+     * \param [in] end The end (excluded) of the range of timestamps.
+     * \param [in] events The events, which all belong to the range.
+     */
+    void AddRung(uint64_t start, uint64_t end, const Bucket& events);
+
+    /** Move events to the Bottom if it is empty and the scheduler is not. */
+    void Refill();
+
+    /**
+     * Sort the given events and make them the content of the (empty) Bottom.
+     *
+     * \param [in] events The events.
+     */
+    void FillBottom(const Bucket& events);
+
+    /** The events in the Top. */
+    Bucket m_top;
+    /** The smallest timestamp of the events in the Top (a lower bound after Remove). */
+    uint64_t m_topMin;
+    /** The largest timestamp of the events in the Top (an upper bound after Remove). */
+    uint64_t m_topMax;
+    /** Events whose timestamp is not smaller than this value are inserted in the Top. */
+    uint64_t m_topStart;
+    /** The rungs (m_nRungs of which are used, rungs are reused to avoid allocations). */
+    std::vector<Rung> m_rungs;
+    /** The number of rungs in use. */
+    std::size_t m_nRungs;
+    /** The events in the Bottom, sorted in increasing order starting at m_bottomHead. */
+    Bucket m_bottom;
+    /** The index of the first event in the Bottom. */
+    std::size_t m_bottomHead;
+    /** Scratch space used when moving events across tiers. */
+    Bucket m_scratch;
+    /** The number of events in the scheduler. */
+    std::size_t m_count;
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
@@ -34,7 +34,7 @@
 #include "rng-stream.h"
 #include "string.h"
 
-#include <algorithm> // upper_bound
+#include <algorithm> // upper_bound, fill
 #include <cmath>
 #include <iostream>
 
@@ -109,6 +109,16 @@ RandomVariableStream::GetInteger()
     return static_cast<uint32_t>(GetValue());
 }
 
+void
+RandomVariableStream::GetValues(double* values, std::size_t n)
+{
+    NS_LOG_FUNCTION(this << values << n);
+    for (std::size_t i = 0; i < n; i++)
+    {
+        values[i] = GetValue();
+    }
+}
+
 void
 RandomVariableStream::SetStream(int64_t stream)
 {
@@ -226,6 +236,24 @@ UniformRandomVariable::GetInteger()
     return static_cast<uint32_t>(GetValue(m_min, m_max + 1));
 }
 
+void
+UniformRandomVariable::GetValues(double* values, std::size_t n)
+{
+    NS_LOG_FUNCTION(this << values << n);
+    Peek()->RandU01(values, n);
+    // Same computation as GetValue(double,double)
+    bool antithetic = IsAntithetic();
+    for (std::size_t i = 0; i < n; i++)
+    {
+        double v = m_min + values[i] * (m_max - m_min);
+        if (antithetic)
+        {
+            v = m_min + (m_max - v);
+        }
+        values[i] = v;
+    }
+}
+
 NS_OBJECT_ENSURE_REGISTERED(ConstantRandomVariable);
 
 TypeId
@@ -277,6 +305,13 @@ ConstantRandomVariable::GetValue()
     return GetValue(m_constant);
 }
 
+void
+ConstantRandomVariable::GetValues(double* values, std::size_t n)
+{
+    NS_LOG_FUNCTION(this << values << n);
+    std::fill(values, values + n, m_constant);
+}
+
 NS_OBJECT_ENSURE_REGISTERED(SequentialRandomVariable);
 
 TypeId
@@ -455,6 +490,30 @@ ExponentialRandomVariable::GetValue()
     return GetValue(m_mean, m_bound);
 }
 
+void
+ExponentialRandomVariable::GetValues(double* values, std::size_t n)
+{
+    NS_LOG_FUNCTION(this << values << n);
+    if (m_bound != 0)
+    {
+        // rejected values would shift the uniform values drawn in advance
+        RandomVariableStream::GetValues(values, n);
+        return;
+    }
+    Peek()->RandU01(values, n);
+    // Same computation as GetValue(double,double)
+    bool antithetic = IsAntithetic();
+    for (std::size_t i = 0; i < n; i++)
+    {
+        double v = values[i];
+        if (antithetic)
+        {
+            v = (1 - v);
+        }
+        values[i] = -m_mean * std::log(v);
+    }
+}
+
 NS_OBJECT_ENSURE_REGISTERED(ParetoRandomVariable);
 
 TypeId
@@ -554,6 +613,30 @@ ParetoRandomVariable::GetValue()
     return GetValue(m_scale, m_shape, m_bound);
 }
 
+void
+ParetoRandomVariable::GetValues(double* values, std::size_t n)
+{
+    NS_LOG_FUNCTION(this << values << n);
+    if (m_bound != 0)
+    {
+        // rejected values would shift the uniform values drawn in advance
+        RandomVariableStream::GetValues(values, n);
+        return;
+    }
+    Peek()->RandU01(values, n);
+    // Same computation as GetValue(double,double,double)
+    bool antithetic = IsAntithetic();
+    for (std::size_t i = 0; i < n; i++)
+    {
+        double v = values[i];
+        if (antithetic)
+        {
+            v = (1 - v);
+        }
+        values[i] = (m_scale * (1.0 / std::pow(v, 1.0 / m_shape)));
+    }
+}
+
 NS_OBJECT_ENSURE_REGISTERED(WeibullRandomVariable);
 
 TypeId
@@ -651,6 +734,31 @@ WeibullRandomVariable::GetValue()
     return GetValue(m_scale, m_shape, m_bound);
 }
 
+void
+WeibullRandomVariable::GetValues(double* values, std::size_t n)
+{
+    NS_LOG_FUNCTION(this << values << n);
+    if (m_bound != 0)
+    {
+        // rejected values would shift the uniform values drawn in advance
+        RandomVariableStream::GetValues(values, n);
+        return;
+    }
+    Peek()->RandU01(values, n);
+    // Same computation as GetValue(double,double,double)
+    bool antithetic = IsAntithetic();
+    double exponent = 1.0 / m_shape;
+    for (std::size_t i = 0; i < n; i++)
+    {
+        double v = values[i];
+        if (antithetic)
+        {
+            v = (1 - v);
+        }
+        values[i] = m_scale * std::pow(-std::log(v), exponent);
+    }
+}
+
 NS_OBJECT_ENSURE_REGISTERED(NormalRandomVariable);
 
 const double NormalRandomVariable::INFINITE_VALUE = 1e307;
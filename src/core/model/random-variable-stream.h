@@ -29,6 +29,7 @@
 #include "object.h"
 #include "type-id.h"
 
+#include <cstddef>
 #include <map>
 #include <stdint.h>
 
@@ -153,6 +154,20 @@ class RandomVariableStream : public Object
     // The base implementation returns `(uint32_t)GetValue()`
     virtual uint32_t GetInteger();
 
+    /**
+     * \brief Get the next random values drawn from the distribution.
+     *
+     * The values are the same as those returned by \pname{n} successive
+     * calls to GetValue(), so that the two can be used interchangeably
+     * without changing the outcome of a simulation.  The base
+     * implementation calls GetValue(); the common distributions draw
+     * their uniform values from the RngStream in blocks.
+     *
+     * \param [out] values The array to fill.
+     * \param [in] n The number of values to draw.
+     */
+    virtual void GetValues(double* values, std::size_t n);
+
   protected:
     /**
      * \brief Get the pointer to the underlying RngStream.
@@ -283,6 +298,12 @@ class UniformRandomVariable : public RandomVariableStream
      */
     uint32_t GetInteger() override;
 
+    /**
+     * \copydoc RandomVariableStream::GetValues(double*,std::size_t)
+     * \note The upper limit is excluded from the output range, as with GetValue().
+     */
+    void GetValues(double* values, std::size_t n) override;
+
   private:
     /** The lower bound on values that can be returned by this RNG stream. */
     double m_min;
@@ -340,6 +361,8 @@ class ConstantRandomVariable : public RandomVariableStream
     double GetValue() override;
     /* \note This RNG always returns the same value. */
     using RandomVariableStream::GetInteger;
+    /** \copydoc RandomVariableStream::GetValues(double*,std::size_t) */
+    void GetValues(double* values, std::size_t n) override;
 
   private:
     /** The constant value returned by this RNG stream. */
@@ -592,6 +615,12 @@ class ExponentialRandomVariable : public RandomVariableStream
     // Inherited
     double GetValue() override;
     using RandomVariableStream::GetInteger;
+    /**
+     * \copydoc RandomVariableStream::GetValues(double*,std::size_t)
+     * \note The values are drawn in blocks only if the distribution is
+     * not bounded, otherwise each value may need several uniform values.
+     */
+    void GetValues(double* values, std::size_t n) override;
 
   private:
     /** The mean value of the unbounded exponential distribution. */
@@ -728,6 +757,12 @@ class ParetoRandomVariable : public RandomVariableStream
     // Inherited
     double GetValue() override;
     using RandomVariableStream::GetInteger;
+    /**
+     * \copydoc RandomVariableStream::GetValues(double*,std::size_t)
+     * \note The values are drawn in blocks only if the distribution is
+     * not bounded, otherwise each value may need several uniform values.
+     */
+    void GetValues(double* values, std::size_t n) override;
 
   private:
     /** The scale parameter for the Pareto distribution returned by this RNG stream. */
@@ -875,6 +910,12 @@ class WeibullRandomVariable : public RandomVariableStream
     // Inherited
     double GetValue() override;
     using RandomVariableStream::GetInteger;
+    /**
+     * \copydoc RandomVariableStream::GetValues(double*,std::size_t)
+     * \note The values are drawn in blocks only if the distribution is
+     * not bounded, otherwise each value may need several uniform values.
+     */
+    void GetValues(double* values, std::size_t n) override;
 
   private:
     /** The scale parameter for the Weibull distribution returned by this RNG stream. */
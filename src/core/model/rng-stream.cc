@@ -24,6 +24,7 @@
 #include "fatal-error.h"
 #include "log.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <iostream>
 
@@ -375,6 +376,75 @@ RngStream::RandU01()
     return u;
 }
 
+void
+RngStream::RandU01(double* values, std::size_t n)
+{
+    // Size of the blocks of the components, which fit in the L1 cache
+    const std::size_t BLOCK = 256;
+    double p1[BLOCK];
+    double p2[BLOCK];
+
+    double s10 = m_currentState[0];
+    double s11 = m_currentState[1];
+    double s12 = m_currentState[2];
+    double s20 = m_currentState[3];
+    double s21 = m_currentState[4];
+    double s22 = m_currentState[5];
+
+    while (n > 0)
+    {
+        std::size_t count = std::min(n, BLOCK);
+
+        // The two components are independent recurrences, computed with the
+        // same exact operations as RandU01()
+        for (std::size_t i = 0; i < count; i++)
+        {
+            double p = a12 * s11 - a13n * s10;
+            auto k = static_cast<int32_t>(p / m1);
+            p -= k * m1;
+            if (p < 0.0)
+            {
+                p += m1;
+            }
+            s10 = s11;
+            s11 = s12;
+            s12 = p;
+            p1[i] = p;
+        }
+        for (std::size_t i = 0; i < count; i++)
+        {
+            double p = a21 * s22 - a23n * s20;
+            auto k = static_cast<int32_t>(p / m2);
+            p -= k * m2;
+            if (p < 0.0)
+            {
+                p += m2;
+            }
+            s20 = s21;
+            s21 = s22;
+            s22 = p;
+            p2[i] = p;
+        }
+
+        // Combination, without dependencies between the lanes
+        for (std::size_t i = 0; i < count; i++)
+        {
+            double d = p1[i] - p2[i];
+            values[i] = (p1[i] > p2[i] ? d : d + m1) * MRG32k3a::norm;
+        }
+
+        values += count;
+        n -= count;
+    }
+
+    m_currentState[0] = s10;
+    m_currentState[1] = s11;
+    m_currentState[2] = s12;
+    m_currentState[3] = s20;
+    m_currentState[4] = s21;
+    m_currentState[5] = s22;
+}
+
 RngStream::RngStream(uint32_t seedNumber, uint64_t stream, uint64_t substream)
 {
     if (seedNumber >= m1 || seedNumber >= m2 || seedNumber == 0)
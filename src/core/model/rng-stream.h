@@ -18,6 +18,7 @@
 
 #ifndef RNGSTREAM_H
 #define RNGSTREAM_H
+#include <cstddef>
 #include <stdint.h>
 #include <string>
 
@@ -70,6 +71,19 @@ class RngStream
      * \returns The next random.
      */
     double RandU01();
+    /**
+     * Generate the next random numbers for this stream.
+     * Uniformly distributed between 0 and 1.
+     *
+     * The numbers are the same as those returned by \pname{n}
+     * successive calls to RandU01(), but the two components of the
+     * generator are computed in blocks, keeping the state in local
+     * variables, and the combination of the components is vectorizable.
+     *
+     * \param [out] values The array to fill.
+     * \param [in] n The number of values to generate.
+     */
+    void RandU01(double* values, std::size_t n);
 
   private:
     /**
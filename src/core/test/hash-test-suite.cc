@@ -254,6 +254,85 @@ Murmur3TestCase::DoRun()
     Check("murmur3", hasher.clear().GetHash64(key));
 }
 
+/**
+ * \ingroup hash-tests
+ * Test Jenkins lookup3 hash on fixed string
+ */
+class JenkinsTestCase : public HashTestCase
+{
+  public:
+    /** Constructor. */
+    JenkinsTestCase();
+    /** Destructor. */
+    ~JenkinsTestCase() override;
+
+  private:
+    void DoRun() override;
+};
+
+JenkinsTestCase::JenkinsTestCase()
+    : HashTestCase("Jenkins: ")
+{
+}
+
+JenkinsTestCase::~JenkinsTestCase()
+{
+}
+
+void
+JenkinsTestCase::DoRun()
+{
+    Hasher hasher = Hasher(Create<Hash::Function::Jenkins>());
+    hash32Reference = 0x58f9edf4; // Jenkins(key)
+    Check("jenkins", hasher.clear().GetHash32(key));
+
+    // test vectors published with lookup3.c
+    std::string lookup3Key = "Four score and seven years ago";
+    hash32Reference = 0x17770551;
+    Check("jenkins", hasher.clear().GetHash32(lookup3Key));
+
+    hasher = Hasher(Create<Hash::Function::Jenkins>(1));
+    hash32Reference = 0xcd628161;
+    Check("jenkins", hasher.clear().GetHash32(lookup3Key));
+}
+
+/**
+ * \ingroup hash-tests
+ * Test CRC32C hash on fixed string
+ */
+class Crc32cTestCase : public HashTestCase
+{
+  public:
+    /** Constructor. */
+    Crc32cTestCase();
+    /** Destructor. */
+    ~Crc32cTestCase() override;
+
+  private:
+    void DoRun() override;
+};
+
+Crc32cTestCase::Crc32cTestCase()
+    : HashTestCase("Crc32c: ")
+{
+}
+
+Crc32cTestCase::~Crc32cTestCase()
+{
+}
+
+void
+Crc32cTestCase::DoRun()
+{
+    Hasher hasher = Hasher(Create<Hash::Function::Crc32c>());
+    hash32Reference = 0x30441f7c; // Crc32c(key)
+    Check("crc32c", hasher.clear().GetHash32(key));
+
+    // standard check value of CRC-32C
+    hash32Reference = 0xe3069283;
+    Check("crc32c", hasher.clear().GetHash32(std::string("123456789")));
+}
+
 /**
  * \ingroup hash-tests
  * Simple hash function based on the GNU sum program.
@@ -435,6 +514,7 @@ IncrementalTestCase::DoRun()
     DoHash("default", Hasher());
     DoHash("murmur3", Hasher(Create<Hash::Function::Murmur3>()));
     DoHash("FNV1a", Hasher(Create<Hash::Function::Fnv1a>()));
+    DoHash("CRC32C", Hasher(Create<Hash::Function::Crc32c>()));
 }
 
 /**
@@ -454,6 +534,8 @@ HashTestSuite::HashTestSuite()
     AddTestCase(new DefaultHashTestCase);
     AddTestCase(new Murmur3TestCase);
     AddTestCase(new Fnv1aTestCase);
+    AddTestCase(new JenkinsTestCase);
+    AddTestCase(new Crc32cTestCase);
     AddTestCase(new IncrementalTestCase);
     AddTestCase(new Hash32FunctionPtrTestCase);
     AddTestCase(new Hash64FunctionPtrTestCase);
@@ -0,0 +1,180 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/double.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/test.h"
+
+#include <string>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup core-tests
+ * \ingroup randomvariable
+ * \ingroup randomvariable-tests
+ * Test for drawing blocks of values from random variable streams.
+ */
+
+namespace ns3
+{
+
+namespace tests
+{
+
+/**
+ * \ingroup randomvariable-tests
+ * Test case for drawing blocks of values with GetValues()
+ */
+class GetValuesTestCase : public TestCase
+{
+  public:
+    /** Constructor. */
+    GetValuesTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Check that the values drawn in blocks from a random variable are the
+     * same as those drawn one by one from an identical random variable.
+     *
+     * \param [in] block The random variable drawing blocks of values.
+     * \param [in] single The random variable drawing single values.
+     * \param [in] name The name of the random variable.
+     */
+    void Check(Ptr<RandomVariableStream> block,
+               Ptr<RandomVariableStream> single,
+               std::string name);
+};
+
+GetValuesTestCase::GetValuesTestCase()
+    : TestCase("Blocks of values drawn with GetValues")
+{
+}
+
+void
+GetValuesTestCase::Check(Ptr<RandomVariableStream> block,
+                         Ptr<RandomVariableStream> single,
+                         std::string name)
+{
+    // the random variables use the same stream
+    block->SetStream(1);
+    single->SetStream(1);
+
+    // the sizes span several blocks of the RngStream
+    std::vector<double> values(1000);
+    for (std::size_t n : {0, 1, 3, 1000, 257, 256})
+    {
+        block->GetValues(values.data(), n);
+        for (std::size_t i = 0; i < n; i++)
+        {
+            double expected = single->GetValue();
+            NS_TEST_ASSERT_MSG_EQ(values[i],
+                                  expected,
+                                  name << ": wrong value " << i << " of a block of " << n);
+        }
+        // blocks and single values can be drawn alternately
+        double value = block->GetValue();
+        double expected = single->GetValue();
+        NS_TEST_ASSERT_MSG_EQ(value, expected, name << ": wrong value after a block of " << n);
+    }
+}
+
+void
+GetValuesTestCase::DoRun()
+{
+    auto uniform = [](double min, double max, bool antithetic) {
+        Ptr<UniformRandomVariable> x = CreateObject<UniformRandomVariable>();
+        x->SetAttribute("Min", DoubleValue(min));
+        x->SetAttribute("Max", DoubleValue(max));
+        x->SetAntithetic(antithetic);
+        return x;
+    };
+    Check(uniform(0, 1, false), uniform(0, 1, false), "Uniform");
+    Check(uniform(-3, 7.5, true), uniform(-3, 7.5, true), "Uniform antithetic");
+
+    auto constant = []() {
+        Ptr<ConstantRandomVariable> x = CreateObject<ConstantRandomVariable>();
+        x->SetAttribute("Constant", DoubleValue(2.5));
+        return x;
+    };
+    Check(constant(), constant(), "Constant");
+
+    auto exponential = [](double bound, bool antithetic) {
+        Ptr<ExponentialRandomVariable> x = CreateObject<ExponentialRandomVariable>();
+        x->SetAttribute("Mean", DoubleValue(3.14));
+        x->SetAttribute("Bound", DoubleValue(bound));
+        x->SetAntithetic(antithetic);
+        return x;
+    };
+    Check(exponential(0, false), exponential(0, false), "Exponential");
+    Check(exponential(0, true), exponential(0, true), "Exponential antithetic");
+    Check(exponential(4, false), exponential(4, false), "Exponential bounded");
+
+    auto pareto = [](double bound, bool antithetic) {
+        Ptr<ParetoRandomVariable> x = CreateObject<ParetoRandomVariable>();
+        x->SetAttribute("Scale", DoubleValue(1.5));
+        x->SetAttribute("Shape", DoubleValue(2));
+        x->SetAttribute("Bound", DoubleValue(bound));
+        x->SetAntithetic(antithetic);
+        return x;
+    };
+    Check(pareto(0, false), pareto(0, false), "Pareto");
+    Check(pareto(0, true), pareto(0, true), "Pareto antithetic");
+    Check(pareto(3, false), pareto(3, false), "Pareto bounded");
+
+    auto weibull = [](double bound, bool antithetic) {
+        Ptr<WeibullRandomVariable> x = CreateObject<WeibullRandomVariable>();
+        x->SetAttribute("Scale", DoubleValue(1.5));
+        x->SetAttribute("Shape", DoubleValue(0.75));
+        x->SetAttribute("Bound", DoubleValue(bound));
+        x->SetAntithetic(antithetic);
+        return x;
+    };
+    Check(weibull(0, false), weibull(0, false), "Weibull");
+    Check(weibull(0, true), weibull(0, true), "Weibull antithetic");
+    Check(weibull(2, false), weibull(2, false), "Weibull bounded");
+
+    // the other distributions use the base implementation
+    Check(CreateObject<NormalRandomVariable>(), CreateObject<NormalRandomVariable>(), "Normal");
+}
+
+/**
+ * \ingroup randomvariable-tests
+ * Test suite for drawing blocks of values from random variable streams
+ */
+class RandomVariableStreamGetValuesTestSuite : public TestSuite
+{
+  public:
+    /** Constructor. */
+    RandomVariableStreamGetValuesTestSuite();
+};
+
+RandomVariableStreamGetValuesTestSuite::RandomVariableStreamGetValuesTestSuite()
+    : TestSuite("random-variable-stream-get-values", UNIT)
+{
+    AddTestCase(new GetValuesTestCase);
+}
+
+/**
+ * \ingroup randomvariable-tests
+ * RandomVariableStreamGetValuesTestSuite instance variable.
+ */
+static RandomVariableStreamGetValuesTestSuite g_randomVariableStreamGetValuesTestSuite;
+
+} // namespace tests
+
+} // namespace ns3
@@ -18,12 +18,17 @@
  */
 #include "ns3/calendar-scheduler.h"
 #include "ns3/heap-scheduler.h"
+#include "ns3/ladder-scheduler.h"
 #include "ns3/list-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/priority-queue-scheduler.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
 
+#include <array>
+#include <unordered_map>
+#include <vector>
+
 using namespace ns3;
 
 /**
@@ -707,6 +712,201 @@ SimulatorTemplateTestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check that a scheduler returns the events in the same order as the
+ * MapScheduler, under a mix of insertions (including bursts of events with
+ * the same timestamp and events far in the future), removals of the next
+ * event and removals of arbitrary events.
+ */
+class SchedulerOrderTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     * \param schedulerFactory Scheduler factory.
+     */
+    SchedulerOrderTestCase(ObjectFactory schedulerFactory);
+    void DoRun() override;
+
+  private:
+    /**
+     * Get a pseudo-random number.
+     * \return A pseudo-random number.
+     */
+    uint32_t Rand();
+
+    ObjectFactory m_schedulerFactory; //!< Scheduler factory.
+    uint64_t m_seed;                  //!< State of the pseudo-random number generator.
+};
+
+SchedulerOrderTestCase::SchedulerOrderTestCase(ObjectFactory schedulerFactory)
+    : TestCase("Check the order of the events returned by " +
+               schedulerFactory.GetTypeId().GetName()),
+      m_schedulerFactory(schedulerFactory),
+      m_seed(1)
+{
+}
+
+uint32_t
+SchedulerOrderTestCase::Rand()
+{
+    m_seed = m_seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    return static_cast<uint32_t>(m_seed >> 33);
+}
+
+void
+SchedulerOrderTestCase::DoRun()
+{
+    Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler>();
+    Ptr<Scheduler> reference = CreateObject<MapScheduler>();
+
+    std::vector<Scheduler::Event> pending;
+    std::unordered_map<uint32_t, std::size_t> index; // position of each event in pending
+    uint32_t uid = 0;
+    uint64_t now = 0;
+
+    auto insert = [&](uint64_t ts) {
+        Scheduler::Event ev = {nullptr, {ts, uid++, 0}};
+        scheduler->Insert(ev);
+        reference->Insert(ev);
+        index[ev.key.m_uid] = pending.size();
+        pending.push_back(ev);
+    };
+    auto forget = [&](const Scheduler::Event& ev) {
+        std::size_t i = index[ev.key.m_uid];
+        index[pending.back().key.m_uid] = i;
+        pending[i] = pending.back();
+        pending.pop_back();
+        index.erase(ev.key.m_uid);
+    };
+
+    for (uint32_t i = 0; i < 2000; i++)
+    {
+        insert(Rand() % 1000000);
+    }
+
+    for (uint32_t op = 0; op < 50000; op++)
+    {
+        uint32_t r = Rand() % 100;
+        if (r < 45)
+        {
+            // short delay, possibly zero
+            insert(now + Rand() % 1000);
+        }
+        else if (r < 47)
+        {
+            // burst of events with the same timestamp
+            uint64_t ts = now + Rand() % 100000;
+            for (uint32_t i = 0; i < 100; i++)
+            {
+                insert(ts);
+            }
+        }
+        else if (r < 50)
+        {
+            // far in the future
+            insert(now + 1000000 + Rand() % 100000000);
+        }
+        else if (r < 55 && !pending.empty())
+        {
+            Scheduler::Event ev = pending[Rand() % pending.size()];
+            scheduler->Remove(ev);
+            reference->Remove(ev);
+            forget(ev);
+        }
+        else if (!reference->IsEmpty())
+        {
+            NS_TEST_ASSERT_MSG_EQ(scheduler->IsEmpty(), false, "The scheduler should not be empty");
+            NS_TEST_ASSERT_MSG_EQ(scheduler->PeekNext().key.m_uid,
+                                  reference->PeekNext().key.m_uid,
+                                  "Unexpected next event");
+            Scheduler::Event ev = scheduler->RemoveNext();
+            NS_TEST_ASSERT_MSG_EQ(ev.key.m_uid,
+                                  reference->RemoveNext().key.m_uid,
+                                  "Unexpected removed event");
+            now = ev.key.m_ts;
+            forget(ev);
+        }
+    }
+
+    while (!reference->IsEmpty())
+    {
+        NS_TEST_ASSERT_MSG_EQ(scheduler->RemoveNext().key.m_uid,
+                              reference->RemoveNext().key.m_uid,
+                              "Unexpected removed event");
+    }
+    NS_TEST_ASSERT_MSG_EQ(scheduler->IsEmpty(), true, "The scheduler should be empty");
+}
+
+/**
+ * \ingroup simulator-tests
+ *
+ * \brief Check that the memory of the events is reused.
+ */
+class EventPoolTestCase : public TestCase
+{
+  public:
+    EventPoolTestCase();
+    void DoRun() override;
+
+  private:
+    /**
+     * Test Event.
+     * \param value Event parameter.
+     */
+    void Event(uint64_t value);
+
+    uint64_t m_sum; //!< Sum of the parameters of the invoked events.
+};
+
+EventPoolTestCase::EventPoolTestCase()
+    : TestCase("Check that the memory of the events is reused"),
+      m_sum(0)
+{
+}
+
+void
+EventPoolTestCase::Event(uint64_t value)
+{
+    m_sum += value;
+}
+
+void
+EventPoolTestCase::DoRun()
+{
+    EventImpl* ev = MakeEvent(&EventPoolTestCase::Event, this, 1);
+    const void* address = ev;
+    ev->Invoke();
+    ev->Unref();
+
+    // an event of the same size class is allocated in the memory just released
+    ev = MakeEvent(&EventPoolTestCase::Event, this, 2);
+    NS_TEST_ASSERT_MSG_EQ(static_cast<const void*>(ev), address, "The memory was not reused");
+    ev->Invoke();
+    ev->Unref();
+
+    // events larger than the largest size class are allocated on the heap
+    std::array<uint8_t, EventImpl::POOL_MAX_SIZE> large{};
+    large[0] = 4;
+    ev = MakeEvent([this, large]() { Event(large[0]); });
+    ev->Invoke();
+    ev->Unref();
+
+    // events can be released after disabling the pools
+    ev = MakeEvent(&EventPoolTestCase::Event, this, 8);
+    EventImpl::SetPoolEnabled(false);
+    ev->Invoke();
+    ev->Unref();
+    ev = MakeEvent(&EventPoolTestCase::Event, this, 16);
+    EventImpl::SetPoolEnabled(true);
+    ev->Invoke();
+    ev->Unref();
+
+    NS_TEST_ASSERT_MSG_EQ(m_sum, 31, "Unexpected invoked events");
+}
+
 /**
  * \ingroup simulator-tests
  *
@@ -730,6 +930,10 @@ class SimulatorTestSuite : public TestSuite
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
         factory.SetTypeId(PriorityQueueScheduler::GetTypeId());
         AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
+        factory.SetTypeId(LadderScheduler::GetTypeId());
+        AddTestCase(new SimulatorEventsTestCase(factory), TestCase::QUICK);
+        AddTestCase(new SchedulerOrderTestCase(factory), TestCase::QUICK);
+        AddTestCase(new EventPoolTestCase(), TestCase::QUICK);
     }
 };
 
@@ -30,6 +30,7 @@
 #include <list>
 #include <thread> // sleep_for
 #include <utility>
+#include <vector>
 
 using namespace ns3;
 
@@ -278,6 +279,144 @@ ThreadedSimulatorEventsTestCase::DoRun()
     NS_TEST_EXPECT_MSG_EQ(m_a, m_d, "Bad scheduling");
 }
 
+/**
+ * \ingroup threaded-tests
+ *
+ * \brief Check that the events scheduled by many threads at once are all
+ * executed, in the order each thread scheduled them.
+ *
+ * The producer threads schedule many more events than fit in the ring buffer
+ * of the DefaultSimulatorImpl, so that its overflow path is exercised, too.
+ */
+class ThreadedSimulatorProducersTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \param schedulerFactory The scheduler factory.
+     * \param threads The number of producer threads.
+     * \param events The number of events scheduled by each thread.
+     */
+    ThreadedSimulatorProducersTestCase(ObjectFactory schedulerFactory,
+                                       unsigned int threads,
+                                       unsigned int events);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Schedule the events of a producer thread.
+     * \param threadno The thread number, used as the event context.
+     */
+    void Produce(unsigned int threadno);
+    /**
+     * Event scheduled by the producer threads.
+     * \param threadno The thread number.
+     * \param seq The sequence number of the event within the thread.
+     */
+    void Consume(unsigned int threadno, unsigned int seq);
+    /** Keep the simulation alive until all the events have been executed. */
+    void Poll();
+
+    ObjectFactory m_schedulerFactory;   //!< Scheduler factory.
+    unsigned int m_threads;             //!< The number of producer threads.
+    unsigned int m_events;              //!< The number of events per thread.
+    std::vector<unsigned int> m_next;   //!< Next expected sequence number per thread.
+    uint64_t m_consumed;                //!< The number of events executed.
+    uint64_t m_lastTs;                  //!< Timestamp of the last event executed.
+    std::string m_error;                //!< Error condition.
+};
+
+ThreadedSimulatorProducersTestCase::ThreadedSimulatorProducersTestCase(
+    ObjectFactory schedulerFactory,
+    unsigned int threads,
+    unsigned int events)
+    : TestCase("Check " + std::to_string(threads) + " threads scheduling " +
+               std::to_string(events) + " events each, " +
+               schedulerFactory.GetTypeId().GetName() + " scheduler"),
+      m_schedulerFactory(schedulerFactory),
+      m_threads(threads),
+      m_events(events),
+      m_consumed(0),
+      m_lastTs(0)
+{
+}
+
+void
+ThreadedSimulatorProducersTestCase::Produce(unsigned int threadno)
+{
+    for (unsigned int seq = 0; seq < m_events; seq++)
+    {
+        Simulator::ScheduleWithContext(threadno,
+                                       MicroSeconds(1),
+                                       &ThreadedSimulatorProducersTestCase::Consume,
+                                       this,
+                                       threadno,
+                                       seq);
+    }
+}
+
+void
+ThreadedSimulatorProducersTestCase::Consume(unsigned int threadno, unsigned int seq)
+{
+    if (Simulator::GetContext() != threadno)
+    {
+        m_error = "Bad context";
+    }
+    if (seq != m_next[threadno])
+    {
+        m_error = "Events of thread " + std::to_string(threadno) + " reordered";
+    }
+    uint64_t ts = Simulator::Now().GetTimeStep();
+    if (ts < m_lastTs)
+    {
+        m_error = "Events executed out of time order";
+    }
+    m_lastTs = ts;
+    m_next[threadno] = seq + 1;
+    m_consumed++;
+}
+
+void
+ThreadedSimulatorProducersTestCase::Poll()
+{
+    if (m_consumed < static_cast<uint64_t>(m_threads) * m_events)
+    {
+        Simulator::Schedule(MicroSeconds(1), &ThreadedSimulatorProducersTestCase::Poll, this);
+    }
+}
+
+void
+ThreadedSimulatorProducersTestCase::DoRun()
+{
+    Simulator::SetScheduler(m_schedulerFactory);
+    m_next.assign(m_threads, 0);
+    m_consumed = 0;
+    m_lastTs = 0;
+    m_error = "";
+
+    Simulator::Schedule(MicroSeconds(1), &ThreadedSimulatorProducersTestCase::Poll, this);
+
+    std::vector<std::thread> producers;
+    for (unsigned int i = 0; i < m_threads; ++i)
+    {
+        producers.emplace_back(&ThreadedSimulatorProducersTestCase::Produce, this, i);
+    }
+
+    Simulator::Run();
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+    Simulator::Destroy();
+
+    NS_TEST_EXPECT_MSG_EQ(m_error.empty(), true, m_error);
+    NS_TEST_EXPECT_MSG_EQ(m_consumed,
+                          static_cast<uint64_t>(m_threads) * m_events,
+                          "Some events were not executed");
+}
+
 /**
  * \ingroup threaded-tests
  *
@@ -298,6 +437,7 @@ class ThreadedSimulatorTestSuite : public TestSuite
             "ns3::HeapScheduler",
             "ns3::MapScheduler",
             "ns3::CalendarScheduler",
+            "ns3::LadderScheduler",
         };
         unsigned int threadCounts[] = {0, 2, 10, 20};
         ObjectFactory factory;
@@ -315,6 +455,19 @@ class ThreadedSimulatorTestSuite : public TestSuite
                 }
             }
         }
+        // the producers may flood the scheduler with events sharing the same
+        // timestamp, which the List and Calendar schedulers insert in linear time
+        std::string producersSchedulerTypes[] = {
+            "ns3::HeapScheduler",
+            "ns3::MapScheduler",
+            "ns3::LadderScheduler",
+        };
+        for (auto& schedulerType : producersSchedulerTypes)
+        {
+            factory.SetTypeId(schedulerType);
+            AddTestCase(new ThreadedSimulatorProducersTestCase(factory, 8, 10000),
+                        TestCase::QUICK);
+        }
     }
 };
 
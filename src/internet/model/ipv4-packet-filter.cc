@@ -23,14 +23,13 @@
 #include "ipv4-packet-filter.h"
 
 #include "ipv4-queue-disc-item.h"
-#include "tcp-header.h"
-#include "udp-header.h"
 
 #include "ns3/enum.h"
 #include "ns3/log.h"
 #include "ns3/packet.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
 #include <typeinfo>
 
 namespace ns3
@@ -65,20 +64,56 @@ Ipv4PacketFilter::CheckProtocol(Ptr<QueueDiscItem> item) const
     return bool(DynamicCast<Ipv4QueueDiscItem>(item));
 }
 
+Ptr<Hash::Implementation>
+CreateDRRFlowHashFunction(DRRFlowHashFunction function)
+{
+    switch (function)
+    {
+    case DRR_HASH_JHASH:
+        return Create<Hash::Function::Jenkins>();
+    case DRR_HASH_CRC32C:
+        return Create<Hash::Function::Crc32c>();
+    case DRR_HASH_MURMUR3:
+    default:
+        return Create<Hash::Function::Murmur3>();
+    }
+}
+
 // ------------------------------------------------------------------------- //
 NS_OBJECT_ENSURE_REGISTERED(DRRIpv4PacketFilter);
 
 TypeId
 DRRIpv4PacketFilter::GetTypeId()
 {
-    static TypeId tid = TypeId("ns3::DRRIpv4PacketFilter")
-                            .SetParent<Ipv4PacketFilter>()
-                            .SetGroupName("Internet")
-                            .AddConstructor<DRRIpv4PacketFilter>();
+    static TypeId tid =
+        TypeId("ns3::DRRIpv4PacketFilter")
+            .SetParent<Ipv4PacketFilter>()
+            .SetGroupName("Internet")
+            .AddConstructor<DRRIpv4PacketFilter>()
+            .AddAttribute("HashFunction",
+                          "The function used to compute the flow hash",
+                          EnumValue(DRR_HASH_MURMUR3),
+                          MakeEnumAccessor(&DRRIpv4PacketFilter::SetHashFunction,
+                                           &DRRIpv4PacketFilter::GetHashFunction),
+                          MakeEnumChecker(DRR_HASH_MURMUR3,
+                                          "Murmur3",
+                                          DRR_HASH_JHASH,
+                                          "Jhash",
+                                          DRR_HASH_CRC32C,
+                                          "Crc32c"))
+            .AddAttribute("Perturbation",
+                          "The salt used as an additional input to the hash function (0 "
+                          "means no salt)",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&DRRIpv4PacketFilter::m_perturbation),
+                          MakeUintegerChecker<uint32_t>());
     return tid;
 }
 
 DRRIpv4PacketFilter::DRRIpv4PacketFilter()
+    : m_hashFunction(DRR_HASH_MURMUR3),
+      m_hasher(CreateDRRFlowHashFunction(DRR_HASH_MURMUR3)),
+      m_perturbation(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -88,10 +123,32 @@ DRRIpv4PacketFilter::~DRRIpv4PacketFilter()
     NS_LOG_FUNCTION(this);
 }
 
+void
+DRRIpv4PacketFilter::SetHashFunction(DRRFlowHashFunction function)
+{
+    NS_LOG_FUNCTION(this << function);
+    m_hashFunction = function;
+    m_hasher = CreateDRRFlowHashFunction(function);
+}
+
+DRRFlowHashFunction
+DRRIpv4PacketFilter::GetHashFunction() const
+{
+    return m_hashFunction;
+}
+
 int32_t
 DRRIpv4PacketFilter::DoClassify(Ptr<QueueDiscItem> item) const
 {
     NS_LOG_FUNCTION(this << item);
+
+    uint32_t hash;
+    if (item->GetFlowHash(hash, m_hashFunction, m_perturbation))
+    {
+        NS_LOG_DEBUG("Cached hash value " << hash);
+        return hash;
+    }
+
     Ptr<Ipv4QueueDiscItem> ipv4Item = DynamicCast<Ipv4QueueDiscItem>(item);
 
     if (!ipv4Item)
@@ -100,50 +157,52 @@ DRRIpv4PacketFilter::DoClassify(Ptr<QueueDiscItem> item) const
         return PacketFilter::PF_NO_MATCH;
     }
 
-    Ipv4Header hdr = ipv4Item->GetHeader();
-    Ipv4Address src = hdr.GetSource();
-    Ipv4Address dest = hdr.GetDestination();
+    const Ipv4Header& hdr = ipv4Item->GetHeader();
     uint8_t prot = hdr.GetProtocol();
-    uint16_t fragOffset = hdr.GetFragmentOffset();
 
-    TcpHeader tcpHdr;
-    UdpHeader udpHdr;
-    uint16_t srcPort = 0;
-    uint16_t destPort = 0;
+    /* serialize the 5-tuple and the perturbation (if any) in buf */
+    uint8_t buf[17];
+    hdr.GetSource().Serialize(buf);
+    hdr.GetDestination().Serialize(buf + 4);
+    buf[8] = prot;
 
-    if (prot == 6 && fragOffset == 0) // TCP
+    if ((prot == 6 || prot == 17) && hdr.GetFragmentOffset() == 0) // TCP or UDP
     {
-        ipv4Item->GetPacket()->PeekHeader(tcpHdr);
-        srcPort = tcpHdr.GetSourcePort();
-        destPort = tcpHdr.GetDestinationPort();
+        // both the TCP and the UDP headers start with the source and destination
+        // ports, hence copy them from the packet buffer into buf rather than
+        // deserializing the whole transport header
+        if (ipv4Item->GetPacket()->CopyData(buf + 9, 4) < 4)
+        {
+            std::fill(buf + 9, buf + 13, 0);
+        }
     }
-    else if (prot == 17 && fragOffset == 0) // UDP
+    else
     {
-        ipv4Item->GetPacket()->PeekHeader(udpHdr);
-        srcPort = udpHdr.GetSourcePort();
-        destPort = udpHdr.GetDestinationPort();
+        if (prot != 6 && prot != 17)
+        {
+            NS_LOG_WARN("Unknown transport protocol, no port number included in hash computation");
+        }
+        std::fill(buf + 9, buf + 13, 0);
     }
-    if (prot != 6 && prot != 17)
+
+    // the perturbation is not hashed when null, so that the default hash values
+    // are the same as the ones computed by Hash32() on the bare 5-tuple
+    uint32_t size = 13;
+    if (m_perturbation != 0)
     {
-        NS_LOG_WARN("Unknown transport protocol, no port number included in hash computation");
+        buf[13] = (m_perturbation >> 24) & 0xff;
+        buf[14] = (m_perturbation >> 16) & 0xff;
+        buf[15] = (m_perturbation >> 8) & 0xff;
+        buf[16] = m_perturbation & 0xff;
+        size += 4;
     }
 
-    /* serialize the 5-tuple and the perturbation in buf */
-    uint8_t buf[13];
-    src.Serialize(buf);
-    dest.Serialize(buf + 4);
-    buf[8] = prot;
-    buf[9] = (srcPort >> 8) & 0xff;
-    buf[10] = srcPort & 0xff;
-    buf[11] = (destPort >> 8) & 0xff;
-    buf[12] = destPort & 0xff;
-
-    // Linux calculates jhash2 (jenkins hash), we calculate murmur3 because it is
-    // already available in ns-3
-    uint32_t hash = Hash32((char*)buf, 13);
+    m_hasher->clear();
+    hash = m_hasher->GetHash32((char*)buf, size);
 
     NS_LOG_DEBUG("Hash value " << hash);
 
+    item->SetFlowHash(hash, m_hashFunction, m_perturbation);
     return hash;
 }
 
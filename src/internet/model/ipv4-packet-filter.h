@@ -23,12 +23,35 @@
 #ifndef IPV4_PACKET_FILTER_H
 #define IPV4_PACKET_FILTER_H
 
+#include "ns3/hash.h"
 #include "ns3/object.h"
 #include "ns3/packet-filter.h"
 
 namespace ns3
 {
 
+/**
+ * \ingroup internet
+ *
+ * Hash functions the DRR packet filters can use to compute the flow hash
+ */
+enum DRRFlowHashFunction
+{
+    DRR_HASH_MURMUR3, //!< murmur3, the default ns-3 hash function
+    DRR_HASH_JHASH,   //!< Jenkins lookup3, i.e., the jhash() function of Linux
+    DRR_HASH_CRC32C   //!< CRC32C, a cheap hash for short keys such as the 5-tuple
+};
+
+/**
+ * \ingroup internet
+ *
+ * Create an instance of the given hash function
+ *
+ * \param function the hash function
+ * \return the hash function implementation
+ */
+Ptr<Hash::Implementation> CreateDRRFlowHashFunction(DRRFlowHashFunction function);
+
 /**
  * \ingroup ipv4
  * \ingroup traffic-control
@@ -70,8 +93,26 @@ class DRRIpv4PacketFilter : public Ipv4PacketFilter
     DRRIpv4PacketFilter();
     ~DRRIpv4PacketFilter() override;
 
+    /**
+     * \brief Set the function used to compute the flow hash
+     *
+     * \param function the hash function
+     */
+    void SetHashFunction(DRRFlowHashFunction function);
+
+    /**
+     * \brief Get the function used to compute the flow hash
+     *
+     * \returns the hash function
+     */
+    DRRFlowHashFunction GetHashFunction() const;
+
   private:
     int32_t DoClassify(Ptr<QueueDiscItem> item) const override;
+
+    DRRFlowHashFunction m_hashFunction; //!< The hash function in use
+    Ptr<Hash::Implementation> m_hasher; //!< The hash function implementation
+    uint32_t m_perturbation;            //!< Hash perturbation value
 };
 
 } // namespace ns3
@@ -23,13 +23,14 @@
 #include "ipv6-packet-filter.h"
 
 #include "ipv6-queue-disc-item.h"
-#include "tcp-header.h"
-#include "udp-header.h"
 
 #include "ns3/enum.h"
 #include "ns3/log.h"
+#include "ns3/packet.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -68,14 +69,35 @@ NS_OBJECT_ENSURE_REGISTERED(DRRIpv6PacketFilter);
 TypeId
 DRRIpv6PacketFilter::GetTypeId()
 {
-    static TypeId tid = TypeId("ns3::DRRIpv6PacketFilter")
-                            .SetParent<Ipv6PacketFilter>()
-                            .SetGroupName("Internet")
-                            .AddConstructor<DRRIpv6PacketFilter>();
+    static TypeId tid =
+        TypeId("ns3::DRRIpv6PacketFilter")
+            .SetParent<Ipv6PacketFilter>()
+            .SetGroupName("Internet")
+            .AddConstructor<DRRIpv6PacketFilter>()
+            .AddAttribute("HashFunction",
+                          "The function used to compute the flow hash",
+                          EnumValue(DRR_HASH_MURMUR3),
+                          MakeEnumAccessor(&DRRIpv6PacketFilter::SetHashFunction,
+                                           &DRRIpv6PacketFilter::GetHashFunction),
+                          MakeEnumChecker(DRR_HASH_MURMUR3,
+                                          "Murmur3",
+                                          DRR_HASH_JHASH,
+                                          "Jhash",
+                                          DRR_HASH_CRC32C,
+                                          "Crc32c"))
+            .AddAttribute("Perturbation",
+                          "The salt used as an additional input to the hash function (0 "
+                          "means no salt)",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&DRRIpv6PacketFilter::m_perturbation),
+                          MakeUintegerChecker<uint32_t>());
     return tid;
 }
 
 DRRIpv6PacketFilter::DRRIpv6PacketFilter()
+    : m_hashFunction(DRR_HASH_MURMUR3),
+      m_hasher(CreateDRRFlowHashFunction(DRR_HASH_MURMUR3)),
+      m_perturbation(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -85,10 +107,32 @@ DRRIpv6PacketFilter::~DRRIpv6PacketFilter()
     NS_LOG_FUNCTION(this);
 }
 
+void
+DRRIpv6PacketFilter::SetHashFunction(DRRFlowHashFunction function)
+{
+    NS_LOG_FUNCTION(this << function);
+    m_hashFunction = function;
+    m_hasher = CreateDRRFlowHashFunction(function);
+}
+
+DRRFlowHashFunction
+DRRIpv6PacketFilter::GetHashFunction() const
+{
+    return m_hashFunction;
+}
+
 int32_t
 DRRIpv6PacketFilter::DoClassify(Ptr<QueueDiscItem> item) const
 {
     NS_LOG_FUNCTION(this << item);
+
+    uint32_t hash;
+    if (item->GetFlowHash(hash, m_hashFunction, m_perturbation))
+    {
+        NS_LOG_DEBUG("Cached hash value " << hash);
+        return hash;
+    }
+
     Ptr<Ipv6QueueDiscItem> ipv6Item = DynamicCast<Ipv6QueueDiscItem>(item);
 
     if (!ipv6Item)
@@ -96,46 +140,50 @@ DRRIpv6PacketFilter::DoClassify(Ptr<QueueDiscItem> item) const
         NS_LOG_DEBUG("No match");
         return PacketFilter::PF_NO_MATCH;
     }
-    Ipv6Header m_header = ipv6Item->GetHeader();
-    Ipv6Address src = m_header.GetSource();
-    Ipv6Address dest = m_header.GetDestination();
-    uint8_t prot = m_header.GetNextHeader();
+    const Ipv6Header& hdr = ipv6Item->GetHeader();
+    uint8_t prot = hdr.GetNextHeader();
 
-    TcpHeader tcpHdr;
-    UdpHeader udpHdr;
-    uint16_t srcPort = 0;
-    uint16_t destPort = 0;
+    /* serialize the 5-tuple and the perturbation (if any) in buf */
+    uint8_t buf[41];
+    hdr.GetSource().Serialize(buf);
+    hdr.GetDestination().Serialize(buf + 16);
+    buf[32] = prot;
 
-    if (prot == 6) // TCP
+    if (prot == 6 || prot == 17) // TCP or UDP
     {
-        ipv6Item->GetPacket()->PeekHeader(tcpHdr);
-        srcPort = tcpHdr.GetSourcePort();
-        destPort = tcpHdr.GetDestinationPort();
+        // both the TCP and the UDP headers start with the source and destination
+        // ports, hence copy them from the packet buffer into buf rather than
+        // deserializing the whole transport header
+        if (ipv6Item->GetPacket()->CopyData(buf + 33, 4) < 4)
+        {
+            std::fill(buf + 33, buf + 37, 0);
+        }
     }
-    else if (prot == 17) // UDP
+    else
     {
-        ipv6Item->GetPacket()->PeekHeader(udpHdr);
-        srcPort = udpHdr.GetSourcePort();
-        destPort = udpHdr.GetDestinationPort();
+        NS_LOG_WARN("Unknown transport protocol, no port number included in hash computation");
+        std::fill(buf + 33, buf + 37, 0);
     }
-    if (prot != 6 && prot != 17)
+
+    // the perturbation is not hashed when null, so that the default hash values
+    // are the same as the ones computed by Hash32() on the bare 5-tuple
+    uint32_t size = 37;
+    if (m_perturbation != 0)
     {
-        NS_LOG_WARN("Unknown transport protocol, no port number included in hash computation");
+        buf[37] = (m_perturbation >> 24) & 0xff;
+        buf[38] = (m_perturbation >> 16) & 0xff;
+        buf[39] = (m_perturbation >> 8) & 0xff;
+        buf[40] = m_perturbation & 0xff;
+        size += 4;
     }
 
-    /* serialize the 5-tuple and the perturbation in buf */
-    uint8_t buf[37];
-    src.Serialize(buf);
-    dest.Serialize(buf + 16);
-    buf[32] = prot;
-    buf[33] = (srcPort >> 8) & 0xff;
-    buf[34] = srcPort & 0xff;
-    buf[35] = (destPort >> 8) & 0xff;
-    buf[36] = destPort & 0xff;
-    uint32_t hash = Hash32((char*)buf, 37);
+    m_hasher->clear();
+    hash = m_hasher->GetHash32((char*)buf, size);
 
     NS_LOG_DEBUG("Found Ipv6 packet; hash of the five tuple " << hash);
 
+    item->SetFlowHash(hash, m_hashFunction, m_perturbation);
     return hash;
 }
+
 } // namespace ns3
@@ -23,6 +23,8 @@
 #ifndef IPV6_PACKET_FILTER_H
 #define IPV6_PACKET_FILTER_H
 
+#include "ipv4-packet-filter.h"
+
 #include "ns3/object.h"
 #include "ns3/packet-filter.h"
 
@@ -64,8 +66,26 @@ class DRRIpv6PacketFilter : public Ipv6PacketFilter
     DRRIpv6PacketFilter();
     ~DRRIpv6PacketFilter() override;
 
+    /**
+     * \brief Set the function used to compute the flow hash
+     *
+     * \param function the hash function
+     */
+    void SetHashFunction(DRRFlowHashFunction function);
+
+    /**
+     * \brief Get the function used to compute the flow hash
+     *
+     * \returns the hash function
+     */
+    DRRFlowHashFunction GetHashFunction() const;
+
   private:
     int32_t DoClassify(Ptr<QueueDiscItem> item) const override;
+
+    DRRFlowHashFunction m_hashFunction; //!< The hash function in use
+    Ptr<Hash::Implementation> m_hasher; //!< The hash function implementation
+    uint32_t m_perturbation;            //!< Hash perturbation value
 };
 
 } // namespace ns3
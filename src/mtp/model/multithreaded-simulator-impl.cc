@@ -0,0 +1,812 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-impl.h"
+
+#include "ns3/assert.h"
+#include "ns3/boolean.h"
+#include "ns3/channel-list.h"
+#include "ns3/channel.h"
+#include "ns3/event-impl.h"
+#include "ns3/log.h"
+#include "ns3/net-device.h"
+#include "ns3/node-list.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <set>
+#include <thread>
+
+/**
+ * \file
+ * \ingroup mtp
+ * ns3::MultithreadedSimulatorImpl implementation.
+ */
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED(MultithreadedSimulatorImpl);
+
+thread_local MultithreadedSimulatorImpl::Partition* MultithreadedSimulatorImpl::t_current =
+    nullptr;
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::MultithreadedSimulatorImpl")
+            .SetParent<SimulatorImpl>()
+            .SetGroupName("Mtp")
+            .AddConstructor<MultithreadedSimulatorImpl>()
+            .AddAttribute("MaxThreads",
+                          "The maximum number of partitions (hence of threads) when the "
+                          "nodes are partitioned automatically, 0 for one per hardware thread",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&MultithreadedSimulatorImpl::m_maxThreads),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("ForcePartitions",
+                          "Run the partitions on their own threads even if ns-3 is not "
+                          "configured with NS3_MTP, which is only safe if the events exchanged "
+                          "by the partitions do not share any reference counted object "
+                          "(e.g., packets)",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&MultithreadedSimulatorImpl::m_forcePartitions),
+                          MakeBooleanChecker());
+    return tid;
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl()
+    : m_lookahead(Time::Max()),
+      m_maxThreads(0),
+      m_forcePartitions(false),
+      m_windowEndTs(0),
+      m_finished(false),
+      m_stop(false)
+{
+    NS_LOG_FUNCTION(this);
+    m_global.uid = EventId::UID::VALID;
+    m_global.currentUid = EventId::UID::INVALID;
+    m_global.currentTs = 0;
+    m_global.currentContext = Simulator::NO_CONTEXT;
+    m_global.eventCount = 0;
+    m_global.unscheduledEvents = 0;
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+
+    for (auto& partition : m_partitions)
+    {
+        while (!partition.events->IsEmpty())
+        {
+            Scheduler::Event next = partition.events->RemoveNext();
+            next.impl->Unref();
+        }
+    }
+    m_partitions.clear();
+    while (!m_global.events->IsEmpty())
+    {
+        Scheduler::Event next = m_global.events->RemoveNext();
+        next.impl->Unref();
+    }
+    m_global.events = nullptr;
+    SimulatorImpl::DoDispose();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy()
+{
+    NS_LOG_FUNCTION(this);
+    while (!m_destroyEvents.empty())
+    {
+        Ptr<EventImpl> ev = m_destroyEvents.front().PeekEventImpl();
+        m_destroyEvents.pop_front();
+        NS_LOG_LOGIC("handle destroy " << ev);
+        if (!ev->IsCancelled())
+        {
+            ev->Invoke();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler(ObjectFactory schedulerFactory)
+{
+    NS_LOG_FUNCTION(this << schedulerFactory);
+    NS_ASSERT_MSG(t_current == nullptr, "Simulator::SetScheduler called while running");
+
+    m_schedulerFactory = schedulerFactory;
+    auto replace = [&schedulerFactory](Partition& partition) {
+        Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler>();
+        if (partition.events)
+        {
+            while (!partition.events->IsEmpty())
+            {
+                scheduler->Insert(partition.events->RemoveNext());
+            }
+        }
+        partition.events = scheduler;
+    };
+
+    replace(m_global);
+    for (auto& partition : m_partitions)
+    {
+        replace(partition);
+    }
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId() const
+{
+    // all the partitions belong to this process
+    return 0;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartitionCount() const
+{
+    return m_partitions.size();
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartition(uint32_t nodeId) const
+{
+    return nodeId < m_nodePartitions.size() ? m_nodePartitions[nodeId] : m_partitions.size();
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookahead() const
+{
+    return m_lookahead;
+}
+
+MultithreadedSimulatorImpl::Partition&
+MultithreadedSimulatorImpl::GetCurrent() const
+{
+    return t_current != nullptr ? *t_current : m_global;
+}
+
+MultithreadedSimulatorImpl::Partition&
+MultithreadedSimulatorImpl::GetPartitionOf(uint32_t context) const
+{
+    if (context < m_nodePartitions.size())
+    {
+        return m_partitions[m_nodePartitions[context]];
+    }
+    return m_global;
+}
+
+Scheduler::EventKey
+MultithreadedSimulatorImpl::Insert(Partition& partition,
+                                   uint64_t ts,
+                                   uint32_t context,
+                                   EventImpl* event)
+{
+    Scheduler::Event ev;
+    ev.impl = event;
+    ev.key.m_ts = ts;
+    ev.key.m_context = context;
+    ev.key.m_uid = partition.uid;
+    partition.uid++;
+    partition.unscheduledEvents++;
+    partition.events->Insert(ev);
+    return ev.key;
+}
+
+bool
+MultithreadedSimulatorImpl::IsCuttable(Ptr<Channel> channel, Time& delay)
+{
+    for (std::size_t i = 0; i < channel->GetNDevices(); i++)
+    {
+        if (!channel->GetDevice(i)->IsPointToPoint())
+        {
+            return false;
+        }
+    }
+    TimeValue value;
+    if (!channel->GetAttributeFailSafe("Delay", value))
+    {
+        return false;
+    }
+    delay = value.Get();
+    return delay.IsStrictlyPositive();
+}
+
+void
+MultithreadedSimulatorImpl::PartitionNodes()
+{
+    NS_LOG_FUNCTION(this);
+
+    uint32_t nNodes = NodeList::GetNNodes();
+    uint32_t nPartitions = 1;
+    m_nodePartitions.assign(nNodes, 0);
+
+    bool bySystemId = false;
+    for (auto it = NodeList::Begin(); it != NodeList::End(); ++it)
+    {
+        bySystemId |= ((*it)->GetSystemId() != 0);
+    }
+
+    if (bySystemId)
+    {
+        std::map<uint32_t, uint32_t> systemIds;
+        for (auto it = NodeList::Begin(); it != NodeList::End(); ++it)
+        {
+            systemIds[(*it)->GetSystemId()] = 0;
+        }
+        nPartitions = 0;
+        for (auto& [systemId, partition] : systemIds)
+        {
+            partition = nPartitions++;
+        }
+        for (auto it = NodeList::Begin(); it != NodeList::End(); ++it)
+        {
+            m_nodePartitions[(*it)->GetId()] = systemIds[(*it)->GetSystemId()];
+        }
+    }
+    else if (nNodes > 0)
+    {
+        // group the nodes connected by channels which cannot be cut; the
+        // representative of each group is its node with the smallest id
+        std::vector<uint32_t> parent(nNodes);
+        std::iota(parent.begin(), parent.end(), 0);
+        auto find = [&parent](uint32_t i) {
+            while (parent[i] != i)
+            {
+                parent[i] = parent[parent[i]];
+                i = parent[i];
+            }
+            return i;
+        };
+
+        for (auto it = ChannelList::Begin(); it != ChannelList::End(); ++it)
+        {
+            Time delay;
+            if (IsCuttable(*it, delay))
+            {
+                continue;
+            }
+            uint32_t root = nNodes;
+            for (std::size_t i = 0; i < (*it)->GetNDevices(); i++)
+            {
+                Ptr<Node> node = (*it)->GetDevice(i)->GetNode();
+                if (!node)
+                {
+                    continue;
+                }
+                uint32_t other = find(node->GetId());
+                if (root == nNodes)
+                {
+                    root = other;
+                }
+                else if (root != other)
+                {
+                    parent[std::max(root, other)] = std::min(root, other);
+                    root = std::min(root, other);
+                }
+            }
+        }
+
+        std::vector<uint32_t> groupSize(nNodes, 0);
+        std::vector<uint32_t> groups;
+        for (uint32_t i = 0; i < nNodes; i++)
+        {
+            if (find(i) == i)
+            {
+                groups.push_back(i);
+            }
+            groupSize[find(i)]++;
+        }
+
+        // assign the largest groups first, each to the least loaded partition
+        uint32_t maxThreads =
+            (m_maxThreads != 0 ? m_maxThreads : std::max(1U, std::thread::hardware_concurrency()));
+        nPartitions = std::min<uint32_t>(maxThreads, groups.size());
+        std::stable_sort(groups.begin(), groups.end(), [&groupSize](uint32_t a, uint32_t b) {
+            return groupSize[a] > groupSize[b];
+        });
+        std::vector<uint32_t> load(nPartitions, 0);
+        std::vector<uint32_t> groupPartition(nNodes, 0);
+        for (auto group : groups)
+        {
+            auto partition = std::min_element(load.begin(), load.end()) - load.begin();
+            groupPartition[group] = partition;
+            load[partition] += groupSize[group];
+        }
+        for (uint32_t i = 0; i < nNodes; i++)
+        {
+            m_nodePartitions[i] = groupPartition[find(i)];
+        }
+    }
+
+#ifndef NS3_MTP
+    // the reference counts of the objects exchanged by the partitions are not
+    // atomic, hence all the nodes are run by the thread which called Run()
+    if (nPartitions > 1 && !m_forcePartitions)
+    {
+        NS_LOG_WARN("ns-3 is not configured with NS3_MTP, running the "
+                    << nPartitions << " partitions as a single partition");
+        nPartitions = 1;
+        m_nodePartitions.assign(nNodes, 0);
+    }
+#endif
+
+    // the lookahead is the smallest delay of the channels which were cut
+    m_lookahead = Time::Max();
+    for (auto it = ChannelList::Begin(); it != ChannelList::End(); ++it)
+    {
+        std::set<uint32_t> partitions;
+        for (std::size_t i = 0; i < (*it)->GetNDevices(); i++)
+        {
+            Ptr<Node> node = (*it)->GetDevice(i)->GetNode();
+            if (node)
+            {
+                partitions.insert(m_nodePartitions[node->GetId()]);
+            }
+        }
+        if (partitions.size() <= 1)
+        {
+            continue;
+        }
+        Time delay;
+        if (!IsCuttable(*it, delay))
+        {
+            NS_FATAL_ERROR("Channel " << (*it)->GetId()
+                                      << " connects nodes of different partitions, but it is "
+                                         "not a point-to-point channel with a positive delay");
+        }
+        m_lookahead = Min(m_lookahead, delay);
+    }
+
+    m_partitions.resize(nPartitions);
+    for (auto& partition : m_partitions)
+    {
+        partition.events = m_schedulerFactory.Create<Scheduler>();
+        partition.uid = EventId::UID::VALID;
+        partition.currentUid = EventId::UID::INVALID;
+        partition.currentTs = m_global.currentTs;
+        partition.currentContext = Simulator::NO_CONTEXT;
+        partition.eventCount = 0;
+        partition.unscheduledEvents = 0;
+        partition.mailboxes.resize(nPartitions + 1);
+    }
+    NS_LOG_INFO(nNodes << " nodes in " << nPartitions << " partitions, lookahead "
+                       << m_lookahead.As(Time::S));
+
+    // move the events of the nodes to their partitions, the others are
+    // global events whose ids have possibly been handed out already
+    std::vector<Scheduler::Event> globalEvents;
+    while (!m_global.events->IsEmpty())
+    {
+        Scheduler::Event ev = m_global.events->RemoveNext();
+        if (ev.key.m_context < nNodes)
+        {
+            Insert(m_partitions[m_nodePartitions[ev.key.m_context]],
+                   ev.key.m_ts,
+                   ev.key.m_context,
+                   ev.impl);
+            m_global.unscheduledEvents--;
+        }
+        else
+        {
+            globalEvents.push_back(ev);
+        }
+    }
+    for (const auto& ev : globalEvents)
+    {
+        m_global.events->Insert(ev);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::DeliverMailboxes(uint32_t index)
+{
+    Partition& partition = (index < m_partitions.size() ? m_partitions[index] : m_global);
+    for (auto& source : m_partitions)
+    {
+        for (const auto& ev : source.mailboxes[index])
+        {
+            Insert(partition, ev.ts, ev.context, ev.event);
+        }
+        source.mailboxes[index].clear();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::ProcessOneEvent(Partition& partition)
+{
+    Scheduler::Event next = partition.events->RemoveNext();
+
+    PreEventHook(EventId(next.impl, next.key.m_ts, next.key.m_context, next.key.m_uid));
+
+    NS_ASSERT(next.key.m_ts >= partition.currentTs);
+    partition.unscheduledEvents--;
+    partition.eventCount++;
+
+    NS_LOG_LOGIC("handle " << next.key.m_ts);
+    partition.currentTs = next.key.m_ts;
+    partition.currentContext = next.key.m_context;
+    partition.currentUid = next.key.m_uid;
+    next.impl->Invoke();
+    next.impl->Unref();
+}
+
+void
+MultithreadedSimulatorImpl::WindowStart::operator()() noexcept
+{
+    impl->StartWindow();
+}
+
+void
+MultithreadedSimulatorImpl::StartWindow()
+{
+    // the global events run while all the partitions are paused
+    Partition* current = t_current;
+    t_current = nullptr;
+
+    DeliverMailboxes(m_partitions.size());
+
+    while (true)
+    {
+        if (m_stop)
+        {
+            m_finished = true;
+            break;
+        }
+
+        uint64_t next = std::numeric_limits<uint64_t>::max();
+        for (const auto& partition : m_partitions)
+        {
+            if (!partition.events->IsEmpty())
+            {
+                next = std::min(next, partition.events->PeekNext().key.m_ts);
+            }
+        }
+
+        if (!m_global.events->IsEmpty() && m_global.events->PeekNext().key.m_ts <= next)
+        {
+            ProcessOneEvent(m_global);
+            continue;
+        }
+        if (next == std::numeric_limits<uint64_t>::max())
+        {
+            m_finished = true;
+            break;
+        }
+
+        // no event can be sent to a different partition earlier than the
+        // next event plus the lookahead
+        m_windowEndTs = next + m_lookahead.GetTimeStep();
+        if (!m_global.events->IsEmpty())
+        {
+            m_windowEndTs = std::min(m_windowEndTs, m_global.events->PeekNext().key.m_ts);
+        }
+        break;
+    }
+
+    t_current = current;
+}
+
+void
+MultithreadedSimulatorImpl::RunPartition(uint32_t index)
+{
+    NS_LOG_FUNCTION(this << index);
+
+    Partition& partition = m_partitions[index];
+    t_current = &partition;
+
+    while (true)
+    {
+        DeliverMailboxes(index);
+        m_windowStart->arrive_and_wait();
+        if (m_finished)
+        {
+            break;
+        }
+        while (!partition.events->IsEmpty() &&
+               partition.events->PeekNext().key.m_ts < m_windowEndTs)
+        {
+            ProcessOneEvent(partition);
+        }
+        m_windowEnd->arrive_and_wait();
+    }
+
+    t_current = nullptr;
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished() const
+{
+    if (m_stop)
+    {
+        return true;
+    }
+    if (!m_global.events->IsEmpty())
+    {
+        return false;
+    }
+    for (const auto& partition : m_partitions)
+    {
+        if (!partition.events->IsEmpty())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+MultithreadedSimulatorImpl::Run()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT_MSG(t_current == nullptr, "Simulator::Run called while running");
+
+    if (m_partitions.empty())
+    {
+        PartitionNodes();
+    }
+    m_stop = false;
+    m_finished = false;
+
+    uint32_t nPartitions = m_partitions.size();
+    m_windowStart = std::make_unique<std::barrier<WindowStart>>(nPartitions, WindowStart{this});
+    m_windowEnd = std::make_unique<std::barrier<>>(nPartitions);
+
+    std::vector<std::thread> threads;
+    for (uint32_t i = 1; i < nPartitions; i++)
+    {
+        threads.emplace_back(&MultithreadedSimulatorImpl::RunPartition, this, i);
+    }
+    RunPartition(0);
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    m_windowStart.reset();
+    m_windowEnd.reset();
+
+    // the global time follows the latest partition
+    for (const auto& partition : m_partitions)
+    {
+        m_global.currentTs = std::max(m_global.currentTs, partition.currentTs);
+        // If the simulator stopped naturally by lack of events, make a
+        // consistency test to check that we didn't lose any events along the way.
+        NS_ASSERT(!partition.events->IsEmpty() || partition.unscheduledEvents == 0);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Stop()
+{
+    NS_LOG_FUNCTION(this);
+    // when called by an event of a partition, the partitions stop at the end
+    // of the current window, so that the execution remains deterministic
+    m_stop = true;
+}
+
+void
+MultithreadedSimulatorImpl::Stop(const Time& delay)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep());
+    Simulator::Schedule(delay, &Simulator::Stop);
+}
+
+EventId
+MultithreadedSimulatorImpl::Schedule(const Time& delay, EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << delay.GetTimeStep() << event);
+
+    Partition& partition = GetCurrent();
+    Time tAbsolute = delay + TimeStep(partition.currentTs);
+
+    NS_ASSERT(tAbsolute.IsPositive());
+    NS_ASSERT(tAbsolute >= TimeStep(partition.currentTs));
+    Scheduler::EventKey key =
+        Insert(partition, tAbsolute.GetTimeStep(), partition.currentContext, event);
+    return EventId(event, key.m_ts, key.m_context, key.m_uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext(uint32_t context,
+                                                const Time& delay,
+                                                EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << context << delay.GetTimeStep() << event);
+
+    Partition& source = GetCurrent();
+    Partition& destination = GetPartitionOf(context);
+    uint64_t ts = source.currentTs + delay.GetTimeStep();
+
+    // the partitions are paused while the global events run
+    if (&destination == &source || &source == &m_global)
+    {
+        Insert(destination, ts, context, event);
+        return;
+    }
+
+    if (ts < m_windowEndTs)
+    {
+        NS_FATAL_ERROR("Event for context " << context << " scheduled at " << TimeStep(ts)
+                                            << ", before the end of the current window at "
+                                            << TimeStep(m_windowEndTs)
+                                            << "; its delay is smaller than the lookahead "
+                                            << m_lookahead);
+    }
+    uint32_t index = (&destination == &m_global ? m_partitions.size()
+                                                : &destination - m_partitions.data());
+    source.mailboxes[index].push_back({ts, context, event});
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow(EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << event);
+    return Schedule(Time(0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy(EventImpl* event)
+{
+    NS_LOG_FUNCTION(this << event);
+    NS_ASSERT_MSG(t_current == nullptr,
+                  "Simulator::ScheduleDestroy can only be called by the global events");
+
+    EventId id(Ptr<EventImpl>(event, false), m_global.currentTs, 0xffffffff, 2);
+    m_destroyEvents.push_back(id);
+    m_global.uid++;
+    return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now() const
+{
+    // Do not add function logging here, to avoid stack overflow
+    return TimeStep(GetCurrent().currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft(const EventId& id) const
+{
+    if (IsExpired(id))
+    {
+        return TimeStep(0);
+    }
+    else
+    {
+        return TimeStep(id.GetTs() - GetCurrent().currentTs);
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove(const EventId& id)
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        // destroy events.
+        for (auto i = m_destroyEvents.begin(); i != m_destroyEvents.end(); i++)
+        {
+            if (*i == id)
+            {
+                m_destroyEvents.erase(i);
+                break;
+            }
+        }
+        return;
+    }
+    if (IsExpired(id))
+    {
+        return;
+    }
+    Partition& partition = GetPartitionOf(id.GetContext());
+    NS_ASSERT_MSG(&partition == &GetCurrent() || t_current == nullptr,
+                  "Simulator::Remove called for an event of a different partition");
+    Scheduler::Event event;
+    event.impl = id.PeekEventImpl();
+    event.key.m_ts = id.GetTs();
+    event.key.m_context = id.GetContext();
+    event.key.m_uid = id.GetUid();
+    partition.events->Remove(event);
+    event.impl->Cancel();
+    // whenever we remove an event from the event list, we have to unref it.
+    event.impl->Unref();
+
+    partition.unscheduledEvents--;
+}
+
+void
+MultithreadedSimulatorImpl::Cancel(const EventId& id)
+{
+    NS_ASSERT_MSG(id.PeekEventImpl() == nullptr || id.GetUid() == EventId::UID::DESTROY ||
+                      t_current == nullptr || &GetPartitionOf(id.GetContext()) == t_current,
+                  "Simulator::Cancel called for an event of a different partition");
+    if (!IsExpired(id))
+    {
+        id.PeekEventImpl()->Cancel();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired(const EventId& id) const
+{
+    if (id.GetUid() == EventId::UID::DESTROY)
+    {
+        if (id.PeekEventImpl() == nullptr || id.PeekEventImpl()->IsCancelled())
+        {
+            return true;
+        }
+        // destroy events.
+        for (auto i = m_destroyEvents.begin(); i != m_destroyEvents.end(); i++)
+        {
+            if (*i == id)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    if (id.PeekEventImpl() == nullptr)
+    {
+        return true;
+    }
+    // the ids of the events are compared to the state of their partition, which
+    // only its own thread may read while the partitions run; the global events
+    // only run while the partitions are paused
+    const Partition& partition = GetPartitionOf(id.GetContext());
+    NS_ASSERT_MSG(&partition == t_current || &partition == &m_global || t_current == nullptr,
+                  "Simulator::IsExpired called for an event of a different partition");
+    return id.GetTs() < partition.currentTs ||
+           (id.GetTs() == partition.currentTs && id.GetUid() <= partition.currentUid) ||
+           id.PeekEventImpl()->IsCancelled();
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime() const
+{
+    return TimeStep(0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext() const
+{
+    return GetCurrent().currentContext;
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetEventCount() const
+{
+    uint64_t count = m_global.eventCount;
+    for (const auto& partition : m_partitions)
+    {
+        count += partition.eventCount;
+    }
+    return count;
+}
+
+} // namespace ns3
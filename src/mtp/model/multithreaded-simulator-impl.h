@@ -0,0 +1,291 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTITHREADED_SIMULATOR_IMPL_H
+#define MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/object-factory.h"
+#include "ns3/ptr.h"
+#include "ns3/scheduler.h"
+#include "ns3/simulator-impl.h"
+
+#include <atomic>
+#include <barrier>
+#include <list>
+#include <memory>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup mtp
+ * ns3::MultithreadedSimulatorImpl declaration.
+ */
+
+namespace ns3
+{
+
+class Channel;
+
+/**
+ * \ingroup mtp
+ *
+ * \brief Conservative parallel simulator running the partitions of the
+ * nodes on multiple threads of a single process.
+ *
+ * When Run() is called for the first time, the nodes are split into
+ * partitions:
+ *  - if any node has a non-zero system id, there is a partition per
+ *    distinct system id, as with the DistributedSimulatorImpl;
+ *  - otherwise, the nodes connected by channels which cannot be cut (see
+ *    below) are grouped together, and the resulting groups are balanced
+ *    over (at most) MaxThreads partitions, based on their number of nodes.
+ *
+ * A channel can be cut, i.e., connect nodes of different partitions, if all
+ * of its devices are point-to-point devices and it has a positive "Delay"
+ * attribute, like the PointToPointChannel. The lookahead is the smallest
+ * delay of the channels connecting different partitions.
+ *
+ * Each partition has its own event queue and is run by its own thread (the
+ * first partition is run by the thread which called Run()). The threads
+ * advance in time windows: each window ends at the earliest timestamp of
+ * the next events plus the lookahead, and the threads wait for each other
+ * at a barrier at the end of each window. The events scheduled for a node
+ * of a different partition are appended to a per-pair mailbox, which the
+ * destination partition moves to its event queue after the barrier, in the
+ * order of the source partitions. Hence, no lock is taken during a window
+ * and, for a given partitioning, the execution is deterministic, i.e., it
+ * does not depend on the relative speed of the threads.
+ *
+ * The events whose context is not a node id (e.g., those scheduled with
+ * Simulator::Schedule before Run() is called) are global: they are executed
+ * between two windows, while all the partitions are paused, and may thus
+ * access the state of any node.
+ *
+ * An event scheduled by a partition for a different partition (or a global
+ * event) must not be earlier than the end of the current window, which is
+ * guaranteed for the events scheduled across the channels which were cut;
+ * otherwise the simulation is aborted.
+ *
+ * \note The partitions share the objects exchanged through their events
+ * (e.g., the packets sent over the channels which were cut), whose reference
+ * counts are atomic only if ns-3 is configured with NS3_MTP. Otherwise, all
+ * the nodes are assigned to a single partition, unless the ForcePartitions
+ * attribute is set.
+ *
+ * An event can only be cancelled or removed by the events of its partition
+ * (or by the global events), as it is stored in the event queue of its
+ * partition.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+  public:
+    /**
+     *  Register this type.
+     *  \return The object TypeId.
+     */
+    static TypeId GetTypeId();
+
+    /** Constructor. */
+    MultithreadedSimulatorImpl();
+    /** Destructor. */
+    ~MultithreadedSimulatorImpl() override;
+
+    // Inherited
+    void Destroy() override;
+    bool IsFinished() const override;
+    void Stop() override;
+    void Stop(const Time& delay) override;
+    EventId Schedule(const Time& delay, EventImpl* event) override;
+    void ScheduleWithContext(uint32_t context, const Time& delay, EventImpl* event) override;
+    EventId ScheduleNow(EventImpl* event) override;
+    EventId ScheduleDestroy(EventImpl* event) override;
+    void Remove(const EventId& id) override;
+    void Cancel(const EventId& id) override;
+    bool IsExpired(const EventId& id) const override;
+    void Run() override;
+    Time Now() const override;
+    Time GetDelayLeft(const EventId& id) const override;
+    Time GetMaximumSimulationTime() const override;
+    void SetScheduler(ObjectFactory schedulerFactory) override;
+    uint32_t GetSystemId() const override;
+    uint32_t GetContext() const override;
+    uint64_t GetEventCount() const override;
+
+    /**
+     * \returns The number of partitions, zero until Run() is called.
+     */
+    uint32_t GetPartitionCount() const;
+
+    /**
+     * \param [in] nodeId The node id.
+     * \returns The partition of the node, or GetPartitionCount() if the node
+     *          was created after the partitions were computed.
+     */
+    uint32_t GetPartition(uint32_t nodeId) const;
+
+    /**
+     * \returns The lookahead, i.e., the smallest delay of the channels
+     *          connecting different partitions (Time::Max() if none).
+     */
+    Time GetLookahead() const;
+
+  private:
+    void DoDispose() override;
+
+    /** An event sent to a different partition. */
+    struct MailboxEvent
+    {
+        uint64_t ts;      //!< The event timestamp.
+        uint32_t context; //!< The event context.
+        EventImpl* event; //!< The event implementation.
+    };
+
+    /**
+     * A partition: the nodes of a partition share an event queue and are
+     * run by the same thread. The global events are stored in a further
+     * partition, which is run while the others are paused.
+     */
+    struct Partition
+    {
+        Ptr<Scheduler> events;   //!< The event priority queue.
+        uint32_t uid;            //!< Next event unique id.
+        uint32_t currentUid;     //!< Unique id of the current event.
+        uint64_t currentTs;      //!< Timestamp of the current event.
+        uint32_t currentContext; //!< Execution context of the current event.
+        uint64_t eventCount;     //!< The event count.
+        /**
+         * Number of events that have been inserted but not yet scheduled;
+         * this is used for validation.
+         */
+        int unscheduledEvents;
+        /**
+         * The events sent to the other partitions during the current window,
+         * indexed by destination partition (the last one is the global
+         * partition).
+         */
+        std::vector<std::vector<MailboxEvent>> mailboxes;
+    };
+
+    /** Completion function of the barrier at the start of each window. */
+    struct WindowStart
+    {
+        MultithreadedSimulatorImpl* impl; //!< The simulator.
+
+        /** Run the global events and compute the end of the next window. */
+        void operator()() noexcept;
+    };
+
+    /**
+     * \returns The partition of the calling thread, or the global partition
+     *          if the thread is not running a partition.
+     */
+    Partition& GetCurrent() const;
+
+    /**
+     * \param [in] context The event context.
+     * \returns The partition running the events with the given context.
+     */
+    Partition& GetPartitionOf(uint32_t context) const;
+
+    /**
+     * Insert an event into the event queue of a partition.
+     *
+     * \param [in] partition The partition.
+     * \param [in] ts The event timestamp.
+     * \param [in] context The event context.
+     * \param [in] event The event implementation.
+     * \returns The event key.
+     */
+    Scheduler::EventKey Insert(Partition& partition,
+                               uint64_t ts,
+                               uint32_t context,
+                               EventImpl* event);
+
+    /**
+     * \param [in] channel The channel.
+     * \param [out] delay The channel delay.
+     * \returns \c true if the channel can connect nodes of different partitions.
+     */
+    static bool IsCuttable(Ptr<Channel> channel, Time& delay);
+
+    /** Compute the partitions and the lookahead, and move the events to their partitions. */
+    void PartitionNodes();
+
+    /**
+     * Move the events in the mailboxes of all the partitions for the given
+     * partition to its event queue.
+     *
+     * \param [in] index The index of the partition (the number of partitions
+     *        for the global partition).
+     */
+    void DeliverMailboxes(uint32_t index);
+
+    /**
+     * Process the next event of a partition.
+     *
+     * \param [in] partition The partition.
+     */
+    void ProcessOneEvent(Partition& partition);
+
+    /**
+     * Run the windows of a partition until the end of the simulation.
+     *
+     * \param [in] index The index of the partition.
+     */
+    void RunPartition(uint32_t index);
+
+    /** Run the global events and compute the end of the next window. */
+    void StartWindow();
+
+    /** The partition run by the calling thread, if any. */
+    static thread_local Partition* t_current;
+
+    /** The partitions, indexed by partition. */
+    mutable std::vector<Partition> m_partitions;
+    /** The global partition. */
+    mutable Partition m_global;
+    /** The partition of each node, indexed by node id. */
+    std::vector<uint32_t> m_nodePartitions;
+    /** The smallest delay of the channels connecting different partitions. */
+    Time m_lookahead;
+    /** The maximum number of partitions when partitioning automatically. */
+    uint32_t m_maxThreads;
+    /** Whether to run several partitions without NS3_MTP. */
+    bool m_forcePartitions;
+    /** The factory of the event priority queues. */
+    ObjectFactory m_schedulerFactory;
+
+    /** The barrier at the start of each window. */
+    std::unique_ptr<std::barrier<WindowStart>> m_windowStart;
+    /** The barrier at the end of each window. */
+    std::unique_ptr<std::barrier<>> m_windowEnd;
+    /** The events earlier than this timestamp can be run in the current window. */
+    uint64_t m_windowEndTs;
+    /** Flag \c true once all the partitions are done. */
+    bool m_finished;
+
+    /** Container type for the events to run at Simulator::Destroy() */
+    typedef std::list<EventId> DestroyEvents;
+    /** The container of events to run at Destroy. */
+    DestroyEvents m_destroyEvents;
+    /** Flag calling for the end of the simulation. */
+    std::atomic<bool> m_stop;
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_SIMULATOR_IMPL_H */
@@ -0,0 +1,541 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/boolean.h"
+#include "ns3/config.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/node-container.h"
+#include "ns3/packet.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \file
+ * \ingroup mtp-tests
+ * MultithreadedSimulatorImpl test suite
+ */
+
+/**
+ * \ingroup mtp
+ * \defgroup mtp-tests mtp module tests
+ */
+
+/**
+ * \ingroup mtp-tests
+ *
+ * \brief Check the partitions and the lookahead computed by the
+ * MultithreadedSimulatorImpl.
+ */
+class MtpPartitionTestCase : public TestCase
+{
+  public:
+    MtpPartitionTestCase();
+
+  private:
+    void DoRun() override;
+    void DoTeardown() override;
+
+#ifndef NS3_MTP
+    /**
+     * Check that all the nodes are assigned to a single partition, as the
+     * reference counts are not atomic without NS3_MTP.
+     *
+     * \param impl The simulator implementation.
+     * \param nodes The nodes.
+     */
+    void CheckSinglePartition(Ptr<MultithreadedSimulatorImpl> impl, const NodeContainer& nodes);
+#endif
+};
+
+MtpPartitionTestCase::MtpPartitionTestCase()
+    : TestCase("Check the partitions of the nodes and the lookahead")
+{
+}
+
+void
+MtpPartitionTestCase::DoRun()
+{
+    Config::SetGlobal("SimulatorImplementationType",
+                      StringValue("ns3::MultithreadedSimulatorImpl"));
+    Config::SetDefault("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue(2));
+
+    // nodes 0, 1 and 2 share a channel which cannot be cut, nodes 2 and 3
+    // and nodes 3 and 4 are connected by point-to-point channels, node 5 is
+    // isolated
+    NodeContainer nodes;
+    nodes.Create(6);
+    SimpleNetDeviceHelper helper;
+    helper.Install(NodeContainer(nodes.Get(0), nodes.Get(1), nodes.Get(2)));
+    helper.SetNetDevicePointToPointMode(true);
+    helper.SetChannelAttribute("Delay", TimeValue(MilliSeconds(2)));
+    helper.Install(NodeContainer(nodes.Get(2), nodes.Get(3)));
+    helper.SetChannelAttribute("Delay", TimeValue(MilliSeconds(1)));
+    helper.Install(NodeContainer(nodes.Get(3), nodes.Get(4)));
+
+    Simulator::Run();
+    auto impl = DynamicCast<MultithreadedSimulatorImpl>(Simulator::GetImplementation());
+    NS_TEST_ASSERT_MSG_EQ((impl != nullptr), true, "Wrong simulator implementation");
+
+#ifdef NS3_MTP
+    // the largest group goes first, the single nodes fill the other partition
+    NS_TEST_EXPECT_MSG_EQ(impl->GetPartitionCount(), 2, "Wrong number of partitions");
+    uint32_t expected[] = {0, 0, 0, 1, 1, 1};
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(impl->GetPartition(i), expected[i], "Wrong partition of node " << i);
+    }
+    // the channel between nodes 3 and 4 is not cut
+    NS_TEST_EXPECT_MSG_EQ(impl->GetLookahead(), MilliSeconds(2), "Wrong lookahead");
+#else
+    CheckSinglePartition(impl, nodes);
+#endif
+    Simulator::Destroy();
+
+    // partitions by system id
+    NodeContainer a;
+    a.Create(1, 0);
+    NodeContainer b;
+    b.Create(2, 3);
+    NodeContainer c;
+    c.Create(1, 7);
+    helper.SetChannelAttribute("Delay", TimeValue(MilliSeconds(5)));
+    helper.Install(NodeContainer(a.Get(0), b.Get(0)));
+    helper.SetChannelAttribute("Delay", TimeValue(MilliSeconds(3)));
+    helper.Install(NodeContainer(b.Get(0), b.Get(1)));
+
+    Simulator::Run();
+    impl = DynamicCast<MultithreadedSimulatorImpl>(Simulator::GetImplementation());
+#ifdef NS3_MTP
+    NS_TEST_EXPECT_MSG_EQ(impl->GetPartitionCount(), 3, "Wrong number of partitions");
+    NS_TEST_EXPECT_MSG_EQ(impl->GetPartition(a.Get(0)->GetId()), 0, "Wrong partition");
+    NS_TEST_EXPECT_MSG_EQ(impl->GetPartition(b.Get(0)->GetId()), 1, "Wrong partition");
+    NS_TEST_EXPECT_MSG_EQ(impl->GetPartition(b.Get(1)->GetId()), 1, "Wrong partition");
+    NS_TEST_EXPECT_MSG_EQ(impl->GetPartition(c.Get(0)->GetId()), 2, "Wrong partition");
+    NS_TEST_EXPECT_MSG_EQ(impl->GetLookahead(), MilliSeconds(5), "Wrong lookahead");
+#else
+    CheckSinglePartition(impl, NodeContainer(a, b, c));
+#endif
+    Simulator::Destroy();
+}
+
+#ifndef NS3_MTP
+void
+MtpPartitionTestCase::CheckSinglePartition(Ptr<MultithreadedSimulatorImpl> impl,
+                                           const NodeContainer& nodes)
+{
+    NS_TEST_EXPECT_MSG_EQ(impl->GetPartitionCount(), 1, "Wrong number of partitions");
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(impl->GetPartition(nodes.Get(i)->GetId()),
+                              0,
+                              "Wrong partition of node " << nodes.Get(i)->GetId());
+    }
+    NS_TEST_EXPECT_MSG_EQ(impl->GetLookahead(), Time::Max(), "Wrong lookahead");
+}
+#endif
+
+void
+MtpPartitionTestCase::DoTeardown()
+{
+    Config::SetGlobal("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+    Config::SetDefault("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue(0));
+}
+
+/**
+ * \ingroup mtp-tests
+ *
+ * \brief Check that the MultithreadedSimulatorImpl runs the same events as
+ * the DefaultSimulatorImpl.
+ *
+ * Tokens hop around a ring of nodes connected by point-to-point channels,
+ * scheduling local events at each hop. The events run on each node, a
+ * snapshot taken by a global event and the time at which a global Stop
+ * event ends the simulation are compared with those of a sequential run.
+ */
+class MtpEventsTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor.
+     *
+     * \param maxThreads The maximum number of threads.
+     */
+    MtpEventsTestCase(uint32_t maxThreads);
+
+  private:
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /** The events run by each node: (timestamp, token) pairs. */
+    typedef std::vector<std::vector<std::pair<int64_t, uint32_t>>> Log;
+
+    /**
+     * Run the scenario.
+     *
+     * \param simulatorType The simulator implementation type.
+     * \param [out] log The events run by each node.
+     * \param [out] snapshot The number of events run when the snapshot was taken.
+     * \param [out] end The time at which the simulation ended.
+     * \param [out] events The number of events run.
+     */
+    void RunScenario(std::string simulatorType,
+                     Log& log,
+                     uint64_t& snapshot,
+                     Time& end,
+                     uint64_t& events);
+    /**
+     * A token arrives at a node.
+     *
+     * \param node The node.
+     * \param token The token.
+     * \param hops The number of hops left.
+     */
+    void Hop(uint32_t node, uint32_t token, uint32_t hops);
+    /**
+     * A local event scheduled by a token.
+     *
+     * \param node The node.
+     * \param token The token.
+     */
+    void Local(uint32_t node, uint32_t token);
+    /** Take a snapshot of the number of events run so far. */
+    void Snapshot();
+
+    uint32_t m_maxThreads;               //!< The maximum number of threads.
+    Log m_log;                           //!< The events run by each node.
+    uint64_t m_snapshot;                 //!< The number of events run at the snapshot.
+    std::vector<uint32_t> m_badContexts; //!< Events run with a wrong context, per node.
+
+    static constexpr uint32_t N_NODES = 8;  //!< The number of nodes.
+    static constexpr uint32_t N_TOKENS = 4; //!< The number of tokens per node.
+    static constexpr uint32_t N_HOPS = 60;  //!< The number of hops of each token.
+};
+
+MtpEventsTestCase::MtpEventsTestCase(uint32_t maxThreads)
+    : TestCase("Check the events run with at most " + std::to_string(maxThreads) + " threads"),
+      m_maxThreads(maxThreads)
+{
+}
+
+void
+MtpEventsTestCase::Hop(uint32_t node, uint32_t token, uint32_t hops)
+{
+    m_badContexts[node] += (Simulator::GetContext() != node);
+    m_log[node].emplace_back(Simulator::Now().GetNanoSeconds(), token);
+    if (hops == 0)
+    {
+        return;
+    }
+    Simulator::Schedule(MicroSeconds((token * 7 + hops * 13) % 500),
+                        &MtpEventsTestCase::Local,
+                        this,
+                        node,
+                        token);
+    uint32_t next = ((token + hops) % 2 == 0 ? node + 1 : node + N_NODES - 1) % N_NODES;
+    Simulator::ScheduleWithContext(next,
+                                   MilliSeconds(1) + MicroSeconds((token * 31 + hops * 17) % 100),
+                                   &MtpEventsTestCase::Hop,
+                                   this,
+                                   next,
+                                   token,
+                                   hops - 1);
+}
+
+void
+MtpEventsTestCase::Local(uint32_t node, uint32_t token)
+{
+    m_badContexts[node] += (Simulator::GetContext() != node);
+    m_log[node].emplace_back(Simulator::Now().GetNanoSeconds(), token + 1000);
+}
+
+void
+MtpEventsTestCase::Snapshot()
+{
+    // the partitions are paused while the global events run
+    m_snapshot = 0;
+    for (const auto& events : m_log)
+    {
+        m_snapshot += events.size();
+    }
+}
+
+void
+MtpEventsTestCase::RunScenario(std::string simulatorType,
+                               Log& log,
+                               uint64_t& snapshot,
+                               Time& end,
+                               uint64_t& events)
+{
+    Config::SetGlobal("SimulatorImplementationType", StringValue(simulatorType));
+    Config::SetDefault("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue(m_maxThreads));
+    // the events only carry integers, hence the partitions can be run on their
+    // own threads even without NS3_MTP
+    Config::SetDefault("ns3::MultithreadedSimulatorImpl::ForcePartitions", BooleanValue(true));
+
+    NodeContainer nodes;
+    nodes.Create(N_NODES);
+    SimpleNetDeviceHelper helper;
+    helper.SetNetDevicePointToPointMode(true);
+    helper.SetChannelAttribute("Delay", TimeValue(MilliSeconds(1)));
+    for (uint32_t i = 0; i < N_NODES; i++)
+    {
+        helper.Install(NodeContainer(nodes.Get(i), nodes.Get((i + 1) % N_NODES)));
+    }
+
+    m_log.assign(N_NODES, {});
+    m_snapshot = 0;
+    m_badContexts.assign(N_NODES, 0);
+    for (uint32_t i = 0; i < N_NODES; i++)
+    {
+        for (uint32_t k = 0; k < N_TOKENS; k++)
+        {
+            Simulator::ScheduleWithContext(i,
+                                           MicroSeconds(10 * i + 100 * k),
+                                           &MtpEventsTestCase::Hop,
+                                           this,
+                                           i,
+                                           i * N_TOKENS + k,
+                                           N_HOPS);
+        }
+    }
+    // the global events do not share their timestamp with any other event
+    Simulator::Schedule(MilliSeconds(25) + NanoSeconds(1), &MtpEventsTestCase::Snapshot, this);
+    Simulator::Stop(MilliSeconds(50) + NanoSeconds(1));
+
+    Simulator::Run();
+
+    auto impl = DynamicCast<MultithreadedSimulatorImpl>(Simulator::GetImplementation());
+    if (impl)
+    {
+        // each node is a group of its own
+        NS_TEST_EXPECT_MSG_EQ(impl->GetPartitionCount(),
+                              std::min(m_maxThreads, N_NODES),
+                              "Wrong number of partitions");
+    }
+    for (uint32_t i = 0; i < N_NODES; i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_badContexts[i], 0, "Event run with a wrong context at node " << i);
+        std::sort(m_log[i].begin(), m_log[i].end());
+    }
+    log = m_log;
+    snapshot = m_snapshot;
+    end = Simulator::Now();
+    events = Simulator::GetEventCount();
+    Simulator::Destroy();
+}
+
+void
+MtpEventsTestCase::DoRun()
+{
+    Log expectedLog;
+    uint64_t expectedSnapshot;
+    Time expectedEnd;
+    uint64_t expectedEvents;
+    RunScenario("ns3::DefaultSimulatorImpl",
+                expectedLog,
+                expectedSnapshot,
+                expectedEnd,
+                expectedEvents);
+
+    Log log;
+    uint64_t snapshot;
+    Time end;
+    uint64_t events;
+    RunScenario("ns3::MultithreadedSimulatorImpl", log, snapshot, end, events);
+
+    NS_TEST_ASSERT_MSG_GT(expectedSnapshot, 0, "No event run before the snapshot");
+    for (uint32_t i = 0; i < N_NODES; i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(log[i].size(), expectedLog[i].size(), "Wrong events at node " << i);
+        NS_TEST_EXPECT_MSG_EQ((log[i] == expectedLog[i]), true, "Wrong events at node " << i);
+    }
+    NS_TEST_EXPECT_MSG_EQ(snapshot, expectedSnapshot, "Wrong snapshot");
+    NS_TEST_EXPECT_MSG_EQ(end, expectedEnd, "Wrong end time");
+    NS_TEST_EXPECT_MSG_EQ(events, expectedEvents, "Wrong event count");
+}
+
+void
+MtpEventsTestCase::DoTeardown()
+{
+    Config::SetGlobal("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+    Config::SetDefault("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue(0));
+    Config::SetDefault("ns3::MultithreadedSimulatorImpl::ForcePartitions", BooleanValue(false));
+}
+
+#ifdef NS3_MTP
+/**
+ * \ingroup mtp-tests
+ *
+ * \brief Check the packets exchanged by the nodes of different partitions.
+ *
+ * This requires the atomic reference counts enabled by NS3_MTP, as the
+ * packets are shared by the partitions.
+ */
+class MtpPacketsTestCase : public TestCase
+{
+  public:
+    MtpPacketsTestCase();
+
+  private:
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * Run the scenario.
+     *
+     * \param simulatorType The simulator implementation type.
+     * \returns The number of bytes received by each node.
+     */
+    std::vector<uint64_t> RunScenario(std::string simulatorType);
+    /**
+     * Send a packet to the neighbour of a node and schedule the next one.
+     *
+     * \param device The device of the node.
+     * \param size The packet size.
+     */
+    void Send(Ptr<NetDevice> device, uint32_t size);
+    /**
+     * Receive a packet.
+     *
+     * \param device The device.
+     * \param packet The packet.
+     * \param protocol The protocol.
+     * \param from The sender address.
+     * \returns \c true.
+     */
+    bool Receive(Ptr<NetDevice> device,
+                 Ptr<const Packet> packet,
+                 uint16_t protocol,
+                 const Address& from);
+
+    std::vector<uint64_t> m_received; //!< The number of bytes received by each node.
+
+    static constexpr uint32_t N_NODES = 16; //!< The number of nodes.
+};
+
+MtpPacketsTestCase::MtpPacketsTestCase()
+    : TestCase("Check the packets exchanged by the partitions")
+{
+}
+
+void
+MtpPacketsTestCase::Send(Ptr<NetDevice> device, uint32_t size)
+{
+    Ptr<Packet> packet = Create<Packet>(size);
+    device->Send(packet, device->GetBroadcast(), 0);
+    Simulator::Schedule(MicroSeconds(10 + size % 7),
+                        &MtpPacketsTestCase::Send,
+                        this,
+                        device,
+                        (size * 13) % 1000 + 1);
+}
+
+bool
+MtpPacketsTestCase::Receive(Ptr<NetDevice> device,
+                            Ptr<const Packet> packet,
+                            uint16_t protocol,
+                            const Address& from)
+{
+    m_received[device->GetNode()->GetId()] += packet->GetSize();
+    return true;
+}
+
+std::vector<uint64_t>
+MtpPacketsTestCase::RunScenario(std::string simulatorType)
+{
+    Config::SetGlobal("SimulatorImplementationType", StringValue(simulatorType));
+    Config::SetDefault("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue(4));
+
+    NodeContainer nodes;
+    nodes.Create(N_NODES);
+    SimpleNetDeviceHelper helper;
+    helper.SetNetDevicePointToPointMode(true);
+    helper.SetChannelAttribute("Delay", TimeValue(MicroSeconds(100)));
+    m_received.assign(N_NODES, 0);
+    for (uint32_t i = 0; i < N_NODES; i++)
+    {
+        NetDeviceContainer devices =
+            helper.Install(NodeContainer(nodes.Get(i), nodes.Get((i + 1) % N_NODES)));
+        for (uint32_t j = 0; j < devices.GetN(); j++)
+        {
+            Ptr<NetDevice> device = devices.Get(j);
+            device->SetReceiveCallback(MakeCallback(&MtpPacketsTestCase::Receive, this));
+            Simulator::ScheduleWithContext(device->GetNode()->GetId(),
+                                           MicroSeconds(i),
+                                           &MtpPacketsTestCase::Send,
+                                           this,
+                                           device,
+                                           i * 100 + j + 1);
+        }
+    }
+    Simulator::Stop(MilliSeconds(200));
+    Simulator::Run();
+    Simulator::Destroy();
+    return m_received;
+}
+
+void
+MtpPacketsTestCase::DoRun()
+{
+    std::vector<uint64_t> expected = RunScenario("ns3::DefaultSimulatorImpl");
+    std::vector<uint64_t> received = RunScenario("ns3::MultithreadedSimulatorImpl");
+    for (uint32_t i = 0; i < N_NODES; i++)
+    {
+        NS_TEST_EXPECT_MSG_GT(expected[i], 0, "No packet received by node " << i);
+        NS_TEST_EXPECT_MSG_EQ(received[i], expected[i], "Wrong bytes received by node " << i);
+    }
+}
+
+void
+MtpPacketsTestCase::DoTeardown()
+{
+    Config::SetGlobal("SimulatorImplementationType", StringValue("ns3::DefaultSimulatorImpl"));
+    Config::SetDefault("ns3::MultithreadedSimulatorImpl::MaxThreads", UintegerValue(0));
+}
+#endif
+
+/**
+ * \ingroup mtp-tests
+ *
+ * \brief The multithreaded simulator Test Suite.
+ */
+class MtpTestSuite : public TestSuite
+{
+  public:
+    MtpTestSuite()
+        : TestSuite("mtp", UNIT)
+    {
+        AddTestCase(new MtpPartitionTestCase, TestCase::QUICK);
+        for (uint32_t maxThreads : {1, 3, 8})
+        {
+            AddTestCase(new MtpEventsTestCase(maxThreads), TestCase::QUICK);
+        }
+#ifdef NS3_MTP
+        AddTestCase(new MtpPacketsTestCase, TestCase::QUICK);
+#endif
+    }
+};
+
+/// Static variable for test initialization.
+static MtpTestSuite g_mtpTestSuite;
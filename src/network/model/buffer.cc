@@ -54,7 +54,11 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("Buffer");
 
+#ifdef NS3_MTP
+std::atomic<uint32_t> Buffer::g_recommendedStart = 0;
+#else
 uint32_t Buffer::g_recommendedStart = 0;
+#endif
 #ifdef BUFFER_FREE_LIST
 /* The following macros are pretty evil but they are needed to allow us to
  * keep track of 3 possible states for the g_freeList variable:
@@ -189,6 +193,21 @@ Buffer::Deallocate(Buffer::Data* data)
     delete[] buf;
 }
 
+void
+Buffer::UpdateRecommendedStart(uint32_t maxZeroAreaStart)
+{
+#ifdef NS3_MTP
+    // the buffers of the other partitions may raise it at the same time
+    uint32_t recommendedStart = g_recommendedStart;
+    while (recommendedStart < maxZeroAreaStart &&
+           !g_recommendedStart.compare_exchange_weak(recommendedStart, maxZeroAreaStart))
+    {
+    }
+#else
+    g_recommendedStart = std::max(g_recommendedStart, maxZeroAreaStart);
+#endif
+}
+
 Buffer::Buffer()
 {
     NS_LOG_FUNCTION(this);
@@ -249,7 +268,7 @@ Buffer::Initialize(uint32_t zeroSize)
 {
     NS_LOG_FUNCTION(this << zeroSize);
     m_data = Buffer::Create(0);
-    m_start = std::min(m_data->m_size, g_recommendedStart);
+    m_start = std::min<uint32_t>(m_data->m_size, g_recommendedStart);
     m_maxZeroAreaStart = m_start;
     m_zeroAreaStart = m_start;
     m_zeroAreaEnd = m_zeroAreaStart + zeroSize;
@@ -266,15 +285,14 @@ Buffer::operator=(const Buffer& o)
     if (m_data != o.m_data)
     {
         // not assignment to self.
-        m_data->m_count--;
-        if (m_data->m_count == 0)
+        if (--m_data->m_count == 0)
         {
             Recycle(m_data);
         }
         m_data = o.m_data;
         m_data->m_count++;
     }
-    g_recommendedStart = std::max(g_recommendedStart, m_maxZeroAreaStart);
+    UpdateRecommendedStart(m_maxZeroAreaStart);
     m_maxZeroAreaStart = o.m_maxZeroAreaStart;
     m_zeroAreaStart = o.m_zeroAreaStart;
     m_zeroAreaEnd = o.m_zeroAreaEnd;
@@ -288,9 +306,8 @@ Buffer::~Buffer()
 {
     NS_LOG_FUNCTION(this);
     NS_ASSERT(CheckInternalState());
-    g_recommendedStart = std::max(g_recommendedStart, m_maxZeroAreaStart);
-    m_data->m_count--;
-    if (m_data->m_count == 0)
+    UpdateRecommendedStart(m_maxZeroAreaStart);
+    if (--m_data->m_count == 0)
     {
         Recycle(m_data);
     }
@@ -316,6 +333,15 @@ Buffer::AddAtStart(uint32_t start)
     NS_LOG_FUNCTION(this << start);
     NS_ASSERT(CheckInternalState());
     bool isDirty = m_data->m_count > 1 && m_start > m_data->m_dirtyStart;
+#ifdef NS3_MTP
+    if (m_start >= start && !isDirty && m_data->m_count > 1)
+    {
+        // a buffer of another partition may share the data and write in front of
+        // the dirty area too: only the buffer which moves the dirty start writes there
+        uint32_t dirtyStart = m_start;
+        isDirty = !m_data->m_dirtyStart.compare_exchange_strong(dirtyStart, m_start - start);
+    }
+#endif
     if (m_start >= start && !isDirty)
     {
         /* enough space in the buffer and not dirty.
@@ -323,7 +349,10 @@ Buffer::AddAtStart(uint32_t start)
          * Before: |*****---------***|
          * After:  |***..---------***|
          */
+#ifndef NS3_MTP
+        // with NS3_MTP, the dirty start was moved by the claim above
         NS_ASSERT(m_data->m_count == 1 || m_start == m_data->m_dirtyStart);
+#endif
         m_start -= start;
         // update dirty area
         m_data->m_dirtyStart = m_start;
@@ -333,8 +362,7 @@ Buffer::AddAtStart(uint32_t start)
         uint32_t newSize = GetInternalSize() + start;
         Buffer::Data* newData = Buffer::Create(newSize);
         memcpy(newData->m_data + start, m_data->m_data + m_start, GetInternalSize());
-        m_data->m_count--;
-        if (m_data->m_count == 0)
+        if (--m_data->m_count == 0)
         {
             Buffer::Recycle(m_data);
         }
@@ -362,6 +390,15 @@ Buffer::AddAtEnd(uint32_t end)
     NS_LOG_FUNCTION(this << end);
     NS_ASSERT(CheckInternalState());
     bool isDirty = m_data->m_count > 1 && m_end < m_data->m_dirtyEnd;
+#ifdef NS3_MTP
+    if (GetInternalEnd() + end <= m_data->m_size && !isDirty && m_data->m_count > 1)
+    {
+        // a buffer of another partition may share the data and write after the
+        // dirty area too: only the buffer which moves the dirty end writes there
+        uint32_t dirtyEnd = m_end;
+        isDirty = !m_data->m_dirtyEnd.compare_exchange_strong(dirtyEnd, m_end + end);
+    }
+#endif
     if (GetInternalEnd() + end <= m_data->m_size && !isDirty)
     {
         /* enough space in buffer and not dirty
@@ -369,7 +406,10 @@ Buffer::AddAtEnd(uint32_t end)
          * Before: |**----*****|
          * After:  |**----...**|
          */
+#ifndef NS3_MTP
+        // with NS3_MTP, the dirty end was moved by the claim above
         NS_ASSERT(m_data->m_count == 1 || m_end == m_data->m_dirtyEnd);
+#endif
         m_end += end;
         // update dirty area.
         m_data->m_dirtyEnd = m_end;
@@ -379,8 +419,7 @@ Buffer::AddAtEnd(uint32_t end)
         uint32_t newSize = GetInternalSize() + end;
         Buffer::Data* newData = Buffer::Create(newSize);
         memcpy(newData->m_data, m_data->m_data + m_start, GetInternalSize());
-        m_data->m_count--;
-        if (m_data->m_count == 0)
+        if (--m_data->m_count == 0)
         {
             Buffer::Recycle(m_data);
         }
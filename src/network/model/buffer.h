@@ -25,7 +25,12 @@
 #include <stdint.h>
 #include <vector>
 
+#ifdef NS3_MTP
+#include <atomic>
+#else
+// the free list is not shared by the threads of a multithreaded simulation
 #define BUFFER_FREE_LIST 1
+#endif
 
 namespace ns3
 {
@@ -665,7 +670,11 @@ class Buffer
          * The reference count of an instance of this data structure.
          * Each buffer which references an instance holds a count.
          */
+#ifdef NS3_MTP
+        std::atomic<uint32_t> m_count;
+#else
         uint32_t m_count;
+#endif
         /**
          * the size of the m_data field below.
          */
@@ -674,12 +683,20 @@ class Buffer
          * offset from the start of the m_data field below to the
          * start of the area in which user bytes were written.
          */
+#ifdef NS3_MTP
+        std::atomic<uint32_t> m_dirtyStart;
+#else
         uint32_t m_dirtyStart;
+#endif
         /**
          * offset from the start of the m_data field below to the
          * end of the area in which user bytes were written.
          */
+#ifdef NS3_MTP
+        std::atomic<uint32_t> m_dirtyEnd;
+#else
         uint32_t m_dirtyEnd;
+#endif
         /**
          * The real data buffer holds _at least_ one byte.
          * Its real size is stored in the m_size field.
@@ -750,6 +767,11 @@ class Buffer
      * \param data the buffer data storage
      */
     static void Deallocate(Buffer::Data* data);
+    /**
+     * \brief Raise the recommended start of the new buffers
+     * \param maxZeroAreaStart the maximum start of the zero area of a buffer
+     */
+    static void UpdateRecommendedStart(uint32_t maxZeroAreaStart);
 
     Data* m_data; //!< the buffer data storage
 
@@ -769,7 +791,11 @@ class Buffer
      * writing data. i.e., m_start should be initialized to this
      * value.
      */
+#ifdef NS3_MTP
+    static std::atomic<uint32_t> g_recommendedStart;
+#else
     static uint32_t g_recommendedStart;
+#endif
 
     /**
      * offset to the start of the virtual zero area from the start
@@ -24,7 +24,11 @@
 #include <limits>
 #include <vector>
 
+#ifdef NS3_MTP
+#include <atomic>
+#else
 #define USE_FREE_LIST 1
+#endif
 #define FREE_LIST_SIZE 1000
 #define OFFSET_MAX (std::numeric_limits<int32_t>::max())
 
@@ -43,8 +47,16 @@ NS_LOG_COMPONENT_DEFINE("ByteTagList");
 struct ByteTagListData
 {
     uint32_t size;   //!< size of the data
-    uint32_t count;  //!< use counter (for smart deallocation)
+#ifdef NS3_MTP
+    std::atomic<uint32_t> count; //!< use counter (for smart deallocation)
+#else
+    uint32_t count; //!< use counter (for smart deallocation)
+#endif
+#ifdef NS3_MTP
+    std::atomic<uint32_t> dirty; //!< number of bytes actually in use
+#else
     uint32_t dirty;  //!< number of bytes actually in use
+#endif
     uint8_t data[4]; //!< data
 };
 
@@ -211,7 +223,7 @@ ByteTagList::Add(TypeId tid, uint32_t bufferSize, int32_t start, int32_t end)
         m_data = Allocate(spaceNeeded);
         m_used = 0;
     }
-    else if (m_data->size < spaceNeeded || (m_data->count != 1 && m_data->dirty != m_used))
+    else if (m_data->size < spaceNeeded || (m_data->count != 1 && !ClaimData(spaceNeeded)))
     {
         ByteTagListData* newData = Allocate(spaceNeeded);
         std::memcpy(&newData->data, &m_data->data, m_used);
@@ -236,6 +248,20 @@ ByteTagList::Add(TypeId tid, uint32_t bufferSize, int32_t start, int32_t end)
     return tag;
 }
 
+bool
+ByteTagList::ClaimData(uint32_t spaceNeeded)
+{
+    NS_LOG_FUNCTION(this << spaceNeeded);
+#ifdef NS3_MTP
+    // a list of another partition may share the data and append its tags at the
+    // same time: only the list which moves the end of the bytes in use writes there
+    uint32_t used = m_used;
+    return m_data->dirty.compare_exchange_strong(used, spaceNeeded);
+#else
+    return m_data->dirty == m_used;
+#endif
+}
+
 void
 ByteTagList::Add(const ByteTagList& o)
 {
@@ -386,8 +412,7 @@ ByteTagList::Deallocate(ByteTagListData* data)
         return;
     }
     g_maxSize = std::max(g_maxSize, data->size);
-    data->count--;
-    if (data->count == 0)
+    if (--data->count == 0)
     {
         if (g_freeList.size() > FREE_LIST_SIZE || data->size < g_maxSize)
         {
@@ -423,8 +448,7 @@ ByteTagList::Deallocate(ByteTagListData* data)
     {
         return;
     }
-    data->count--;
-    if (data->count == 0)
+    if (--data->count == 0)
     {
         uint8_t* buffer = (uint8_t*)data;
         delete[] buffer;
@@ -283,6 +283,17 @@ class ByteTagList
      */
     void Deallocate(ByteTagListData* data);
 
+    /**
+     * \brief Claim the bytes of the shared ByteTagListData after the bytes in use
+     *
+     * The claim fails if another ByteTagList sharing the data already wrote after
+     * the bytes in use of this list.
+     *
+     * \param spaceNeeded the number of bytes in use after the claim
+     * \returns true if the bytes can be written in place
+     */
+    bool ClaimData(uint32_t spaceNeeded);
+
     int32_t m_minStart;      //!< minimal start offset
     int32_t m_maxEnd;        //!< maximal end offset
     int32_t m_adjustment;    //!< adjustment to byte tag offsets
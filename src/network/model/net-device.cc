@@ -20,6 +20,8 @@
 #include "net-device.h"
 
 #include "ns3/log.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/queue-item.h"
 
 namespace ns3
 {
@@ -40,4 +42,23 @@ NetDevice::~NetDevice()
     NS_LOG_FUNCTION(this);
 }
 
+uint32_t
+NetDevice::SendBatch(const std::vector<Ptr<QueueDiscItem>>& items)
+{
+    NS_LOG_FUNCTION(this << items.size());
+    Ptr<NetDeviceQueueInterface> ndqi = GetObject<NetDeviceQueueInterface>();
+    uint32_t n = 0;
+
+    for (const auto& item : items)
+    {
+        if (n > 0 && ndqi && ndqi->GetTxQueue(item->GetTxQueueIndex())->IsStopped())
+        {
+            break;
+        }
+        Send(item->GetPacket(), item->GetAddress(), item->GetProtocol());
+        n++;
+    }
+    return n;
+}
+
 } // namespace ns3
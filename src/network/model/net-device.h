@@ -30,12 +30,14 @@
 #include "ns3/ptr.h"
 
 #include <stdint.h>
+#include <vector>
 
 namespace ns3
 {
 
 class Node;
 class Channel;
+class QueueDiscItem;
 
 /**
  * \ingroup network
@@ -264,6 +266,21 @@ class NetDevice : public Object
                           const Address& source,
                           const Address& dest,
                           uint16_t protocolNumber) = 0;
+    /**
+     * \param items the packets sent from above down to Network Device, each
+     *        along with its destination address and protocol number
+     *
+     *  Called from the traffic control layer to send a batch of packets into
+     *  Network Device. All the packets of a batch are destined to the same
+     *  transmission queue of the device. Packets are consumed in order, until
+     *  such transmission queue is stopped (the first packet is always consumed).
+     *  Devices may override this method to amortize the per-packet overhead of
+     *  Send over the whole batch. The default implementation calls Send for
+     *  each packet.
+     *
+     * \return the number of packets (at the head of the batch) consumed
+     */
+    virtual uint32_t SendBatch(const std::vector<Ptr<QueueDiscItem>>& items);
     /**
      * \returns the node base class which contains this network
      *          interface.
@@ -26,6 +26,10 @@
 
 #include "ns3/type-id.h"
 
+#ifdef NS3_MTP
+#include <atomic>
+#endif
+
 #include <ostream>
 #include <stdint.h>
 
@@ -142,7 +146,11 @@ class PacketTagList
     struct TagData
     {
         TagData* next;   //!< Pointer to next in list
-        uint32_t count;  //!< Number of incoming links
+#ifdef NS3_MTP
+        std::atomic<uint32_t> count; //!< Number of incoming links
+#else
+        uint32_t count; //!< Number of incoming links
+#endif
         TypeId tid;      //!< Type of the tag serialized into #data
         uint32_t size;   //!< Size of the \c data buffer
         uint8_t data[1]; //!< Serialization buffer
@@ -358,8 +366,7 @@ PacketTagList::RemoveAll()
     TagData* prev = nullptr;
     for (TagData* cur = m_next; cur != nullptr; cur = cur->next)
     {
-        cur->count--;
-        if (cur->count > 0)
+        if (--cur->count > 0)
         {
             break;
         }
@@ -15,10 +15,16 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
+#include "ns3/boolean.h"
 #include "ns3/drop-tail-queue.h"
+#include "ns3/object-factory.h"
+#include "ns3/ring-buffer.h"
 #include "ns3/string.h"
 #include "ns3/test.h"
 
+#include <list>
+#include <vector>
+
 using namespace ns3;
 
 /**
@@ -87,6 +93,128 @@ DropTailQueueTestCase::DoRun()
     NS_TEST_EXPECT_MSG_EQ(packet, nullptr, "There are really no packets in there");
 }
 
+/**
+ * \ingroup network-test
+ * \ingroup tests
+ *
+ * RingBuffer unit tests.
+ */
+class RingBufferTestCase : public TestCase
+{
+  public:
+    RingBufferTestCase();
+    void DoRun() override;
+
+  private:
+    /**
+     * Check that the ring buffer stores the same elements as the list
+     * \param buffer the ring buffer
+     * \param list the list
+     */
+    void CheckEqual(const RingBuffer<int>& buffer, const std::list<int>& list);
+};
+
+RingBufferTestCase::RingBufferTestCase()
+    : TestCase("Sanity check on the ring buffer that can be used as the container of queues")
+{
+}
+
+void
+RingBufferTestCase::CheckEqual(const RingBuffer<int>& buffer, const std::list<int>& list)
+{
+    NS_TEST_ASSERT_MSG_EQ(buffer.size(), list.size(), "Unexpected number of elements");
+    auto it = list.begin();
+    for (auto value : buffer)
+    {
+        NS_TEST_EXPECT_MSG_EQ(value, *it++, "Unexpected element");
+    }
+}
+
+void
+RingBufferTestCase::DoRun()
+{
+    RingBuffer<int> buffer;
+    std::list<int> list;
+
+    // make the elements wrap around the end of the array before it grows
+    for (int i = 0; i < 10; i++)
+    {
+        buffer.push_back(i);
+        list.push_back(i);
+    }
+    for (int i = 0; i < 8; i++)
+    {
+        buffer.erase(buffer.begin());
+        list.pop_front();
+    }
+    for (int i = 10; i < 40; i++)
+    {
+        buffer.insert(buffer.end(), i);
+        list.push_back(i);
+    }
+    CheckEqual(buffer, list);
+    NS_TEST_EXPECT_MSG_EQ(buffer.capacity(), 32, "The capacity should have been doubled once");
+
+    // insert and erase elements in the middle and at the ends
+    auto it = buffer.insert(buffer.begin() + 5, 100);
+    NS_TEST_EXPECT_MSG_EQ(*it, 100, "The iterator should point to the inserted element");
+    list.insert(std::next(list.begin(), 5), 100);
+    buffer.insert(buffer.begin(), 101);
+    list.push_front(101);
+    it = buffer.erase(buffer.begin() + 10);
+    NS_TEST_EXPECT_MSG_EQ(*it,
+                          *list.erase(std::next(list.begin(), 10)),
+                          "The iterator should point to the element after the erased one");
+    buffer.pop_back();
+    list.pop_back();
+    CheckEqual(buffer, list);
+
+    buffer.clear();
+    NS_TEST_EXPECT_MSG_EQ(buffer.empty(), true, "The buffer should be empty");
+    NS_TEST_EXPECT_MSG_EQ(buffer.capacity(), 64, "Clearing the buffer should keep its capacity");
+
+    // packets removed from a drop tail queue are no longer referenced by the queue
+    Ptr<Queue<Packet>> queue =
+        CreateObjectWithAttributes<DropTailQueue<Packet>>("RingBuffer", BooleanValue(true));
+    BooleanValue ringBuffer;
+    queue->GetAttribute("RingBuffer", ringBuffer);
+    NS_TEST_EXPECT_MSG_EQ(ringBuffer.Get(), true, "The queue should use a ring buffer");
+    Ptr<Packet> p = Create<Packet>();
+    queue->Enqueue(p);
+    NS_TEST_EXPECT_MSG_EQ(p->GetReferenceCount(), 2, "The queue should reference the packet");
+    queue->Dequeue();
+    NS_TEST_EXPECT_MSG_EQ(p->GetReferenceCount(),
+                          1,
+                          "The queue should not reference a dequeued packet");
+
+    // a queue using a ring buffer behaves as a queue using a list
+    Ptr<Queue<Packet>> listQueue = CreateObjectWithAttributes<DropTailQueue<Packet>>(
+        "MaxSize",
+        StringValue("8p"),
+        "RingBuffer",
+        BooleanValue(false));
+    queue->SetAttribute("MaxSize", StringValue("8p"));
+    std::vector<Ptr<Packet>> packets;
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        packets.push_back(Create<Packet>(i + 1));
+    }
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        bool enqueued = queue->Enqueue(packets[i]);
+        NS_TEST_EXPECT_MSG_EQ(enqueued, listQueue->Enqueue(packets[i]), "Unexpected drop");
+        if (i % 3 == 2)
+        {
+            NS_TEST_EXPECT_MSG_EQ(queue->Dequeue(), listQueue->Dequeue(), "Unexpected packet");
+        }
+    }
+    while (!listQueue->IsEmpty())
+    {
+        NS_TEST_EXPECT_MSG_EQ(queue->Dequeue(), listQueue->Dequeue(), "Unexpected packet");
+    }
+    NS_TEST_EXPECT_MSG_EQ(queue->IsEmpty(), true, "The queue should be empty");
+}
+
 /**
  * \ingroup network-test
  * \ingroup tests
@@ -100,6 +228,7 @@ class DropTailQueueTestSuite : public TestSuite
         : TestSuite("drop-tail-queue", UNIT)
     {
         AddTestCase(new DropTailQueueTestCase(), TestCase::QUICK);
+        AddTestCase(new RingBufferTestCase(), TestCase::QUICK);
     }
 };
 
@@ -20,6 +20,8 @@
 
 #include "queue.h"
 
+#include "ns3/boolean.h"
+
 namespace ns3
 {
 
@@ -27,6 +29,10 @@ namespace ns3
  * \ingroup queue
  *
  * \brief A FIFO packet queue that drops tail-end packets on overflow
+ *
+ * As items are only added at the tail and removed from the head, the queue
+ * can store them in a RingBuffer (see the RingBuffer attribute), which avoids
+ * allocating memory for every enqueued item.
  */
 template <typename Item>
 class DropTailQueue : public Queue<Item>
@@ -57,6 +63,8 @@ class DropTailQueue : public Queue<Item>
     using Queue<Item>::DoDequeue;
     using Queue<Item>::DoRemove;
     using Queue<Item>::DoPeek;
+    using Queue<Item>::SetRingBuffer;
+    using Queue<Item>::IsRingBuffer;
 
     NS_LOG_TEMPLATE_DECLARE; //!< redefinition of the log component
 };
@@ -78,7 +86,14 @@ DropTailQueue<Item>::GetTypeId()
                           "The max queue size",
                           QueueSizeValue(QueueSize("100p")),
                           MakeQueueSizeAccessor(&QueueBase::SetMaxSize, &QueueBase::GetMaxSize),
-                          MakeQueueSizeChecker());
+                          MakeQueueSizeChecker())
+            .AddAttribute("RingBuffer",
+                          "Whether to store the items in a RingBuffer, which does not allocate "
+                          "memory for every item, rather than in a std::list",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&DropTailQueue<Item>::SetRingBuffer,
+                                              &DropTailQueue<Item>::IsRingBuffer),
+                          MakeBooleanChecker());
     return tid;
 }
 
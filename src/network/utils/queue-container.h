@@ -0,0 +1,313 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef QUEUE_CONTAINER_H
+#define QUEUE_CONTAINER_H
+
+#include "ring-buffer.h"
+
+#include "ns3/abort.h"
+
+#include <iterator>
+#include <list>
+#include <type_traits>
+
+namespace ns3
+{
+
+/**
+ * \ingroup queue
+ *
+ * \brief The default container of the items of a Queue
+ *
+ * QueueContainer stores its elements either in a std::list (the default) or
+ * in a RingBuffer, which does not allocate memory for every element. The
+ * storage can be selected at run time while the container is empty, hence
+ * queues of the same type (e.g., the Queue<Packet> of the devices and the
+ * Queue<QueueDiscItem> internal queues of the queue discs) can use either of
+ * them. Its iterators are invalidated as those of the selected storage: with
+ * a RingBuffer, every insertion or removal invalidates all the iterators.
+ *
+ * \tparam T \explicit Type of the elements
+ */
+template <typename T>
+class QueueContainer
+{
+    /**
+     * \brief Bidirectional iterator over the elements of a QueueContainer
+     *
+     * The iterator wraps an iterator of the storage selected for the container.
+     *
+     * \tparam Const whether the iterator is a const iterator
+     */
+    template <bool Const>
+    class IteratorImpl
+    {
+      public:
+        /// Type of the iterator of the std::list storage
+        using ListIterator = std::conditional_t<Const,
+                                                typename std::list<T>::const_iterator,
+                                                typename std::list<T>::iterator>;
+        /// Type of the iterator of the RingBuffer storage
+        using RingIterator = std::conditional_t<Const,
+                                                typename RingBuffer<T>::const_iterator,
+                                                typename RingBuffer<T>::iterator>;
+
+        using iterator_category = std::bidirectional_iterator_tag; //!< iterator category
+        using value_type = T;                                      //!< value type
+        using difference_type = std::ptrdiff_t;                    //!< difference type
+        using pointer = std::conditional_t<Const, const T*, T*>;   //!< pointer type
+        using reference = std::conditional_t<Const, const T&, T&>; //!< reference type
+
+        IteratorImpl() = default;
+
+        /**
+         * Constructor
+         * \param it the iterator of the std::list storage
+         */
+        IteratorImpl(ListIterator it)
+            : m_listIt(it),
+              m_ring(false)
+        {
+        }
+
+        /**
+         * Constructor
+         * \param it the iterator of the RingBuffer storage
+         */
+        IteratorImpl(RingIterator it)
+            : m_ringIt(it),
+              m_ring(true)
+        {
+        }
+
+        /**
+         * Conversion from a non-const iterator to a const iterator
+         * \param other the non-const iterator
+         */
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        IteratorImpl(const IteratorImpl<false>& other)
+            : m_listIt(other.m_listIt),
+              m_ringIt(other.m_ringIt),
+              m_ring(other.m_ring)
+        {
+        }
+
+        /// \return a reference to the element pointed to by this iterator
+        reference operator*() const
+        {
+            return m_ring ? *m_ringIt : *m_listIt;
+        }
+
+        /// \return a pointer to the element pointed to by this iterator
+        pointer operator->() const
+        {
+            return &**this;
+        }
+
+        /// \return the incremented iterator
+        IteratorImpl& operator++()
+        {
+            if (m_ring)
+            {
+                ++m_ringIt;
+            }
+            else
+            {
+                ++m_listIt;
+            }
+            return *this;
+        }
+
+        /// \return the iterator before being incremented
+        IteratorImpl operator++(int)
+        {
+            IteratorImpl tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        /// \return the decremented iterator
+        IteratorImpl& operator--()
+        {
+            if (m_ring)
+            {
+                --m_ringIt;
+            }
+            else
+            {
+                --m_listIt;
+            }
+            return *this;
+        }
+
+        /// \return the iterator before being decremented
+        IteratorImpl operator--(int)
+        {
+            IteratorImpl tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        /**
+         * \param a an iterator
+         * \param b another iterator over the same container
+         * \return whether the two iterators point to the same element
+         */
+        friend bool operator==(const IteratorImpl& a, const IteratorImpl& b)
+        {
+            return a.m_ring ? a.m_ringIt == b.m_ringIt : a.m_listIt == b.m_listIt;
+        }
+
+        /**
+         * \param a an iterator
+         * \param b another iterator over the same container
+         * \return whether the two iterators point to different elements
+         */
+        friend bool operator!=(const IteratorImpl& a, const IteratorImpl& b)
+        {
+            return !(a == b);
+        }
+
+      private:
+        friend class QueueContainer;
+        friend class IteratorImpl<true>;
+
+        ListIterator m_listIt; //!< the iterator of the std::list storage
+        RingIterator m_ringIt; //!< the iterator of the RingBuffer storage
+        bool m_ring{false};    //!< whether the RingBuffer storage is used
+    };
+
+  public:
+    using value_type = T;                      //!< value type
+    using size_type = std::size_t;             //!< size type
+    using difference_type = std::ptrdiff_t;    //!< difference type
+    using reference = T&;                      //!< reference type
+    using const_reference = const T&;          //!< const reference type
+    using iterator = IteratorImpl<false>;      //!< iterator
+    using const_iterator = IteratorImpl<true>; //!< const iterator
+
+    /**
+     * Select the storage of the elements. The container must be empty.
+     * \param ringBuffer whether to store the elements in a RingBuffer rather
+     *                   than in a std::list
+     */
+    void SetRingBuffer(bool ringBuffer)
+    {
+        NS_ABORT_MSG_IF(!empty(), "The storage of a non-empty container cannot be changed");
+        m_useRing = ringBuffer;
+    }
+
+    /// \return whether the elements are stored in a RingBuffer
+    bool IsRingBuffer() const
+    {
+        return m_useRing;
+    }
+
+    /// \return an iterator pointing to the first element
+    iterator begin()
+    {
+        return m_useRing ? iterator(m_ring.begin()) : iterator(m_list.begin());
+    }
+
+    /// \return an iterator pointing past the last element
+    iterator end()
+    {
+        return m_useRing ? iterator(m_ring.end()) : iterator(m_list.end());
+    }
+
+    /// \return a const iterator pointing to the first element
+    const_iterator begin() const
+    {
+        return m_useRing ? const_iterator(m_ring.begin()) : const_iterator(m_list.begin());
+    }
+
+    /// \return a const iterator pointing past the last element
+    const_iterator end() const
+    {
+        return m_useRing ? const_iterator(m_ring.end()) : const_iterator(m_list.end());
+    }
+
+    /// \return a const iterator pointing to the first element
+    const_iterator cbegin() const
+    {
+        return begin();
+    }
+
+    /// \return a const iterator pointing past the last element
+    const_iterator cend() const
+    {
+        return end();
+    }
+
+    /// \return the number of elements in the container
+    size_type size() const
+    {
+        return m_useRing ? m_ring.size() : m_list.size();
+    }
+
+    /// \return whether the container is empty
+    bool empty() const
+    {
+        return m_useRing ? m_ring.empty() : m_list.empty();
+    }
+
+    /**
+     * Insert an element before the given position
+     * \param pos the position before which the element is inserted
+     * \param value the element
+     * \return an iterator pointing to the inserted element
+     */
+    iterator insert(const_iterator pos, T value)
+    {
+        NS_ASSERT(pos.m_ring == m_useRing);
+        if (m_useRing)
+        {
+            return iterator(m_ring.insert(pos.m_ringIt, std::move(value)));
+        }
+        return iterator(m_list.insert(pos.m_listIt, std::move(value)));
+    }
+
+    /**
+     * Remove the element at the given position
+     * \param pos the position of the element to remove
+     * \return an iterator pointing to the element following the removed one
+     */
+    iterator erase(const_iterator pos)
+    {
+        NS_ASSERT(pos.m_ring == m_useRing);
+        if (m_useRing)
+        {
+            return iterator(m_ring.erase(pos.m_ringIt));
+        }
+        return iterator(m_list.erase(pos.m_listIt));
+    }
+
+    /// Remove all the elements of the container
+    void clear()
+    {
+        m_ring.clear();
+        m_list.clear();
+    }
+
+  private:
+    std::list<T> m_list;   //!< the std::list storage
+    RingBuffer<T> m_ring;  //!< the RingBuffer storage
+    bool m_useRing{false}; //!< whether the elements are stored in the RingBuffer
+};
+
+} // namespace ns3
+
+#endif /* QUEUE_CONTAINER_H */
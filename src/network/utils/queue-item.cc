@@ -78,7 +78,11 @@ QueueDiscItem::QueueDiscItem(Ptr<Packet> p, const Address& addr, uint16_t protoc
     : QueueItem(p),
       m_address(addr),
       m_protocol(protocol),
-      m_txq(0)
+      m_txq(0),
+      m_hasFlowHash(false),
+      m_flowHash(0),
+      m_flowHashFunction(0),
+      m_flowHashPerturbation(0)
 {
     NS_LOG_FUNCTION(this << p << addr << protocol);
 }
@@ -146,4 +150,22 @@ QueueDiscItem::Hash(uint32_t perturbation) const
     return 0;
 }
 
+void
+QueueDiscItem::SetFlowHash(uint32_t hash, uint32_t function, uint32_t perturbation)
+{
+    NS_LOG_FUNCTION(this << hash << function << perturbation);
+    m_flowHash = hash;
+    m_flowHashFunction = function;
+    m_flowHashPerturbation = perturbation;
+    m_hasFlowHash = true;
+}
+
+bool
+QueueDiscItem::GetFlowHash(uint32_t& hash, uint32_t function, uint32_t perturbation) const
+{
+    hash = m_flowHash;
+    return m_hasFlowHash && m_flowHashFunction == function &&
+           m_flowHashPerturbation == perturbation;
+}
+
 } // namespace ns3
@@ -217,10 +217,39 @@ class QueueDiscItem : public QueueItem
      */
     virtual uint32_t Hash(uint32_t perturbation = 0) const;
 
+    /**
+     * \brief Store the flow hash computed by a packet filter
+     *
+     * Packet filters may cache the flow hash they compute in the item, so that
+     * queue discs classifying the item again (e.g., nested queue discs) do not
+     * need to compute it again. The hash function and the perturbation are
+     * stored along with the hash, which is only reused by filters computing
+     * the hash in the same way.
+     *
+     * \param hash the flow hash
+     * \param function an identifier of the hash function (e.g., a DRRFlowHashFunction)
+     * \param perturbation the hash perturbation
+     */
+    void SetFlowHash(uint32_t hash, uint32_t function, uint32_t perturbation);
+
+    /**
+     * \brief Get the flow hash stored in this item, if any
+     * \param [out] hash the flow hash stored in this item
+     * \param function an identifier of the hash function
+     * \param perturbation the hash perturbation
+     * \return true if a flow hash computed with the given hash function and
+     *         perturbation is stored in this item, false otherwise
+     */
+    bool GetFlowHash(uint32_t& hash, uint32_t function, uint32_t perturbation) const;
+
   private:
     Address m_address;   //!< MAC destination address
     uint16_t m_protocol; //!< L3 Protocol number
     uint8_t m_txq;       //!< Transmission queue index
+    bool m_hasFlowHash;              //!< Whether a flow hash is stored in this item
+    uint32_t m_flowHash;             //!< The flow hash stored in this item
+    uint32_t m_flowHashFunction;     //!< The function used to compute the flow hash
+    uint32_t m_flowHashPerturbation; //!< The perturbation used to compute the flow hash
     Time m_tstamp;       //!< timestamp when the packet was enqueued
 };
 
@@ -22,6 +22,7 @@
 #ifndef QUEUE_H
 #define QUEUE_H
 
+#include "queue-container.h"
 #include "queue-fwd.h"
 #include "queue-item.h"
 #include "queue-size.h"
@@ -246,7 +247,12 @@ class QueueBase : public Object
  * container used internally to store queue items. The container type must provide
  * the methods insert(), erase() and clear() and define the iterator and const_iterator
  * types, following the usual syntax of C++ containers. The default container type
- * is std::list (as defined in queue-fwd.h). In case the container is such that
+ * is QueueContainer (as defined in queue-fwd.h), which stores the items in a
+ * std::list unless the subclass selects a RingBuffer through SetRingBuffer. A
+ * RingBuffer does not allocate memory for every enqueued item, but should only
+ * be selected by the subclasses that do not need iterators surviving the
+ * insertion or removal of other items (e.g., DropTailQueue, through its
+ * RingBuffer attribute). In case the container is such that
  * an object stored within the queue is obtained from a container element through
  * an operation other than dereferencing an iterator pointing to the container
  * element, the container has to provide a public method named GetItem that
@@ -365,6 +371,21 @@ class Queue : public QueueBase
      */
     Ptr<const Item> DoPeek(ConstIterator pos) const;
 
+    /**
+     * Select whether the items are stored in a RingBuffer rather than in a
+     * std::list. This is only possible while the queue is empty and if the
+     * container is a QueueContainer (the default one). Given that inserting or
+     * removing an item invalidates all the iterators to a RingBuffer, only the
+     * subclasses that do not keep iterators should select it.
+     * \param ringBuffer whether to store the items in a RingBuffer
+     */
+    void SetRingBuffer(bool ringBuffer);
+
+    /**
+     * \return whether the items are stored in a RingBuffer
+     */
+    bool IsRingBuffer() const;
+
     /**
      * \brief Drop a packet before enqueue
      * \param item item that was dropped
@@ -638,6 +659,36 @@ Queue<Item, Container>::DoPeek(ConstIterator pos) const
     return MakeGetItem<Container>::GetItem(m_packets, pos);
 }
 
+template <typename Item, typename Container>
+void
+Queue<Item, Container>::SetRingBuffer(bool ringBuffer)
+{
+    NS_LOG_FUNCTION(this << ringBuffer);
+
+    if constexpr (std::is_same_v<Container, QueueContainer<Ptr<Item>>>)
+    {
+        m_packets.SetRingBuffer(ringBuffer);
+    }
+    else
+    {
+        NS_ABORT_MSG_IF(ringBuffer != IsRingBuffer(), "The container cannot be changed");
+    }
+}
+
+template <typename Item, typename Container>
+bool
+Queue<Item, Container>::IsRingBuffer() const
+{
+    if constexpr (std::is_same_v<Container, QueueContainer<Ptr<Item>>>)
+    {
+        return m_packets.IsRingBuffer();
+    }
+    else
+    {
+        return std::is_same_v<Container, RingBuffer<Ptr<Item>>>;
+    }
+}
+
 template <typename Item, typename Container>
 void
 Queue<Item, Container>::DropBeforeEnqueue(Ptr<Item> item)
@@ -0,0 +1,570 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include "ns3/assert.h"
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup queue
+ * ns3::RingBuffer declaration and implementation.
+ */
+
+namespace ns3
+{
+
+/**
+ * \ingroup queue
+ *
+ * \brief A growable circular buffer
+ *
+ * RingBuffer stores its elements in a contiguous array whose capacity is a power
+ * of two and doubles when the array is full. Hence, adding elements to and removing
+ * elements from both ends of the buffer takes constant time and does not allocate
+ * memory once the buffer has reached its steady state capacity. Elements can also
+ * be inserted or erased in the middle of the buffer, at the cost of moving all the
+ * subsequent elements.
+ *
+ * RingBuffer provides the methods required by the Queue class for a container
+ * (insert(), erase() and clear(), plus the iterator and const_iterator types).
+ * It is one of the storages of QueueContainer, the default container of Queue,
+ * and is selected through the RingBuffer attribute of DropTailQueue. Unlike
+ * std::list, every insertion or removal invalidates all the iterators.
+ *
+ * Removed elements are replaced with a default constructed element, so that the
+ * buffer does not keep references to the objects pointed to by smart pointers.
+ *
+ * \tparam T \explicit Type of the elements stored in the buffer
+ */
+template <typename T>
+class RingBuffer
+{
+    /**
+     * \brief Random access iterator over the elements of a RingBuffer
+     *
+     * The iterator stores the position of the element relative to the first
+     * element of the buffer.
+     *
+     * \tparam Const whether the iterator is a const iterator
+     */
+    template <bool Const>
+    class IteratorImpl
+    {
+      public:
+        /// Type of the buffer
+        using Buffer = std::conditional_t<Const, const RingBuffer, RingBuffer>;
+
+        using iterator_category = std::random_access_iterator_tag; //!< iterator category
+        using value_type = T;                                      //!< value type
+        using difference_type = std::ptrdiff_t;                    //!< difference type
+        using pointer = std::conditional_t<Const, const T*, T*>;   //!< pointer type
+        using reference = std::conditional_t<Const, const T&, T&>; //!< reference type
+
+        IteratorImpl() = default;
+
+        /**
+         * Constructor
+         * \param buffer the buffer
+         * \param index the position relative to the first element of the buffer
+         */
+        IteratorImpl(Buffer* buffer, std::size_t index)
+            : m_buffer(buffer),
+              m_index(index)
+        {
+        }
+
+        /**
+         * Conversion from a non-const iterator to a const iterator
+         * \param other the non-const iterator
+         */
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        IteratorImpl(const IteratorImpl<false>& other)
+            : m_buffer(other.m_buffer),
+              m_index(other.m_index)
+        {
+        }
+
+        /// \return a reference to the element pointed to by this iterator
+        reference operator*() const
+        {
+            return m_buffer->At(m_index);
+        }
+
+        /// \return a pointer to the element pointed to by this iterator
+        pointer operator->() const
+        {
+            return &m_buffer->At(m_index);
+        }
+
+        /**
+         * \param n the offset
+         * \return a reference to the element at the given offset from this iterator
+         */
+        reference operator[](difference_type n) const
+        {
+            return m_buffer->At(m_index + n);
+        }
+
+        /// \return the incremented iterator
+        IteratorImpl& operator++()
+        {
+            ++m_index;
+            return *this;
+        }
+
+        /// \return the iterator before being incremented
+        IteratorImpl operator++(int)
+        {
+            IteratorImpl tmp = *this;
+            ++m_index;
+            return tmp;
+        }
+
+        /// \return the decremented iterator
+        IteratorImpl& operator--()
+        {
+            --m_index;
+            return *this;
+        }
+
+        /// \return the iterator before being decremented
+        IteratorImpl operator--(int)
+        {
+            IteratorImpl tmp = *this;
+            --m_index;
+            return tmp;
+        }
+
+        /**
+         * \param n the offset
+         * \return the advanced iterator
+         */
+        IteratorImpl& operator+=(difference_type n)
+        {
+            m_index += n;
+            return *this;
+        }
+
+        /**
+         * \param n the offset
+         * \return the moved back iterator
+         */
+        IteratorImpl& operator-=(difference_type n)
+        {
+            m_index -= n;
+            return *this;
+        }
+
+        /**
+         * \param n the offset
+         * \return an iterator at the given offset from this iterator
+         */
+        IteratorImpl operator+(difference_type n) const
+        {
+            return IteratorImpl(m_buffer, m_index + n);
+        }
+
+        /**
+         * \param n the offset
+         * \return an iterator at the given negative offset from this iterator
+         */
+        IteratorImpl operator-(difference_type n) const
+        {
+            return IteratorImpl(m_buffer, m_index - n);
+        }
+
+        /**
+         * \param a an iterator
+         * \param b another iterator over the same buffer
+         * \return the distance between the two iterators
+         */
+        friend difference_type operator-(const IteratorImpl& a, const IteratorImpl& b)
+        {
+            return static_cast<difference_type>(a.m_index) -
+                   static_cast<difference_type>(b.m_index);
+        }
+
+        /**
+         * \param a an iterator
+         * \param b another iterator
+         * \return whether the two iterators point to the same element
+         */
+        friend bool operator==(const IteratorImpl& a, const IteratorImpl& b)
+        {
+            return a.m_buffer == b.m_buffer && a.m_index == b.m_index;
+        }
+
+        /**
+         * \param a an iterator
+         * \param b another iterator
+         * \return whether the two iterators point to different elements
+         */
+        friend bool operator!=(const IteratorImpl& a, const IteratorImpl& b)
+        {
+            return !(a == b);
+        }
+
+        /**
+         * \param a an iterator
+         * \param b another iterator over the same buffer
+         * \return whether the first iterator precedes the second one
+         */
+        friend bool operator<(const IteratorImpl& a, const IteratorImpl& b)
+        {
+            return a.m_index < b.m_index;
+        }
+
+        /**
+         * \param a an iterator
+         * \param b another iterator over the same buffer
+         * \return whether the first iterator follows the second one
+         */
+        friend bool operator>(const IteratorImpl& a, const IteratorImpl& b)
+        {
+            return b < a;
+        }
+
+        /**
+         * \param a an iterator
+         * \param b another iterator over the same buffer
+         * \return whether the first iterator does not follow the second one
+         */
+        friend bool operator<=(const IteratorImpl& a, const IteratorImpl& b)
+        {
+            return !(b < a);
+        }
+
+        /**
+         * \param a an iterator
+         * \param b another iterator over the same buffer
+         * \return whether the first iterator does not precede the second one
+         */
+        friend bool operator>=(const IteratorImpl& a, const IteratorImpl& b)
+        {
+            return !(a < b);
+        }
+
+      private:
+        friend class RingBuffer;
+        friend class IteratorImpl<true>;
+
+        Buffer* m_buffer{nullptr}; //!< the buffer
+        std::size_t m_index{0};    //!< the position relative to the first element
+    };
+
+  public:
+    using value_type = T;                      //!< value type
+    using size_type = std::size_t;             //!< size type
+    using difference_type = std::ptrdiff_t;    //!< difference type
+    using reference = T&;                      //!< reference type
+    using const_reference = const T&;          //!< const reference type
+    using iterator = IteratorImpl<false>;      //!< iterator
+    using const_iterator = IteratorImpl<true>; //!< const iterator
+
+    RingBuffer() = default;
+
+    /**
+     * Copy constructor
+     * \param other the buffer to copy
+     */
+    RingBuffer(const RingBuffer& other)
+    {
+        reserve(other.m_size);
+        for (const auto& value : other)
+        {
+            push_back(value);
+        }
+    }
+
+    /**
+     * Copy assignment operator
+     * \param other the buffer to copy
+     * \return a reference to this buffer
+     */
+    RingBuffer& operator=(const RingBuffer& other)
+    {
+        if (this != &other)
+        {
+            clear();
+            reserve(other.m_size);
+            for (const auto& value : other)
+            {
+                push_back(value);
+            }
+        }
+        return *this;
+    }
+
+    /// \return an iterator pointing to the first element
+    iterator begin()
+    {
+        return iterator(this, 0);
+    }
+
+    /// \return an iterator pointing past the last element
+    iterator end()
+    {
+        return iterator(this, m_size);
+    }
+
+    /// \return a const iterator pointing to the first element
+    const_iterator begin() const
+    {
+        return const_iterator(this, 0);
+    }
+
+    /// \return a const iterator pointing past the last element
+    const_iterator end() const
+    {
+        return const_iterator(this, m_size);
+    }
+
+    /// \return a const iterator pointing to the first element
+    const_iterator cbegin() const
+    {
+        return begin();
+    }
+
+    /// \return a const iterator pointing past the last element
+    const_iterator cend() const
+    {
+        return end();
+    }
+
+    /// \return the number of elements in the buffer
+    size_type size() const
+    {
+        return m_size;
+    }
+
+    /// \return whether the buffer is empty
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    /// \return the number of elements the buffer can store without growing
+    size_type capacity() const
+    {
+        return m_elements.size();
+    }
+
+    /**
+     * Make sure that the buffer can store the given number of elements without growing
+     * \param n the number of elements
+     */
+    void reserve(size_type n)
+    {
+        if (n > capacity())
+        {
+            Grow(n);
+        }
+    }
+
+    /// \return a reference to the first element
+    reference front()
+    {
+        NS_ASSERT(m_size > 0);
+        return At(0);
+    }
+
+    /// \return a const reference to the first element
+    const_reference front() const
+    {
+        NS_ASSERT(m_size > 0);
+        return At(0);
+    }
+
+    /// \return a reference to the last element
+    reference back()
+    {
+        NS_ASSERT(m_size > 0);
+        return At(m_size - 1);
+    }
+
+    /// \return a const reference to the last element
+    const_reference back() const
+    {
+        NS_ASSERT(m_size > 0);
+        return At(m_size - 1);
+    }
+
+    /**
+     * Append an element to the end of the buffer
+     * \param value the element
+     */
+    void push_back(T value)
+    {
+        if (m_size == capacity())
+        {
+            Grow(m_size + 1);
+        }
+        At(m_size) = std::move(value);
+        m_size++;
+    }
+
+    /**
+     * Prepend an element to the beginning of the buffer
+     * \param value the element
+     */
+    void push_front(T value)
+    {
+        if (m_size == capacity())
+        {
+            Grow(m_size + 1);
+        }
+        m_head = (m_head + capacity() - 1) & (capacity() - 1);
+        m_elements[m_head] = std::move(value);
+        m_size++;
+    }
+
+    /// Remove the first element of the buffer
+    void pop_front()
+    {
+        NS_ASSERT(m_size > 0);
+        m_elements[m_head] = T();
+        m_head = (m_head + 1) & (capacity() - 1);
+        m_size--;
+    }
+
+    /// Remove the last element of the buffer
+    void pop_back()
+    {
+        NS_ASSERT(m_size > 0);
+        At(m_size - 1) = T();
+        m_size--;
+    }
+
+    /**
+     * Insert an element before the given position
+     * \param pos the position before which the element is inserted
+     * \param value the element
+     * \return an iterator pointing to the inserted element
+     */
+    iterator insert(const_iterator pos, T value)
+    {
+        NS_ASSERT(pos.m_buffer == this && pos.m_index <= m_size);
+        std::size_t index = pos.m_index;
+
+        if (index == 0)
+        {
+            push_front(std::move(value));
+            return begin();
+        }
+
+        push_back(std::move(value));
+        // move the new element to its position
+        for (std::size_t i = m_size - 1; i > index; i--)
+        {
+            std::swap(At(i), At(i - 1));
+        }
+        return iterator(this, index);
+    }
+
+    /**
+     * Remove the element at the given position
+     * \param pos the position of the element to remove
+     * \return an iterator pointing to the element following the removed one
+     */
+    iterator erase(const_iterator pos)
+    {
+        NS_ASSERT(pos.m_buffer == this && pos.m_index < m_size);
+        std::size_t index = pos.m_index;
+
+        if (index == 0)
+        {
+            pop_front();
+            return begin();
+        }
+
+        // move the subsequent elements back by one position
+        for (std::size_t i = index; i + 1 < m_size; i++)
+        {
+            At(i) = std::move(At(i + 1));
+        }
+        pop_back();
+        return iterator(this, index);
+    }
+
+    /// Remove all the elements of the buffer, keeping its capacity
+    void clear()
+    {
+        while (m_size > 0)
+        {
+            pop_back();
+        }
+        m_head = 0;
+    }
+
+  private:
+    /**
+     * \param index the position relative to the first element
+     * \return a reference to the element at the given position
+     */
+    reference At(std::size_t index)
+    {
+        return m_elements[(m_head + index) & (capacity() - 1)];
+    }
+
+    /**
+     * \param index the position relative to the first element
+     * \return a const reference to the element at the given position
+     */
+    const_reference At(std::size_t index) const
+    {
+        return m_elements[(m_head + index) & (capacity() - 1)];
+    }
+
+    /**
+     * Reallocate the array so that it can store at least the given number of elements.
+     * The elements are moved to the beginning of the new array.
+     * \param n the minimum number of elements
+     */
+    void Grow(std::size_t n)
+    {
+        std::size_t newCapacity = (capacity() > 0 ? capacity() : MIN_CAPACITY);
+        while (newCapacity < n)
+        {
+            newCapacity *= 2;
+        }
+
+        std::vector<T> elements(newCapacity);
+        for (std::size_t i = 0; i < m_size; i++)
+        {
+            elements[i] = std::move(At(i));
+        }
+        m_elements.swap(elements);
+        m_head = 0;
+    }
+
+    /// The capacity of the buffer when the first element is added
+    static constexpr std::size_t MIN_CAPACITY = 16;
+
+    std::vector<T> m_elements; //!< the array storing the elements
+    std::size_t m_head{0};     //!< the index of the first element in the array
+    std::size_t m_size{0};     //!< the number of elements
+};
+
+} // namespace ns3
+
+#endif /* RING_BUFFER_H */
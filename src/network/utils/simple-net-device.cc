@@ -19,6 +19,8 @@
 #include "simple-net-device.h"
 
 #include "error-model.h"
+#include "net-device-queue-interface.h"
+#include "queue-item.h"
 #include "queue.h"
 #include "simple-channel.h"
 
@@ -433,14 +435,25 @@ SimpleNetDevice::SendFrom(Ptr<Packet> p,
                           uint16_t protocolNumber)
 {
     NS_LOG_FUNCTION(this << p << source << dest << protocolNumber);
-    if (p->GetSize() > GetMtu())
+
+    return DoSend(p,
+                  Mac48Address::ConvertFrom(source),
+                  Mac48Address::ConvertFrom(dest),
+                  protocolNumber);
+}
+
+bool
+SimpleNetDevice::DoSend(Ptr<Packet> p,
+                        Mac48Address from,
+                        Mac48Address to,
+                        uint16_t protocolNumber)
+{
+    NS_LOG_FUNCTION(this << p << from << to << protocolNumber);
+    if (p->GetSize() > m_mtu)
     {
         return false;
     }
 
-    Mac48Address to = Mac48Address::ConvertFrom(dest);
-    Mac48Address from = Mac48Address::ConvertFrom(source);
-
     SimpleTag tag;
     tag.SetSrc(from);
     tag.SetDst(to);
@@ -460,6 +473,39 @@ SimpleNetDevice::SendFrom(Ptr<Packet> p,
     return false;
 }
 
+uint32_t
+SimpleNetDevice::SendBatch(const std::vector<Ptr<QueueDiscItem>>& items)
+{
+    NS_LOG_FUNCTION(this << items.size());
+
+    // The device queue and the source address are looked up once for the whole
+    // batch, whose packets are all destined to the same device queue. Packets
+    // are consumed as long as the device queue is not stopped, so that a batch
+    // does not overflow the device queue.
+    Ptr<NetDeviceQueue> txq;
+    Ptr<NetDeviceQueueInterface> ndqi = GetObject<NetDeviceQueueInterface>();
+    if (ndqi && !items.empty())
+    {
+        txq = ndqi->GetTxQueue(items[0]->GetTxQueueIndex());
+    }
+    Mac48Address from = Mac48Address::ConvertFrom(m_address);
+
+    uint32_t n = 0;
+    for (const auto& item : items)
+    {
+        if (n > 0 && txq && txq->IsStopped())
+        {
+            break;
+        }
+        n++;
+        DoSend(item->GetPacket(),
+               from,
+               Mac48Address::ConvertFrom(item->GetAddress()),
+               item->GetProtocol());
+    }
+    return n;
+}
+
 void
 SimpleNetDevice::StartTransmission()
 {
@@ -128,6 +128,7 @@ class SimpleNetDevice : public NetDevice
                   const Address& source,
                   const Address& dest,
                   uint16_t protocolNumber) override;
+    uint32_t SendBatch(const std::vector<Ptr<QueueDiscItem>>& items) override;
     Ptr<Node> GetNode() const override;
     void SetNode(Ptr<Node> node) override;
     bool NeedsArp() const override;
@@ -161,6 +162,18 @@ class SimpleNetDevice : public NetDevice
      */
     TracedCallback<Ptr<const Packet>> m_phyRxDropTrace;
 
+    /**
+     * Tag a packet with its source and destination addresses and protocol
+     * number and enqueue it in the device queue, starting its transmission
+     * if the device is idle. Used by both SendFrom and SendBatch.
+     * \param p The packet to send
+     * \param from The source address
+     * \param to The destination address
+     * \param protocolNumber The protocol number
+     * \return true if the packet has been enqueued
+     */
+    bool DoSend(Ptr<Packet> p, Mac48Address from, Mac48Address to, uint16_t protocolNumber);
+
     /**
      * The StartTransmission method is used internally to start the process
      * of sending a packet out on the channel, by scheduling the
@@ -24,7 +24,9 @@
 #include "ns3/llc-snap-header.h"
 #include "ns3/log.h"
 #include "ns3/mac48-address.h"
+#include "ns3/net-device-queue-interface.h"
 #include "ns3/pointer.h"
+#include "ns3/queue-item.h"
 #include "ns3/queue.h"
 #include "ns3/simulator.h"
 #include "ns3/trace-source-accessor.h"
@@ -516,6 +518,14 @@ PointToPointNetDevice::Send(Ptr<Packet> packet, const Address& dest, uint16_t pr
     NS_LOG_LOGIC("p=" << packet << ", dest=" << &dest);
     NS_LOG_LOGIC("UID is " << packet->GetUid());
 
+    return DoSend(packet, protocolNumber);
+}
+
+bool
+PointToPointNetDevice::DoSend(Ptr<Packet> packet, uint16_t protocolNumber)
+{
+    NS_LOG_FUNCTION(this << packet << protocolNumber);
+
     //
     // If IsLinkUp() is false it means there is no channel to send any packet
     // over so we just hit the drop trace on the packet and return an error.
@@ -559,6 +569,35 @@ PointToPointNetDevice::Send(Ptr<Packet> packet, const Address& dest, uint16_t pr
     return false;
 }
 
+uint32_t
+PointToPointNetDevice::SendBatch(const std::vector<Ptr<QueueDiscItem>>& items)
+{
+    NS_LOG_FUNCTION(this << items.size());
+
+    //
+    // The device queue is looked up once for the whole batch. Packets are
+    // consumed as long as the device queue is not stopped, so that a batch
+    // does not overflow the device queue.
+    //
+    Ptr<NetDeviceQueue> txq;
+    if (Ptr<NetDeviceQueueInterface> ndqi = GetObject<NetDeviceQueueInterface>())
+    {
+        txq = ndqi->GetTxQueue(0);
+    }
+
+    uint32_t n = 0;
+    for (const auto& item : items)
+    {
+        if (n > 0 && txq && txq->IsStopped())
+        {
+            break;
+        }
+        n++;
+        DoSend(item->GetPacket(), item->GetProtocol());
+    }
+    return n;
+}
+
 bool
 PointToPointNetDevice::SendFrom(Ptr<Packet> packet,
                                 const Address& source,
@@ -185,6 +185,7 @@ class PointToPointNetDevice : public NetDevice
                   const Address& source,
                   const Address& dest,
                   uint16_t protocolNumber) override;
+    uint32_t SendBatch(const std::vector<Ptr<QueueDiscItem>>& items) override;
 
     Ptr<Node> GetNode() const override;
     void SetNode(Ptr<Node> node) override;
@@ -236,6 +237,19 @@ class PointToPointNetDevice : public NetDevice
      */
     bool ProcessHeader(Ptr<Packet> p, uint16_t& param);
 
+    /**
+     * Add the PPP header to a packet and enqueue it in the device queue, then
+     * start its transmission if the device is ready. The packet is dropped if
+     * the link is down or the device queue is full. Used by both Send and
+     * SendBatch.
+     *
+     * \param packet the packet to send
+     * \param protocolNumber the protocol number of the packet
+     * \returns true if the packet has been enqueued and, if the device was
+     *          ready, its transmission has started
+     */
+    bool DoSend(Ptr<Packet> packet, uint16_t protocolNumber);
+
     /**
      * Start Sending a Packet Down the Wire.
      *
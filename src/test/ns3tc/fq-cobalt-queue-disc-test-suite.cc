@@ -20,6 +20,8 @@
  * Modified by: Bhaskar Kataria <bhaskar.k7920@gmail.com> (COBALT changes)
  */
 
+#include "fq-inline-flow-aqm-test.h"
+
 #include "ns3/cobalt-queue-disc.h"
 #include "ns3/fq-cobalt-queue-disc.h"
 #include "ns3/ipv4-address.h"
@@ -1706,6 +1708,58 @@ FqCobaltQueueDiscL4sMode::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup system-tests-tc
+ *
+ * This test runs the scenario of FqInlineFlowAqmTestCase with FQ-COBALT and checks
+ * that the packets dropped and marked by COBALT are the same in both modes.
+ */
+class FqCobaltQueueDiscInlineFlowAqm : public FqInlineFlowAqmTestCase<FqCobaltQueueDisc>
+{
+  public:
+    FqCobaltQueueDiscInlineFlowAqm();
+
+  private:
+    void CheckAqmStats(const QueueDisc::Stats& childStats,
+                       const QueueDisc::Stats& inlineStats) override;
+};
+
+FqCobaltQueueDiscInlineFlowAqm::FqCobaltQueueDiscInlineFlowAqm()
+    : FqInlineFlowAqmTestCase<FqCobaltQueueDisc>("COBALT")
+{
+}
+
+void
+FqCobaltQueueDiscInlineFlowAqm::CheckAqmStats(const QueueDisc::Stats& childStats,
+                                              const QueueDisc::Stats& inlineStats)
+{
+    // the reasons provided by the child queue discs are prefixed by the parent
+    const std::string childDrop = QueueDisc::CHILD_QUEUE_DISC_DROP;
+    const std::string childMark = QueueDisc::CHILD_QUEUE_DISC_MARK;
+    NS_TEST_EXPECT_MSG_GT(
+        childStats.GetNDroppedPackets(childDrop + CobaltQueueDisc::TARGET_EXCEEDED_DROP),
+        0,
+        "the scenario should cause target exceeded drops");
+    NS_TEST_EXPECT_MSG_EQ(
+        inlineStats.GetNDroppedPackets(CobaltQueueDisc::TARGET_EXCEEDED_DROP),
+        childStats.GetNDroppedPackets(childDrop + CobaltQueueDisc::TARGET_EXCEEDED_DROP),
+        "unexpected number of target exceeded drops");
+    NS_TEST_EXPECT_MSG_GT(childStats.GetNMarkedPackets(childMark + CobaltQueueDisc::FORCED_MARK),
+                          0,
+                          "the scenario should cause forced marks");
+    NS_TEST_EXPECT_MSG_EQ(inlineStats.GetNMarkedPackets(CobaltQueueDisc::FORCED_MARK),
+                          childStats.GetNMarkedPackets(childMark + CobaltQueueDisc::FORCED_MARK),
+                          "unexpected number of forced marks");
+    NS_TEST_EXPECT_MSG_GT(
+        childStats.GetNMarkedPackets(childMark + CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+        0,
+        "the scenario should cause CE threshold marks");
+    NS_TEST_EXPECT_MSG_EQ(
+        inlineStats.GetNMarkedPackets(CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+        childStats.GetNMarkedPackets(childMark + CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+        "unexpected number of CE threshold marks");
+}
+
 /**
  * \ingroup system-tests-tc
  *
@@ -1728,6 +1782,7 @@ FqCobaltQueueDiscTestSuite::FqCobaltQueueDiscTestSuite()
     AddTestCase(new FqCobaltQueueDiscEcnMarking, TestCase::QUICK);
     AddTestCase(new FqCobaltQueueDiscSetLinearProbing, TestCase::QUICK);
     AddTestCase(new FqCobaltQueueDiscL4sMode, TestCase::QUICK);
+    AddTestCase(new FqCobaltQueueDiscInlineFlowAqm, TestCase::QUICK);
 }
 
 /// Do not forget to allocate an instance of this TestSuite.
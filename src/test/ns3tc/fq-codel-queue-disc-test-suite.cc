@@ -18,6 +18,8 @@
  *          Stefano Avallone <stefano.avallone@unina.it>
  */
 
+#include "fq-inline-flow-aqm-test.h"
+
 #include "ns3/codel-queue-disc.h"
 #include "ns3/fq-codel-queue-disc.h"
 #include "ns3/ipv4-address.h"
@@ -1756,6 +1758,60 @@ FqCoDelQueueDiscL4sMode::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup system-tests-tc
+ *
+ * This test runs the scenario of FqInlineFlowAqmTestCase with FQ-CoDel and checks
+ * that the packets dropped and marked by CoDel are the same in both modes.
+ */
+class FqCoDelQueueDiscInlineFlowAqm : public FqInlineFlowAqmTestCase<FqCoDelQueueDisc>
+{
+  public:
+    FqCoDelQueueDiscInlineFlowAqm();
+
+  private:
+    void CheckAqmStats(const QueueDisc::Stats& childStats,
+                       const QueueDisc::Stats& inlineStats) override;
+};
+
+FqCoDelQueueDiscInlineFlowAqm::FqCoDelQueueDiscInlineFlowAqm()
+    : FqInlineFlowAqmTestCase<FqCoDelQueueDisc>("CoDel")
+{
+}
+
+void
+FqCoDelQueueDiscInlineFlowAqm::CheckAqmStats(const QueueDisc::Stats& childStats,
+                                             const QueueDisc::Stats& inlineStats)
+{
+    // the reasons provided by the child queue discs are prefixed by the parent
+    const std::string childDrop = QueueDisc::CHILD_QUEUE_DISC_DROP;
+    const std::string childMark = QueueDisc::CHILD_QUEUE_DISC_MARK;
+    NS_TEST_EXPECT_MSG_GT(
+        childStats.GetNDroppedPackets(childDrop + CoDelQueueDisc::TARGET_EXCEEDED_DROP),
+        0,
+        "the scenario should cause target exceeded drops");
+    NS_TEST_EXPECT_MSG_EQ(
+        inlineStats.GetNDroppedPackets(CoDelQueueDisc::TARGET_EXCEEDED_DROP),
+        childStats.GetNDroppedPackets(childDrop + CoDelQueueDisc::TARGET_EXCEEDED_DROP),
+        "unexpected number of target exceeded drops");
+    NS_TEST_EXPECT_MSG_GT(
+        childStats.GetNMarkedPackets(childMark + CoDelQueueDisc::TARGET_EXCEEDED_MARK),
+        0,
+        "the scenario should cause target exceeded marks");
+    NS_TEST_EXPECT_MSG_EQ(
+        inlineStats.GetNMarkedPackets(CoDelQueueDisc::TARGET_EXCEEDED_MARK),
+        childStats.GetNMarkedPackets(childMark + CoDelQueueDisc::TARGET_EXCEEDED_MARK),
+        "unexpected number of target exceeded marks");
+    NS_TEST_EXPECT_MSG_GT(
+        childStats.GetNMarkedPackets(childMark + CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+        0,
+        "the scenario should cause CE threshold marks");
+    NS_TEST_EXPECT_MSG_EQ(
+        inlineStats.GetNMarkedPackets(CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+        childStats.GetNMarkedPackets(childMark + CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+        "unexpected number of CE threshold marks");
+}
+
 /**
  * \ingroup system-tests-tc
  *
@@ -1778,6 +1834,7 @@ FqCoDelQueueDiscTestSuite::FqCoDelQueueDiscTestSuite()
     AddTestCase(new FqCoDelQueueDiscECNMarking, TestCase::QUICK);
     AddTestCase(new FqCoDelQueueDiscSetLinearProbing, TestCase::QUICK);
     AddTestCase(new FqCoDelQueueDiscL4sMode, TestCase::QUICK);
+    AddTestCase(new FqCoDelQueueDiscInlineFlowAqm, TestCase::QUICK);
 }
 
 /// Do not forget to allocate an instance of this TestSuite.
@@ -0,0 +1,262 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FQ_INLINE_FLOW_AQM_TEST_H
+#define FQ_INLINE_FLOW_AQM_TEST_H
+
+#include "ns3/boolean.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-queue-disc-item.h"
+#include "ns3/nstime.h"
+#include "ns3/queue-disc.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup system-tests-tc
+ *
+ * This test checks that embedding the AQM state of each flow in a flow queue disc
+ * (InlineFlowAqm attribute) does not change the behavior of the queue disc: the same
+ * packets are dequeued, dropped and marked as when a child queue disc is created per
+ * flow. The scenario is shared by the FQ-CoDel, FQ-PIE and FQ-COBALT test suites,
+ * which check the drops and marks specific to their AQM algorithm in CheckAqmStats.
+ *
+ * \tparam FqQueueDisc the flow queue disc under test
+ */
+template <typename FqQueueDisc>
+class FqInlineFlowAqmTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param aqm The name of the AQM algorithm used by the flow queues
+     */
+    FqInlineFlowAqmTestCase(const std::string& aqm);
+
+  protected:
+    /**
+     * Set the attributes specific to the AQM algorithm, before the queue disc is
+     * initialized.
+     * \param queueDisc The queue disc.
+     */
+    virtual void SetAqmAttributes(Ptr<FqQueueDisc> queueDisc)
+    {
+    }
+
+    /**
+     * Check the drops and marks specific to the AQM algorithm.
+     * \param childStats The statistics collected with a child queue disc per flow.
+     * \param inlineStats The statistics collected with the AQM state of the flows embedded.
+     */
+    virtual void CheckAqmStats(const QueueDisc::Stats& childStats,
+                               const QueueDisc::Stats& inlineStats) = 0;
+
+  private:
+    void DoRun() override;
+    /**
+     * Enqueue some packets.
+     * \param queue The queue disc.
+     * \param hdr The IPv4 header.
+     * \param nPkt The number of packets to enqueue.
+     */
+    void AddPacket(Ptr<FqQueueDisc> queue, Ipv4Header hdr, uint32_t nPkt);
+    /**
+     * Dequeue a packet and record its identification and ECN codepoint.
+     * \param queue The queue disc.
+     * \param trace The trace of dequeued packets.
+     */
+    void Dequeue(Ptr<FqQueueDisc> queue, std::vector<uint32_t>* trace);
+    /**
+     * Run the scenario with the given value of the InlineFlowAqm attribute.
+     * \param inlineAqm The value of the InlineFlowAqm attribute.
+     * \param trace The trace of dequeued packets.
+     * \return The statistics of the queue disc.
+     */
+    QueueDisc::Stats RunScenario(bool inlineAqm, std::vector<uint32_t>* trace);
+
+    uint16_t m_id; //!< Identification of the next enqueued packet
+};
+
+template <typename FqQueueDisc>
+FqInlineFlowAqmTestCase<FqQueueDisc>::FqInlineFlowAqmTestCase(const std::string& aqm)
+    : TestCase("Test that embedding the " + aqm + " state of the flows does not change the " +
+               "behavior"),
+      m_id(0)
+{
+}
+
+template <typename FqQueueDisc>
+void
+FqInlineFlowAqmTestCase<FqQueueDisc>::AddPacket(Ptr<FqQueueDisc> queue,
+                                                Ipv4Header hdr,
+                                                uint32_t nPkt)
+{
+    Address dest;
+    for (uint32_t i = 0; i < nPkt; i++)
+    {
+        hdr.SetIdentification(m_id++);
+        Ptr<Packet> p = Create<Packet>(100);
+        Ptr<Ipv4QueueDiscItem> item = Create<Ipv4QueueDiscItem>(p, dest, 0, hdr);
+        queue->Enqueue(item);
+    }
+}
+
+template <typename FqQueueDisc>
+void
+FqInlineFlowAqmTestCase<FqQueueDisc>::Dequeue(Ptr<FqQueueDisc> queue,
+                                              std::vector<uint32_t>* trace)
+{
+    Ptr<const Ipv4QueueDiscItem> item = DynamicCast<const Ipv4QueueDiscItem>(queue->Dequeue());
+    if (item)
+    {
+        trace->push_back(item->GetHeader().GetIdentification() << 2 | item->GetHeader().GetEcn());
+    }
+}
+
+template <typename FqQueueDisc>
+QueueDisc::Stats
+FqInlineFlowAqmTestCase<FqQueueDisc>::RunScenario(bool inlineAqm, std::vector<uint32_t>* trace)
+{
+    m_id = 0;
+    Ptr<FqQueueDisc> queueDisc =
+        CreateObjectWithAttributes<FqQueueDisc>("MaxSize",
+                                                StringValue("200p"),
+                                                "UseEcn",
+                                                BooleanValue(true),
+                                                "CeThreshold",
+                                                TimeValue(MilliSeconds(50)),
+                                                "UseL4s",
+                                                BooleanValue(true),
+                                                "Perturbation",
+                                                UintegerValue(0),
+                                                "InlineFlowAqm",
+                                                BooleanValue(inlineAqm));
+    queueDisc->SetQuantum(1514);
+    SetAqmAttributes(queueDisc);
+    queueDisc->Initialize();
+
+    Ipv4Header hdr;
+    hdr.SetPayloadSize(100);
+    hdr.SetSource(Ipv4Address("10.10.1.1"));
+    hdr.SetProtocol(7);
+
+    // An L4S flow, two ECN capable flows and two non ECN capable flows exceed the queue
+    // disc limit, then each of them sends a second burst while the queues are draining
+    // and a third burst after the queues have been idle for a while
+    const Ipv4Header::EcnType ecn[] = {Ipv4Header::ECN_ECT1,
+                                       Ipv4Header::ECN_ECT0,
+                                       Ipv4Header::ECN_ECT0,
+                                       Ipv4Header::ECN_NotECT,
+                                       Ipv4Header::ECN_NotECT};
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        hdr.SetDestination(Ipv4Address(0x0a0a0102 + i));
+        hdr.SetEcn(ecn[i]);
+        Simulator::Schedule(Seconds(0),
+                            &FqInlineFlowAqmTestCase::AddPacket,
+                            this,
+                            queueDisc,
+                            hdr,
+                            50);
+        Simulator::Schedule(MilliSeconds(100 + 10 * i),
+                            &FqInlineFlowAqmTestCase::AddPacket,
+                            this,
+                            queueDisc,
+                            hdr,
+                            20);
+        Simulator::Schedule(MilliSeconds(1000 + 10 * i),
+                            &FqInlineFlowAqmTestCase::AddPacket,
+                            this,
+                            queueDisc,
+                            hdr,
+                            40);
+    }
+
+    for (uint32_t i = 1; i <= 400; i++)
+    {
+        Simulator::Schedule(MilliSeconds(i),
+                            &FqInlineFlowAqmTestCase::Dequeue,
+                            this,
+                            queueDisc,
+                            trace);
+        Simulator::Schedule(MilliSeconds(1000 + i),
+                            &FqInlineFlowAqmTestCase::Dequeue,
+                            this,
+                            queueDisc,
+                            trace);
+    }
+
+    Simulator::Stop(MilliSeconds(1500));
+    Simulator::Run();
+    Simulator::Destroy();
+
+    NS_TEST_EXPECT_MSG_EQ(queueDisc->GetNQueueDiscClasses(),
+                          (inlineAqm ? 0 : 5),
+                          "unexpected number of flow queues");
+    NS_TEST_EXPECT_MSG_EQ(queueDisc->GetNPackets(), 0, "all the packets should have been dequeued");
+    return queueDisc->GetStats();
+}
+
+template <typename FqQueueDisc>
+void
+FqInlineFlowAqmTestCase<FqQueueDisc>::DoRun()
+{
+    std::vector<uint32_t> childTrace;
+    std::vector<uint32_t> inlineTrace;
+    QueueDisc::Stats childStats = RunScenario(false, &childTrace);
+    QueueDisc::Stats inlineStats = RunScenario(true, &inlineTrace);
+
+    NS_TEST_EXPECT_MSG_GT(childStats.GetNDroppedPackets(FqQueueDisc::OVERLIMIT_DROP),
+                          0,
+                          "the scenario should overflow the queue disc");
+    NS_TEST_EXPECT_MSG_GT(childStats.nTotalMarkedPackets, 0, "the scenario should mark packets");
+    NS_TEST_EXPECT_MSG_EQ(inlineStats.nTotalReceivedPackets,
+                          childStats.nTotalReceivedPackets,
+                          "unexpected number of received packets");
+    NS_TEST_EXPECT_MSG_EQ(inlineStats.nTotalDroppedPacketsBeforeEnqueue,
+                          childStats.nTotalDroppedPacketsBeforeEnqueue,
+                          "unexpected number of packets dropped before enqueue");
+    NS_TEST_EXPECT_MSG_EQ(inlineStats.nTotalDroppedPacketsAfterDequeue,
+                          childStats.nTotalDroppedPacketsAfterDequeue,
+                          "unexpected number of packets dropped after dequeue");
+    NS_TEST_EXPECT_MSG_EQ(inlineStats.GetNDroppedPackets(FqQueueDisc::OVERLIMIT_DROP),
+                          childStats.GetNDroppedPackets(FqQueueDisc::OVERLIMIT_DROP),
+                          "unexpected number of overlimit drops");
+    NS_TEST_EXPECT_MSG_EQ(inlineStats.nTotalMarkedPackets,
+                          childStats.nTotalMarkedPackets,
+                          "unexpected number of marked packets");
+    NS_TEST_EXPECT_MSG_EQ(inlineStats.nTotalDequeuedPackets,
+                          childStats.nTotalDequeuedPackets,
+                          "unexpected number of dequeued packets");
+    NS_TEST_EXPECT_MSG_EQ((inlineTrace == childTrace),
+                          true,
+                          "the packets have not been dequeued in the same order");
+
+    CheckAqmStats(childStats, inlineStats);
+}
+
+} // namespace ns3
+
+#endif /* FQ_INLINE_FLOW_AQM_TEST_H */
@@ -25,6 +25,9 @@
  *
  */
 
+#include "fq-inline-flow-aqm-test.h"
+
+#include "ns3/double.h"
 #include "ns3/fq-pie-queue-disc.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv4-header.h"
@@ -1148,6 +1151,61 @@ FqPieQueueDiscL4sMode::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup system-tests-tc
+ *
+ * This test runs the scenario of FqInlineFlowAqmTestCase with FQ-PIE and checks
+ * that the packets dropped and marked by PIE are the same in both modes.
+ */
+class FqPieQueueDiscInlineFlowAqm : public FqInlineFlowAqmTestCase<FqPieQueueDisc>
+{
+  public:
+    FqPieQueueDiscInlineFlowAqm();
+
+  private:
+    void SetAqmAttributes(Ptr<FqPieQueueDisc> queueDisc) override;
+    void CheckAqmStats(const QueueDisc::Stats& childStats,
+                       const QueueDisc::Stats& inlineStats) override;
+};
+
+FqPieQueueDiscInlineFlowAqm::FqPieQueueDiscInlineFlowAqm()
+    : FqInlineFlowAqmTestCase<FqPieQueueDisc>("PIE")
+{
+}
+
+void
+FqPieQueueDiscInlineFlowAqm::SetAqmAttributes(Ptr<FqPieQueueDisc> queueDisc)
+{
+    // without the delay trend term, the drop probability does not drop to zero as
+    // soon as the queues are empty, and it decays while the flows are idle
+    queueDisc->SetAttribute("A", DoubleValue(0.5));
+    queueDisc->SetAttribute("B", DoubleValue(0));
+    queueDisc->SetAttribute("MaxBurstAllowance", TimeValue(Seconds(0)));
+}
+
+void
+FqPieQueueDiscInlineFlowAqm::CheckAqmStats(const QueueDisc::Stats& childStats,
+                                           const QueueDisc::Stats& inlineStats)
+{
+    // the reasons provided by the child queue discs are prefixed by the parent
+    const std::string childDrop = QueueDisc::CHILD_QUEUE_DISC_DROP;
+    const std::string childMark = QueueDisc::CHILD_QUEUE_DISC_MARK;
+    NS_TEST_EXPECT_MSG_EQ(inlineStats.GetNDroppedPackets(PieQueueDisc::UNFORCED_DROP),
+                          childStats.GetNDroppedPackets(childDrop + PieQueueDisc::UNFORCED_DROP),
+                          "unexpected number of unforced drops");
+    NS_TEST_EXPECT_MSG_EQ(inlineStats.GetNMarkedPackets(PieQueueDisc::UNFORCED_MARK),
+                          childStats.GetNMarkedPackets(childMark + PieQueueDisc::UNFORCED_MARK),
+                          "unexpected number of unforced marks");
+    NS_TEST_EXPECT_MSG_GT(
+        childStats.GetNMarkedPackets(childMark + PieQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+        0,
+        "the scenario should cause CE threshold marks");
+    NS_TEST_EXPECT_MSG_EQ(
+        inlineStats.GetNMarkedPackets(PieQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+        childStats.GetNMarkedPackets(childMark + PieQueueDisc::CE_THRESHOLD_EXCEEDED_MARK),
+        "unexpected number of CE threshold marks");
+}
+
 /**
  * \ingroup system-tests-tc
  *
@@ -1169,6 +1227,7 @@ FqPieQueueDiscTestSuite::FqPieQueueDiscTestSuite()
     AddTestCase(new FqPieQueueDiscUDPFlowsSeparation, TestCase::QUICK);
     AddTestCase(new FqPieQueueDiscSetLinearProbing, TestCase::QUICK);
     AddTestCase(new FqPieQueueDiscL4sMode, TestCase::QUICK);
+    AddTestCase(new FqPieQueueDiscInlineFlowAqm, TestCase::QUICK);
 }
 
 /// Do not forget to allocate an instance of this TestSuite.
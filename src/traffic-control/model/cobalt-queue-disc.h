@@ -46,6 +46,7 @@ namespace ns3
 #define DEFAULT_COBALT_LIMIT 1000
 
 class TraceContainer;
+class CobaltFlowAqm;
 
 /**
  * \ingroup traffic-control
@@ -151,80 +152,6 @@ class CobaltQueueDisc : public QueueDisc
      */
     void InitializeParams() override;
 
-    /**
-     * \brief Calculate the reciprocal square root of m_count by using Newton's method
-     *  http://en.wikipedia.org/wiki/Methods_of_computing_square_roots#Iterative_methods_for_reciprocal_square_roots
-     * m_recInvSqrt (new) = (m_recInvSqrt (old) / 2) * (3 - m_count * m_recInvSqrt^2)
-     */
-    void NewtonStep();
-
-    /**
-     * \brief Determine the time for next drop
-     * CoDel control law is t + m_interval/sqrt(m_count).
-     * Here, we use m_recInvSqrt calculated by Newton's method in NewtonStep() to avoid
-     * both sqrt() and divide operations
-     *
-     * \param t Current next drop time
-     * \returns The new next drop time:
-     */
-    int64_t ControlLaw(int64_t t);
-
-    /**
-     * \brief Updates the inverse square root
-     */
-    void InvSqrt();
-
-    /**
-     * There is a big difference in timing between the accurate values placed in
-     * the cache and the approximations given by a single Newton step for small
-     * count values, particularly when stepping from count 1 to 2 or vice versa.
-     * Above 16, a single Newton step gives sufficient accuracy in either
-     * direction, given the precision stored.
-     *
-     * The magnitude of the error when stepping up to count 2 is such as to give
-     * the value that *should* have been produced at count 4.
-     */
-    void CacheInit();
-
-    /**
-     * Check if CoDel time a is successive to b
-     * @param a left operand
-     * @param b right operand
-     * @return true if a is greater than b
-     */
-
-    bool CoDelTimeAfter(int64_t a, int64_t b);
-
-    /**
-     * Check if CoDel time a is successive or equal to b
-     * @param a left operand
-     * @param b right operand
-     * @return true if a is greater than or equal to b
-     */
-    bool CoDelTimeAfterEq(int64_t a, int64_t b);
-
-    /**
-     * Called when the queue becomes full to alter the drop probabilities of Blue
-     * \param now time in CoDel time units (microseconds)
-     */
-    void CobaltQueueFull(int64_t now);
-
-    /**
-     * Called when the queue becomes empty to alter the drop probabilities of Blue
-     * \param now time in CoDel time units (microseconds)
-     */
-    void CobaltQueueEmpty(int64_t now);
-
-    /**
-     * Called to decide whether the current packet should be dropped based on decisions taken by
-     * Blue and Codel working parallelly
-     *
-     * \return true if the packet should be dropped, false otherwise
-     * \param item current packet
-     * \param now time in CoDel time units (microseconds)
-     */
-    bool CobaltShouldDrop(Ptr<QueueDiscItem> item, int64_t now);
-
     // Common to CoDel and Blue
     // Maintained by Cobalt
     Stats m_stats; //!< Cobalt statistics
@@ -235,8 +162,6 @@ class CobaltQueueDisc : public QueueDisc
     TracedValue<int64_t> m_dropNext; //!< Time to drop next packet
     TracedValue<bool> m_dropping;    //!< True if in dropping state
     uint32_t m_recInvSqrt;           //!< Reciprocal inverse square root
-    uint32_t m_recInvSqrtCache[REC_INV_SQRT_CACHE] = {
-        0}; //!< Cache to maintain some initial values of InvSqrt
 
     // Supplied by user
     Time m_interval;      //!< sliding minimum time window width
@@ -248,13 +173,14 @@ class CobaltQueueDisc : public QueueDisc
 
     // Blue parameters
     // Maintained by Cobalt
-    Ptr<UniformRandomVariable> m_uv; //!< Rng stream
-    uint32_t m_lastUpdateTimeBlue;   //!< Blue's last update time for drop probability
+    uint32_t m_lastUpdateTimeBlue; //!< Blue's last update time for drop probability
 
     // Supplied by user
     double m_increment; //!< increment value for marking probability
     double m_decrement; //!< decrement value for marking probability
     double m_pDrop;     //!< Drop Probability
+
+    Ptr<CobaltFlowAqm> m_flowAqm; //!< The control law, run on the variables above
 };
 
 } // namespace ns3
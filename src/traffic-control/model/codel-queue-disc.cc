@@ -27,6 +27,8 @@
 
 #include "codel-queue-disc.h"
 
+#include "flow-aqm.h"
+
 #include "ns3/abort.h"
 #include "ns3/drop-tail-queue.h"
 #include "ns3/enum.h"
@@ -55,19 +57,6 @@ ReciprocalDivide(uint32_t A, uint32_t R)
 
 /* end kernel borrowings */
 
-/**
- * Returns the current time translated in CoDel time representation
- * \return the current time
- */
-static uint32_t
-CoDelGetTime()
-{
-    Time time = Simulator::Now();
-    uint64_t ns = time.GetNanoSeconds();
-
-    return static_cast<uint32_t>(ns >> CODEL_SHIFT);
-}
-
 NS_OBJECT_ENSURE_REGISTERED(CoDelQueueDisc);
 
 TypeId
@@ -144,6 +133,7 @@ CoDelQueueDisc::CoDelQueueDisc()
       m_dropNext(0)
 {
     NS_LOG_FUNCTION(this);
+    m_flowAqm = CreateObject<CoDelFlowAqm>();
 }
 
 CoDelQueueDisc::~CoDelQueueDisc()
@@ -151,6 +141,14 @@ CoDelQueueDisc::~CoDelQueueDisc()
     NS_LOG_FUNCTION(this);
 }
 
+void
+CoDelQueueDisc::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_flowAqm = nullptr;
+    QueueDisc::DoDispose();
+}
+
 uint16_t
 CoDelQueueDisc::NewtonStep(uint16_t recInvSqrt, uint32_t count)
 {
@@ -194,228 +192,18 @@ CoDelQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
     return retval;
 }
 
-bool
-CoDelQueueDisc::OkToDrop(Ptr<QueueDiscItem> item, uint32_t now)
-{
-    NS_LOG_FUNCTION(this);
-    bool okToDrop;
-
-    if (!item)
-    {
-        m_firstAboveTime = 0;
-        return false;
-    }
-
-    Time delta = Simulator::Now() - item->GetTimeStamp();
-    NS_LOG_INFO("Sojourn time " << delta.As(Time::MS));
-    uint32_t sojournTime = Time2CoDel(delta);
-
-    if (CoDelTimeBefore(sojournTime, Time2CoDel(m_target)) ||
-        GetInternalQueue(0)->GetNBytes() < m_minBytes)
-    {
-        // went below so we'll stay below for at least q->interval
-        NS_LOG_LOGIC("Sojourn time is below target or number of bytes in queue is less than "
-                     "minBytes; packet should not be dropped");
-        m_firstAboveTime = 0;
-        return false;
-    }
-    okToDrop = false;
-    if (m_firstAboveTime == 0)
-    {
-        /* just went above from below. If we stay above
-         * for at least q->interval we'll say it's ok to drop
-         */
-        NS_LOG_LOGIC("Sojourn time has just gone above target from below, need to stay above for "
-                     "at least q->interval before packet can be dropped. ");
-        m_firstAboveTime = now + Time2CoDel(m_interval);
-    }
-    else if (CoDelTimeAfter(now, m_firstAboveTime))
-    {
-        NS_LOG_LOGIC("Sojourn time has been above target for at least q->interval; it's OK to "
-                     "(possibly) drop packet.");
-        okToDrop = true;
-    }
-    return okToDrop;
-}
-
 Ptr<QueueDiscItem>
 CoDelQueueDisc::DoDequeue()
 {
     NS_LOG_FUNCTION(this);
 
-    Ptr<QueueDiscItem> item = GetInternalQueue(0)->Dequeue();
-    if (!item)
-    {
-        // Leave dropping state when queue is empty
-        m_dropping = false;
-        NS_LOG_LOGIC("Queue empty");
-        return nullptr;
-    }
-    uint32_t ldelay = Time2CoDel(Simulator::Now() - item->GetTimeStamp());
-    if (item && m_useL4s)
-    {
-        uint8_t tosByte = 0;
-        if (item->GetUint8Value(QueueItem::IP_DSFIELD, tosByte) &&
-            (((tosByte & 0x3) == 1) || (tosByte & 0x3) == 3))
-        {
-            if ((tosByte & 0x3) == 1)
-            {
-                NS_LOG_DEBUG("ECT1 packet " << static_cast<uint16_t>(tosByte & 0x3));
-            }
-            else
-            {
-                NS_LOG_DEBUG("CE packet " << static_cast<uint16_t>(tosByte & 0x3));
-            }
-
-            if (CoDelTimeAfter(ldelay, Time2CoDel(m_ceThreshold)) &&
-                Mark(item, CE_THRESHOLD_EXCEEDED_MARK))
-            {
-                NS_LOG_LOGIC("Marking due to CeThreshold " << m_ceThreshold.GetSeconds());
-            }
-            return item;
-        }
-    }
-
-    uint32_t now = CoDelGetTime();
-
-    NS_LOG_LOGIC("Popped " << item);
-    NS_LOG_LOGIC("Number packets remaining " << GetInternalQueue(0)->GetNPackets());
-    NS_LOG_LOGIC("Number bytes remaining " << GetInternalQueue(0)->GetNBytes());
-
-    // Determine if item should be dropped
-    bool okToDrop = OkToDrop(item, now);
-    bool isMarked = false;
-
-    if (m_dropping)
-    { // In the dropping state (sojourn time has gone above target and hasn't come down yet)
-        // Check if we can leave the dropping state or next drop should occur
-        NS_LOG_LOGIC("In dropping state, check if it's OK to leave or next drop should occur");
-        if (!okToDrop)
-        {
-            /* sojourn time fell below target - leave dropping state */
-            NS_LOG_LOGIC("Sojourn time goes below target, it's OK to leave dropping state.");
-            m_dropping = false;
-        }
-        else if (CoDelTimeAfterEq(now, m_dropNext))
-        {
-            while (m_dropping && CoDelTimeAfterEq(now, m_dropNext))
-            {
-                ++m_count;
-                m_recInvSqrt = NewtonStep(m_recInvSqrt, m_count);
-                // It's time for the next drop. Drop the current packet and
-                // dequeue the next. The dequeue might take us out of dropping
-                // state. If not, schedule the next drop.
-                // A large amount of packets in queue might result in drop
-                // rates so high that the next drop should happen now,
-                // hence the while loop.
-                if (m_useEcn && Mark(item, TARGET_EXCEEDED_MARK))
-                {
-                    isMarked = true;
-                    NS_LOG_LOGIC("Sojourn time is still above target and it's time for next drop "
-                                 "or mark; marking "
-                                 << item);
-                    NS_LOG_LOGIC("Running ControlLaw for input m_dropNext: " << (double)m_dropNext /
-                                                                                    1000000);
-                    m_dropNext = ControlLaw(now, Time2CoDel(m_interval), m_recInvSqrt);
-                    NS_LOG_LOGIC("Scheduled next drop at " << (double)m_dropNext / 1000000);
-                    goto end;
-                }
-                NS_LOG_LOGIC(
-                    "Sojourn time is still above target and it's time for next drop; dropping "
-                    << item);
-                DropAfterDequeue(item, TARGET_EXCEEDED_DROP);
-
-                item = GetInternalQueue(0)->Dequeue();
-
-                if (item)
-                {
-                    NS_LOG_LOGIC("Popped " << item);
-                    NS_LOG_LOGIC("Number packets remaining " << GetInternalQueue(0)->GetNPackets());
-                    NS_LOG_LOGIC("Number bytes remaining " << GetInternalQueue(0)->GetNBytes());
-                }
-
-                if (!OkToDrop(item, now))
-                {
-                    /* leave dropping state */
-                    NS_LOG_LOGIC("Leaving dropping state");
-                    m_dropping = false;
-                }
-                else
-                {
-                    /* schedule the next drop */
-                    NS_LOG_LOGIC("Running ControlLaw for input m_dropNext: " << (double)m_dropNext /
-                                                                                    1000000);
-                    m_dropNext = ControlLaw(m_dropNext, Time2CoDel(m_interval), m_recInvSqrt);
-                    NS_LOG_LOGIC("Scheduled next drop at " << (double)m_dropNext / 1000000);
-                }
-            }
-        }
-    }
-    else
-    {
-        // Not in the dropping state
-        // Decide if we have to enter the dropping state and drop the first packet
-        NS_LOG_LOGIC("Not in dropping state; decide if we have to enter the state and drop the "
-                     "first packet");
-        if (okToDrop)
-        {
-            if (m_useEcn && Mark(item, TARGET_EXCEEDED_MARK))
-            {
-                isMarked = true;
-                NS_LOG_LOGIC("Sojourn time goes above target, marking the first packet "
-                             << item << " and entering the dropping state");
-            }
-            else
-            {
-                // Drop the first packet and enter dropping state unless the queue is empty
-                NS_LOG_LOGIC("Sojourn time goes above target, dropping the first packet "
-                             << item << " and entering the dropping state");
-                DropAfterDequeue(item, TARGET_EXCEEDED_DROP);
-                item = GetInternalQueue(0)->Dequeue();
-                if (item)
-                {
-                    NS_LOG_LOGIC("Popped " << item);
-                    NS_LOG_LOGIC("Number packets remaining " << GetInternalQueue(0)->GetNPackets());
-                    NS_LOG_LOGIC("Number bytes remaining " << GetInternalQueue(0)->GetNBytes());
-                }
-                OkToDrop(item, now);
-            }
-            m_dropping = true;
-            /*
-             * if min went above target close to when we last went below it
-             * assume that the drop rate that controlled the queue on the
-             * last cycle is a good starting point to control it now.
-             */
-            int delta = m_count - m_lastCount;
-            if (delta > 1 && CoDelTimeBefore(now - m_dropNext, 16 * Time2CoDel(m_interval)))
-            {
-                m_count = delta;
-                m_recInvSqrt = NewtonStep(m_recInvSqrt, m_count);
-            }
-            else
-            {
-                m_count = 1;
-                m_recInvSqrt = ~0U >> REC_INV_SQRT_SHIFT;
-            }
-            m_lastCount = m_count;
-            NS_LOG_LOGIC("Running ControlLaw for input now: " << (double)now);
-            m_dropNext = ControlLaw(now, Time2CoDel(m_interval), m_recInvSqrt);
-            NS_LOG_LOGIC("Scheduled next drop at " << (double)m_dropNext / 1000000 << " now "
-                                                   << (double)now / 1000000);
-        }
-    }
-end:
-    ldelay = Time2CoDel(Simulator::Now() - item->GetTimeStamp());
-    // In Linux, this branch of code is executed even if the packet has been marked
-    // according to the target delay above. If the ns-3 code were to do the same here,
-    // it would result in two counts of mark in the queue statistics. Therefore, we
-    // use the isMarked flag to suppress a second attempt at marking.
-    if (!isMarked && item && !m_useL4s && m_useEcn &&
-        CoDelTimeAfter(ldelay, Time2CoDel(m_ceThreshold)) && Mark(item, CE_THRESHOLD_EXCEEDED_MARK))
-    {
-        NS_LOG_LOGIC("Marking due to CeThreshold " << m_ceThreshold.GetSeconds());
-    }
-    return item;
+    CoDelFlowAqm::QueueDiscState state{m_count,
+                                       m_lastCount,
+                                       m_firstAboveTime,
+                                       m_dropNext,
+                                       m_recInvSqrt,
+                                       m_dropping};
+    return m_flowAqm->Dequeue(state, *GetInternalQueue(0));
 }
 
 Time
@@ -436,30 +224,6 @@ CoDelQueueDisc::GetDropNext()
     return m_dropNext;
 }
 
-bool
-CoDelQueueDisc::CoDelTimeAfter(uint32_t a, uint32_t b)
-{
-    return ((int64_t)(a) - (int64_t)(b) > 0);
-}
-
-bool
-CoDelQueueDisc::CoDelTimeAfterEq(uint32_t a, uint32_t b)
-{
-    return ((int64_t)(a) - (int64_t)(b) >= 0);
-}
-
-bool
-CoDelQueueDisc::CoDelTimeBefore(uint32_t a, uint32_t b)
-{
-    return ((int64_t)(a) - (int64_t)(b) < 0);
-}
-
-bool
-CoDelQueueDisc::CoDelTimeBeforeEq(uint32_t a, uint32_t b)
-{
-    return ((int64_t)(a) - (int64_t)(b) <= 0);
-}
-
 uint32_t
 CoDelQueueDisc::Time2CoDel(Time t)
 {
@@ -503,6 +267,14 @@ void
 CoDelQueueDisc::InitializeParams()
 {
     NS_LOG_FUNCTION(this);
+    m_flowAqm->SetAttribute("UseEcn", BooleanValue(m_useEcn));
+    m_flowAqm->SetAttribute("UseL4s", BooleanValue(m_useL4s));
+    m_flowAqm->SetAttribute("MinBytes", UintegerValue(m_minBytes));
+    m_flowAqm->SetAttribute("Interval", TimeValue(m_interval));
+    m_flowAqm->SetAttribute("Target", TimeValue(m_target));
+    m_flowAqm->SetAttribute("CeThreshold", TimeValue(m_ceThreshold));
+    m_flowAqm->SetDropAfterDequeueCallback(MakeCallback(&CoDelQueueDisc::DropAfterDequeue, this));
+    m_flowAqm->SetMarkCallback(MakeCallback(&CoDelQueueDisc::Mark, this));
 }
 
 } // namespace ns3
@@ -53,6 +53,7 @@ static const int CODEL_SHIFT = 10;
 #define REC_INV_SQRT_SHIFT (32 - REC_INV_SQRT_BITS)
 
 class TraceContainer;
+class CoDelFlowAqm;
 
 /**
  * \ingroup traffic-control
@@ -110,9 +111,16 @@ class CoDelQueueDisc : public QueueDisc
     static constexpr const char* CE_THRESHOLD_EXCEEDED_MARK =
         "CE threshold exceeded mark"; //!< Sojourn time above CE threshold
 
+  protected:
+    /**
+     * \brief Dispose of the object
+     */
+    void DoDispose() override;
+
   private:
     friend class ::CoDelQueueDiscNewtonStepTest; // Test code
     friend class ::CoDelQueueDiscControlLawTest; // Test code
+    friend class CoDelFlowAqm;                   // Runs the control law
     /**
      * \brief Add a packet to the queue
      *
@@ -157,46 +165,6 @@ class CoDelQueueDisc : public QueueDisc
      */
     static uint32_t ControlLaw(uint32_t t, uint32_t interval, uint32_t recInvSqrt);
 
-    /**
-     * \brief Determine whether a packet is OK to be dropped. The packet
-     * may not be actually dropped (depending on the drop state)
-     *
-     * \param item The packet that is considered
-     * \param now The current time represented as 32-bit unsigned integer (us)
-     * \returns True if it is OK to drop the packet (sojourn time above target for at least
-     * interval)
-     */
-    bool OkToDrop(Ptr<QueueDiscItem> item, uint32_t now);
-
-    /**
-     * Check if CoDel time a is successive to b
-     * @param a left operand
-     * @param b right operand
-     * @return true if a is greater than b
-     */
-    bool CoDelTimeAfter(uint32_t a, uint32_t b);
-    /**
-     * Check if CoDel time a is successive or equal to b
-     * @param a left operand
-     * @param b right operand
-     * @return true if a is greater than or equal to b
-     */
-    bool CoDelTimeAfterEq(uint32_t a, uint32_t b);
-    /**
-     * Check if CoDel time a is preceding b
-     * @param a left operand
-     * @param b right operand
-     * @return true if a is less than to b
-     */
-    bool CoDelTimeBefore(uint32_t a, uint32_t b);
-    /**
-     * Check if CoDel time a is preceding or equal to b
-     * @param a left operand
-     * @param b right operand
-     * @return true if a is less than or equal to b
-     */
-    bool CoDelTimeBeforeEq(uint32_t a, uint32_t b);
-
     /**
      * Return the unsigned 32-bit integer representation of the input Time
      * object. Units are microseconds
@@ -219,6 +187,7 @@ class CoDelQueueDisc : public QueueDisc
     uint16_t m_recInvSqrt;             //!< Reciprocal inverse square root
     uint32_t m_firstAboveTime;         //!< Time to declare sojourn time above target
     TracedValue<uint32_t> m_dropNext;  //!< Time to drop next packet
+    Ptr<CoDelFlowAqm> m_flowAqm;       //!< The control law, run on the variables above
 };
 
 } // namespace ns3
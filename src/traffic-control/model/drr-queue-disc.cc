@@ -26,12 +26,18 @@
 
 #include "drr-queue-disc.h"
 
+#include "ns3/abort.h"
+#include "ns3/boolean.h"
 #include "ns3/ipv4-packet-filter.h"
 #include "ns3/log.h"
 #include "ns3/net-device-queue-interface.h"
+#include "ns3/net-device.h"
 #include "ns3/queue.h"
+#include "ns3/simulator.h"
 #include "ns3/string.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -45,13 +51,22 @@ DRRFlow::GetTypeId()
     static TypeId tid = TypeId("ns3::DRRFlow")
                             .SetParent<QueueDiscClass>()
                             .SetGroupName("TrafficControl")
-                            .AddConstructor<DRRFlow>();
+                            .AddConstructor<DRRFlow>()
+                            .AddAttribute("Quantum",
+                                          "The number of bytes this flow is allowed to send at "
+                                          "each round. If null, the quantum of the queue disc "
+                                          "is used",
+                                          UintegerValue(0),
+                                          MakeUintegerAccessor(&DRRFlow::m_quantum),
+                                          MakeUintegerChecker<uint32_t>());
     return tid;
 }
 
 DRRFlow::DRRFlow()
     : m_deficit(0),
-      m_status(INACTIVE)
+      m_quantum(0),
+      m_status(INACTIVE),
+      m_index(0)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -82,6 +97,19 @@ DRRFlow::IncreaseDeficit(int32_t deficit)
     m_deficit += deficit;
 }
 
+void
+DRRFlow::SetQuantum(uint32_t quantum)
+{
+    NS_LOG_FUNCTION(this << quantum);
+    m_quantum = quantum;
+}
+
+uint32_t
+DRRFlow::GetQuantum() const
+{
+    return m_quantum;
+}
+
 void
 DRRFlow::SetStatus(FlowStatus status)
 {
@@ -96,6 +124,19 @@ DRRFlow::GetStatus() const
     return m_status;
 }
 
+void
+DRRFlow::SetIndex(uint32_t index)
+{
+    NS_LOG_FUNCTION(this);
+    m_index = index;
+}
+
+uint32_t
+DRRFlow::GetIndex() const
+{
+    return m_index;
+}
+
 NS_OBJECT_ENSURE_REGISTERED(DRRQueueDisc);
 
 TypeId
@@ -115,12 +156,73 @@ DRRQueueDisc::GetTypeId()
                           "The number of queues into which the incoming packets are classified",
                           UintegerValue(1024),
                           MakeUintegerAccessor(&DRRQueueDisc::m_flows),
-                          MakeUintegerChecker<uint32_t>());
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("Quantum",
+                          "The number of bytes each flow can dequeue on each round of the "
+                          "scheduling algorithm. If null, the MTU of the device is used",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&DRRQueueDisc::SetQuantum,
+                                               &DRRQueueDisc::GetQuantum),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("AdaptiveQuantum",
+                          "True to rescale the quantum based on the size of the dequeued "
+                          "packets, so that flows dequeue a packet at each visit",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&DRRQueueDisc::m_adaptiveQuantum),
+                          MakeBooleanChecker())
+            .AddAttribute("AdaptiveQuantumWindow",
+                          "The number of dequeued packets after which the adaptive quantum is "
+                          "set to the size of the largest packet dequeued in the meantime",
+                          UintegerValue(1024),
+                          MakeUintegerAccessor(&DRRQueueDisc::m_adaptiveWindow),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("DropBatchSize",
+                          "The maximum number of packets dropped from the fat flow when the "
+                          "byte limit is exceeded",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&DRRQueueDisc::m_dropBatchSize),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("EnableSetAssociativeHash",
+                          "Enable/Disable Set Associative Hash",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&DRRQueueDisc::m_enableSetAssociativeHash),
+                          MakeBooleanChecker())
+            .AddAttribute("SetWays",
+                          "The size of a set of queues (used by set associative hash)",
+                          UintegerValue(8),
+                          MakeUintegerAccessor(&DRRQueueDisc::m_setWays),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("FlowPoolSize",
+                          "The number of flows (and child queue discs) allocated at "
+                          "initialization, rather than when the first packet of a flow arrives",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&DRRQueueDisc::m_flowPoolSize),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("MaxFlowObjects",
+                          "The maximum number of flows (and child queue discs) allocated. When "
+                          "reached, the least recently active idle flow is reclaimed for new "
+                          "flows. If null, a flow is allocated for each hash bucket used",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&DRRQueueDisc::m_maxFlowObjects),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("FlowIdleTimeout",
+                          "The time after which an idle flow can be reclaimed for a new flow. "
+                          "If null, idle flows are only reclaimed when MaxFlowObjects is reached",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&DRRQueueDisc::m_flowIdleTimeout),
+                          MakeTimeChecker());
     return tid;
 }
 
 DRRQueueDisc::DRRQueueDisc()
-    : m_quantum(0)
+    : m_quantum(0),
+      m_maxObservedSize(0),
+      m_nObservedPackets(0),
+      m_defaultFlowQuantum(0),
+      m_nFlowsInUse(0),
+      m_idleHead(IDLE_LIST_END),
+      m_idleTail(IDLE_LIST_END),
+      m_headCredited(false)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -130,6 +232,17 @@ DRRQueueDisc::~DRRQueueDisc()
     NS_LOG_FUNCTION(this);
 }
 
+void
+DRRQueueDisc::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_flowTable.clear();
+    m_freeFlows.clear();
+    m_tags.clear();
+    m_scheduler.Reset(0);
+    QueueDisc::DoDispose();
+}
+
 void
 DRRQueueDisc::SetQuantum(uint32_t quantum)
 {
@@ -143,6 +256,201 @@ DRRQueueDisc::GetQuantum() const
     return m_quantum;
 }
 
+void
+DRRQueueDisc::SetFlowQuantum(uint32_t index, uint32_t quantum)
+{
+    NS_LOG_FUNCTION(this << index << quantum);
+    NS_ABORT_MSG_IF(!quantum, "The quantum of a flow cannot be null");
+    m_flowQuanta[index] = quantum;
+
+    // update the flow if it has been already created
+    if (index < m_flowTable.size() && m_flowTable[index])
+    {
+        m_flowTable[index]->SetQuantum(quantum);
+    }
+}
+
+uint32_t
+DRRQueueDisc::GetFlowQuantum(uint32_t index) const
+{
+    if (index < m_flowTable.size() && m_flowTable[index])
+    {
+        return GetFlowQuantum(PeekPointer(m_flowTable[index]));
+    }
+    auto it = m_flowQuanta.find(index);
+    return (it != m_flowQuanta.end() ? it->second : m_quantum);
+}
+
+uint32_t
+DRRQueueDisc::GetFlowQuantum(const DRRFlow* flow) const
+{
+    uint32_t quantum = flow->GetQuantum();
+    return (quantum ? quantum : m_quantum);
+}
+
+void
+DRRQueueDisc::AdaptQuantum(uint32_t size)
+{
+    NS_LOG_FUNCTION(this << size);
+
+    m_maxObservedSize = std::max(m_maxObservedSize, size);
+
+    if (size > m_quantum)
+    {
+        // grow the quantum at once, so that a packet is dequeued at each visit
+        m_quantum = size;
+        NS_LOG_DEBUG("Increasing the quantum to: " << m_quantum);
+    }
+
+    if (++m_nObservedPackets == m_adaptiveWindow)
+    {
+        // shrink the quantum to the largest packet observed in the last window
+        m_quantum = m_maxObservedSize;
+        NS_LOG_DEBUG("Setting the quantum to: " << m_quantum);
+        m_maxObservedSize = 0;
+        m_nObservedPackets = 0;
+    }
+}
+
+DRRFlow*
+DRRQueueDisc::ActiveListPopFront()
+{
+    DRRFlow* flow = PeekPointer(m_flowTable[m_scheduler.PopFront(FlowQueueScheduler::OLD_FLOWS)]);
+    // the next flow has not started its turn yet
+    m_headCredited = false;
+    return flow;
+}
+
+uint32_t
+DRRQueueDisc::SetAssociativeHash(uint32_t flowHash)
+{
+    NS_LOG_FUNCTION(this << flowHash);
+
+    uint32_t h = (flowHash % m_flows);
+    uint32_t innerHash = h % m_setWays;
+    uint32_t outerHash = h - innerHash;
+
+    // look for the queue associated with this flow first, so that the packets
+    // of a flow are not spread over multiple queues of the set
+    for (uint32_t i = outerHash; i < outerHash + m_setWays; i++)
+    {
+        if (m_flowTable[i] && m_tags[i] == flowHash)
+        {
+            return i;
+        }
+    }
+
+    for (uint32_t i = outerHash; i < outerHash + m_setWays; i++)
+    {
+        if (!m_flowTable[i] || m_flowTable[i]->GetStatus() == DRRFlow::INACTIVE)
+        {
+            // this queue has not been created yet or is inactive, hence we can use it
+            m_tags[i] = flowHash;
+            return i;
+        }
+    }
+
+    // all the queues of the set are used. Use the first queue of the set
+    NotifyFlowHashCollision();
+    m_tags[outerHash] = flowHash;
+    return outerHash;
+}
+
+Ptr<DRRFlow>
+DRRQueueDisc::CreateFlow()
+{
+    NS_LOG_FUNCTION(this);
+
+    Ptr<DRRFlow> flow = m_flowFactory.Create<DRRFlow>();
+    m_defaultFlowQuantum = flow->GetQuantum();
+    Ptr<QueueDisc> qd = m_queueDiscFactory.Create<QueueDisc>();
+    qd->Initialize();
+    flow->SetQueueDisc(qd);
+    AddQueueDiscClass(flow);
+    return flow;
+}
+
+Ptr<DRRFlow>
+DRRQueueDisc::AttachFlow(uint32_t index)
+{
+    NS_LOG_FUNCTION(this << index);
+
+    Ptr<DRRFlow> flow;
+
+    if (!m_freeFlows.empty())
+    {
+        NS_LOG_DEBUG("Taking a flow from the pool for the flow queue with index " << index);
+        flow = m_freeFlows.back();
+        m_freeFlows.pop_back();
+        m_nFlowsInUse++;
+    }
+    else if (m_idleHead != IDLE_LIST_END &&
+             ((m_maxFlowObjects && GetNQueueDiscClasses() >= m_maxFlowObjects) ||
+              (!m_flowIdleTimeout.IsZero() &&
+               Simulator::Now() - m_idleSince[m_idleHead] >= m_flowIdleTimeout)))
+    {
+        // reclaim the least recently active idle flow
+        uint32_t old = m_idleHead;
+        NS_LOG_DEBUG("Reclaiming the idle flow of the flow queue with index "
+                     << old << " for the flow queue with index " << index);
+        IdleListRemove(old);
+        flow = m_flowTable[old];
+        m_flowTable[old] = nullptr;
+    }
+    else if (!m_maxFlowObjects || GetNQueueDiscClasses() < m_maxFlowObjects)
+    {
+        NS_LOG_DEBUG("Creating a new flow queue with index " << index);
+        flow = CreateFlow();
+        m_nFlowsInUse++;
+    }
+    else
+    {
+        return nullptr;
+    }
+
+    NotifyFlowObjectsInUse(m_nFlowsInUse);
+
+    flow->SetIndex(index);
+    auto it = m_flowQuanta.find(index);
+    flow->SetQuantum(it != m_flowQuanta.end() ? it->second : m_defaultFlowQuantum);
+    m_flowTable[index] = flow;
+    return flow;
+}
+
+void
+DRRQueueDisc::DeactivateFlow(DRRFlow* flow)
+{
+    NS_LOG_FUNCTION(this << flow);
+
+    flow->SetDeficit(0);
+    flow->SetStatus(DRRFlow::INACTIVE);
+
+    uint32_t index = flow->GetIndex();
+    m_idleSince[index] = Simulator::Now();
+    m_idlePrev[index] = m_idleTail;
+    m_idleNext[index] = IDLE_LIST_END;
+    if (m_idleTail != IDLE_LIST_END)
+    {
+        m_idleNext[m_idleTail] = index;
+    }
+    else
+    {
+        m_idleHead = index;
+    }
+    m_idleTail = index;
+}
+
+void
+DRRQueueDisc::IdleListRemove(uint32_t index)
+{
+    NS_LOG_FUNCTION(this << index);
+
+    uint32_t prev = m_idlePrev[index];
+    uint32_t next = m_idleNext[index];
+    (prev != IDLE_LIST_END ? m_idleNext[prev] : m_idleHead) = next;
+    (next != IDLE_LIST_END ? m_idlePrev[next] : m_idleTail) = prev;
+}
+
 bool
 DRRQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
 {
@@ -157,37 +465,48 @@ DRRQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
         h = m_flows; // place all unfiltered packets into a separate flow queue
     }
 
+    else if (m_enableSetAssociativeHash)
+    {
+        h = SetAssociativeHash(ret);
+    }
     else
     {
         h = ret % m_flows;
+        if (m_flowTable[h] && m_flowTable[h]->GetStatus() == DRRFlow::ACTIVE &&
+            m_tags[h] != static_cast<uint32_t>(ret))
+        {
+            NotifyFlowHashCollision();
+        }
+        m_tags[h] = ret;
     }
 
-    Ptr<DRRFlow> flow;
-    if (m_flowsIndices.find(h) == m_flowsIndices.end())
+    Ptr<DRRFlow> flow = m_flowTable[h];
+    if (!flow)
     {
-        NS_LOG_DEBUG("Creating a new flow queue with index " << h);
-        flow = m_flowFactory.Create<DRRFlow>();
-        Ptr<QueueDisc> qd = m_queueDiscFactory.Create<QueueDisc>();
-        qd->Initialize();
-        flow->SetQueueDisc(qd);
-        AddQueueDiscClass(flow);
-
-        m_flowsIndices[h] = GetNQueueDiscClasses() - 1;
+        flow = AttachFlow(h);
+        if (!flow)
+        {
+            NS_LOG_DEBUG("No flow object available, drop the packet");
+            DropBeforeEnqueue(item, FLOW_LIMIT_DROP);
+            return false;
+        }
     }
-    else
+    else if (flow->GetStatus() == DRRFlow::INACTIVE)
     {
-        flow = StaticCast<DRRFlow>(GetQueueDiscClass(m_flowsIndices[h]));
+        // the flow is no longer idle
+        IdleListRemove(h);
     }
 
     flow->GetQueueDisc()->Enqueue(item);
+    UpdateBacklog(h);
 
-    NS_LOG_DEBUG("Packet enqueued into flow " << h << "; flow index " << m_flowsIndices[h]);
+    NS_LOG_DEBUG("Packet enqueued into flow " << h);
 
     if (flow->GetStatus() == DRRFlow::INACTIVE)
     {
         NS_LOG_DEBUG("Setting flow as ACTIVE");
         flow->SetStatus(DRRFlow::ACTIVE);
-        m_flowList.push_back(flow);
+        m_scheduler.PushBack(FlowQueueScheduler::OLD_FLOWS, h);
     }
 
     while (GetNBytes() > m_limit)
@@ -203,61 +522,118 @@ DRRQueueDisc::DoDequeue()
 {
     NS_LOG_FUNCTION(this);
 
-    Ptr<DRRFlow> flow;
-    Ptr<QueueDiscItem> item;
+    // number of flows visited since the beginning of the current round
+    uint32_t visited = 0;
 
-    if (m_flowList.empty())
+    while (!m_scheduler.IsEmpty(FlowQueueScheduler::OLD_FLOWS))
     {
-        NS_LOG_DEBUG("No active flows found");
-        return nullptr;
-    }
+        if (visited == m_scheduler.GetSize(FlowQueueScheduler::OLD_FLOWS))
+        {
+            // a whole round went by and no flow could send its head packet
+            SkipRounds();
+            visited = 0;
+        }
 
-    do
-    {
-        if (!m_flowList.empty()) // unnecessary ?
+        DRRFlow* flow = PeekPointer(m_flowTable[m_scheduler.Front(FlowQueueScheduler::OLD_FLOWS)]);
+        Ptr<QueueDisc> qd = flow->GetQueueDisc();
+        Ptr<const QueueDiscItem> t_item = qd->Peek();
+
+        if (!t_item)
         {
-            flow = m_flowList.front();
-            m_flowList.pop_front();
-            flow->IncreaseDeficit(m_quantum);
-            Ptr<const QueueDiscItem> t_item = flow->GetQueueDisc()->Peek();
+            UpdateBacklog(flow->GetIndex());
+            // the flow may have been emptied by DRRDrop
+            NS_LOG_DEBUG("Empty Flow, Setting it to INACTIVE");
+            ActiveListPopFront();
+            DeactivateFlow(flow);
+            continue;
+        }
 
-            if ((uint32_t)flow->GetDeficit() >= t_item->GetSize())
+        if (!m_headCredited)
+        {
+            // the flow at the head of the list starts its turn
+            flow->IncreaseDeficit(GetFlowQuantum(flow));
+            m_headCredited = true;
+        }
+
+        if ((uint32_t)flow->GetDeficit() >= t_item->GetSize())
+        {
+            Ptr<QueueDiscItem> item = qd->Dequeue();
+            UpdateBacklog(flow->GetIndex());
+            flow->IncreaseDeficit(-item->GetSize());
+
+            if (m_adaptiveQuantum)
             {
-                item = flow->GetQueueDisc()->Dequeue();
-                flow->IncreaseDeficit(-item->GetSize());
-                NS_LOG_DEBUG("Dequeued packet " << item->GetPacket());
-
-                if (flow->GetQueueDisc()->GetNPackets() == 0)
-                {
-                    NS_LOG_DEBUG("Empty Flow, Setting it to INACTIVE");
-                    flow->SetDeficit(0);
-                    flow->SetStatus(DRRFlow::INACTIVE);
-                }
-
-                else
-                {
-                    NS_LOG_DEBUG("Flow still active, pushing back to active list");
-                    m_flowList.push_back(flow);
-                }
-
-                return item;
-            } // End if(flow->GetDeficit ...)
+                AdaptQuantum(item->GetSize());
+            }
+            NS_LOG_DEBUG("Dequeued packet " << item->GetPacket());
 
+            if (qd->GetNPackets() == 0)
+            {
+                NS_LOG_DEBUG("Empty Flow, Setting it to INACTIVE");
+                ActiveListPopFront();
+                DeactivateFlow(flow);
+            }
             else
             {
-                NS_LOG_DEBUG("Packet size greater than deficit, pushing flow back to end of list");
-                m_flowList.push_back(flow);
-                item = nullptr;
+                NS_LOG_DEBUG("Flow still active, keeping its turn");
             }
+
+            return item;
         }
-        else
+
+        // peeking may have caused the child queue disc to drop packets
+        UpdateBacklog(flow->GetIndex());
+        NS_LOG_DEBUG("Packet size greater than deficit, pushing flow back to end of list");
+        m_scheduler.MoveFront(FlowQueueScheduler::OLD_FLOWS, FlowQueueScheduler::OLD_FLOWS);
+        // the next flow has not started its turn yet
+        m_headCredited = false;
+        visited++;
+    }
+
+    NS_LOG_DEBUG("No active flows found");
+    return nullptr;
+}
+
+void
+DRRQueueDisc::SkipRounds()
+{
+    NS_LOG_FUNCTION(this);
+
+    // Every active flow has been visited in the last round and the list is back
+    // in its initial order. Compute the minimum number of further visits needed
+    // by a flow for its deficit to cover the size of its head packet
+    uint32_t rounds = UINT32_MAX;
+    for (uint32_t index = m_scheduler.Front(FlowQueueScheduler::OLD_FLOWS);
+         index != FlowQueueScheduler::NO_FLOW;
+         index = m_scheduler.Next(index))
+    {
+        DRRFlow* flow = PeekPointer(m_flowTable[index]);
+        Ptr<const QueueDiscItem> t_item = flow->GetQueueDisc()->Peek();
+        if (t_item)
         {
-            NS_LOG_DEBUG("No active flows found");
-            return nullptr;
+            uint32_t deficit = flow->GetDeficit();
+            uint32_t quantum = GetFlowQuantum(flow);
+            uint32_t needed = (t_item->GetSize() > deficit ? t_item->GetSize() - deficit : 0);
+            rounds = std::min(rounds, (needed + quantum - 1) / quantum);
         }
-    } while (!item);
+    }
 
-    return nullptr; // never reached
+    if (rounds == UINT32_MAX || rounds <= 1)
+    {
+        return;
+    }
+
+    // All the rounds but the last one would be completed without any flow
+    // sending a packet. Credit the quantum for those rounds to all the flows at
+    // once; the last round is performed by visiting the flows as usual.
+    NS_LOG_DEBUG("Skipping " << rounds - 1 << " rounds");
+    for (uint32_t index = m_scheduler.Front(FlowQueueScheduler::OLD_FLOWS);
+         index != FlowQueueScheduler::NO_FLOW;
+         index = m_scheduler.Next(index))
+    {
+        DRRFlow* flow = PeekPointer(m_flowTable[index]);
+        flow->IncreaseDeficit((rounds - 1) * GetFlowQuantum(flow));
+    }
 }
 
 Ptr<const QueueDiscItem>
@@ -265,18 +641,12 @@ DRRQueueDisc::DoPeek()
 {
     NS_LOG_FUNCTION(this);
 
-    Ptr<DRRFlow> flow;
-
-    if (!m_flowList.empty())
-    {
-        flow = m_flowList.front();
-    }
-    else
+    if (m_scheduler.IsEmpty(FlowQueueScheduler::OLD_FLOWS))
     {
         return nullptr;
     }
 
-    return flow->GetQueueDisc()->Peek();
+    return m_flowTable[m_scheduler.Front(FlowQueueScheduler::OLD_FLOWS)]->GetQueueDisc()->Peek();
 }
 
 bool
@@ -303,6 +673,40 @@ DRRQueueDisc::CheckConfig()
         return false;
     }
 
+    if (m_maxFlowObjects && m_flowPoolSize > m_maxFlowObjects)
+    {
+        NS_LOG_ERROR("The size of the flow pool cannot exceed the maximum number of flows");
+        return false;
+    }
+
+    if (m_enableSetAssociativeHash && (m_flows % m_setWays != 0))
+    {
+        NS_LOG_ERROR("The number of queues must be an integer multiple of the size "
+                     "of the set of queues used by set associative hash");
+        return false;
+    }
+
+    // the child queue discs are CoDel queue discs, unless the user selected another type
+    if (!m_queueDiscFactory.IsTypeIdSet())
+    {
+        m_queueDiscFactory.SetTypeId("ns3::CoDelQueueDisc");
+    }
+
+    // the overlimit drops remove packets from the internal queue of the child
+    // queue discs, hence queue discs without internal queues (e.g., classful
+    // queue discs) cannot be used as children
+    Ptr<QueueDisc> child = m_queueDiscFactory.Create<QueueDisc>();
+    child->Initialize();
+    uint32_t nInternalQueues = child->GetNInternalQueues();
+    child->Dispose();
+    if (nInternalQueues == 0)
+    {
+        NS_LOG_ERROR("The child queue discs of DRRQueueDisc ("
+                     << m_queueDiscFactory.GetTypeId().GetName()
+                     << ") must have an internal queue");
+        return false;
+    }
+
     return true;
 }
 
@@ -312,19 +716,51 @@ DRRQueueDisc::InitializeParams()
     NS_LOG_FUNCTION(this);
 
     // we are at initialization time. If the user has not set a quantum value,
-    // set the quantum to the MTU of the device
+    // set the quantum to the MTU of the device (if any)
     if (!m_quantum)
     {
-        // Ptr<NetDevice> device = GetNetDevice ();
-        // NS_ASSERT_MSG (device, "Device not set for the queue disc");
-        // m_quantum = device->GetMtu ();
-        m_quantum = 600;
-        NS_LOG_DEBUG("Setting the quantum to: " << m_quantum);
+        Ptr<NetDeviceQueueInterface> ndqi = GetNetDeviceQueueInterface();
+        Ptr<NetDevice> dev;
+        // if the NetDeviceQueueInterface object is aggregated to a
+        // NetDevice, get the MTU of such NetDevice
+        if (ndqi && (dev = ndqi->GetObject<NetDevice>()))
+        {
+            m_quantum = dev->GetMtu();
+            NS_LOG_DEBUG("Setting the quantum to the MTU of the device: " << m_quantum);
+        }
+
+        if (!m_quantum)
+        {
+            m_quantum = DEFAULT_QUANTUM;
+            NS_LOG_DEBUG("No device MTU available, setting the quantum to: " << m_quantum);
+        }
     }
 
+    m_maxObservedSize = 0;
+    m_nObservedPackets = 0;
+
+    // one bucket per flow queue plus one for the unclassified packets
+    m_flowTable.assign(m_flows + 1, nullptr);
+    m_tags.assign(m_flows, 0);
+    m_scheduler.Reset(m_flows + 1);
+    m_headCredited = false;
+    m_idlePrev.assign(m_flows + 1, IDLE_LIST_END);
+    m_idleNext.assign(m_flows + 1, IDLE_LIST_END);
+    m_idleSince.assign(m_flows + 1, Time(0));
+    m_idleHead = IDLE_LIST_END;
+    m_idleTail = IDLE_LIST_END;
+
     m_flowFactory.SetTypeId("ns3::DRRFlow");
 
-    m_queueDiscFactory.SetTypeId("ns3::CoDelQueueDisc");
+    // preallocate the pool of flows, so that no object has to be created when
+    // the first packet of a flow arrives
+    m_freeFlows.clear();
+    m_freeFlows.reserve(m_flowPoolSize);
+    for (uint32_t i = 0; i < m_flowPoolSize; i++)
+    {
+        m_freeFlows.push_back(CreateFlow());
+    }
+    m_nFlowsInUse = 0;
 
     // m_queueDiscFactory.Set ("Mode", EnumValue (QueueBase::QUEUE_MODE_BYTES));
     // m_queueDiscFactory.Set ("MaxPackets", UintegerValue (m_limit + 1));
@@ -337,29 +773,39 @@ DRRQueueDisc::DRRDrop()
 {
     NS_LOG_FUNCTION(this);
 
-    uint32_t maxBacklog = 0;
-    uint32_t index = 0;
-    Ptr<QueueDisc> qd;
-
-    /* Queue is full! Find the fat flow and drop one packet from it */
-    for (uint32_t i = 0; i < GetNQueueDiscClasses(); i++)
-    {
-        qd = GetQueueDiscClass(i)->GetQueueDisc();
-        uint32_t bytes = qd->GetNBytes();
-        if (bytes > maxBacklog)
+    /* Queue is full! Drop packets from the fat flow */
+    uint32_t index = m_scheduler.DropFromFatFlow(m_dropBatchSize, [this](uint32_t index) {
+        NS_LOG_DEBUG("Drop packet (overflow) from flow " << index);
+        Ptr<QueueDisc> qd = m_flowTable[index]->GetQueueDisc();
+        Ptr<QueueDiscItem> item;
+        if (qd->GetNPackets() > qd->GetInternalQueue(0)->GetNPackets())
         {
-            maxBacklog = bytes;
-            index = i;
+            // the head packet has been peeked by DoDequeue and is held by the
+            // child queue disc, which must release it for its statistics to be
+            // updated when packets are removed from its internal queue
+            item = qd->Dequeue();
         }
-    }
+        else
+        {
+            item = qd->GetInternalQueue(0)->Dequeue();
+        }
+        if (!item)
+        {
+            return 0U;
+        }
+        DropAfterDequeue(item, OVERLIMIT_DROP);
+        return item->GetSize();
+    });
 
-    /* Now we drop one packet from the fat flow */
-    qd = GetQueueDiscClass(index)->GetQueueDisc();
-    Ptr<QueueDiscItem> item;
-    item = qd->GetInternalQueue(0)->Dequeue();
-    DropAfterDequeue(item, OVERLIMIT_DROP);
+    UpdateBacklog(index);
 
     return index;
 }
 
+void
+DRRQueueDisc::UpdateBacklog(uint32_t index)
+{
+    m_scheduler.SetBacklog(index, m_flowTable[index]->GetQueueDisc()->GetNBytes());
+}
+
 } // namespace ns3
@@ -27,12 +27,15 @@
 #ifndef DRR_QUEUE_DISC
 #define DRR_QUEUE_DISC
 
+#include "flow-queue-scheduler.h"
 #include "queue-disc.h"
 
+#include "ns3/nstime.h"
 #include "ns3/object-factory.h"
 
-#include <list>
 #include <map>
+#include <string>
+#include <vector>
 
 namespace ns3
 {
@@ -87,6 +90,18 @@ class DRRFlow : public QueueDiscClass
      */
     void IncreaseDeficit(int32_t deficit);
 
+    /**
+     * \brief Set the quantum for this flow
+     * \param quantum the number of bytes this flow is allowed to send at each round
+     */
+    void SetQuantum(uint32_t quantum);
+
+    /**
+     * \brief Get the quantum for this flow
+     * \return the number of bytes this flow is allowed to send at each round
+     */
+    uint32_t GetQuantum() const;
+
     /**
      * \brief Set the status for this flow
      * \param status the status for this flow
@@ -99,9 +114,23 @@ class DRRFlow : public QueueDiscClass
      */
     FlowStatus GetStatus() const;
 
+    /**
+     * \brief Set the index for this flow
+     * \param index the index for this flow
+     */
+    void SetIndex(uint32_t index);
+
+    /**
+     * \brief Get the index of this flow
+     * \return the index of this flow
+     */
+    uint32_t GetIndex() const;
+
   private:
     uint32_t m_deficit;  //!< the deficit for this flow
+    uint32_t m_quantum;  //!< the quantum for this flow
     FlowStatus m_status; //!< the status of this flow
+    uint32_t m_index;    //!< the index for this flow
 };
 
 /**
@@ -141,10 +170,59 @@ class DRRQueueDisc : public QueueDisc
      */
     uint32_t GetQuantum() const;
 
+    /**
+     * \brief Set the quantum of a flow, i.e., its weight.
+     *
+     * Flows are identified by the index of the hash bucket their packets are
+     * classified into (i.e., the value returned by the packet filter modulo the
+     * number of flows). Flows whose quantum is not set use the quantum of the
+     * queue disc (or the Quantum attribute of DRRFlow, if set).
+     *
+     * \param index the index of the flow
+     * \param quantum The number of bytes the flow can dequeue on each round of the
+     * scheduling algorithm
+     */
+    void SetFlowQuantum(uint32_t index, uint32_t quantum);
+
+    /**
+     * \brief Get the quantum of a flow.
+     *
+     * \param index the index of the flow
+     * \returns The number of bytes the flow can dequeue on each round of the
+     * scheduling algorithm
+     */
+    uint32_t GetFlowQuantum(uint32_t index) const;
+
+    /// Quantum used if the quantum is not set and no device MTU is available
+    static constexpr uint32_t DEFAULT_QUANTUM = 1500;
+
+    /**
+     * \brief Set the type and the attributes of the child queue discs.
+     *
+     * By default, the child queue discs are CoDel queue discs. The child queue
+     * discs must store packets in their first internal queue, from which packets
+     * are dropped when the byte limit is exceeded: a type of queue disc without
+     * internal queues (e.g., PrioQueueDisc) is rejected at initialization time.
+     *
+     * \tparam Args \deduced Template type parameter pack for the sequence of name-value pairs.
+     * \param type the type of the child queue discs
+     * \param args A sequence of name-value pairs of the attributes to set.
+     */
+    template <typename... Args>
+    void SetChildQueueDisc(const std::string& type, Args&&... args);
+
     // Reasons for dropping packets
     static constexpr const char* UNCLASSIFIED_DROP =
         "Unclassified drop"; //!< No packet filter able to classify packet
     static constexpr const char* OVERLIMIT_DROP = "Overlimit drop"; //!< Overlimit dropped packets
+    static constexpr const char* FLOW_LIMIT_DROP =
+        "Flow limit drop"; //!< No flow object available for the flow of the packet
+
+  protected:
+    /**
+     * \brief Dispose of the object
+     */
+    void DoDispose() override;
 
   private:
     bool DoEnqueue(Ptr<QueueDiscItem> item) override;
@@ -154,23 +232,151 @@ class DRRQueueDisc : public QueueDisc
     void InitializeParams() override;
 
     /**
-     * \brief Drop a packet from the tail of the queue with the largest current byte count (Packet
-     * Stealing) \return the index of the queue with the largest current byte count
+     * \brief Drop up to DropBatchSize packets from the head of the queue with the largest
+     * current byte count (Packet Stealing)
+     * \return the index of the queue with the largest current byte count
      */
     uint32_t DRRDrop();
 
-    uint32_t m_limit;   //!< Maximum number of bytes in the queue disc
-    uint32_t m_quantum; //!< total number of bytes that a flow can send
-    uint32_t m_flows;   //!< Number of flow queues
+    /**
+     * \brief Compute the index of the flow queue using set associative hash
+     *
+     * The flow queue associated with the given flow hash in the set is looked up
+     * first, then an unused or inactive flow queue of the set. If all the flow
+     * queues of the set are active and associated with other flows, the first
+     * flow queue of the set is used and a collision is recorded.
+     *
+     * \param flowHash the hash of the flow 5-tuple
+     * \return the index of the flow queue
+     */
+    uint32_t SetAssociativeHash(uint32_t flowHash);
+
+    /**
+     * \brief Create a flow along with its child queue disc
+     * \return the flow
+     */
+    Ptr<DRRFlow> CreateFlow();
 
-    std::list<Ptr<DRRFlow>> m_flowList; //!< The list of flows
+    /**
+     * \brief Get a flow object for the hash bucket with the given index, which
+     * has no flow associated. A flow is taken from the pool of free flows, or an
+     * idle flow is reclaimed from another bucket, or a new flow is created
+     * \param index the index of the hash bucket
+     * \return the flow associated with the bucket, or null if the maximum number
+     * of flow objects has been reached and no flow can be reclaimed
+     */
+    Ptr<DRRFlow> AttachFlow(uint32_t index);
 
-    std::map<uint32_t, uint32_t> m_flowsIndices; //!< Map with the index of class for each flow
+    /**
+     * \brief Set the given flow as inactive and append it to the list of idle flows
+     * \param flow the flow
+     */
+    void DeactivateFlow(DRRFlow* flow);
+
+    /**
+     * \brief Remove the flow associated with the bucket with the given index
+     * from the list of idle flows
+     * \param index the index of the bucket
+     */
+    void IdleListRemove(uint32_t index);
+
+    /**
+     * \brief Get the quantum of the given flow
+     * \param flow the flow
+     * \return the quantum of the flow, if set, or the quantum of the queue disc
+     */
+    uint32_t GetFlowQuantum(const DRRFlow* flow) const;
+
+    /**
+     * \brief Update the quantum based on the size of a dequeued packet, when
+     * the adaptive quantum is enabled
+     * \param size the size of the dequeued packet
+     */
+    void AdaptQuantum(uint32_t size);
+
+    /**
+     * \brief Credit all the active flows with the quantum of the rounds that
+     * would go by without any flow being able to send its head packet, so that
+     * the cost of a dequeue does not depend on the ratio of the packet size to
+     * the quantum. Must be called after a whole round in which no packet was sent.
+     */
+    void SkipRounds();
+
+    /**
+     * \brief Notify the scheduler of the amount of bytes stored in the queue of
+     * a flow, after it has changed
+     * \param index the index of the flow
+     */
+    void UpdateBacklog(uint32_t index);
+
+    /**
+     * \brief Remove the flow at the head of the list of active flows
+     * \return the flow that was at the head of the list
+     */
+    DRRFlow* ActiveListPopFront();
+
+    uint32_t m_limit;                //!< Maximum number of bytes in the queue disc
+    uint32_t m_quantum;              //!< total number of bytes that a flow can send
+    bool m_adaptiveQuantum;          //!< Whether the quantum is rescaled from the packet sizes
+    uint32_t m_adaptiveWindow;       //!< Number of packets after which the quantum is rescaled
+    uint32_t m_maxObservedSize;      //!< Largest packet dequeued in the current window
+    uint32_t m_nObservedPackets;     //!< Number of packets dequeued in the current window
+    uint32_t m_flows;                //!< Number of flow queues
+    uint32_t m_dropBatchSize;        //!< Max number of packets dropped from the fat flow
+    bool m_enableSetAssociativeHash; //!< Whether set associative hash is enabled
+    uint32_t m_setWays;              //!< Size of a set of flow queues (set associative hash)
+    uint32_t m_flowPoolSize;         //!< Number of flows allocated at initialization
+    uint32_t m_maxFlowObjects;       //!< Max number of flow objects (0 means no limit)
+    Time m_flowIdleTimeout;          //!< Time after which an idle flow can be reclaimed
+    uint32_t m_defaultFlowQuantum;   //!< Quantum of the flows created by the flow factory
+
+    /// Flow associated with each hash bucket (null if not created yet), the
+    /// last bucket being reserved to unclassified packets
+    std::vector<Ptr<DRRFlow>> m_flowTable;
+
+    /// Hash of the flow last associated with each hash bucket (meaningful only if
+    /// the flow queue of the bucket has been created)
+    std::vector<uint32_t> m_tags;
+
+    /// Flow objects not associated with any hash bucket, available for new flows
+    std::vector<Ptr<DRRFlow>> m_freeFlows;
+    uint32_t m_nFlowsInUse; //!< Number of flow objects associated with a hash bucket
+
+    /// Doubly linked list of the buckets whose flow is inactive, from the least
+    /// recently to the most recently active, used to reclaim idle flows
+    std::vector<uint32_t> m_idlePrev;
+    std::vector<uint32_t> m_idleNext; //!< Next bucket in the list of idle flows
+    std::vector<Time> m_idleSince;    //!< Time since when the flow of each bucket is idle
+    uint32_t m_idleHead;              //!< First bucket in the list of idle flows
+    uint32_t m_idleTail;              //!< Last bucket in the list of idle flows
+
+    /// Marker of the ends of the list of idle flows. A bucket is in the list if
+    /// and only if its flow exists and is inactive
+    static constexpr uint32_t IDLE_LIST_END = UINT32_MAX;
+
+    /// List of the active flows in round robin order (the list of old flows of
+    /// the scheduler) and backlog of each flow
+    FlowQueueScheduler m_scheduler;
+    bool m_headCredited; //!< Whether the flow at the head of the list started its turn
+
+    std::map<uint32_t, uint32_t> m_flowQuanta; //!< Quantum set for specific flows
 
     ObjectFactory m_flowFactory;      //!< Factory to create a new flow
     ObjectFactory m_queueDiscFactory; //!< Factory to create a new queue
 };
 
+/***************************************************************
+ *  Implementation of the templates declared above.
+ ***************************************************************/
+
+template <typename... Args>
+void
+DRRQueueDisc::SetChildQueueDisc(const std::string& type, Args&&... args)
+{
+    m_queueDiscFactory.SetTypeId(type);
+    m_queueDiscFactory.Set(std::forward<Args>(args)...);
+}
+
 } // namespace ns3
 
 #endif /* DRR_QUEUE_DISC */
@@ -0,0 +1,1224 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "flow-aqm.h"
+
+#include "ns3/boolean.h"
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/queue.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("FlowAqm");
+
+/**
+ * Performs a reciprocal divide, similar to the
+ * Linux kernel reciprocal_divide function
+ * \param A numerator
+ * \param R reciprocal of the denominator B
+ * \return the value of A/B
+ */
+static inline uint32_t
+ReciprocalDivide(uint32_t A, uint32_t R)
+{
+    return (uint32_t)(((uint64_t)A * R) >> 32);
+}
+
+/**
+ * Check if CoDel time a is successive to b
+ * \param a left operand
+ * \param b right operand
+ * \return true if a is greater than b
+ */
+static inline bool
+CoDelTimeAfter(int64_t a, int64_t b)
+{
+    return a - b > 0;
+}
+
+/**
+ * Check if CoDel time a is successive or equal to b
+ * \param a left operand
+ * \param b right operand
+ * \return true if a is greater than or equal to b
+ */
+static inline bool
+CoDelTimeAfterEq(int64_t a, int64_t b)
+{
+    return a - b >= 0;
+}
+
+/**
+ * Return the representation of the input Time object used by CoDel, whose
+ * units are (roughly) microseconds
+ * \param t the input Time object
+ * \return the unsigned 32-bit integer representation
+ */
+static inline uint32_t
+Time2CoDel(Time t)
+{
+    return static_cast<uint32_t>(t.GetNanoSeconds() >> CODEL_SHIFT);
+}
+
+NS_OBJECT_ENSURE_REGISTERED(FlowAqm);
+
+TypeId
+FlowAqm::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::FlowAqm")
+            .SetParent<Object>()
+            .SetGroupName("TrafficControl")
+            .AddAttribute("MaxSize",
+                          "The maximum number of packets/bytes accepted by a flow queue.",
+                          QueueSizeValue(QueueSize("1000p")),
+                          MakeQueueSizeAccessor(&FlowAqm::m_maxSize),
+                          MakeQueueSizeChecker());
+    return tid;
+}
+
+FlowAqmQueue::FlowAqmQueue()
+    : m_nBytes(0)
+{
+}
+
+FlowAqm::FlowAqm()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+FlowAqm::~FlowAqm()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+FlowAqm::SetDequeueCallback(DequeueCallback cb)
+{
+    NS_LOG_FUNCTION(this);
+    m_dequeue = cb;
+}
+
+void
+FlowAqm::SetDropBeforeEnqueueCallback(DropCallback cb)
+{
+    NS_LOG_FUNCTION(this);
+    m_dropBeforeEnqueue = cb;
+}
+
+void
+FlowAqm::SetDropAfterDequeueCallback(DropCallback cb)
+{
+    NS_LOG_FUNCTION(this);
+    m_dropAfterDequeue = cb;
+}
+
+void
+FlowAqm::SetMarkCallback(MarkCallback cb)
+{
+    NS_LOG_FUNCTION(this);
+    m_mark = cb;
+}
+
+bool
+FlowAqm::Fits(const FlowAqmQueue& queue, Ptr<const QueueDiscItem> item) const
+{
+    if (m_maxSize.GetUnit() == QueueSizeUnit::PACKETS)
+    {
+        return queue.GetNPackets() + 1 <= m_maxSize.GetValue();
+    }
+    return queue.GetNBytes() + item->GetSize() <= m_maxSize.GetValue();
+}
+
+Ptr<QueueDiscItem>
+FlowAqm::Pop(QueueDisc::InternalQueue& queue)
+{
+    return queue.Dequeue();
+}
+
+bool
+FlowAqm::IsL4s(Ptr<const QueueDiscItem> item)
+{
+    uint8_t tosByte = 0;
+    return item->GetUint8Value(QueueItem::IP_DSFIELD, tosByte) &&
+           (((tosByte & 0x3) == 1) || (tosByte & 0x3) == 3);
+}
+
+NS_OBJECT_ENSURE_REGISTERED(CoDelFlowAqm);
+
+TypeId
+CoDelFlowAqm::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::CoDelFlowAqm")
+            .SetParent<FlowAqm>()
+            .SetGroupName("TrafficControl")
+            .AddConstructor<CoDelFlowAqm>()
+            .AddAttribute("UseEcn",
+                          "True to use ECN (packets are marked instead of being dropped)",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&CoDelFlowAqm::m_useEcn),
+                          MakeBooleanChecker())
+            .AddAttribute("UseL4s",
+                          "True to use L4S (only ECT1 packets are marked at CE threshold)",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&CoDelFlowAqm::m_useL4s),
+                          MakeBooleanChecker())
+            .AddAttribute("MinBytes",
+                          "The CoDel algorithm minbytes parameter.",
+                          UintegerValue(1500),
+                          MakeUintegerAccessor(&CoDelFlowAqm::m_minBytes),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("Interval",
+                          "The CoDel algorithm interval",
+                          StringValue("100ms"),
+                          MakeTimeAccessor(&CoDelFlowAqm::m_interval),
+                          MakeTimeChecker())
+            .AddAttribute("Target",
+                          "The CoDel algorithm target queue delay",
+                          StringValue("5ms"),
+                          MakeTimeAccessor(&CoDelFlowAqm::m_target),
+                          MakeTimeChecker())
+            .AddAttribute("CeThreshold",
+                          "The CoDel CE threshold for marking packets",
+                          TimeValue(Time::Max()),
+                          MakeTimeAccessor(&CoDelFlowAqm::m_ceThreshold),
+                          MakeTimeChecker());
+    return tid;
+}
+
+CoDelFlowAqm::CoDelFlowAqm()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+CoDelFlowAqm::~CoDelFlowAqm()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+bool
+CoDelFlowAqm::Enqueue(State& state, FlowAqmQueue& queue, Ptr<QueueDiscItem> item)
+{
+    NS_LOG_FUNCTION(this << item);
+
+    if (!Fits(queue, item))
+    {
+        NS_LOG_LOGIC("Queue full -- dropping pkt");
+        m_dropBeforeEnqueue(item, CoDelQueueDisc::OVERLIMIT_DROP);
+        return false;
+    }
+
+    queue.Push(item);
+    return true;
+}
+
+template <typename S, typename Q>
+bool
+CoDelFlowAqm::OkToDrop(S& state, const Q& queue, Ptr<const QueueDiscItem> item, uint32_t now) const
+{
+    if (!item)
+    {
+        state.firstAboveTime = 0;
+        return false;
+    }
+
+    uint32_t sojournTime = Time2CoDel(Simulator::Now() - item->GetTimeStamp());
+
+    if (!CoDelTimeAfterEq(sojournTime, Time2CoDel(m_target)) || queue.GetNBytes() < m_minBytes)
+    {
+        // went below so we'll stay below for at least interval
+        state.firstAboveTime = 0;
+        return false;
+    }
+    if (state.firstAboveTime == 0)
+    {
+        // just went above from below. If we stay above for at least interval
+        // we'll say it's ok to drop
+        state.firstAboveTime = now + Time2CoDel(m_interval);
+        return false;
+    }
+    return CoDelTimeAfter(now, state.firstAboveTime);
+}
+
+template <typename S, typename Q>
+Ptr<QueueDiscItem>
+CoDelFlowAqm::Dequeue(S& state, Q& queue)
+{
+    NS_LOG_FUNCTION(this);
+
+    Ptr<QueueDiscItem> item = Pop(queue);
+    if (!item)
+    {
+        // Leave dropping state when queue is empty
+        state.dropping = false;
+        NS_LOG_LOGIC("Queue empty");
+        return nullptr;
+    }
+
+    if (m_useL4s && IsL4s(item))
+    {
+        uint32_t ldelay = Time2CoDel(Simulator::Now() - item->GetTimeStamp());
+        if (CoDelTimeAfter(ldelay, Time2CoDel(m_ceThreshold)))
+        {
+            m_mark(item, CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK);
+        }
+        return item;
+    }
+
+    uint32_t now = Time2CoDel(Simulator::Now());
+    uint32_t interval = Time2CoDel(m_interval);
+    bool okToDrop = OkToDrop(state, queue, item, now);
+    bool isMarked = false;
+
+    if (state.dropping)
+    {
+        // In the dropping state, check if it's OK to leave or next drop should occur
+        if (!okToDrop)
+        {
+            state.dropping = false;
+        }
+        else
+        {
+            while (state.dropping && CoDelTimeAfterEq(now, state.dropNext))
+            {
+                ++state.count;
+                state.recInvSqrt = CoDelQueueDisc::NewtonStep(state.recInvSqrt, state.count);
+                if (m_useEcn && m_mark(item, CoDelQueueDisc::TARGET_EXCEEDED_MARK))
+                {
+                    isMarked = true;
+                    state.dropNext = CoDelQueueDisc::ControlLaw(now, interval, state.recInvSqrt);
+                    break;
+                }
+                NS_LOG_LOGIC("Sojourn time is still above target; dropping " << item);
+                m_dropAfterDequeue(item, CoDelQueueDisc::TARGET_EXCEEDED_DROP);
+
+                item = Pop(queue);
+
+                if (!OkToDrop(state, queue, item, now))
+                {
+                    state.dropping = false;
+                }
+                else
+                {
+                    state.dropNext =
+                        CoDelQueueDisc::ControlLaw(state.dropNext, interval, state.recInvSqrt);
+                }
+            }
+        }
+    }
+    else if (okToDrop)
+    {
+        // Not in the dropping state: enter it and drop (or mark) the first packet
+        if (m_useEcn && m_mark(item, CoDelQueueDisc::TARGET_EXCEEDED_MARK))
+        {
+            isMarked = true;
+        }
+        else
+        {
+            NS_LOG_LOGIC("Sojourn time goes above target, dropping " << item);
+            m_dropAfterDequeue(item, CoDelQueueDisc::TARGET_EXCEEDED_DROP);
+            item = Pop(queue);
+            OkToDrop(state, queue, item, now);
+        }
+        state.dropping = true;
+        // if min went above target close to when we last went below it, assume
+        // that the drop rate that controlled the queue on the last cycle is a
+        // good starting point to control it now
+        int delta = state.count - state.lastCount;
+        if (delta > 1 && !CoDelTimeAfterEq(now - state.dropNext, 16 * interval))
+        {
+            state.count = delta;
+            state.recInvSqrt = CoDelQueueDisc::NewtonStep(state.recInvSqrt, state.count);
+        }
+        else
+        {
+            state.count = 1;
+            state.recInvSqrt = ~0U >> REC_INV_SQRT_SHIFT;
+        }
+        state.lastCount = state.count;
+        state.dropNext = CoDelQueueDisc::ControlLaw(now, interval, state.recInvSqrt);
+    }
+
+    if (!isMarked && item && !m_useL4s && m_useEcn &&
+        CoDelTimeAfter(Time2CoDel(Simulator::Now() - item->GetTimeStamp()),
+                       Time2CoDel(m_ceThreshold)))
+    {
+        m_mark(item, CoDelQueueDisc::CE_THRESHOLD_EXCEEDED_MARK);
+    }
+    return item;
+}
+
+Ptr<QueueDiscItem>
+CoDelFlowAqm::Remove(State& state, FlowAqmQueue& queue)
+{
+    NS_LOG_FUNCTION(this);
+    return Pop(queue);
+}
+
+template Ptr<QueueDiscItem> CoDelFlowAqm::Dequeue(State&, FlowAqmQueue&);
+template Ptr<QueueDiscItem> CoDelFlowAqm::Dequeue(QueueDiscState&, QueueDisc::InternalQueue&);
+
+NS_OBJECT_ENSURE_REGISTERED(PieFlowAqm);
+
+TypeId
+PieFlowAqm::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::PieFlowAqm")
+            .SetParent<FlowAqm>()
+            .SetGroupName("TrafficControl")
+            .AddConstructor<PieFlowAqm>()
+            .AddAttribute("MeanPktSize",
+                          "Average of packet size",
+                          UintegerValue(1000),
+                          MakeUintegerAccessor(&PieFlowAqm::m_meanPktSize),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("A",
+                          "Value of alpha",
+                          DoubleValue(0.125),
+                          MakeDoubleAccessor(&PieFlowAqm::m_a),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("B",
+                          "Value of beta",
+                          DoubleValue(1.25),
+                          MakeDoubleAccessor(&PieFlowAqm::m_b),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("Tupdate",
+                          "Time period to calculate drop probability",
+                          TimeValue(MilliSeconds(15)),
+                          MakeTimeAccessor(&PieFlowAqm::m_tUpdate),
+                          MakeTimeChecker())
+            .AddAttribute("Supdate",
+                          "Start time of the update timer of a flow, relative to the arrival "
+                          "of its first packet",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&PieFlowAqm::m_sUpdate),
+                          MakeTimeChecker())
+            .AddAttribute("DequeueThreshold",
+                          "Minimum queue size in bytes before dequeue rate is measured",
+                          UintegerValue(16384),
+                          MakeUintegerAccessor(&PieFlowAqm::m_dqThreshold),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("QueueDelayReference",
+                          "Desired queue delay",
+                          TimeValue(MilliSeconds(15)),
+                          MakeTimeAccessor(&PieFlowAqm::m_qDelayRef),
+                          MakeTimeChecker())
+            .AddAttribute("MaxBurstAllowance",
+                          "Current max burst allowance before random drop",
+                          TimeValue(MilliSeconds(150)),
+                          MakeTimeAccessor(&PieFlowAqm::m_maxBurst),
+                          MakeTimeChecker())
+            .AddAttribute("UseDequeueRateEstimator",
+                          "Enable/Disable usage of Dequeue Rate Estimator",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&PieFlowAqm::m_useDqRateEstimator),
+                          MakeBooleanChecker())
+            .AddAttribute("UseCapDropAdjustment",
+                          "Enable/Disable Cap Drop Adjustment feature mentioned in RFC 8033",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&PieFlowAqm::m_isCapDropAdjustment),
+                          MakeBooleanChecker())
+            .AddAttribute("UseEcn",
+                          "True to use ECN (packets are marked instead of being dropped)",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&PieFlowAqm::m_useEcn),
+                          MakeBooleanChecker())
+            .AddAttribute("MarkEcnThreshold",
+                          "ECN marking threshold (RFC 8033 suggests 0.1 (i.e., 10%) default)",
+                          DoubleValue(0.1),
+                          MakeDoubleAccessor(&PieFlowAqm::m_markEcnTh),
+                          MakeDoubleChecker<double>(0, 1))
+            .AddAttribute("UseDerandomization",
+                          "Enable/Disable Derandomization feature mentioned in RFC 8033",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&PieFlowAqm::m_useDerandomization),
+                          MakeBooleanChecker())
+            .AddAttribute("CeThreshold",
+                          "The PIE CE threshold for marking packets",
+                          TimeValue(Time::Max()),
+                          MakeTimeAccessor(&PieFlowAqm::m_ceThreshold),
+                          MakeTimeChecker())
+            .AddAttribute("UseL4s",
+                          "True to use L4S (only ECT1 packets are marked at CE threshold)",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&PieFlowAqm::m_useL4s),
+                          MakeBooleanChecker());
+    return tid;
+}
+
+PieFlowAqm::PieFlowAqm()
+{
+    NS_LOG_FUNCTION(this);
+    m_uv = CreateObject<UniformRandomVariable>();
+}
+
+PieFlowAqm::~PieFlowAqm()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+PieFlowAqm::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_uv = nullptr;
+    FlowAqm::DoDispose();
+}
+
+int64_t
+PieFlowAqm::AssignStreams(int64_t stream)
+{
+    NS_LOG_FUNCTION(this << stream);
+    m_uv->SetStream(stream);
+    return 1;
+}
+
+void
+PieFlowAqm::Update(State& state, const FlowAqmQueue& queue) const
+{
+    Time now = Simulator::Now();
+
+    if (state.nextUpdate == Time::Max())
+    {
+        // first access to this flow: start the update timer
+        state.nextUpdate = now + m_sUpdate;
+    }
+
+    // an update due at the current time is run at the next access, as if the timer
+    // expired after the operations performed at the current time
+    while (state.nextUpdate < now)
+    {
+        // the queue delay computed by the next update is null if the flow is empty
+        // (with the dequeue rate estimator) or it was empty when last dequeued
+        bool idle = state.qDelayOld.IsZero() &&
+                    (m_useDqRateEstimator ? (queue.IsEmpty() || state.avgDqRate <= 0)
+                                          : state.qDelay.IsZero());
+        int64_t n = 0;
+        if (idle)
+        {
+            int64_t due =
+                ((now - state.nextUpdate).GetTimeStep() - 1) / m_tUpdate.GetTimeStep() + 1;
+            n = SkipIdleUpdates(state, due);
+        }
+        if (n == 0)
+        {
+            CalculateP(state, queue);
+            n = 1;
+        }
+        state.nextUpdate += m_tUpdate * n;
+
+        // if the state is back to the initial one, further updates do not change
+        // it: skip them
+        if (state.dropProb == 0 && state.qDelay.IsZero() && state.qDelayOld.IsZero() &&
+            state.burstAllowance.IsZero() && state.burstState == PieQueueDisc::NO_BURST &&
+            state.avgDqRate == 0 && state.nextUpdate < now)
+        {
+            int64_t periods = (now - state.nextUpdate).GetTimeStep() / m_tUpdate.GetTimeStep();
+            state.nextUpdate += m_tUpdate * periods;
+        }
+    }
+}
+
+int64_t
+PieFlowAqm::SkipIdleUpdates(State& state, int64_t due) const
+{
+    if (!state.burstAllowance.IsZero())
+    {
+        // the burst allowance lasts a few updates only
+        return 0;
+    }
+
+    double c = m_a * m_qDelayRef.GetSeconds();
+    if (state.dropProb > 0 && c >= 0)
+    {
+        // The probability increment computed by CalculateP is -c, scaled down by a
+        // factor that depends on the range the drop probability falls in. Hence, as
+        // long as the drop probability stays in the same range, each update maps it
+        // to 0.98 * (p - c / scale), whose m-th iterate is
+        // 0.98^m * (p + 49 * c / scale) - 49 * c / scale
+        static constexpr double lower[] = {0.1, 0.01, 0.001, 0.0001, 0.00001, 0.000001, 0};
+        static constexpr double scale[] = {1, 2, 8, 32, 128, 512, 2048};
+        uint32_t range = 0;
+        while (state.dropProb < lower[range])
+        {
+            range++;
+        }
+        double offset = 49 * c / scale[range];
+        // the drop probability must stay positive, otherwise the update resetting the
+        // burst state is run by CalculateP
+        double bound = std::max(lower[range], std::numeric_limits<double>::min());
+        auto decay = [&state, offset](int64_t m) {
+            return std::pow(0.98, m) * (state.dropProb + offset) - offset;
+        };
+
+        auto m = static_cast<double>(due);
+        m = std::min(m, std::floor(std::log((bound + offset) / (state.dropProb + offset)) /
+                                   std::log(0.98)));
+        auto n = static_cast<int64_t>(std::max(m, 0.0));
+        // correct the rounding errors of the logarithms
+        while (n > 0 && decay(n) < bound)
+        {
+            n--;
+        }
+        if (n > 0)
+        {
+            state.dropProb = decay(n);
+            state.qDelay = Seconds(0);
+            if (state.burstState == PieQueueDisc::IN_BURST)
+            {
+                state.burstReset = 0;
+            }
+        }
+        return n;
+    }
+
+    // With a null drop probability, each update finds a low delay and only advances
+    // the burst state. Once the dequeue rate estimate is reset, the updates before
+    // leaving the IN_BURST state only increment the burst reset counter
+    bool reset =
+        (state.avgDqRate == 0 && (m_useDqRateEstimator || state.dqCount == DQCOUNT_INVALID));
+    if (state.dropProb == 0 && c >= 0 && m_qDelayRef.IsStrictlyPositive() && reset &&
+        state.burstState == PieQueueDisc::IN_BURST)
+    {
+        auto burstResetLimit = static_cast<uint32_t>(BURST_RESET_TIMEOUT / m_tUpdate.GetSeconds());
+        int64_t n = std::min<int64_t>(due, int64_t{burstResetLimit} - state.burstReset);
+        if (n > 0)
+        {
+            state.burstReset += n;
+            state.qDelay = Seconds(0);
+        }
+        return std::max<int64_t>(n, 0);
+    }
+    return 0;
+}
+
+template <typename S, typename Q>
+void
+PieFlowAqm::CalculateP(S& state, const Q& queue) const
+{
+    Time qDelay;
+    double p = 0.0;
+    bool missingInitFlag = false;
+
+    if (m_useDqRateEstimator)
+    {
+        if (state.avgDqRate > 0)
+        {
+            qDelay = Seconds(queue.GetNBytes() / state.avgDqRate);
+        }
+        else
+        {
+            qDelay = Seconds(0);
+            missingInitFlag = true;
+        }
+        state.qDelay = qDelay;
+    }
+    else
+    {
+        qDelay = state.qDelay;
+    }
+
+    if (state.burstAllowance.GetSeconds() > 0)
+    {
+        state.dropProb = 0;
+    }
+    else
+    {
+        p = m_a * (qDelay.GetSeconds() - m_qDelayRef.GetSeconds()) +
+            m_b * (qDelay.GetSeconds() - state.qDelayOld.GetSeconds());
+        if (state.dropProb < 0.000001)
+        {
+            p /= 2048;
+        }
+        else if (state.dropProb < 0.00001)
+        {
+            p /= 512;
+        }
+        else if (state.dropProb < 0.0001)
+        {
+            p /= 128;
+        }
+        else if (state.dropProb < 0.001)
+        {
+            p /= 32;
+        }
+        else if (state.dropProb < 0.01)
+        {
+            p /= 8;
+        }
+        else if (state.dropProb < 0.1)
+        {
+            p /= 2;
+        }
+
+        // Cap Drop Adjustment (Section 5.5 of RFC 8033)
+        if (m_isCapDropAdjustment && (state.dropProb >= 0.1) && (p > 0.02))
+        {
+            p = 0.02;
+        }
+    }
+
+    p += state.dropProb;
+
+    // Decay the drop probability exponentially (Section 4.2 of RFC 8033)
+    if (qDelay.GetSeconds() == 0 && state.qDelayOld.GetSeconds() == 0)
+    {
+        p *= 0.98;
+    }
+
+    // bound the drop probability (Section 4.2 of RFC 8033)
+    state.dropProb = std::clamp(p, 0.0, 1.0);
+
+    // Section 4.4 #2
+    if (state.burstAllowance < m_tUpdate)
+    {
+        state.burstAllowance = Seconds(0);
+    }
+    else
+    {
+        state.burstAllowance -= m_tUpdate;
+    }
+
+    auto burstResetLimit = static_cast<uint32_t>(BURST_RESET_TIMEOUT / m_tUpdate.GetSeconds());
+    bool lowDelay = (qDelay.GetSeconds() < 0.5 * m_qDelayRef.GetSeconds()) &&
+                    (state.qDelayOld.GetSeconds() < 0.5 * m_qDelayRef.GetSeconds()) &&
+                    (state.dropProb == 0);
+    if (lowDelay && !missingInitFlag)
+    {
+        state.dqCount = DQCOUNT_INVALID;
+        state.avgDqRate = 0.0;
+    }
+    if (lowDelay && (state.burstAllowance.GetSeconds() == 0))
+    {
+        if (state.burstState == PieQueueDisc::IN_BURST_PROTECTING)
+        {
+            state.burstState = PieQueueDisc::IN_BURST;
+            state.burstReset = 0;
+        }
+        else if (state.burstState == PieQueueDisc::IN_BURST)
+        {
+            state.burstReset++;
+            if (state.burstReset > burstResetLimit)
+            {
+                state.burstReset = 0;
+                state.burstState = PieQueueDisc::NO_BURST;
+            }
+        }
+    }
+    else if (state.burstState == PieQueueDisc::IN_BURST)
+    {
+        state.burstReset = 0;
+    }
+
+    state.qDelayOld = qDelay;
+}
+
+template <typename S, typename Q>
+bool
+PieFlowAqm::DropEarly(S& state, const Q& queue, Ptr<const QueueDiscItem> item) const
+{
+    if (state.burstAllowance.GetSeconds() > 0)
+    {
+        // If there is still burst_allowance left, skip random early drop.
+        return false;
+    }
+
+    if (state.burstState == PieQueueDisc::NO_BURST)
+    {
+        state.burstState = PieQueueDisc::IN_BURST_PROTECTING;
+        state.burstAllowance = m_maxBurst;
+    }
+
+    double p = state.dropProb;
+    bool bytes = (m_maxSize.GetUnit() == QueueSizeUnit::BYTES);
+
+    if (bytes)
+    {
+        p = p * item->GetSize() / m_meanPktSize;
+    }
+
+    // Safeguard PIE to be work conserving (Section 4.1 of RFC 8033)
+    if ((state.qDelayOld.GetSeconds() < (0.5 * m_qDelayRef.GetSeconds())) &&
+        (state.dropProb < 0.2))
+    {
+        return false;
+    }
+    else if (bytes && queue.GetNBytes() <= 2 * m_meanPktSize)
+    {
+        return false;
+    }
+    else if (!bytes && queue.GetNPackets() <= 2)
+    {
+        return false;
+    }
+
+    if (m_useDerandomization)
+    {
+        if (state.dropProb == 0)
+        {
+            state.accuProb = 0;
+        }
+        state.accuProb += state.dropProb;
+        if (state.accuProb < 0.85)
+        {
+            return false;
+        }
+        else if (state.accuProb >= 8.5)
+        {
+            return true;
+        }
+    }
+
+    return m_uv->GetValue() <= p;
+}
+
+bool
+PieFlowAqm::Enqueue(State& state, FlowAqmQueue& queue, Ptr<QueueDiscItem> item)
+{
+    NS_LOG_FUNCTION(this << item);
+
+    Update(state, queue);
+
+    if (!Fits(queue, item))
+    {
+        // Drops due to queue limit: reactive
+        m_dropBeforeEnqueue(item, PieQueueDisc::FORCED_DROP);
+        state.accuProb = 0;
+        return false;
+    }
+    // If L4S is enabled and the packet is ECT1, then directly enqueue the packet
+    if (!(m_useL4s && IsL4s(item)) && DropEarly(state, queue, item))
+    {
+        if (!m_useEcn || state.dropProb >= m_markEcnTh ||
+            !m_mark(item, PieQueueDisc::UNFORCED_MARK))
+        {
+            // Early probability drop: proactive
+            m_dropBeforeEnqueue(item, PieQueueDisc::UNFORCED_DROP);
+            state.accuProb = 0;
+            return false;
+        }
+    }
+
+    queue.Push(item);
+    return true;
+}
+
+Ptr<QueueDiscItem>
+PieFlowAqm::Dequeue(State& state, FlowAqmQueue& queue)
+{
+    NS_LOG_FUNCTION(this);
+    Update(state, queue);
+    return DoDequeue(state, queue);
+}
+
+template <typename S, typename Q>
+Ptr<QueueDiscItem>
+PieFlowAqm::DoDequeue(S& state, Q& queue)
+{
+    Ptr<QueueDiscItem> item = Pop(queue);
+    if (!item)
+    {
+        NS_LOG_LOGIC("Queue empty");
+        return nullptr;
+    }
+
+    // If L4S is enabled and packet is ECT1, then check if delay is greater than
+    // CE threshold and if it is then mark the packet, skip PIE steps, and return the item
+    if (m_useL4s && IsL4s(item))
+    {
+        if (Simulator::Now() - item->GetTimeStamp() > m_ceThreshold)
+        {
+            m_mark(item, PieQueueDisc::CE_THRESHOLD_EXCEEDED_MARK);
+        }
+        return item;
+    }
+
+    if (!m_useDqRateEstimator)
+    {
+        state.qDelay = (queue.IsEmpty() ? Seconds(0) : Simulator::Now() - item->GetTimeStamp());
+        return item;
+    }
+
+    // if not in a measurement cycle and the queue has built up to dq_threshold,
+    // start the measurement cycle
+    if (queue.GetNBytes() >= m_dqThreshold && !state.inMeasurement)
+    {
+        state.dqStart = Simulator::Now();
+        state.dqCount = 0;
+        state.inMeasurement = true;
+    }
+
+    if (state.inMeasurement)
+    {
+        state.dqCount += item->GetSize();
+
+        // done with a measurement cycle
+        if (state.dqCount >= m_dqThreshold)
+        {
+            Time dqTime = Simulator::Now() - state.dqStart;
+            if (dqTime.IsStrictlyPositive())
+            {
+                double rate = state.dqCount / dqTime.GetSeconds();
+                state.avgDqRate =
+                    (state.avgDqRate == 0 ? rate : 0.5 * state.avgDqRate + 0.5 * rate);
+            }
+
+            // restart a measurement cycle if there is enough data
+            state.inMeasurement = (queue.GetNBytes() > m_dqThreshold);
+            state.dqStart = (state.inMeasurement ? Simulator::Now() : state.dqStart);
+            state.dqCount = 0;
+        }
+    }
+    return item;
+}
+
+Ptr<QueueDiscItem>
+PieFlowAqm::Remove(State& state, FlowAqmQueue& queue)
+{
+    NS_LOG_FUNCTION(this);
+    Update(state, queue);
+    return Pop(queue);
+}
+
+template void PieFlowAqm::CalculateP(QueueDiscState&, const QueueDisc::InternalQueue&) const;
+template bool PieFlowAqm::DropEarly(QueueDiscState&,
+                                    const QueueDisc::InternalQueue&,
+                                    Ptr<const QueueDiscItem>) const;
+template Ptr<QueueDiscItem> PieFlowAqm::DoDequeue(QueueDiscState&, QueueDisc::InternalQueue&);
+
+NS_OBJECT_ENSURE_REGISTERED(CobaltFlowAqm);
+
+TypeId
+CobaltFlowAqm::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::CobaltFlowAqm")
+            .SetParent<FlowAqm>()
+            .SetGroupName("TrafficControl")
+            .AddConstructor<CobaltFlowAqm>()
+            .AddAttribute("Interval",
+                          "The Cobalt algorithm interval",
+                          StringValue("100ms"),
+                          MakeTimeAccessor(&CobaltFlowAqm::m_interval),
+                          MakeTimeChecker())
+            .AddAttribute("Target",
+                          "The Cobalt algorithm target queue delay",
+                          StringValue("5ms"),
+                          MakeTimeAccessor(&CobaltFlowAqm::m_target),
+                          MakeTimeChecker())
+            .AddAttribute("UseEcn",
+                          "True to use ECN (packets are marked instead of being dropped)",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&CobaltFlowAqm::m_useEcn),
+                          MakeBooleanChecker())
+            .AddAttribute("Increment",
+                          "Pdrop increment value",
+                          DoubleValue(1. / 256),
+                          MakeDoubleAccessor(&CobaltFlowAqm::m_increment),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("Decrement",
+                          "Pdrop decrement Value",
+                          DoubleValue(1. / 4096),
+                          MakeDoubleAccessor(&CobaltFlowAqm::m_decrement),
+                          MakeDoubleChecker<double>())
+            .AddAttribute("CeThreshold",
+                          "The Cobalt CE threshold for marking packets",
+                          TimeValue(Time::Max()),
+                          MakeTimeAccessor(&CobaltFlowAqm::m_ceThreshold),
+                          MakeTimeChecker())
+            .AddAttribute("UseL4s",
+                          "True to use L4S (only ECT1 packets are marked at CE threshold)",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&CobaltFlowAqm::m_useL4s),
+                          MakeBooleanChecker())
+            .AddAttribute("BlueThreshold",
+                          "The Threshold after which Blue is enabled",
+                          TimeValue(MilliSeconds(400)),
+                          MakeTimeAccessor(&CobaltFlowAqm::m_blueThreshold),
+                          MakeTimeChecker());
+    return tid;
+}
+
+CobaltFlowAqm::CobaltFlowAqm()
+{
+    NS_LOG_FUNCTION(this);
+    m_uv = CreateObject<UniformRandomVariable>();
+
+    // cache the initial values of the reciprocal inverse square root, which
+    // are shared by all the flows
+    State state;
+    m_recInvSqrtCache[0] = state.recInvSqrt;
+    for (state.count = 1; state.count < REC_INV_SQRT_CACHE; state.count++)
+    {
+        for (uint8_t i = 0; i < 4; i++)
+        {
+            uint32_t invsqrt = state.recInvSqrt;
+            uint32_t invsqrt2 = ((uint64_t)invsqrt * invsqrt) >> 32;
+            uint64_t val = (3LL << 32) - ((uint64_t)state.count * invsqrt2);
+            val >>= 2; /* avoid overflow */
+            state.recInvSqrt = (val * invsqrt) >> (32 - 2 + 1);
+        }
+        m_recInvSqrtCache[state.count] = state.recInvSqrt;
+    }
+}
+
+CobaltFlowAqm::~CobaltFlowAqm()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+CobaltFlowAqm::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_uv = nullptr;
+    FlowAqm::DoDispose();
+}
+
+int64_t
+CobaltFlowAqm::AssignStreams(int64_t stream)
+{
+    NS_LOG_FUNCTION(this << stream);
+    m_uv->SetStream(stream);
+    return 1;
+}
+
+template <typename S>
+void
+CobaltFlowAqm::InvSqrt(S& state) const
+{
+    if (state.count < static_cast<uint32_t>(REC_INV_SQRT_CACHE))
+    {
+        state.recInvSqrt = m_recInvSqrtCache[state.count];
+        return;
+    }
+    // Newton's method step
+    uint32_t invsqrt = state.recInvSqrt;
+    uint32_t invsqrt2 = ((uint64_t)invsqrt * invsqrt) >> 32;
+    uint64_t val = (3LL << 32) - ((uint64_t)state.count * invsqrt2);
+    val >>= 2; /* avoid overflow */
+    state.recInvSqrt = (val * invsqrt) >> (32 - 2 + 1);
+}
+
+template <typename S>
+int64_t
+CobaltFlowAqm::ControlLaw(const S& state, int64_t t) const
+{
+    return t + ReciprocalDivide(m_interval.GetNanoSeconds(), state.recInvSqrt);
+}
+
+template <typename S>
+void
+CobaltFlowAqm::QueueFull(S& state, int64_t now) const
+{
+    if (CoDelTimeAfter(now - state.lastUpdateTimeBlue, m_target.GetNanoSeconds()))
+    {
+        state.pDrop = std::min(state.pDrop + m_increment, 1.0);
+        state.lastUpdateTimeBlue = now;
+    }
+    state.dropping = true;
+    state.dropNext = now;
+    if (!state.count)
+    {
+        state.count = 1;
+    }
+}
+
+template <typename S>
+void
+CobaltFlowAqm::QueueEmpty(S& state, int64_t now) const
+{
+    if (state.pDrop && CoDelTimeAfter(now - state.lastUpdateTimeBlue, m_target.GetNanoSeconds()))
+    {
+        state.pDrop = std::max(state.pDrop - m_decrement, 0.0);
+        state.lastUpdateTimeBlue = now;
+    }
+    state.dropping = false;
+
+    if (state.count && CoDelTimeAfterEq(now - state.dropNext, 0))
+    {
+        state.count--;
+        InvSqrt(state);
+        state.dropNext = ControlLaw(state, state.dropNext);
+    }
+}
+
+template <typename S>
+bool
+CobaltFlowAqm::ShouldDrop(S& state, Ptr<QueueDiscItem> item, int64_t now)
+{
+    bool drop = false;
+
+    /* Simplified Codel implementation */
+    int64_t sojournTime = (Simulator::Now() - item->GetTimeStamp()).GetNanoSeconds();
+    int64_t schedule = now - state.dropNext;
+    bool overTarget = CoDelTimeAfter(sojournTime, m_target.GetNanoSeconds());
+    bool nextDue = state.count && schedule >= 0;
+    bool isMarked = false;
+
+    // If L4S mode is enabled, ECT1 and CE packets are only marked if the
+    // sojourn time is greater than the CE threshold
+    if (m_useL4s && IsL4s(item))
+    {
+        if (CoDelTimeAfter(sojournTime, m_ceThreshold.GetNanoSeconds()))
+        {
+            m_mark(item, CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK);
+        }
+        return false;
+    }
+
+    if (overTarget)
+    {
+        if (!state.dropping)
+        {
+            state.dropping = true;
+            state.dropNext = ControlLaw(state, now);
+        }
+        if (!state.count)
+        {
+            state.count = 1;
+        }
+    }
+    else if (state.dropping)
+    {
+        state.dropping = false;
+    }
+
+    if (nextDue && state.dropping)
+    {
+        // Check for marking possibility only if BLUE decides NOT to drop
+        isMarked = (m_useEcn && m_mark(item, CobaltQueueDisc::FORCED_MARK));
+        drop = !isMarked;
+
+        state.count = std::max(state.count, state.count + 1);
+
+        InvSqrt(state);
+        state.dropNext = ControlLaw(state, state.dropNext);
+        schedule = now - state.dropNext;
+    }
+    else
+    {
+        while (nextDue)
+        {
+            state.count--;
+            InvSqrt(state);
+            state.dropNext = ControlLaw(state, state.dropNext);
+            schedule = now - state.dropNext;
+            nextDue = state.count && schedule >= 0;
+        }
+    }
+
+    // If the packet was marked, a second attempt at marking is suppressed.
+    // If L4S is enabled, ECT0 packets are not marked at the CE threshold
+    if (!isMarked && !m_useL4s && m_useEcn &&
+        CoDelTimeAfter(sojournTime, m_ceThreshold.GetNanoSeconds()))
+    {
+        m_mark(item, CobaltQueueDisc::CE_THRESHOLD_EXCEEDED_MARK);
+    }
+
+    // Enable Blue Enhancement if sojourn time is greater than blueThreshold and
+    // it's been target time since the last time blue was updated
+    if (CoDelTimeAfter(sojournTime, m_blueThreshold.GetNanoSeconds()) &&
+        CoDelTimeAfter(now - state.lastUpdateTimeBlue, m_target.GetNanoSeconds()))
+    {
+        state.pDrop = std::min(state.pDrop + m_increment, 1.0);
+        state.lastUpdateTimeBlue = now;
+    }
+
+    /* Simple BLUE implementation. Lack of ECN is deliberate. */
+    if (state.pDrop)
+    {
+        // draw a random number even if the packet is already being dropped
+        double u = m_uv->GetValue();
+        drop = drop || (u < state.pDrop);
+    }
+
+    /* Overload the drop_next field as an activity timeout */
+    if (!state.count)
+    {
+        state.dropNext = now + m_interval.GetNanoSeconds();
+    }
+    else if (schedule > 0 && !drop)
+    {
+        state.dropNext = now;
+    }
+
+    return drop;
+}
+
+bool
+CobaltFlowAqm::Enqueue(State& state, FlowAqmQueue& queue, Ptr<QueueDiscItem> item)
+{
+    NS_LOG_FUNCTION(this << item);
+
+    if (!Fits(queue, item))
+    {
+        NS_LOG_LOGIC("Queue full -- dropping pkt");
+        // Call this to update Blue's drop probability
+        QueueFull(state, Simulator::Now().GetNanoSeconds());
+        m_dropBeforeEnqueue(item, CobaltQueueDisc::OVERLIMIT_DROP);
+        return false;
+    }
+
+    queue.Push(item);
+    return true;
+}
+
+template <typename S, typename Q>
+Ptr<QueueDiscItem>
+CobaltFlowAqm::Dequeue(S& state, Q& queue)
+{
+    NS_LOG_FUNCTION(this);
+
+    int64_t now = Simulator::Now().GetNanoSeconds();
+
+    while (Ptr<QueueDiscItem> item = Pop(queue))
+    {
+        // ECN marking happens inside ShouldDrop, so it need not be done here
+        if (!ShouldDrop(state, item, now))
+        {
+            return item;
+        }
+        m_dropAfterDequeue(item, CobaltQueueDisc::TARGET_EXCEEDED_DROP);
+    }
+
+    // Leave dropping state when queue is empty and update Blue's drop probability
+    NS_LOG_LOGIC("Queue empty");
+    QueueEmpty(state, now);
+    return nullptr;
+}
+
+Ptr<QueueDiscItem>
+CobaltFlowAqm::Remove(State& state, FlowAqmQueue& queue)
+{
+    NS_LOG_FUNCTION(this);
+    return Pop(queue);
+}
+
+template Ptr<QueueDiscItem> CobaltFlowAqm::Dequeue(State&, FlowAqmQueue&);
+template Ptr<QueueDiscItem> CobaltFlowAqm::Dequeue(QueueDiscState&, QueueDisc::InternalQueue&);
+template void CobaltFlowAqm::QueueFull(QueueDiscState&, int64_t) const;
+
+} // namespace ns3
@@ -0,0 +1,673 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLOW_AQM_H
+#define FLOW_AQM_H
+
+#include "cobalt-queue-disc.h"
+#include "codel-queue-disc.h"
+#include "pie-queue-disc.h"
+#include "queue-disc.h"
+
+#include "ns3/callback.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/ring-buffer.h"
+#include "ns3/traced-value.h"
+
+#include <cstdint>
+#include <limits>
+
+namespace ns3
+{
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief The packets of a flow whose AQM state is embedded in the parent queue disc
+ *
+ * A FlowAqmQueue is a plain FIFO of queue disc items which also keeps track of
+ * the number of bytes it stores. Unlike an internal queue, it has no attributes,
+ * no trace sources and no size limit, and it does not allocate memory until the
+ * first packet is stored.
+ */
+class FlowAqmQueue
+{
+  public:
+    FlowAqmQueue();
+
+    /**
+     * \brief Check whether the queue is empty
+     * \return true if the queue stores no packet
+     */
+    bool IsEmpty() const;
+
+    /**
+     * \brief Get the number of packets stored in the queue
+     * \return the number of packets stored in the queue
+     */
+    uint32_t GetNPackets() const;
+
+    /**
+     * \brief Get the number of bytes stored in the queue
+     * \return the number of bytes stored in the queue
+     */
+    uint32_t GetNBytes() const;
+
+    /**
+     * \brief Append a packet to the tail of the queue
+     * \param item the packet
+     */
+    void Push(Ptr<QueueDiscItem> item);
+
+    /**
+     * \brief Remove the packet at the head of the queue
+     * \return the removed packet, or a null pointer if the queue is empty
+     */
+    Ptr<QueueDiscItem> Pop();
+
+  private:
+    RingBuffer<Ptr<QueueDiscItem>> m_items; //!< the packets stored in the queue
+    uint32_t m_nBytes;                      //!< the number of bytes stored in the queue
+};
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief Base class for the AQM control laws that a queue disc embeds in each of its flows
+ *
+ * Flow queueing disciplines (such as FqCoDel) may apply an AQM algorithm to each
+ * flow by creating a child queue disc per flow. A child queue disc has its own
+ * statistics, trace sources, internal queue and attributes, and every packet goes
+ * through the bookkeeping of both the parent and the child queue disc.
+ *
+ * A FlowAqm object, instead, holds the parameters of an AQM algorithm and is shared
+ * by all the flows of a queue disc. The state that the algorithm maintains for each
+ * flow is stored in a small State structure (defined by each subclass), which is
+ * passed to the Enqueue and Dequeue methods of the subclasses along with the
+ * FlowAqmQueue storing the packets of the flow. The queue disc embedding the AQM
+ * keeps the statistics once for all the flows: the AQM notifies the queue disc of
+ * the packets removed from a flow queue and of the packets dropped or marked by
+ * means of callbacks.
+ *
+ * The queue discs implementing the same AQM algorithms (such as CoDelQueueDisc)
+ * run the code of the FlowAqm subclasses, too: they pass a QueueDiscState
+ * structure, which refers to the (possibly traced) variables of the queue disc,
+ * and their internal queue in place of a flow queue.
+ */
+class FlowAqm : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    FlowAqm();
+    ~FlowAqm() override;
+
+    /// Callback invoked when a packet is removed from a flow queue
+    typedef Callback<void, Ptr<const QueueDiscItem>> DequeueCallback;
+    /// Callback invoked when a packet is dropped, along with the reason for the drop
+    typedef Callback<void, Ptr<const QueueDiscItem>, const char*> DropCallback;
+    /// Callback invoked to mark a packet, which returns true if the packet was marked
+    typedef Callback<bool, Ptr<QueueDiscItem>, const char*> MarkCallback;
+
+    /**
+     * \brief Set the callback invoked when a packet is removed from a flow queue
+     * \param cb the callback
+     */
+    void SetDequeueCallback(DequeueCallback cb);
+
+    /**
+     * \brief Set the callback invoked when a packet is dropped before enqueue
+     * \param cb the callback
+     */
+    void SetDropBeforeEnqueueCallback(DropCallback cb);
+
+    /**
+     * \brief Set the callback invoked when a packet is dropped after dequeue
+     * \param cb the callback
+     */
+    void SetDropAfterDequeueCallback(DropCallback cb);
+
+    /**
+     * \brief Set the callback invoked to mark a packet
+     * \param cb the callback
+     */
+    void SetMarkCallback(MarkCallback cb);
+
+  protected:
+    /**
+     * \brief Check whether a packet can be added to a flow queue without
+     *        exceeding the maximum size of a flow queue
+     * \param queue the flow queue
+     * \param item the packet
+     * \return true if the packet fits in the flow queue
+     */
+    bool Fits(const FlowAqmQueue& queue, Ptr<const QueueDiscItem> item) const;
+
+    /**
+     * \brief Remove the packet at the head of a flow queue and notify the queue disc
+     * \param queue the flow queue
+     * \return the removed packet, or a null pointer if the flow queue is empty
+     */
+    Ptr<QueueDiscItem> Pop(FlowAqmQueue& queue);
+
+    /**
+     * \brief Remove the packet at the head of the internal queue of a queue disc
+     *        running the AQM (the queue disc accounts for the packet by itself)
+     * \param queue the internal queue
+     * \return the removed packet, or a null pointer if the internal queue is empty
+     */
+    static Ptr<QueueDiscItem> Pop(QueueDisc::InternalQueue& queue);
+
+    /**
+     * \brief Check whether a packet is ECT(1) or CE marked
+     * \param item the packet
+     * \return true if the packet is ECT(1) or CE marked
+     */
+    static bool IsL4s(Ptr<const QueueDiscItem> item);
+
+    QueueSize m_maxSize;                //!< Maximum size of a flow queue
+    DequeueCallback m_dequeue;          //!< Callback invoked when a packet is dequeued
+    DropCallback m_dropBeforeEnqueue;   //!< Callback invoked when a packet is dropped on enqueue
+    DropCallback m_dropAfterDequeue;    //!< Callback invoked when a packet is dropped on dequeue
+    MarkCallback m_mark;                //!< Callback invoked to mark a packet
+};
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief The CoDel control law, applied to the flows of a queue disc
+ *
+ * This class implements the algorithm of CoDelQueueDisc, whose per-flow
+ * variables are stored in a CoDelFlowAqm::State structure. CoDelQueueDisc
+ * runs the Dequeue method on its own variables.
+ */
+class CoDelFlowAqm : public FlowAqm
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    CoDelFlowAqm();
+    ~CoDelFlowAqm() override;
+
+    /// The variables maintained by CoDel for each flow
+    struct State
+    {
+        uint32_t count{0};          //!< Number of packets dropped since entering drop state
+        uint32_t lastCount{0};      //!< Last number of packets dropped since entering drop state
+        uint32_t firstAboveTime{0}; //!< Time to declare sojourn time above target
+        uint32_t dropNext{0};       //!< Time to drop next packet
+        /// Reciprocal inverse square root
+        uint16_t recInvSqrt{static_cast<uint16_t>(~0U >> REC_INV_SQRT_SHIFT)};
+        bool dropping{false}; //!< True if in dropping state
+    };
+
+    /// References to the variables of a CoDelQueueDisc, some of which are traced
+    struct QueueDiscState
+    {
+        TracedValue<uint32_t>& count;     //!< Number of packets dropped since entering drop state
+        TracedValue<uint32_t>& lastCount; //!< Last number of packets dropped in drop state
+        uint32_t& firstAboveTime;         //!< Time to declare sojourn time above target
+        TracedValue<uint32_t>& dropNext;  //!< Time to drop next packet
+        uint16_t& recInvSqrt;             //!< Reciprocal inverse square root
+        TracedValue<bool>& dropping;      //!< True if in dropping state
+    };
+
+    /**
+     * \brief Add a packet to a flow queue, unless the flow queue is full
+     * \param state the CoDel state of the flow
+     * \param queue the flow queue
+     * \param item the packet
+     * \return true if the packet was enqueued, false if it was dropped
+     */
+    bool Enqueue(State& state, FlowAqmQueue& queue, Ptr<QueueDiscItem> item);
+
+    /**
+     * \brief Remove a packet from a flow queue, dropping or marking packets as
+     *        required by the CoDel control law
+     * \tparam S the type of the CoDel state (State or QueueDiscState)
+     * \tparam Q the type of the queue (FlowAqmQueue or QueueDisc::InternalQueue)
+     * \param state the CoDel state of the flow
+     * \param queue the flow queue
+     * \return the dequeued packet, or a null pointer if the flow queue is empty
+     */
+    template <typename S, typename Q>
+    Ptr<QueueDiscItem> Dequeue(S& state, Q& queue);
+
+    /**
+     * \brief Remove the packet at the head of a flow queue without applying the
+     *        control law (e.g., because the queue disc drops it on overflow)
+     * \param state the CoDel state of the flow
+     * \param queue the flow queue
+     * \return the removed packet, or a null pointer if the flow queue is empty
+     */
+    Ptr<QueueDiscItem> Remove(State& state, FlowAqmQueue& queue);
+
+  private:
+    /**
+     * \brief Determine whether a packet is OK to be dropped
+     * \tparam S the type of the CoDel state
+     * \tparam Q the type of the queue
+     * \param state the CoDel state of the flow
+     * \param queue the flow queue
+     * \param item the packet
+     * \param now the current time in CoDel time units
+     * \return true if the sojourn time has been above target for at least interval
+     */
+    template <typename S, typename Q>
+    bool OkToDrop(S& state, const Q& queue, Ptr<const QueueDiscItem> item, uint32_t now) const;
+
+    bool m_useEcn;       //!< True if ECN is used (packets are marked instead of being dropped)
+    bool m_useL4s;       //!< True if L4S is used (ECT1 packets are marked at CE threshold)
+    uint32_t m_minBytes; //!< Minimum bytes in queue to allow a packet drop
+    Time m_interval;     //!< Sliding minimum time window width
+    Time m_target;       //!< Target queue delay
+    Time m_ceThreshold;  //!< Threshold above which to CE mark
+};
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief The PIE control law, applied to the flows of a queue disc
+ *
+ * This class implements the algorithm of PieQueueDisc, whose per-flow
+ * variables are stored in a PieFlowAqm::State structure. PieQueueDisc runs
+ * the CalculateP, DropEarly and DoDequeue methods on its own variables, and
+ * it updates the drop probability every Tupdate by means of a timer. Scheduling a timer per
+ * flow would defeat the purpose of embedding the AQM state in the parent queue
+ * disc, hence the drop probability of a flow is updated when the flow is
+ * accessed, by running all the updates that were due since the last access.
+ * Between two accesses, the backlog of a flow does not change, so the result is
+ * the same as if the updates had been run on time. While the queue delay of a
+ * flow is null (e.g., the flow is idle), each update decays the drop probability
+ * by means of the same affine map, hence the updates due in such a period are
+ * applied in closed form rather than one at a time.
+ */
+class PieFlowAqm : public FlowAqm
+{
+    friend class PieQueueDisc; // Runs the control law on its own variables
+
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    PieFlowAqm();
+    ~PieFlowAqm() override;
+
+    /// The variables maintained by PIE for each flow
+    struct State
+    {
+        double dropProb{0};     //!< Drop probability
+        double accuProb{0};     //!< Accumulated drop probability
+        double avgDqRate{0};    //!< Time averaged dequeue rate
+        Time qDelayOld;         //!< Old value of queue delay
+        Time qDelay;            //!< Current value of queue delay
+        Time burstAllowance;    //!< Current burst allowance before random drops kick in
+        Time dqStart;           //!< Start timestamp of current measurement cycle
+        Time nextUpdate{Time::Max()}; //!< Time of the next drop probability update
+        uint64_t dqCount{DQCOUNT_INVALID}; //!< Bytes departed since the measurement cycle start
+        uint32_t burstReset{0};            //!< Used to reset the burst allowance
+        uint8_t burstState{PieQueueDisc::NO_BURST}; //!< Current burst state
+        bool inMeasurement{false}; //!< Whether we are in a measurement cycle
+    };
+
+    /// References to the variables of a PieQueueDisc
+    struct QueueDiscState
+    {
+        double& dropProb;                      //!< Drop probability
+        double& accuProb;                      //!< Accumulated drop probability
+        double& avgDqRate;                     //!< Time averaged dequeue rate
+        Time& qDelayOld;                       //!< Old value of queue delay
+        Time& qDelay;                          //!< Current value of queue delay
+        Time& burstAllowance;                  //!< Current burst allowance
+        Time& dqStart;                         //!< Start timestamp of current measurement cycle
+        uint64_t& dqCount;                     //!< Bytes departed since the cycle start
+        uint32_t& burstReset;                  //!< Used to reset the burst allowance
+        PieQueueDisc::BurstStateT& burstState; //!< Current burst state
+        bool& inMeasurement;                   //!< Whether we are in a measurement cycle
+    };
+
+    /**
+     * Assign a fixed random variable stream number to the random variables
+     * used by this model.  Return the number of streams (possibly zero) that
+     * have been assigned.
+     *
+     * \param stream first stream index to use
+     * \return the number of stream indices assigned by this model
+     */
+    int64_t AssignStreams(int64_t stream);
+
+    /**
+     * \brief Add a packet to a flow queue, unless the flow queue is full or
+     *        the packet is early dropped
+     * \param state the PIE state of the flow
+     * \param queue the flow queue
+     * \param item the packet
+     * \return true if the packet was enqueued, false if it was dropped
+     */
+    bool Enqueue(State& state, FlowAqmQueue& queue, Ptr<QueueDiscItem> item);
+
+    /**
+     * \brief Remove a packet from a flow queue and update the dequeue rate estimate
+     * \param state the PIE state of the flow
+     * \param queue the flow queue
+     * \return the dequeued packet, or a null pointer if the flow queue is empty
+     */
+    Ptr<QueueDiscItem> Dequeue(State& state, FlowAqmQueue& queue);
+
+    /**
+     * \brief Remove the packet at the head of a flow queue without applying the
+     *        control law (e.g., because the queue disc drops it on overflow)
+     * \param state the PIE state of the flow
+     * \param queue the flow queue
+     * \return the removed packet, or a null pointer if the flow queue is empty
+     */
+    Ptr<QueueDiscItem> Remove(State& state, FlowAqmQueue& queue);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /**
+     * \brief Run the drop probability updates that were due since the flow was
+     *        last accessed
+     * \param state the PIE state of the flow
+     * \param queue the flow queue
+     */
+    void Update(State& state, const FlowAqmQueue& queue) const;
+
+    /**
+     * \brief Apply at once a number of consecutive updates of a flow whose queue
+     *        delay is null, as long as their effect can be computed in closed form
+     * \param state the PIE state of the flow
+     * \param due the number of updates that are due
+     * \return the number of updates applied (at most due), which is zero if the
+     *         next update has to be run by CalculateP
+     */
+    int64_t SkipIdleUpdates(State& state, int64_t due) const;
+
+    /**
+     * \brief Update the drop probability of a flow
+     * \tparam S the type of the PIE state (State or QueueDiscState)
+     * \tparam Q the type of the queue (FlowAqmQueue or QueueDisc::InternalQueue)
+     * \param state the PIE state of the flow
+     * \param queue the flow queue
+     */
+    template <typename S, typename Q>
+    void CalculateP(S& state, const Q& queue) const;
+
+    /**
+     * \brief Check if a packet needs to be dropped due to probability drop
+     * \tparam S the type of the PIE state
+     * \tparam Q the type of the queue
+     * \param state the PIE state of the flow
+     * \param queue the flow queue
+     * \param item the packet
+     * \return true if the packet has to be dropped
+     */
+    template <typename S, typename Q>
+    bool DropEarly(S& state, const Q& queue, Ptr<const QueueDiscItem> item) const;
+
+    /**
+     * \brief Remove a packet from a flow queue and update the dequeue rate
+     *        estimate, without running the updates of the drop probability
+     * \tparam S the type of the PIE state
+     * \tparam Q the type of the queue
+     * \param state the PIE state of the flow
+     * \param queue the flow queue
+     * \return the dequeued packet, or a null pointer if the flow queue is empty
+     */
+    template <typename S, typename Q>
+    Ptr<QueueDiscItem> DoDequeue(S& state, Q& queue);
+
+    static const uint64_t DQCOUNT_INVALID =
+        std::numeric_limits<uint64_t>::max(); //!< Invalid dqCount value
+
+    Time m_sUpdate;            //!< Start time of the update timer
+    Time m_tUpdate;            //!< Time period after which CalculateP () is called
+    Time m_qDelayRef;          //!< Desired queue delay
+    uint32_t m_meanPktSize;    //!< Average packet size in bytes
+    Time m_maxBurst;           //!< Maximum burst allowed before random early dropping kicks in
+    double m_a;                //!< Parameter to pie controller
+    double m_b;                //!< Parameter to pie controller
+    uint32_t m_dqThreshold;    //!< Minimum queue size in bytes before dequeue rate is measured
+    bool m_useDqRateEstimator; //!< Enable/Disable usage of dequeue rate estimator
+    bool m_isCapDropAdjustment; //!< Enable/Disable Cap Drop Adjustment (RFC 8033)
+    bool m_useEcn;              //!< Enable ECN Marking functionality
+    bool m_useDerandomization;  //!< Enable Derandomization feature mentioned in RFC 8033
+    double m_markEcnTh;         //!< ECN marking threshold
+    Time m_ceThreshold;         //!< Threshold above which to CE mark
+    bool m_useL4s;              //!< True if L4S is used (ECT1 packets are marked at CE threshold)
+    Ptr<UniformRandomVariable> m_uv; //!< Rng stream shared by all the flows
+};
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief The COBALT control law, applied to the flows of a queue disc
+ *
+ * This class implements the algorithm of CobaltQueueDisc, whose per-flow
+ * variables are stored in a CobaltFlowAqm::State structure. CobaltQueueDisc
+ * runs the Dequeue and QueueFull methods on its own variables. The cache of the
+ * initial values of the reciprocal inverse square root is shared by all the flows.
+ */
+class CobaltFlowAqm : public FlowAqm
+{
+    friend class CobaltQueueDisc; // Runs the control law on its own variables
+
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    CobaltFlowAqm();
+    ~CobaltFlowAqm() override;
+
+    /// The variables maintained by COBALT for each flow
+    struct State
+    {
+        int64_t dropNext{0};           //!< Time to drop next packet
+        int64_t lastUpdateTimeBlue{0}; //!< Blue's last update time for drop probability
+        double pDrop{0};               //!< Drop probability
+        uint32_t count{0};             //!< Number of packets dropped since entering drop state
+        uint32_t recInvSqrt{~0U};      //!< Reciprocal inverse square root
+        bool dropping{false};          //!< True if in dropping state
+    };
+
+    /// References to the variables of a CobaltQueueDisc, some of which are traced
+    struct QueueDiscState
+    {
+        TracedValue<int64_t>& dropNext; //!< Time to drop next packet
+        uint32_t& lastUpdateTimeBlue;   //!< Blue's last update time for drop probability
+        double& pDrop;                  //!< Drop probability
+        TracedValue<uint32_t>& count;   //!< Number of packets dropped since entering drop state
+        uint32_t& recInvSqrt;           //!< Reciprocal inverse square root
+        TracedValue<bool>& dropping;    //!< True if in dropping state
+    };
+
+    /**
+     * Assign a fixed random variable stream number to the random variables
+     * used by this model.  Return the number of streams (possibly zero) that
+     * have been assigned.
+     *
+     * \param stream first stream index to use
+     * \return the number of stream indices assigned by this model
+     */
+    int64_t AssignStreams(int64_t stream);
+
+    /**
+     * \brief Add a packet to a flow queue, unless the flow queue is full
+     * \param state the COBALT state of the flow
+     * \param queue the flow queue
+     * \param item the packet
+     * \return true if the packet was enqueued, false if it was dropped
+     */
+    bool Enqueue(State& state, FlowAqmQueue& queue, Ptr<QueueDiscItem> item);
+
+    /**
+     * \brief Remove a packet from a flow queue, dropping or marking packets as
+     *        required by the COBALT control law
+     * \tparam S the type of the COBALT state (State or QueueDiscState)
+     * \tparam Q the type of the queue (FlowAqmQueue or QueueDisc::InternalQueue)
+     * \param state the COBALT state of the flow
+     * \param queue the flow queue
+     * \return the dequeued packet, or a null pointer if the flow queue is empty
+     */
+    template <typename S, typename Q>
+    Ptr<QueueDiscItem> Dequeue(S& state, Q& queue);
+
+    /**
+     * \brief Remove the packet at the head of a flow queue without applying the
+     *        control law (e.g., because the queue disc drops it on overflow)
+     * \param state the COBALT state of the flow
+     * \param queue the flow queue
+     * \return the removed packet, or a null pointer if the flow queue is empty
+     */
+    Ptr<QueueDiscItem> Remove(State& state, FlowAqmQueue& queue);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /**
+     * \brief Update the reciprocal inverse square root of the count of a flow
+     * \tparam S the type of the COBALT state (State or QueueDiscState)
+     * \param state the COBALT state of the flow
+     */
+    template <typename S>
+    void InvSqrt(S& state) const;
+
+    /**
+     * \brief Determine the time for next drop
+     * \tparam S the type of the COBALT state
+     * \param state the COBALT state of the flow
+     * \param t the current next drop time
+     * \return the new next drop time
+     */
+    template <typename S>
+    int64_t ControlLaw(const S& state, int64_t t) const;
+
+    /**
+     * \brief Update the state of a flow whose packet was dropped due to queue overflow
+     * \tparam S the type of the COBALT state
+     * \param state the COBALT state of the flow
+     * \param now the current time
+     */
+    template <typename S>
+    void QueueFull(S& state, int64_t now) const;
+
+    /**
+     * \brief Update the state of a flow that was serviced but turned out to be empty
+     * \tparam S the type of the COBALT state
+     * \param state the COBALT state of the flow
+     * \param now the current time
+     */
+    template <typename S>
+    void QueueEmpty(S& state, int64_t now) const;
+
+    /**
+     * \brief Determine whether a packet has to be dropped, based on the decisions
+     *        taken by CoDel and Blue
+     * \tparam S the type of the COBALT state
+     * \param state the COBALT state of the flow
+     * \param item the packet
+     * \param now the current time
+     * \return true if the packet has to be dropped
+     */
+    template <typename S>
+    bool ShouldDrop(S& state, Ptr<QueueDiscItem> item, int64_t now);
+
+    Time m_interval;      //!< Sliding minimum time window width
+    Time m_target;        //!< Target queue delay
+    bool m_useEcn;        //!< True if ECN is used (packets are marked instead of being dropped)
+    Time m_ceThreshold;   //!< Threshold above which to CE mark
+    bool m_useL4s;        //!< True if L4S is used (ECT1 packets are marked at CE threshold)
+    Time m_blueThreshold; //!< Threshold to enable blue enhancement
+    double m_increment;   //!< Increment value for marking probability
+    double m_decrement;   //!< Decrement value for marking probability
+    uint32_t m_recInvSqrtCache[REC_INV_SQRT_CACHE]; //!< Initial values of InvSqrt
+    Ptr<UniformRandomVariable> m_uv;                //!< Rng stream shared by all the flows
+};
+
+/***************************************************************
+ *  Implementation of the inline functions declared above.
+ ***************************************************************/
+
+inline bool
+FlowAqmQueue::IsEmpty() const
+{
+    return m_items.empty();
+}
+
+inline uint32_t
+FlowAqmQueue::GetNPackets() const
+{
+    return m_items.size();
+}
+
+inline uint32_t
+FlowAqmQueue::GetNBytes() const
+{
+    return m_nBytes;
+}
+
+inline void
+FlowAqmQueue::Push(Ptr<QueueDiscItem> item)
+{
+    m_nBytes += item->GetSize();
+    m_items.push_back(std::move(item));
+}
+
+inline Ptr<QueueDiscItem>
+FlowAqmQueue::Pop()
+{
+    if (m_items.empty())
+    {
+        return nullptr;
+    }
+    Ptr<QueueDiscItem> item = std::move(m_items.front());
+    m_items.pop_front();
+    m_nBytes -= item->GetSize();
+    return item;
+}
+
+inline Ptr<QueueDiscItem>
+FlowAqm::Pop(FlowAqmQueue& queue)
+{
+    Ptr<QueueDiscItem> item = queue.Pop();
+    if (item)
+    {
+        m_dequeue(item);
+    }
+    return item;
+}
+
+} // namespace ns3
+
+#endif /* FLOW_AQM_H */
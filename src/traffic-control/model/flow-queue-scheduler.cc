@@ -0,0 +1,145 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "flow-queue-scheduler.h"
+
+#include "ns3/log.h"
+
+#include <utility>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("FlowQueueScheduler");
+
+FlowQueueScheduler::FlowQueueScheduler()
+{
+    NS_LOG_FUNCTION(this);
+    Reset(0);
+}
+
+void
+FlowQueueScheduler::Reset(uint32_t nFlows)
+{
+    NS_LOG_FUNCTION(this << nFlows);
+
+    m_next.assign(nFlows, NO_FLOW);
+    m_lists.assign(nFlows, NO_LIST);
+    for (uint8_t list = NEW_FLOWS; list < NO_LIST; list++)
+    {
+        m_heads[list] = NO_FLOW;
+        m_tails[list] = NO_FLOW;
+        m_sizes[list] = 0;
+    }
+
+    m_backlogHeap.clear();
+    m_backlogHeap.reserve(nFlows);
+    m_backlogs.assign(nFlows, 0);
+    m_heapPos.assign(nFlows, NOT_IN_HEAP);
+}
+
+void
+FlowQueueScheduler::SetBacklog(uint32_t flow, uint32_t bytes)
+{
+    uint32_t old = m_backlogs[flow];
+    uint32_t pos = m_heapPos[flow];
+    m_backlogs[flow] = bytes;
+
+    if (pos == NOT_IN_HEAP)
+    {
+        if (bytes > 0)
+        {
+            m_heapPos[flow] = m_backlogHeap.size();
+            m_backlogHeap.push_back(flow);
+            SiftUp(m_backlogHeap.size() - 1);
+        }
+        return;
+    }
+
+    if (bytes == 0)
+    {
+        // replace the flow with the last element of the heap and restore the heap
+        uint32_t last = m_backlogHeap.size() - 1;
+        Swap(pos, last);
+        m_backlogHeap.pop_back();
+        m_heapPos[flow] = NOT_IN_HEAP;
+        if (pos < m_backlogHeap.size())
+        {
+            SiftUp(pos);
+            SiftDown(pos);
+        }
+        return;
+    }
+
+    if (bytes > old)
+    {
+        SiftUp(pos);
+    }
+    else if (bytes < old)
+    {
+        SiftDown(pos);
+    }
+}
+
+void
+FlowQueueScheduler::SiftUp(uint32_t pos)
+{
+    while (pos > 0)
+    {
+        uint32_t parent = (pos - 1) / 2;
+        if (m_backlogs[m_backlogHeap[parent]] >= m_backlogs[m_backlogHeap[pos]])
+        {
+            break;
+        }
+        Swap(pos, parent);
+        pos = parent;
+    }
+}
+
+void
+FlowQueueScheduler::SiftDown(uint32_t pos)
+{
+    uint32_t size = m_backlogHeap.size();
+    while (true)
+    {
+        uint32_t largest = pos;
+        uint32_t left = 2 * pos + 1;
+        uint32_t right = left + 1;
+        if (left < size && m_backlogs[m_backlogHeap[left]] > m_backlogs[m_backlogHeap[largest]])
+        {
+            largest = left;
+        }
+        if (right < size && m_backlogs[m_backlogHeap[right]] > m_backlogs[m_backlogHeap[largest]])
+        {
+            largest = right;
+        }
+        if (largest == pos)
+        {
+            break;
+        }
+        Swap(pos, largest);
+        pos = largest;
+    }
+}
+
+void
+FlowQueueScheduler::Swap(uint32_t i, uint32_t j)
+{
+    std::swap(m_backlogHeap[i], m_backlogHeap[j]);
+    m_heapPos[m_backlogHeap[i]] = i;
+    m_heapPos[m_backlogHeap[j]] = j;
+}
+
+} // namespace ns3
@@ -0,0 +1,325 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FLOW_QUEUE_SCHEDULER_H
+#define FLOW_QUEUE_SCHEDULER_H
+
+#include "ns3/assert.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief The bookkeeping shared by the flow queueing disciplines (FqCoDel,
+ * FqPie, FqCobalt and DRR)
+ *
+ * Flows are identified by an index ranging from zero to the number of flows
+ * minus one (typically, the index of the hash bucket their packets are
+ * classified into). This class keeps, in flat arrays allocated once by Reset:
+ *
+ * - the lists of new and old flows, as intrusive singly linked lists of flow
+ *   indices. A flow is in at most one list at a time. Queue discs with a single
+ *   round robin list of active flows (such as DRR) use the list of old flows;
+ * - the backlog (in bytes) of each flow, along with a max-heap of the non-empty
+ *   flows keyed by their backlog, so that the fat flow is found in constant time
+ *   when the queue disc is overlimit.
+ *
+ * The queue disc is in charge of storing the packets of each flow and of
+ * notifying the backlog of a flow whenever it changes (SetBacklog).
+ */
+class FlowQueueScheduler
+{
+  public:
+    /// The lists of active flows
+    enum FlowList : uint8_t
+    {
+        NEW_FLOWS = 0,
+        OLD_FLOWS = 1,
+        NO_LIST = 2
+    };
+
+    /// Index returned when there is no such flow
+    static constexpr uint32_t NO_FLOW = UINT32_MAX;
+
+    FlowQueueScheduler();
+
+    /**
+     * \brief Allocate the state of the given number of flows. All the flows are
+     * removed from the lists and their backlog is set to zero
+     * \param nFlows the number of flows
+     */
+    void Reset(uint32_t nFlows);
+
+    /**
+     * \brief Get the number of flows
+     * \return the number of flows
+     */
+    uint32_t GetNFlows() const;
+
+    /**
+     * \brief Check whether a list of flows is empty
+     * \param list the list
+     * \return true if the list is empty
+     */
+    bool IsEmpty(FlowList list) const;
+
+    /**
+     * \brief Get the number of flows in a list
+     * \param list the list
+     * \return the number of flows in the list
+     */
+    uint32_t GetSize(FlowList list) const;
+
+    /**
+     * \brief Get the flow at the head of a list
+     * \param list the list
+     * \return the index of the flow at the head of the list, or NO_FLOW if the list is empty
+     */
+    uint32_t Front(FlowList list) const;
+
+    /**
+     * \brief Get the flow that follows the given flow in its list
+     * \param flow the index of the flow
+     * \return the index of the next flow, or NO_FLOW if the flow is the last one
+     */
+    uint32_t Next(uint32_t flow) const;
+
+    /**
+     * \brief Get the list the given flow belongs to
+     * \param flow the index of the flow
+     * \return the list of the flow, or NO_LIST if the flow is not in any list
+     */
+    FlowList GetList(uint32_t flow) const;
+
+    /**
+     * \brief Append a flow, which must not belong to any list, to the tail of a list
+     * \param list the list
+     * \param flow the index of the flow
+     */
+    void PushBack(FlowList list, uint32_t flow);
+
+    /**
+     * \brief Remove the flow at the head of a non-empty list
+     * \param list the list
+     * \return the index of the removed flow
+     */
+    uint32_t PopFront(FlowList list);
+
+    /**
+     * \brief Move the flow at the head of a non-empty list to the tail of a
+     * (possibly the same) list
+     * \param from the list the flow is removed from
+     * \param to the list the flow is appended to
+     * \return the index of the moved flow
+     */
+    uint32_t MoveFront(FlowList from, FlowList to);
+
+    /**
+     * \brief Set the number of bytes stored by a flow
+     * \param flow the index of the flow
+     * \param bytes the backlog of the flow
+     */
+    void SetBacklog(uint32_t flow, uint32_t bytes);
+
+    /**
+     * \brief Get the number of bytes stored by a flow
+     * \param flow the index of the flow
+     * \return the backlog of the flow
+     */
+    uint32_t GetBacklog(uint32_t flow) const;
+
+    /**
+     * \brief Get the flow storing the largest number of bytes
+     * \return the index of the fat flow, or NO_FLOW if all the flows are empty
+     */
+    uint32_t GetFatFlow() const;
+
+    /**
+     * \brief Drop packets from the head of the fat flow, until either the given
+     * number of packets or half of its backlog has been dropped. The backlog of
+     * the fat flow is updated accordingly.
+     *
+     * \tparam DropHead \deduced the type of the callable dropping a packet
+     * \param maxPackets the maximum number of packets to drop
+     * \param dropHead a callable which takes the index of a flow, drops the
+     * packet at the head of the flow and returns its size (or zero if the flow
+     * is empty)
+     * \return the index of the fat flow
+     */
+    template <typename DropHead>
+    uint32_t DropFromFatFlow(uint32_t maxPackets, DropHead&& dropHead);
+
+  private:
+    /**
+     * \brief Move the element at the given position of the backlog heap towards the root
+     * \param pos the position of the element
+     */
+    void SiftUp(uint32_t pos);
+
+    /**
+     * \brief Move the element at the given position of the backlog heap towards the leaves
+     * \param pos the position of the element
+     */
+    void SiftDown(uint32_t pos);
+
+    /**
+     * \brief Swap two elements of the backlog heap
+     * \param i the position of the first element
+     * \param j the position of the second element
+     */
+    void Swap(uint32_t i, uint32_t j);
+
+    std::vector<uint32_t> m_next;  //!< Next flow in the list of each flow
+    std::vector<FlowList> m_lists; //!< List each flow belongs to
+    uint32_t m_heads[NO_LIST];     //!< First flow of each list
+    uint32_t m_tails[NO_LIST];     //!< Last flow of each list
+    uint32_t m_sizes[NO_LIST];     //!< Number of flows in each list
+
+    /// Max-heap of the indices of the non-empty flows, keyed by their backlog
+    std::vector<uint32_t> m_backlogHeap;
+    std::vector<uint32_t> m_backlogs; //!< Backlog (bytes) of each flow
+    std::vector<uint32_t> m_heapPos;  //!< Position of each flow in the backlog heap
+
+    /// Position of the flows that are not in the backlog heap
+    static constexpr uint32_t NOT_IN_HEAP = UINT32_MAX;
+};
+
+/***************************************************************
+ *  Implementation of the inline functions and templates declared above.
+ ***************************************************************/
+
+inline uint32_t
+FlowQueueScheduler::GetNFlows() const
+{
+    return m_next.size();
+}
+
+inline bool
+FlowQueueScheduler::IsEmpty(FlowList list) const
+{
+    return m_sizes[list] == 0;
+}
+
+inline uint32_t
+FlowQueueScheduler::GetSize(FlowList list) const
+{
+    return m_sizes[list];
+}
+
+inline uint32_t
+FlowQueueScheduler::Front(FlowList list) const
+{
+    return m_heads[list];
+}
+
+inline uint32_t
+FlowQueueScheduler::Next(uint32_t flow) const
+{
+    return m_next[flow];
+}
+
+inline FlowQueueScheduler::FlowList
+FlowQueueScheduler::GetList(uint32_t flow) const
+{
+    return m_lists[flow];
+}
+
+inline void
+FlowQueueScheduler::PushBack(FlowList list, uint32_t flow)
+{
+    NS_ASSERT_MSG(m_lists[flow] == NO_LIST, "Flow " << flow << " already belongs to a list");
+    m_next[flow] = NO_FLOW;
+    m_lists[flow] = list;
+    if (m_sizes[list]++ == 0)
+    {
+        m_heads[list] = flow;
+    }
+    else
+    {
+        m_next[m_tails[list]] = flow;
+    }
+    m_tails[list] = flow;
+}
+
+inline uint32_t
+FlowQueueScheduler::PopFront(FlowList list)
+{
+    NS_ASSERT_MSG(m_sizes[list] > 0, "The list of flows is empty");
+    uint32_t flow = m_heads[list];
+    m_heads[list] = m_next[flow];
+    if (--m_sizes[list] == 0)
+    {
+        m_tails[list] = NO_FLOW;
+    }
+    m_next[flow] = NO_FLOW;
+    m_lists[flow] = NO_LIST;
+    return flow;
+}
+
+inline uint32_t
+FlowQueueScheduler::MoveFront(FlowList from, FlowList to)
+{
+    uint32_t flow = PopFront(from);
+    PushBack(to, flow);
+    return flow;
+}
+
+inline uint32_t
+FlowQueueScheduler::GetBacklog(uint32_t flow) const
+{
+    return m_backlogs[flow];
+}
+
+inline uint32_t
+FlowQueueScheduler::GetFatFlow() const
+{
+    return (m_backlogHeap.empty() ? NO_FLOW : m_backlogHeap.front());
+}
+
+template <typename DropHead>
+uint32_t
+FlowQueueScheduler::DropFromFatFlow(uint32_t maxPackets, DropHead&& dropHead)
+{
+    uint32_t flow = GetFatFlow();
+    NS_ASSERT_MSG(flow != NO_FLOW, "No flow to drop packets from");
+
+    // drop up to half of the fat flow backlog, within the given number of packets
+    uint32_t backlog = m_backlogs[flow];
+    uint32_t threshold = backlog >> 1;
+    uint32_t len = 0;
+    uint32_t count = 0;
+
+    do
+    {
+        uint32_t size = dropHead(flow);
+        if (size == 0)
+        {
+            break;
+        }
+        len += size;
+    } while (++count < maxPackets && len < threshold);
+
+    SetBacklog(flow, (len < backlog ? backlog - len : 0));
+    return flow;
+}
+
+} // namespace ns3
+
+#endif /* FLOW_QUEUE_SCHEDULER_H */
@@ -196,7 +196,13 @@ FqCobaltQueueDisc::GetTypeId()
                           "The Threshold after which Blue is enabled",
                           TimeValue(MilliSeconds(400)),
                           MakeTimeAccessor(&FqCobaltQueueDisc::m_blueThreshold),
-                          MakeTimeChecker());
+                          MakeTimeChecker())
+            .AddAttribute("InlineFlowAqm",
+                          "True to embed the COBALT state of each flow in this queue disc "
+                          "instead of creating a COBALT queue disc per flow",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&FqCobaltQueueDisc::m_inlineAqm),
+                          MakeBooleanChecker());
     return tid;
 }
 
@@ -212,6 +218,15 @@ FqCobaltQueueDisc::~FqCobaltQueueDisc()
     NS_LOG_FUNCTION(this);
 }
 
+void
+FqCobaltQueueDisc::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_inlineFlows.clear();
+    m_flowAqm = nullptr;
+    QueueDisc::DoDispose();
+}
+
 void
 FqCobaltQueueDisc::SetQuantum(uint32_t quantum)
 {
@@ -236,12 +251,10 @@ FqCobaltQueueDisc::SetAssociativeHash(uint32_t flowHash)
 
     for (uint32_t i = outerHash; i < outerHash + m_setWays; i++)
     {
-        auto it = m_flowsIndices.find(i);
-
-        if (it == m_flowsIndices.end() ||
-            (m_tags.find(i) != m_tags.end() && m_tags[i] == flowHash) ||
-            StaticCast<FqCobaltFlow>(GetQueueDiscClass(it->second))->GetStatus() ==
-                FqCobaltFlow::INACTIVE)
+        bool inactive = (m_inlineAqm ? m_inlineFlows[i].status == FqCobaltFlow::INACTIVE
+                                     : !m_flowTable[i] ||
+                                           m_flowTable[i]->GetStatus() == FqCobaltFlow::INACTIVE);
+        if (inactive || m_tags[i] == flowHash)
         {
             // this queue has not been created yet or is associated with this flow
             // or is inactive, hence we can use it
@@ -292,8 +305,13 @@ FqCobaltQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
         h = flowHash % m_flows;
     }
 
-    Ptr<FqCobaltFlow> flow;
-    if (m_flowsIndices.find(h) == m_flowsIndices.end())
+    if (m_inlineAqm)
+    {
+        return InlineEnqueue(h, item);
+    }
+
+    Ptr<FqCobaltFlow> flow = m_flowTable[h];
+    if (!flow)
     {
         NS_LOG_DEBUG("Creating a new flow queue with index " << h);
         flow = m_flowFactory.Create<FqCobaltFlow>();
@@ -312,23 +330,50 @@ FqCobaltQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
         flow->SetIndex(h);
         AddQueueDiscClass(flow);
 
-        m_flowsIndices[h] = GetNQueueDiscClasses() - 1;
-    }
-    else
-    {
-        flow = StaticCast<FqCobaltFlow>(GetQueueDiscClass(m_flowsIndices[h]));
+        m_flowTable[h] = flow;
     }
 
     if (flow->GetStatus() == FqCobaltFlow::INACTIVE)
     {
         flow->SetStatus(FqCobaltFlow::NEW_FLOW);
         flow->SetDeficit(m_quantum);
-        m_newFlows.push_back(flow);
+        m_scheduler.PushBack(FlowQueueScheduler::NEW_FLOWS, h);
     }
 
     flow->GetQueueDisc()->Enqueue(item);
+    m_scheduler.SetBacklog(h, flow->GetQueueDisc()->GetNBytes());
+
+    NS_LOG_DEBUG("Packet enqueued into flow " << h);
+
+    if (GetCurrentSize() > GetMaxSize())
+    {
+        NS_LOG_DEBUG("Overload; enter FqCobaltDrop ()");
+        FqCobaltDrop();
+    }
+
+    return true;
+}
+
+bool
+FqCobaltQueueDisc::InlineEnqueue(uint32_t h, Ptr<QueueDiscItem> item)
+{
+    NS_LOG_FUNCTION(this << h << item);
 
-    NS_LOG_DEBUG("Packet enqueued into flow " << h << "; flow index " << m_flowsIndices[h]);
+    InlineFlow& flow = m_inlineFlows[h];
+    if (flow.status == FqCobaltFlow::INACTIVE)
+    {
+        flow.status = FqCobaltFlow::NEW_FLOW;
+        flow.deficit = m_quantum;
+        m_scheduler.PushBack(FlowQueueScheduler::NEW_FLOWS, h);
+    }
+
+    if (m_flowAqm->Enqueue(flow.aqm, flow.queue, item))
+    {
+        PacketEnqueued(item);
+    }
+    m_scheduler.SetBacklog(h, flow.queue.GetNBytes());
+
+    NS_LOG_DEBUG("Packet enqueued into flow " << h);
 
     if (GetCurrentSize() > GetMaxSize())
     {
@@ -344,24 +389,28 @@ FqCobaltQueueDisc::DoDequeue()
 {
     NS_LOG_FUNCTION(this);
 
-    Ptr<FqCobaltFlow> flow;
+    if (m_inlineAqm)
+    {
+        return InlineDequeue();
+    }
+
+    FqCobaltFlow* flow = nullptr;
     Ptr<QueueDiscItem> item;
 
     do
     {
         bool found = false;
 
-        while (!found && !m_newFlows.empty())
+        while (!found && !m_scheduler.IsEmpty(FlowQueueScheduler::NEW_FLOWS))
         {
-            flow = m_newFlows.front();
+            flow = PeekPointer(m_flowTable[m_scheduler.Front(FlowQueueScheduler::NEW_FLOWS)]);
 
             if (flow->GetDeficit() <= 0)
             {
                 NS_LOG_DEBUG("Increase deficit for new flow index " << flow->GetIndex());
                 flow->IncreaseDeficit(m_quantum);
                 flow->SetStatus(FqCobaltFlow::OLD_FLOW);
-                m_oldFlows.push_back(flow);
-                m_newFlows.pop_front();
+                m_scheduler.MoveFront(FlowQueueScheduler::NEW_FLOWS, FlowQueueScheduler::OLD_FLOWS);
             }
             else
             {
@@ -370,16 +419,15 @@ FqCobaltQueueDisc::DoDequeue()
             }
         }
 
-        while (!found && !m_oldFlows.empty())
+        while (!found && !m_scheduler.IsEmpty(FlowQueueScheduler::OLD_FLOWS))
         {
-            flow = m_oldFlows.front();
+            flow = PeekPointer(m_flowTable[m_scheduler.Front(FlowQueueScheduler::OLD_FLOWS)]);
 
             if (flow->GetDeficit() <= 0)
             {
                 NS_LOG_DEBUG("Increase deficit for old flow index " << flow->GetIndex());
                 flow->IncreaseDeficit(m_quantum);
-                m_oldFlows.push_back(flow);
-                m_oldFlows.pop_front();
+                m_scheduler.MoveFront(FlowQueueScheduler::OLD_FLOWS, FlowQueueScheduler::OLD_FLOWS);
             }
             else
             {
@@ -395,20 +443,20 @@ FqCobaltQueueDisc::DoDequeue()
         }
 
         item = flow->GetQueueDisc()->Dequeue();
+        m_scheduler.SetBacklog(flow->GetIndex(), flow->GetQueueDisc()->GetNBytes());
 
         if (!item)
         {
             NS_LOG_DEBUG("Could not get a packet from the selected flow queue");
-            if (!m_newFlows.empty())
+            if (flow->GetStatus() == FqCobaltFlow::NEW_FLOW)
             {
                 flow->SetStatus(FqCobaltFlow::OLD_FLOW);
-                m_oldFlows.push_back(flow);
-                m_newFlows.pop_front();
+                m_scheduler.MoveFront(FlowQueueScheduler::NEW_FLOWS, FlowQueueScheduler::OLD_FLOWS);
             }
             else
             {
                 flow->SetStatus(FqCobaltFlow::INACTIVE);
-                m_oldFlows.pop_front();
+                m_scheduler.PopFront(FlowQueueScheduler::OLD_FLOWS);
             }
         }
         else
@@ -422,6 +470,86 @@ FqCobaltQueueDisc::DoDequeue()
     return item;
 }
 
+Ptr<QueueDiscItem>
+FqCobaltQueueDisc::InlineDequeue()
+{
+    NS_LOG_FUNCTION(this);
+
+    uint32_t index = FlowQueueScheduler::NO_FLOW;
+    InlineFlow* flow = nullptr;
+    Ptr<QueueDiscItem> item;
+
+    do
+    {
+        bool found = false;
+
+        while (!found && !m_scheduler.IsEmpty(FlowQueueScheduler::NEW_FLOWS))
+        {
+            index = m_scheduler.Front(FlowQueueScheduler::NEW_FLOWS);
+            flow = &m_inlineFlows[index];
+
+            if (flow->deficit <= 0)
+            {
+                NS_LOG_DEBUG("Increase deficit for new flow index " << index);
+                flow->deficit += m_quantum;
+                flow->status = FqCobaltFlow::OLD_FLOW;
+                m_scheduler.MoveFront(FlowQueueScheduler::NEW_FLOWS, FlowQueueScheduler::OLD_FLOWS);
+            }
+            else
+            {
+                NS_LOG_DEBUG("Found a new flow " << index << " with positive deficit");
+                found = true;
+            }
+        }
+
+        while (!found && !m_scheduler.IsEmpty(FlowQueueScheduler::OLD_FLOWS))
+        {
+            index = m_scheduler.Front(FlowQueueScheduler::OLD_FLOWS);
+            flow = &m_inlineFlows[index];
+
+            if (flow->deficit <= 0)
+            {
+                NS_LOG_DEBUG("Increase deficit for old flow index " << index);
+                flow->deficit += m_quantum;
+                m_scheduler.MoveFront(FlowQueueScheduler::OLD_FLOWS, FlowQueueScheduler::OLD_FLOWS);
+            }
+            else
+            {
+                NS_LOG_DEBUG("Found an old flow " << index << " with positive deficit");
+                found = true;
+            }
+        }
+
+        if (!found)
+        {
+            NS_LOG_DEBUG("No flow found to dequeue a packet");
+            return nullptr;
+        }
+
+        item = m_flowAqm->Dequeue(flow->aqm, flow->queue);
+        m_scheduler.SetBacklog(index, flow->queue.GetNBytes());
+
+        if (!item)
+        {
+            NS_LOG_DEBUG("Could not get a packet from the selected flow queue");
+            if (flow->status == FqCobaltFlow::NEW_FLOW)
+            {
+                flow->status = FqCobaltFlow::OLD_FLOW;
+                m_scheduler.MoveFront(FlowQueueScheduler::NEW_FLOWS, FlowQueueScheduler::OLD_FLOWS);
+            }
+            else
+            {
+                flow->status = FqCobaltFlow::INACTIVE;
+                m_scheduler.PopFront(FlowQueueScheduler::OLD_FLOWS);
+            }
+        }
+    } while (!item);
+
+    flow->deficit -= item->GetSize();
+
+    return item;
+}
+
 bool
 FqCobaltQueueDisc::CheckConfig()
 {
@@ -482,6 +610,10 @@ FqCobaltQueueDisc::InitializeParams()
 {
     NS_LOG_FUNCTION(this);
 
+    m_flowTable.assign(m_flows, nullptr);
+    m_tags.assign(m_flows, 0);
+    m_scheduler.Reset(m_flows);
+
     m_flowFactory.SetTypeId("ns3::FqCobaltFlow");
 
     m_queueDiscFactory.SetTypeId("ns3::CobaltQueueDisc");
@@ -491,6 +623,31 @@ FqCobaltQueueDisc::InitializeParams()
     m_queueDiscFactory.Set("Pdrop", DoubleValue(m_Pdrop));
     m_queueDiscFactory.Set("Increment", DoubleValue(m_increment));
     m_queueDiscFactory.Set("Decrement", DoubleValue(m_decrement));
+
+    if (m_inlineAqm)
+    {
+        // the initial drop probability is set in the state of each flow
+        m_flowAqmFactory.SetTypeId("ns3::CobaltFlowAqm");
+        m_flowAqmFactory.Set("MaxSize", QueueSizeValue(GetMaxSize()));
+        m_flowAqmFactory.Set("Interval", StringValue(m_interval));
+        m_flowAqmFactory.Set("Target", StringValue(m_target));
+        m_flowAqmFactory.Set("Increment", DoubleValue(m_increment));
+        m_flowAqmFactory.Set("Decrement", DoubleValue(m_decrement));
+        m_flowAqmFactory.Set("UseEcn", BooleanValue(m_useEcn));
+        m_flowAqmFactory.Set("CeThreshold", TimeValue(m_ceThreshold));
+        m_flowAqmFactory.Set("UseL4s", BooleanValue(m_useL4s));
+        m_flowAqmFactory.Set("BlueThreshold", TimeValue(m_blueThreshold));
+        m_flowAqm = m_flowAqmFactory.Create<CobaltFlowAqm>();
+        m_flowAqm->SetDequeueCallback(MakeCallback(&FqCobaltQueueDisc::PacketDequeued, this));
+        m_flowAqm->SetDropBeforeEnqueueCallback(
+            MakeCallback(&FqCobaltQueueDisc::DropBeforeEnqueue, this));
+        m_flowAqm->SetDropAfterDequeueCallback(
+            MakeCallback(&FqCobaltQueueDisc::DropAfterDequeue, this));
+        m_flowAqm->SetMarkCallback(MakeCallback(&FqCobaltQueueDisc::Mark, this));
+        InlineFlow flow;
+        flow.aqm.pDrop = m_Pdrop;
+        m_inlineFlows.assign(m_flows, flow);
+    }
 }
 
 uint32_t
@@ -498,39 +655,26 @@ FqCobaltQueueDisc::FqCobaltDrop()
 {
     NS_LOG_FUNCTION(this);
 
-    uint32_t maxBacklog = 0;
-    uint32_t index = 0;
-    Ptr<QueueDisc> qd;
-
-    /* Queue is full! Find the fat flow and drop packet(s) from it */
-    for (uint32_t i = 0; i < GetNQueueDiscClasses(); i++)
-    {
-        qd = GetQueueDiscClass(i)->GetQueueDisc();
-        uint32_t bytes = qd->GetNBytes();
-        if (bytes > maxBacklog)
+    /* Queue is full! Drop packet(s) from the fat flow, up to half of its backlog */
+    return m_scheduler.DropFromFatFlow(m_dropBatchSize, [this](uint32_t index) {
+        NS_LOG_DEBUG("Drop packet (overflow) from flow " << index);
+        Ptr<QueueDiscItem> item;
+        if (m_inlineAqm)
         {
-            maxBacklog = bytes;
-            index = i;
+            InlineFlow& flow = m_inlineFlows[index];
+            item = m_flowAqm->Remove(flow.aqm, flow.queue);
+        }
+        else
+        {
+            item = m_flowTable[index]->GetQueueDisc()->GetInternalQueue(0)->Dequeue();
+        }
+        if (!item)
+        {
+            return 0U;
         }
-    }
-
-    /* Our goal is to drop half of this fat flow backlog */
-    uint32_t len = 0;
-    uint32_t count = 0;
-    uint32_t threshold = maxBacklog >> 1;
-    qd = GetQueueDiscClass(index)->GetQueueDisc();
-    Ptr<QueueDiscItem> item;
-
-    do
-    {
-        NS_LOG_DEBUG("Drop packet (overflow); count: " << count << " len: " << len
-                                                       << " threshold: " << threshold);
-        item = qd->GetInternalQueue(0)->Dequeue();
         DropAfterDequeue(item, OVERLIMIT_DROP);
-        len += item->GetSize();
-    } while (++count < m_dropBatchSize && len < threshold);
-
-    return index;
+        return item->GetSize();
+    });
 }
 
 } // namespace ns3
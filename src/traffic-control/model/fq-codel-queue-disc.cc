@@ -170,6 +170,12 @@ FqCoDelQueueDisc::GetTypeId()
                           "True to use L4S (only ECT1 packets are marked at CE threshold)",
                           BooleanValue(false),
                           MakeBooleanAccessor(&FqCoDelQueueDisc::m_useL4s),
+                          MakeBooleanChecker())
+            .AddAttribute("InlineFlowAqm",
+                          "True to embed the CoDel state of each flow in this queue disc "
+                          "instead of creating a CoDel queue disc per flow",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&FqCoDelQueueDisc::m_inlineAqm),
                           MakeBooleanChecker());
     return tid;
 }
@@ -186,6 +192,15 @@ FqCoDelQueueDisc::~FqCoDelQueueDisc()
     NS_LOG_FUNCTION(this);
 }
 
+void
+FqCoDelQueueDisc::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_inlineFlows.clear();
+    m_flowAqm = nullptr;
+    QueueDisc::DoDispose();
+}
+
 void
 FqCoDelQueueDisc::SetQuantum(uint32_t quantum)
 {
@@ -210,12 +225,10 @@ FqCoDelQueueDisc::SetAssociativeHash(uint32_t flowHash)
 
     for (uint32_t i = outerHash; i < outerHash + m_setWays; i++)
     {
-        auto it = m_flowsIndices.find(i);
-
-        if (it == m_flowsIndices.end() ||
-            (m_tags.find(i) != m_tags.end() && m_tags[i] == flowHash) ||
-            StaticCast<FqCoDelFlow>(GetQueueDiscClass(it->second))->GetStatus() ==
-                FqCoDelFlow::INACTIVE)
+        bool inactive = (m_inlineAqm ? m_inlineFlows[i].status == FqCoDelFlow::INACTIVE
+                                     : !m_flowTable[i] ||
+                                           m_flowTable[i]->GetStatus() == FqCoDelFlow::INACTIVE);
+        if (inactive || m_tags[i] == flowHash)
         {
             // this queue has not been created yet or is associated with this flow
             // or is inactive, hence we can use it
@@ -225,6 +238,7 @@ FqCoDelQueueDisc::SetAssociativeHash(uint32_t flowHash)
     }
 
     // all the queues of the set are used. Use the first queue of the set
+    NotifyFlowHashCollision();
     m_tags[outerHash] = flowHash;
     return outerHash;
 }
@@ -266,8 +280,13 @@ FqCoDelQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
         h = flowHash % m_flows;
     }
 
-    Ptr<FqCoDelFlow> flow;
-    if (m_flowsIndices.find(h) == m_flowsIndices.end())
+    if (m_inlineAqm)
+    {
+        return InlineEnqueue(h, item);
+    }
+
+    Ptr<FqCoDelFlow> flow = m_flowTable[h];
+    if (!flow)
     {
         NS_LOG_DEBUG("Creating a new flow queue with index " << h);
         flow = m_flowFactory.Create<FqCoDelFlow>();
@@ -285,23 +304,50 @@ FqCoDelQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
         flow->SetIndex(h);
         AddQueueDiscClass(flow);
 
-        m_flowsIndices[h] = GetNQueueDiscClasses() - 1;
-    }
-    else
-    {
-        flow = StaticCast<FqCoDelFlow>(GetQueueDiscClass(m_flowsIndices[h]));
+        m_flowTable[h] = flow;
     }
 
     if (flow->GetStatus() == FqCoDelFlow::INACTIVE)
     {
         flow->SetStatus(FqCoDelFlow::NEW_FLOW);
         flow->SetDeficit(m_quantum);
-        m_newFlows.push_back(flow);
+        m_scheduler.PushBack(FlowQueueScheduler::NEW_FLOWS, h);
     }
 
     flow->GetQueueDisc()->Enqueue(item);
+    m_scheduler.SetBacklog(h, flow->GetQueueDisc()->GetNBytes());
+
+    NS_LOG_DEBUG("Packet enqueued into flow " << h);
+
+    if (GetCurrentSize() > GetMaxSize())
+    {
+        NS_LOG_DEBUG("Overload; enter FqCodelDrop ()");
+        FqCoDelDrop();
+    }
+
+    return true;
+}
+
+bool
+FqCoDelQueueDisc::InlineEnqueue(uint32_t h, Ptr<QueueDiscItem> item)
+{
+    NS_LOG_FUNCTION(this << h << item);
 
-    NS_LOG_DEBUG("Packet enqueued into flow " << h << "; flow index " << m_flowsIndices[h]);
+    InlineFlow& flow = m_inlineFlows[h];
+    if (flow.status == FqCoDelFlow::INACTIVE)
+    {
+        flow.status = FqCoDelFlow::NEW_FLOW;
+        flow.deficit = m_quantum;
+        m_scheduler.PushBack(FlowQueueScheduler::NEW_FLOWS, h);
+    }
+
+    if (m_flowAqm->Enqueue(flow.aqm, flow.queue, item))
+    {
+        PacketEnqueued(item);
+    }
+    m_scheduler.SetBacklog(h, flow.queue.GetNBytes());
+
+    NS_LOG_DEBUG("Packet enqueued into flow " << h);
 
     if (GetCurrentSize() > GetMaxSize())
     {
@@ -317,23 +363,28 @@ FqCoDelQueueDisc::DoDequeue()
 {
     NS_LOG_FUNCTION(this);
 
-    Ptr<FqCoDelFlow> flow;
+    if (m_inlineAqm)
+    {
+        return InlineDequeue();
+    }
+
+    FqCoDelFlow* flow = nullptr;
     Ptr<QueueDiscItem> item;
 
     do
     {
         bool found = false;
 
-        while (!found && !m_newFlows.empty())
+        while (!found && !m_scheduler.IsEmpty(FlowQueueScheduler::NEW_FLOWS))
         {
-            flow = m_newFlows.front();
+            flow = PeekPointer(m_flowTable[m_scheduler.Front(FlowQueueScheduler::NEW_FLOWS)]);
 
             if (flow->GetDeficit() <= 0)
             {
                 NS_LOG_DEBUG("Increase deficit for new flow index " << flow->GetIndex());
                 flow->IncreaseDeficit(m_quantum);
                 flow->SetStatus(FqCoDelFlow::OLD_FLOW);
-                m_oldFlows.splice(m_oldFlows.end(), m_newFlows, m_newFlows.begin());
+                m_scheduler.MoveFront(FlowQueueScheduler::NEW_FLOWS, FlowQueueScheduler::OLD_FLOWS);
             }
             else
             {
@@ -342,15 +393,15 @@ FqCoDelQueueDisc::DoDequeue()
             }
         }
 
-        while (!found && !m_oldFlows.empty())
+        while (!found && !m_scheduler.IsEmpty(FlowQueueScheduler::OLD_FLOWS))
         {
-            flow = m_oldFlows.front();
+            flow = PeekPointer(m_flowTable[m_scheduler.Front(FlowQueueScheduler::OLD_FLOWS)]);
 
             if (flow->GetDeficit() <= 0)
             {
                 NS_LOG_DEBUG("Increase deficit for old flow index " << flow->GetIndex());
                 flow->IncreaseDeficit(m_quantum);
-                m_oldFlows.splice(m_oldFlows.end(), m_oldFlows, m_oldFlows.begin());
+                m_scheduler.MoveFront(FlowQueueScheduler::OLD_FLOWS, FlowQueueScheduler::OLD_FLOWS);
             }
             else
             {
@@ -366,20 +417,20 @@ FqCoDelQueueDisc::DoDequeue()
         }
 
         item = flow->GetQueueDisc()->Dequeue();
+        m_scheduler.SetBacklog(flow->GetIndex(), flow->GetQueueDisc()->GetNBytes());
 
         if (!item)
         {
             NS_LOG_DEBUG("Could not get a packet from the selected flow queue");
-            if (!m_newFlows.empty())
+            if (flow->GetStatus() == FqCoDelFlow::NEW_FLOW)
             {
                 flow->SetStatus(FqCoDelFlow::OLD_FLOW);
-                m_oldFlows.push_back(flow);
-                m_newFlows.pop_front();
+                m_scheduler.MoveFront(FlowQueueScheduler::NEW_FLOWS, FlowQueueScheduler::OLD_FLOWS);
             }
             else
             {
                 flow->SetStatus(FqCoDelFlow::INACTIVE);
-                m_oldFlows.pop_front();
+                m_scheduler.PopFront(FlowQueueScheduler::OLD_FLOWS);
             }
         }
         else
@@ -393,6 +444,86 @@ FqCoDelQueueDisc::DoDequeue()
     return item;
 }
 
+Ptr<QueueDiscItem>
+FqCoDelQueueDisc::InlineDequeue()
+{
+    NS_LOG_FUNCTION(this);
+
+    uint32_t index = FlowQueueScheduler::NO_FLOW;
+    InlineFlow* flow = nullptr;
+    Ptr<QueueDiscItem> item;
+
+    do
+    {
+        bool found = false;
+
+        while (!found && !m_scheduler.IsEmpty(FlowQueueScheduler::NEW_FLOWS))
+        {
+            index = m_scheduler.Front(FlowQueueScheduler::NEW_FLOWS);
+            flow = &m_inlineFlows[index];
+
+            if (flow->deficit <= 0)
+            {
+                NS_LOG_DEBUG("Increase deficit for new flow index " << index);
+                flow->deficit += m_quantum;
+                flow->status = FqCoDelFlow::OLD_FLOW;
+                m_scheduler.MoveFront(FlowQueueScheduler::NEW_FLOWS, FlowQueueScheduler::OLD_FLOWS);
+            }
+            else
+            {
+                NS_LOG_DEBUG("Found a new flow " << index << " with positive deficit");
+                found = true;
+            }
+        }
+
+        while (!found && !m_scheduler.IsEmpty(FlowQueueScheduler::OLD_FLOWS))
+        {
+            index = m_scheduler.Front(FlowQueueScheduler::OLD_FLOWS);
+            flow = &m_inlineFlows[index];
+
+            if (flow->deficit <= 0)
+            {
+                NS_LOG_DEBUG("Increase deficit for old flow index " << index);
+                flow->deficit += m_quantum;
+                m_scheduler.MoveFront(FlowQueueScheduler::OLD_FLOWS, FlowQueueScheduler::OLD_FLOWS);
+            }
+            else
+            {
+                NS_LOG_DEBUG("Found an old flow " << index << " with positive deficit");
+                found = true;
+            }
+        }
+
+        if (!found)
+        {
+            NS_LOG_DEBUG("No flow found to dequeue a packet");
+            return nullptr;
+        }
+
+        item = m_flowAqm->Dequeue(flow->aqm, flow->queue);
+        m_scheduler.SetBacklog(index, flow->queue.GetNBytes());
+
+        if (!item)
+        {
+            NS_LOG_DEBUG("Could not get a packet from the selected flow queue");
+            if (flow->status == FqCoDelFlow::NEW_FLOW)
+            {
+                flow->status = FqCoDelFlow::OLD_FLOW;
+                m_scheduler.MoveFront(FlowQueueScheduler::NEW_FLOWS, FlowQueueScheduler::OLD_FLOWS);
+            }
+            else
+            {
+                flow->status = FqCoDelFlow::INACTIVE;
+                m_scheduler.PopFront(FlowQueueScheduler::OLD_FLOWS);
+            }
+        }
+    } while (!item);
+
+    flow->deficit -= item->GetSize();
+
+    return item;
+}
+
 bool
 FqCoDelQueueDisc::CheckConfig()
 {
@@ -453,12 +584,35 @@ FqCoDelQueueDisc::InitializeParams()
 {
     NS_LOG_FUNCTION(this);
 
+    m_flowTable.assign(m_flows, nullptr);
+    m_tags.assign(m_flows, 0);
+    m_scheduler.Reset(m_flows);
+
     m_flowFactory.SetTypeId("ns3::FqCoDelFlow");
 
     m_queueDiscFactory.SetTypeId("ns3::CoDelQueueDisc");
     m_queueDiscFactory.Set("MaxSize", QueueSizeValue(GetMaxSize()));
     m_queueDiscFactory.Set("Interval", StringValue(m_interval));
     m_queueDiscFactory.Set("Target", StringValue(m_target));
+
+    if (m_inlineAqm)
+    {
+        m_flowAqmFactory.SetTypeId("ns3::CoDelFlowAqm");
+        m_flowAqmFactory.Set("MaxSize", QueueSizeValue(GetMaxSize()));
+        m_flowAqmFactory.Set("Interval", StringValue(m_interval));
+        m_flowAqmFactory.Set("Target", StringValue(m_target));
+        m_flowAqmFactory.Set("UseEcn", BooleanValue(m_useEcn));
+        m_flowAqmFactory.Set("CeThreshold", TimeValue(m_ceThreshold));
+        m_flowAqmFactory.Set("UseL4s", BooleanValue(m_useL4s));
+        m_flowAqm = m_flowAqmFactory.Create<CoDelFlowAqm>();
+        m_flowAqm->SetDequeueCallback(MakeCallback(&FqCoDelQueueDisc::PacketDequeued, this));
+        m_flowAqm->SetDropBeforeEnqueueCallback(
+            MakeCallback(&FqCoDelQueueDisc::DropBeforeEnqueue, this));
+        m_flowAqm->SetDropAfterDequeueCallback(
+            MakeCallback(&FqCoDelQueueDisc::DropAfterDequeue, this));
+        m_flowAqm->SetMarkCallback(MakeCallback(&FqCoDelQueueDisc::Mark, this));
+        m_inlineFlows.assign(m_flows, InlineFlow());
+    }
 }
 
 uint32_t
@@ -466,39 +620,26 @@ FqCoDelQueueDisc::FqCoDelDrop()
 {
     NS_LOG_FUNCTION(this);
 
-    uint32_t maxBacklog = 0;
-    uint32_t index = 0;
-    Ptr<QueueDisc> qd;
-
-    /* Queue is full! Find the fat flow and drop packet(s) from it */
-    for (uint32_t i = 0; i < GetNQueueDiscClasses(); i++)
-    {
-        qd = GetQueueDiscClass(i)->GetQueueDisc();
-        uint32_t bytes = qd->GetNBytes();
-        if (bytes > maxBacklog)
+    /* Queue is full! Drop packet(s) from the fat flow, up to half of its backlog */
+    return m_scheduler.DropFromFatFlow(m_dropBatchSize, [this](uint32_t index) {
+        NS_LOG_DEBUG("Drop packet (overflow) from flow " << index);
+        Ptr<QueueDiscItem> item;
+        if (m_inlineAqm)
         {
-            maxBacklog = bytes;
-            index = i;
+            InlineFlow& flow = m_inlineFlows[index];
+            item = m_flowAqm->Remove(flow.aqm, flow.queue);
+        }
+        else
+        {
+            item = m_flowTable[index]->GetQueueDisc()->GetInternalQueue(0)->Dequeue();
+        }
+        if (!item)
+        {
+            return 0U;
         }
-    }
-
-    /* Our goal is to drop half of this fat flow backlog */
-    uint32_t len = 0;
-    uint32_t count = 0;
-    uint32_t threshold = maxBacklog >> 1;
-    qd = GetQueueDiscClass(index)->GetQueueDisc();
-    Ptr<QueueDiscItem> item;
-
-    do
-    {
-        NS_LOG_DEBUG("Drop packet (overflow); count: " << count << " len: " << len
-                                                       << " threshold: " << threshold);
-        item = qd->GetInternalQueue(0)->Dequeue();
         DropAfterDequeue(item, OVERLIMIT_DROP);
-        len += item->GetSize();
-    } while (++count < m_dropBatchSize && len < threshold);
-
-    return index;
+        return item->GetSize();
+    });
 }
 
 } // namespace ns3
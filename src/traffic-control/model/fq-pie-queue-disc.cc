@@ -225,7 +225,13 @@ FqPieQueueDisc::GetTypeId()
                           "The size of a set of queues (used by set associative hash)",
                           UintegerValue(8),
                           MakeUintegerAccessor(&FqPieQueueDisc::m_setWays),
-                          MakeUintegerChecker<uint32_t>());
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("InlineFlowAqm",
+                          "True to embed the PIE state of each flow in this queue disc "
+                          "instead of creating a PIE queue disc per flow",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&FqPieQueueDisc::m_inlineAqm),
+                          MakeBooleanChecker());
     return tid;
 }
 
@@ -241,6 +247,15 @@ FqPieQueueDisc::~FqPieQueueDisc()
     NS_LOG_FUNCTION(this);
 }
 
+void
+FqPieQueueDisc::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_inlineFlows.clear();
+    m_flowAqm = nullptr;
+    QueueDisc::DoDispose();
+}
+
 void
 FqPieQueueDisc::SetQuantum(uint32_t quantum)
 {
@@ -265,12 +280,10 @@ FqPieQueueDisc::SetAssociativeHash(uint32_t flowHash)
 
     for (uint32_t i = outerHash; i < outerHash + m_setWays; i++)
     {
-        auto it = m_flowsIndices.find(i);
-
-        if (it == m_flowsIndices.end() ||
-            (m_tags.find(i) != m_tags.end() && m_tags[i] == flowHash) ||
-            StaticCast<FqPieFlow>(GetQueueDiscClass(it->second))->GetStatus() ==
-                FqPieFlow::INACTIVE)
+        bool inactive = (m_inlineAqm ? m_inlineFlows[i].status == FqPieFlow::INACTIVE
+                                     : !m_flowTable[i] ||
+                                           m_flowTable[i]->GetStatus() == FqPieFlow::INACTIVE);
+        if (inactive || m_tags[i] == flowHash)
         {
             // this queue has not been created yet or is associated with this flow
             // or is inactive, hence we can use it
@@ -321,8 +334,13 @@ FqPieQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
         h = flowHash % m_flows;
     }
 
-    Ptr<FqPieFlow> flow;
-    if (m_flowsIndices.find(h) == m_flowsIndices.end())
+    if (m_inlineAqm)
+    {
+        return InlineEnqueue(h, item);
+    }
+
+    Ptr<FqPieFlow> flow = m_flowTable[h];
+    if (!flow)
     {
         NS_LOG_DEBUG("Creating a new flow queue with index " << h);
         flow = m_flowFactory.Create<FqPieFlow>();
@@ -340,23 +358,50 @@ FqPieQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
         flow->SetIndex(h);
         AddQueueDiscClass(flow);
 
-        m_flowsIndices[h] = GetNQueueDiscClasses() - 1;
-    }
-    else
-    {
-        flow = StaticCast<FqPieFlow>(GetQueueDiscClass(m_flowsIndices[h]));
+        m_flowTable[h] = flow;
     }
 
     if (flow->GetStatus() == FqPieFlow::INACTIVE)
     {
         flow->SetStatus(FqPieFlow::NEW_FLOW);
         flow->SetDeficit(m_quantum);
-        m_newFlows.push_back(flow);
+        m_scheduler.PushBack(FlowQueueScheduler::NEW_FLOWS, h);
     }
 
     flow->GetQueueDisc()->Enqueue(item);
+    m_scheduler.SetBacklog(h, flow->GetQueueDisc()->GetNBytes());
+
+    NS_LOG_DEBUG("Packet enqueued into flow " << h);
+
+    if (GetCurrentSize() > GetMaxSize())
+    {
+        NS_LOG_DEBUG("Overload; enter FqPieDrop ()");
+        FqPieDrop();
+    }
+
+    return true;
+}
+
+bool
+FqPieQueueDisc::InlineEnqueue(uint32_t h, Ptr<QueueDiscItem> item)
+{
+    NS_LOG_FUNCTION(this << h << item);
 
-    NS_LOG_DEBUG("Packet enqueued into flow " << h << "; flow index " << m_flowsIndices[h]);
+    InlineFlow& flow = m_inlineFlows[h];
+    if (flow.status == FqPieFlow::INACTIVE)
+    {
+        flow.status = FqPieFlow::NEW_FLOW;
+        flow.deficit = m_quantum;
+        m_scheduler.PushBack(FlowQueueScheduler::NEW_FLOWS, h);
+    }
+
+    if (m_flowAqm->Enqueue(flow.aqm, flow.queue, item))
+    {
+        PacketEnqueued(item);
+    }
+    m_scheduler.SetBacklog(h, flow.queue.GetNBytes());
+
+    NS_LOG_DEBUG("Packet enqueued into flow " << h);
 
     if (GetCurrentSize() > GetMaxSize())
     {
@@ -372,24 +417,28 @@ FqPieQueueDisc::DoDequeue()
 {
     NS_LOG_FUNCTION(this);
 
-    Ptr<FqPieFlow> flow;
+    if (m_inlineAqm)
+    {
+        return InlineDequeue();
+    }
+
+    FqPieFlow* flow = nullptr;
     Ptr<QueueDiscItem> item;
 
     do
     {
         bool found = false;
 
-        while (!found && !m_newFlows.empty())
+        while (!found && !m_scheduler.IsEmpty(FlowQueueScheduler::NEW_FLOWS))
         {
-            flow = m_newFlows.front();
+            flow = PeekPointer(m_flowTable[m_scheduler.Front(FlowQueueScheduler::NEW_FLOWS)]);
 
             if (flow->GetDeficit() <= 0)
             {
                 NS_LOG_DEBUG("Increase deficit for new flow index " << flow->GetIndex());
                 flow->IncreaseDeficit(m_quantum);
                 flow->SetStatus(FqPieFlow::OLD_FLOW);
-                m_oldFlows.push_back(flow);
-                m_newFlows.pop_front();
+                m_scheduler.MoveFront(FlowQueueScheduler::NEW_FLOWS, FlowQueueScheduler::OLD_FLOWS);
             }
             else
             {
@@ -398,16 +447,15 @@ FqPieQueueDisc::DoDequeue()
             }
         }
 
-        while (!found && !m_oldFlows.empty())
+        while (!found && !m_scheduler.IsEmpty(FlowQueueScheduler::OLD_FLOWS))
         {
-            flow = m_oldFlows.front();
+            flow = PeekPointer(m_flowTable[m_scheduler.Front(FlowQueueScheduler::OLD_FLOWS)]);
 
             if (flow->GetDeficit() <= 0)
             {
                 NS_LOG_DEBUG("Increase deficit for old flow index " << flow->GetIndex());
                 flow->IncreaseDeficit(m_quantum);
-                m_oldFlows.push_back(flow);
-                m_oldFlows.pop_front();
+                m_scheduler.MoveFront(FlowQueueScheduler::OLD_FLOWS, FlowQueueScheduler::OLD_FLOWS);
             }
             else
             {
@@ -423,20 +471,20 @@ FqPieQueueDisc::DoDequeue()
         }
 
         item = flow->GetQueueDisc()->Dequeue();
+        m_scheduler.SetBacklog(flow->GetIndex(), flow->GetQueueDisc()->GetNBytes());
 
         if (!item)
         {
             NS_LOG_DEBUG("Could not get a packet from the selected flow queue");
-            if (!m_newFlows.empty())
+            if (flow->GetStatus() == FqPieFlow::NEW_FLOW)
             {
                 flow->SetStatus(FqPieFlow::OLD_FLOW);
-                m_oldFlows.push_back(flow);
-                m_newFlows.pop_front();
+                m_scheduler.MoveFront(FlowQueueScheduler::NEW_FLOWS, FlowQueueScheduler::OLD_FLOWS);
             }
             else
             {
                 flow->SetStatus(FqPieFlow::INACTIVE);
-                m_oldFlows.pop_front();
+                m_scheduler.PopFront(FlowQueueScheduler::OLD_FLOWS);
             }
         }
         else
@@ -450,6 +498,86 @@ FqPieQueueDisc::DoDequeue()
     return item;
 }
 
+Ptr<QueueDiscItem>
+FqPieQueueDisc::InlineDequeue()
+{
+    NS_LOG_FUNCTION(this);
+
+    uint32_t index = FlowQueueScheduler::NO_FLOW;
+    InlineFlow* flow = nullptr;
+    Ptr<QueueDiscItem> item;
+
+    do
+    {
+        bool found = false;
+
+        while (!found && !m_scheduler.IsEmpty(FlowQueueScheduler::NEW_FLOWS))
+        {
+            index = m_scheduler.Front(FlowQueueScheduler::NEW_FLOWS);
+            flow = &m_inlineFlows[index];
+
+            if (flow->deficit <= 0)
+            {
+                NS_LOG_DEBUG("Increase deficit for new flow index " << index);
+                flow->deficit += m_quantum;
+                flow->status = FqPieFlow::OLD_FLOW;
+                m_scheduler.MoveFront(FlowQueueScheduler::NEW_FLOWS, FlowQueueScheduler::OLD_FLOWS);
+            }
+            else
+            {
+                NS_LOG_DEBUG("Found a new flow " << index << " with positive deficit");
+                found = true;
+            }
+        }
+
+        while (!found && !m_scheduler.IsEmpty(FlowQueueScheduler::OLD_FLOWS))
+        {
+            index = m_scheduler.Front(FlowQueueScheduler::OLD_FLOWS);
+            flow = &m_inlineFlows[index];
+
+            if (flow->deficit <= 0)
+            {
+                NS_LOG_DEBUG("Increase deficit for old flow index " << index);
+                flow->deficit += m_quantum;
+                m_scheduler.MoveFront(FlowQueueScheduler::OLD_FLOWS, FlowQueueScheduler::OLD_FLOWS);
+            }
+            else
+            {
+                NS_LOG_DEBUG("Found an old flow " << index << " with positive deficit");
+                found = true;
+            }
+        }
+
+        if (!found)
+        {
+            NS_LOG_DEBUG("No flow found to dequeue a packet");
+            return nullptr;
+        }
+
+        item = m_flowAqm->Dequeue(flow->aqm, flow->queue);
+        m_scheduler.SetBacklog(index, flow->queue.GetNBytes());
+
+        if (!item)
+        {
+            NS_LOG_DEBUG("Could not get a packet from the selected flow queue");
+            if (flow->status == FqPieFlow::NEW_FLOW)
+            {
+                flow->status = FqPieFlow::OLD_FLOW;
+                m_scheduler.MoveFront(FlowQueueScheduler::NEW_FLOWS, FlowQueueScheduler::OLD_FLOWS);
+            }
+            else
+            {
+                flow->status = FqPieFlow::INACTIVE;
+                m_scheduler.PopFront(FlowQueueScheduler::OLD_FLOWS);
+            }
+        }
+    } while (!item);
+
+    flow->deficit -= item->GetSize();
+
+    return item;
+}
+
 bool
 FqPieQueueDisc::CheckConfig()
 {
@@ -510,6 +638,10 @@ FqPieQueueDisc::InitializeParams()
 {
     NS_LOG_FUNCTION(this);
 
+    m_flowTable.assign(m_flows, nullptr);
+    m_tags.assign(m_flows, 0);
+    m_scheduler.Reset(m_flows);
+
     m_flowFactory.SetTypeId("ns3::FqPieFlow");
 
     m_queueDiscFactory.SetTypeId("ns3::PieQueueDisc");
@@ -525,6 +657,35 @@ FqPieQueueDisc::InitializeParams()
     m_queueDiscFactory.Set("UseDequeueRateEstimator", BooleanValue(m_useDqRateEstimator));
     m_queueDiscFactory.Set("UseCapDropAdjustment", BooleanValue(m_isCapDropAdjustment));
     m_queueDiscFactory.Set("UseDerandomization", BooleanValue(m_useDerandomization));
+
+    if (m_inlineAqm)
+    {
+        m_flowAqmFactory.SetTypeId("ns3::PieFlowAqm");
+        m_flowAqmFactory.Set("MaxSize", QueueSizeValue(GetMaxSize()));
+        m_flowAqmFactory.Set("MeanPktSize", UintegerValue(m_meanPktSize));
+        m_flowAqmFactory.Set("A", DoubleValue(m_a));
+        m_flowAqmFactory.Set("B", DoubleValue(m_b));
+        m_flowAqmFactory.Set("Tupdate", TimeValue(m_tUpdate));
+        m_flowAqmFactory.Set("Supdate", TimeValue(m_sUpdate));
+        m_flowAqmFactory.Set("DequeueThreshold", UintegerValue(m_dqThreshold));
+        m_flowAqmFactory.Set("QueueDelayReference", TimeValue(m_qDelayRef));
+        m_flowAqmFactory.Set("MaxBurstAllowance", TimeValue(m_maxBurst));
+        m_flowAqmFactory.Set("UseDequeueRateEstimator", BooleanValue(m_useDqRateEstimator));
+        m_flowAqmFactory.Set("UseCapDropAdjustment", BooleanValue(m_isCapDropAdjustment));
+        m_flowAqmFactory.Set("UseDerandomization", BooleanValue(m_useDerandomization));
+        m_flowAqmFactory.Set("UseEcn", BooleanValue(m_useEcn));
+        m_flowAqmFactory.Set("MarkEcnThreshold", DoubleValue(m_markEcnTh));
+        m_flowAqmFactory.Set("CeThreshold", TimeValue(m_ceThreshold));
+        m_flowAqmFactory.Set("UseL4s", BooleanValue(m_useL4s));
+        m_flowAqm = m_flowAqmFactory.Create<PieFlowAqm>();
+        m_flowAqm->SetDequeueCallback(MakeCallback(&FqPieQueueDisc::PacketDequeued, this));
+        m_flowAqm->SetDropBeforeEnqueueCallback(
+            MakeCallback(&FqPieQueueDisc::DropBeforeEnqueue, this));
+        m_flowAqm->SetDropAfterDequeueCallback(
+            MakeCallback(&FqPieQueueDisc::DropAfterDequeue, this));
+        m_flowAqm->SetMarkCallback(MakeCallback(&FqPieQueueDisc::Mark, this));
+        m_inlineFlows.assign(m_flows, InlineFlow());
+    }
 }
 
 uint32_t
@@ -532,39 +693,26 @@ FqPieQueueDisc::FqPieDrop()
 {
     NS_LOG_FUNCTION(this);
 
-    uint32_t maxBacklog = 0;
-    uint32_t index = 0;
-    Ptr<QueueDisc> qd;
-
-    /* Queue is full! Find the fat flow and drop packet(s) from it */
-    for (uint32_t i = 0; i < GetNQueueDiscClasses(); i++)
-    {
-        qd = GetQueueDiscClass(i)->GetQueueDisc();
-        uint32_t bytes = qd->GetNBytes();
-        if (bytes > maxBacklog)
+    /* Queue is full! Drop packet(s) from the fat flow, up to half of its backlog */
+    return m_scheduler.DropFromFatFlow(m_dropBatchSize, [this](uint32_t index) {
+        NS_LOG_DEBUG("Drop packet (overflow) from flow " << index);
+        Ptr<QueueDiscItem> item;
+        if (m_inlineAqm)
         {
-            maxBacklog = bytes;
-            index = i;
+            InlineFlow& flow = m_inlineFlows[index];
+            item = m_flowAqm->Remove(flow.aqm, flow.queue);
+        }
+        else
+        {
+            item = m_flowTable[index]->GetQueueDisc()->GetInternalQueue(0)->Dequeue();
+        }
+        if (!item)
+        {
+            return 0U;
         }
-    }
-
-    /* Our goal is to drop half of this fat flow backlog */
-    uint32_t len = 0;
-    uint32_t count = 0;
-    uint32_t threshold = maxBacklog >> 1;
-    qd = GetQueueDiscClass(index)->GetQueueDisc();
-    Ptr<QueueDiscItem> item;
-
-    do
-    {
-        NS_LOG_DEBUG("Drop packet (overflow); count: " << count << " len: " << len
-                                                       << " threshold: " << threshold);
-        item = qd->GetInternalQueue(0)->Dequeue();
         DropAfterDequeue(item, OVERLIMIT_DROP);
-        len += item->GetSize();
-    } while (++count < m_dropBatchSize && len < threshold);
-
-    return index;
+        return item->GetSize();
+    });
 }
 
 } // namespace ns3
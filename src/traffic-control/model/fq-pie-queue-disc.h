@@ -26,12 +26,13 @@
 #ifndef FQ_PIE_QUEUE_DISC
 #define FQ_PIE_QUEUE_DISC
 
+#include "flow-aqm.h"
+#include "flow-queue-scheduler.h"
 #include "queue-disc.h"
 
 #include "ns3/object-factory.h"
 
-#include <list>
-#include <map>
+#include <vector>
 
 namespace ns3
 {
@@ -152,12 +153,34 @@ class FqPieQueueDisc : public QueueDisc
         "Unclassified drop"; //!< No packet filter able to classify packet
     static constexpr const char* OVERLIMIT_DROP = "Overlimit drop"; //!< Overlimit dropped packets
 
+  protected:
+    /**
+     * \brief Dispose of the object
+     */
+    void DoDispose() override;
+
   private:
     bool DoEnqueue(Ptr<QueueDiscItem> item) override;
     Ptr<QueueDiscItem> DoDequeue() override;
     bool CheckConfig() override;
     void InitializeParams() override;
 
+    /**
+     * \brief Enqueue a packet into a flow whose PIE state is embedded in this
+     *        queue disc (InlineFlowAqm mode)
+     * \param h the index of the flow
+     * \param item the packet
+     * \return true (packets dropped by the flow AQM are accounted for as drops)
+     */
+    bool InlineEnqueue(uint32_t h, Ptr<QueueDiscItem> item);
+
+    /**
+     * \brief Dequeue a packet from the flows whose PIE state is embedded in
+     *        this queue disc (InlineFlowAqm mode)
+     * \return the dequeued packet, or a null pointer if all the flows are empty
+     */
+    Ptr<QueueDiscItem> InlineDequeue();
+
     /**
      * \brief Drop a packet from the head of the queue with the largest current byte count
      * \return the index of the queue with the largest current byte count
@@ -200,14 +223,29 @@ class FqPieQueueDisc : public QueueDisc
     uint32_t m_perturbation;         //!< hash perturbation value
     bool m_enableSetAssociativeHash; //!< whether to enable set associative hash
 
-    std::list<Ptr<FqPieFlow>> m_newFlows; //!< The list of new flows
-    std::list<Ptr<FqPieFlow>> m_oldFlows; //!< The list of old flows
+    bool m_inlineAqm; //!< True to embed the PIE state of each flow in this queue disc
+
+    FlowQueueScheduler m_scheduler; //!< Lists of new and old flows and backlog of each flow
+
+    /// Flow associated with each hash bucket (null if not created yet)
+    std::vector<Ptr<FqPieFlow>> m_flowTable;
+    std::vector<uint32_t> m_tags; //!< Tags used by set associative hash
+
+    /// A flow whose PIE state is embedded in this queue disc
+    struct InlineFlow
+    {
+        FlowAqmQueue queue;                                //!< the packets of the flow
+        PieFlowAqm::State aqm;                             //!< the PIE state of the flow
+        int32_t deficit{0};                                //!< the deficit for this flow
+        FqPieFlow::FlowStatus status{FqPieFlow::INACTIVE}; //!< the status of this flow
+    };
 
-    std::map<uint32_t, uint32_t> m_flowsIndices; //!< Map with the index of class for each flow
-    std::map<uint32_t, uint32_t> m_tags;         //!< Tags used by set associative hash
+    std::vector<InlineFlow> m_inlineFlows; //!< Flows, if their PIE state is embedded
+    Ptr<PieFlowAqm> m_flowAqm;             //!< PIE controller applied to the embedded flows
 
     ObjectFactory m_flowFactory;      //!< Factory to create a new flow
     ObjectFactory m_queueDiscFactory; //!< Factory to create a new queue
+    ObjectFactory m_flowAqmFactory;   //!< Factory to create the flow AQM
 };
 
 } // namespace ns3
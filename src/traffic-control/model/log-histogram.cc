@@ -0,0 +1,153 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "log-histogram.h"
+
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+LogHistogram::LogHistogram()
+    : m_count(0),
+      m_sum(0),
+      m_min(std::numeric_limits<uint64_t>::max()),
+      m_max(0)
+{
+}
+
+void
+LogHistogram::Merge(const LogHistogram& other)
+{
+    if (other.m_counts.size() > m_counts.size())
+    {
+        m_counts.resize(other.m_counts.size(), 0);
+    }
+    for (std::size_t i = 0; i < other.m_counts.size(); i++)
+    {
+        m_counts[i] += other.m_counts[i];
+    }
+    m_count += other.m_count;
+    m_sum += other.m_sum;
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+}
+
+void
+LogHistogram::Reset()
+{
+    m_counts.clear();
+    m_count = 0;
+    m_sum = 0;
+    m_min = std::numeric_limits<uint64_t>::max();
+    m_max = 0;
+}
+
+uint64_t
+LogHistogram::GetCount() const
+{
+    return m_count;
+}
+
+uint64_t
+LogHistogram::GetMin() const
+{
+    return (m_count ? m_min : 0);
+}
+
+uint64_t
+LogHistogram::GetMax() const
+{
+    return m_max;
+}
+
+double
+LogHistogram::GetMean() const
+{
+    return (m_count ? static_cast<double>(m_sum) / m_count : 0.);
+}
+
+uint64_t
+LogHistogram::GetPercentile(double percentile) const
+{
+    NS_ASSERT_MSG(percentile >= 0 && percentile <= 100, "Invalid percentile " << percentile);
+
+    if (m_count == 0)
+    {
+        return 0;
+    }
+
+    // rank (starting at 1) of the requested value among the recorded values
+    auto rank = static_cast<uint64_t>(std::ceil(percentile / 100 * m_count));
+    rank = std::clamp<uint64_t>(rank, 1, m_count);
+
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < m_counts.size(); i++)
+    {
+        seen += m_counts[i];
+        if (seen >= rank)
+        {
+            uint64_t upper = GetBucketUpperBound(static_cast<uint32_t>(i));
+            return std::clamp(upper, m_min, m_max);
+        }
+    }
+    NS_ABORT_MSG("The bucket counts do not add up to the number of values");
+    return m_max;
+}
+
+void
+LogHistogram::Print(std::ostream& os) const
+{
+    os << "count " << m_count << ", mean " << GetMean() << ", p50 " << GetPercentile(50)
+       << ", p99 " << GetPercentile(99) << ", p99.9 " << GetPercentile(99.9);
+}
+
+uint64_t
+LogHistogram::GetBucketLowerBound(uint32_t index)
+{
+    if (index < (1U << PRECISION_BITS))
+    {
+        return index;
+    }
+    uint32_t shift = (index >> PRECISION_BITS) - 1;
+    uint64_t top = index - (shift << PRECISION_BITS);
+    return top << shift;
+}
+
+uint64_t
+LogHistogram::GetBucketUpperBound(uint32_t index)
+{
+    if (index < (1U << PRECISION_BITS))
+    {
+        return index;
+    }
+    uint32_t shift = (index >> PRECISION_BITS) - 1;
+    uint64_t top = index - (shift << PRECISION_BITS);
+    // the upper bound of the last bucket wraps around to the largest value
+    return ((top + 1) << shift) - 1;
+}
+
+std::ostream&
+operator<<(std::ostream& os, const LogHistogram& histogram)
+{
+    histogram.Print(os);
+    return os;
+}
+
+} // namespace ns3
@@ -0,0 +1,185 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LOG_HISTOGRAM_H
+#define LOG_HISTOGRAM_H
+
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A histogram of non-negative integer values with logarithmic buckets
+ *
+ * Values smaller than 2^PRECISION_BITS have a bucket each. Larger values are
+ * grouped in buckets whose width is proportional to the values they contain:
+ * each power-of-two range is split into 2^PRECISION_BITS buckets of equal
+ * width, hence the relative error on the values returned by GetPercentile is
+ * at most 2^-PRECISION_BITS, regardless of the magnitude of the values.
+ *
+ * Recording a value only takes a few integer operations (the bucket index is
+ * obtained from the position of the most significant bit of the value) and
+ * never allocates memory, unless the value is larger than all the values
+ * recorded so far and falls in a bucket not yet allocated.
+ */
+class LogHistogram
+{
+  public:
+    /// Number of bits used to split each power-of-two range into buckets
+    static constexpr uint32_t PRECISION_BITS = 5;
+
+    LogHistogram();
+
+    /**
+     * \brief Record a value
+     * \param value the value
+     */
+    inline void Record(uint64_t value);
+
+    /**
+     * \brief Add the values recorded by another histogram to this histogram
+     * \param other the other histogram
+     */
+    void Merge(const LogHistogram& other);
+
+    /**
+     * \brief Remove all the recorded values
+     */
+    void Reset();
+
+    /**
+     * \brief Get the number of recorded values
+     * \return the number of recorded values
+     */
+    uint64_t GetCount() const;
+
+    /**
+     * \brief Get the smallest recorded value
+     * \return the smallest recorded value (0 if no value has been recorded)
+     */
+    uint64_t GetMin() const;
+
+    /**
+     * \brief Get the largest recorded value
+     * \return the largest recorded value (0 if no value has been recorded)
+     */
+    uint64_t GetMax() const;
+
+    /**
+     * \brief Get the average of the recorded values
+     * \return the average of the recorded values (0 if no value has been recorded)
+     */
+    double GetMean() const;
+
+    /**
+     * \brief Get the given percentile of the recorded values
+     *
+     * The returned value is the upper bound of the bucket including the value
+     * of the requested rank, capped to the largest recorded value.
+     * \param percentile the percentile, between 0 and 100
+     * \return the percentile (0 if no value has been recorded)
+     */
+    uint64_t GetPercentile(double percentile) const;
+
+    /**
+     * \brief Print the number of values, the average and the 50th, 99th and
+     *        99.9th percentiles
+     * \param os output stream in which the data should be printed
+     */
+    void Print(std::ostream& os) const;
+
+    /**
+     * \brief Get the index of the bucket including the given value
+     * \param value the value
+     * \return the index of the bucket
+     */
+    static inline uint32_t GetBucketIndex(uint64_t value);
+
+    /**
+     * \brief Get the smallest value included in the given bucket
+     * \param index the index of the bucket
+     * \return the smallest value included in the bucket
+     */
+    static uint64_t GetBucketLowerBound(uint32_t index);
+
+    /**
+     * \brief Get the largest value included in the given bucket
+     * \param index the index of the bucket
+     * \return the largest value included in the bucket
+     */
+    static uint64_t GetBucketUpperBound(uint32_t index);
+
+  private:
+    std::vector<uint64_t> m_counts; //!< the number of values recorded in each bucket
+    uint64_t m_count;               //!< the number of recorded values
+    uint64_t m_sum;                 //!< the sum of the recorded values
+    uint64_t m_min;                 //!< the smallest recorded value
+    uint64_t m_max;                 //!< the largest recorded value
+};
+
+/**
+ * \brief Stream insertion operator.
+ * \param os the stream
+ * \param histogram the histogram
+ * \returns a reference to the stream
+ */
+std::ostream& operator<<(std::ostream& os, const LogHistogram& histogram);
+
+uint32_t
+LogHistogram::GetBucketIndex(uint64_t value)
+{
+    if (value < (1ULL << PRECISION_BITS))
+    {
+        return static_cast<uint32_t>(value);
+    }
+#if defined(__GNUC__) || defined(__clang__)
+    uint32_t msb = 63 - __builtin_clzll(value);
+#else
+    uint32_t msb = 0;
+    for (uint64_t x = value; x >>= 1;)
+    {
+        msb++;
+    }
+#endif
+    // the PRECISION_BITS bits following the most significant bit select the
+    // bucket within the power-of-two range of the value
+    uint32_t shift = msb - PRECISION_BITS;
+    return (shift << PRECISION_BITS) + static_cast<uint32_t>(value >> shift);
+}
+
+void
+LogHistogram::Record(uint64_t value)
+{
+    uint32_t index = GetBucketIndex(value);
+    if (index >= m_counts.size())
+    {
+        m_counts.resize(index + 1, 0);
+    }
+    m_counts[index]++;
+    m_count++;
+    m_sum += value;
+    m_min = (value < m_min ? value : m_min);
+    m_max = (value > m_max ? value : m_max);
+}
+
+} // namespace ns3
+
+#endif /* LOG_HISTOGRAM_H */
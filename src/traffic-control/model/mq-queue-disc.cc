@@ -20,7 +20,12 @@
 
 #include "mq-queue-disc.h"
 
+#include "ns3/boolean.h"
 #include "ns3/log.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
 
 namespace ns3
 {
@@ -35,12 +40,32 @@ MqQueueDisc::GetTypeId()
     static TypeId tid = TypeId("ns3::MqQueueDisc")
                             .SetParent<QueueDisc>()
                             .SetGroupName("TrafficControl")
-                            .AddConstructor<MqQueueDisc>();
+                            .AddConstructor<MqQueueDisc>()
+                            .AddAttribute("ParallelRun",
+                                          "Whether the child queue discs are run in parallel",
+                                          BooleanValue(false),
+                                          MakeBooleanAccessor(&MqQueueDisc::m_parallelRun),
+                                          MakeBooleanChecker())
+                            .AddAttribute("ParallelThreads",
+                                          "The number of threads used to run the child queue "
+                                          "discs in parallel (0 means as many as the hardware "
+                                          "threads)",
+                                          UintegerValue(0),
+                                          MakeUintegerAccessor(&MqQueueDisc::m_nThreads),
+                                          MakeUintegerChecker<uint32_t>());
     return tid;
 }
 
 MqQueueDisc::MqQueueDisc()
-    : QueueDisc(QueueDiscSizePolicy::NO_LIMITS)
+    : QueueDisc(QueueDiscSizePolicy::NO_LIMITS),
+      m_parallelRun(false),
+      m_nThreads(0),
+      m_job(nullptr),
+      m_nJobs(0),
+      m_nextJob(0),
+      m_nBusyWorkers(0),
+      m_generation(0),
+      m_stopWorkers(false)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -50,12 +75,147 @@ MqQueueDisc::~MqQueueDisc()
     NS_LOG_FUNCTION(this);
 }
 
+void
+MqQueueDisc::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopWorkers = true;
+    }
+    m_jobCv.notify_all();
+    for (auto& worker : m_workers)
+    {
+        worker.join();
+    }
+    m_workers.clear();
+    QueueDisc::DoDispose();
+}
+
 MqQueueDisc::WakeMode
 MqQueueDisc::GetWakeMode() const
 {
     return WAKE_CHILD;
 }
 
+bool
+MqQueueDisc::IsParallelRunEnabled() const
+{
+    return m_parallelRun;
+}
+
+void
+MqQueueDisc::RunChildren(const std::vector<std::size_t>& txqs)
+{
+    NS_LOG_FUNCTION(this << txqs.size());
+
+    std::vector<Ptr<QueueDisc>> children;
+    std::vector<Ptr<NetDeviceQueue>> txQueues;
+    children.reserve(txqs.size());
+    txQueues.reserve(txqs.size());
+
+    for (auto i : txqs)
+    {
+        Ptr<QueueDisc> child = GetQueueDiscClass(i)->GetQueueDisc();
+        Ptr<NetDeviceQueueInterface> ndqi = child->GetNetDeviceQueueInterface();
+        children.push_back(child);
+        txQueues.push_back(ndqi ? ndqi->GetTxQueue(i) : nullptr);
+    }
+
+    // The drops and marks notified by the child queue discs while they are staging
+    // their runs are recorded, and delivered to this queue disc when the staged
+    // packets are sent, in the order of the transmission queues
+    DeferChildNotifications(true);
+    ParallelFor(children.size(),
+                [&children, &txQueues](std::size_t k) { children[k]->StageRun(txQueues[k]); });
+    DeferChildNotifications(false);
+
+    for (auto& child : children)
+    {
+        child->TransmitStaged();
+    }
+}
+
+void
+MqQueueDisc::ParallelFor(std::size_t n, const std::function<void(std::size_t)>& job)
+{
+    NS_LOG_FUNCTION(this << n);
+
+    if (m_workers.empty() && n > 1)
+    {
+        uint32_t nThreads = m_nThreads ? m_nThreads : std::thread::hardware_concurrency();
+        // the calling thread executes jobs as well
+        for (uint32_t i = 1; i < std::min<std::size_t>(nThreads, GetNQueueDiscClasses()); i++)
+        {
+            m_workers.emplace_back(&MqQueueDisc::WorkerLoop, this);
+        }
+    }
+
+    if (m_workers.empty() || n <= 1)
+    {
+        for (std::size_t i = 0; i < n; i++)
+        {
+            job(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = &job;
+        m_nJobs = n;
+        m_nextJob = 0;
+        m_nBusyWorkers = m_workers.size();
+        m_generation++;
+    }
+    m_jobCv.notify_all();
+
+    RunJobs();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCv.wait(lock, [this] { return m_nBusyWorkers == 0; });
+    m_job = nullptr;
+}
+
+void
+MqQueueDisc::RunJobs()
+{
+    std::size_t i;
+    while ((i = m_nextJob++) < m_nJobs)
+    {
+        (*m_job)(i);
+    }
+}
+
+void
+MqQueueDisc::WorkerLoop()
+{
+    uint64_t generation = 0;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_jobCv.wait(lock, [this, generation] {
+                return m_stopWorkers || m_generation != generation;
+            });
+            if (m_stopWorkers)
+            {
+                return;
+            }
+            generation = m_generation;
+        }
+
+        RunJobs();
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_nBusyWorkers == 0)
+        {
+            m_doneCv.notify_one();
+        }
+    }
+}
+
 bool
 MqQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
 {
@@ -23,6 +23,12 @@
 
 #include "queue-disc.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
 namespace ns3
 {
 
@@ -32,6 +38,13 @@ namespace ns3
  * mq is a classful multi-queue aware dummy scheduler. It has as many child
  * queue discs as the number of device transmission queues. Packets are
  * directly enqueued into and dequeued from child queue discs.
+ *
+ * If the ParallelRun attribute is set, the runs of the child queue discs
+ * requested within a simulation event (by enqueues or wakes) are deferred by
+ * the traffic control layer and performed together. The child queue discs
+ * dequeue the packets to send concurrently, and then send them to the device
+ * one child queue disc at a time, in the order of the transmission queues, so
+ * that the results do not depend on the number of threads.
  */
 class MqQueueDisc : public QueueDisc
 {
@@ -54,12 +67,67 @@ class MqQueueDisc : public QueueDisc
      */
     WakeMode GetWakeMode() const override;
 
+    /**
+     * \brief Return whether the child queue discs are run in parallel.
+     * \return true if the child queue discs are run in parallel.
+     */
+    bool IsParallelRunEnabled() const;
+
+    /**
+     * \brief Run the child queue discs associated with the given transmission
+     *        queues, in parallel.
+     *
+     * The child queue discs first stage their runs concurrently (see
+     * QueueDisc::StageRun) and then send the staged packets to the device (see
+     * QueueDisc::TransmitStaged) in the given order.
+     *
+     * \param txqs the indices of the transmission queues, in increasing order
+     */
+    void RunChildren(const std::vector<std::size_t>& txqs);
+
+  protected:
+    /**
+     * \brief Dispose of the object
+     */
+    void DoDispose() override;
+
   private:
     bool DoEnqueue(Ptr<QueueDiscItem> item) override;
     Ptr<QueueDiscItem> DoDequeue() override;
     Ptr<const QueueDiscItem> DoPeek() override;
     bool CheckConfig() override;
     void InitializeParams() override;
+
+    /**
+     * \brief Execute the given job for all the indices from 0 to n-1, using the
+     *        worker threads and the calling thread.
+     * \param n the number of jobs
+     * \param job the job to execute
+     */
+    void ParallelFor(std::size_t n, const std::function<void(std::size_t)>& job);
+
+    /**
+     * \brief Execute the jobs that have not been taken by other threads yet.
+     */
+    void RunJobs();
+
+    /**
+     * \brief The loop executed by a worker thread.
+     */
+    void WorkerLoop();
+
+    bool m_parallelRun;                           //!< Run the child queue discs in parallel
+    uint32_t m_nThreads;                          //!< Number of threads for parallel runs
+    std::vector<std::thread> m_workers;           //!< Worker threads
+    std::mutex m_mutex;                           //!< Mutex protecting the job state
+    std::condition_variable m_jobCv;              //!< Signals new jobs to the workers
+    std::condition_variable m_doneCv;             //!< Signals the end of the jobs
+    const std::function<void(std::size_t)>* m_job; //!< The job to execute
+    std::size_t m_nJobs;                          //!< The number of jobs
+    std::atomic<std::size_t> m_nextJob;           //!< The next job to execute
+    std::size_t m_nBusyWorkers;                   //!< Workers executing jobs
+    uint64_t m_generation;                        //!< Incremented for every set of jobs
+    bool m_stopWorkers;                           //!< Request the workers to exit
 };
 
 } // namespace ns3
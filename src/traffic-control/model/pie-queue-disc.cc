@@ -26,6 +26,8 @@
 
 #include "pie-queue-disc.h"
 
+#include "flow-aqm.h"
+
 #include "ns3/abort.h"
 #include "ns3/double.h"
 #include "ns3/drop-tail-queue.h"
@@ -142,7 +144,7 @@ PieQueueDisc::PieQueueDisc()
     : QueueDisc(QueueDiscSizePolicy::SINGLE_INTERNAL_QUEUE)
 {
     NS_LOG_FUNCTION(this);
-    m_uv = CreateObject<UniformRandomVariable>();
+    m_flowAqm = CreateObject<PieFlowAqm>();
     m_rtrsEvent = Simulator::Schedule(m_sUpdate, &PieQueueDisc::CalculateP, this);
 }
 
@@ -155,7 +157,7 @@ void
 PieQueueDisc::DoDispose()
 {
     NS_LOG_FUNCTION(this);
-    m_uv = nullptr;
+    m_flowAqm = nullptr;
     m_rtrsEvent.Cancel();
     QueueDisc::DoDispose();
 }
@@ -170,8 +172,7 @@ int64_t
 PieQueueDisc::AssignStreams(int64_t stream)
 {
     NS_LOG_FUNCTION(this << stream);
-    m_uv->SetStream(stream);
-    return 1;
+    return m_flowAqm->AssignStreams(stream);
 }
 
 bool
@@ -180,6 +181,17 @@ PieQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
     NS_LOG_FUNCTION(this << item);
 
     QueueSize nQueued = GetCurrentSize();
+    PieFlowAqm::QueueDiscState state{m_dropProb,
+                                     m_accuProb,
+                                     m_avgDqRate,
+                                     m_qDelayOld,
+                                     m_qDelay,
+                                     m_burstAllowance,
+                                     m_dqStart,
+                                     m_dqCount,
+                                     m_burstReset,
+                                     m_burstState,
+                                     m_inMeasurement};
     // If L4S is enabled, then check if the packet is ECT1, and if it is then set isEct true
     bool isEct1 = false;
     if (item && m_useL4s)
@@ -210,7 +222,7 @@ PieQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
     // isEct1 will be true only if L4S enabled as well as the packet is ECT1.
     // If L4S is enabled and packet is ECT1 then directly enqueue the packet.
     else if ((m_activeThreshold == Time::Max() || m_active) && !isEct1 &&
-             DropEarly(item, nQueued.GetValue()))
+             m_flowAqm->DropEarly(state, *GetInternalQueue(0), item))
     {
         if (!m_useEcn || m_dropProb >= m_markEcnTh || !Mark(item, UNFORCED_MARK))
         {
@@ -269,207 +281,44 @@ PieQueueDisc::InitializeParams()
     m_qDelayOld = Seconds(0);
     m_accuProb = 0.0;
     m_active = false;
-}
-
-bool
-PieQueueDisc::DropEarly(Ptr<QueueDiscItem> item, uint32_t qSize)
-{
-    NS_LOG_FUNCTION(this << item << qSize);
-    if (m_burstAllowance.GetSeconds() > 0)
-    {
-        // If there is still burst_allowance left, skip random early drop.
-        return false;
-    }
-
-    if (m_burstState == NO_BURST)
-    {
-        m_burstState = IN_BURST_PROTECTING;
-        m_burstAllowance = m_maxBurst;
-    }
-
-    double p = m_dropProb;
-
-    uint32_t packetSize = item->GetSize();
 
-    if (GetMaxSize().GetUnit() == QueueSizeUnit::BYTES)
-    {
-        p = p * packetSize / m_meanPktSize;
-    }
-
-    // Safeguard PIE to be work conserving (Section 4.1 of RFC 8033)
-    if ((m_qDelayOld.GetSeconds() < (0.5 * m_qDelayRef.GetSeconds())) && (m_dropProb < 0.2))
-    {
-        return false;
-    }
-    else if (GetMaxSize().GetUnit() == QueueSizeUnit::BYTES && qSize <= 2 * m_meanPktSize)
-    {
-        return false;
-    }
-    else if (GetMaxSize().GetUnit() == QueueSizeUnit::PACKETS && qSize <= 2)
-    {
-        return false;
-    }
-
-    if (m_useDerandomization)
-    {
-        if (m_dropProb == 0)
-        {
-            m_accuProb = 0;
-        }
-        m_accuProb += m_dropProb;
-        if (m_accuProb < 0.85)
-        {
-            return false;
-        }
-        else if (m_accuProb >= 8.5)
-        {
-            return true;
-        }
-    }
-
-    double u = m_uv->GetValue();
-    return u <= p;
+    m_flowAqm->SetAttribute("MaxSize", QueueSizeValue(GetMaxSize()));
+    m_flowAqm->SetAttribute("MeanPktSize", UintegerValue(m_meanPktSize));
+    m_flowAqm->SetAttribute("A", DoubleValue(m_a));
+    m_flowAqm->SetAttribute("B", DoubleValue(m_b));
+    m_flowAqm->SetAttribute("Tupdate", TimeValue(m_tUpdate));
+    m_flowAqm->SetAttribute("Supdate", TimeValue(m_sUpdate));
+    m_flowAqm->SetAttribute("DequeueThreshold", UintegerValue(m_dqThreshold));
+    m_flowAqm->SetAttribute("QueueDelayReference", TimeValue(m_qDelayRef));
+    m_flowAqm->SetAttribute("MaxBurstAllowance", TimeValue(m_maxBurst));
+    m_flowAqm->SetAttribute("UseDequeueRateEstimator", BooleanValue(m_useDqRateEstimator));
+    m_flowAqm->SetAttribute("UseCapDropAdjustment", BooleanValue(m_isCapDropAdjustment));
+    m_flowAqm->SetAttribute("UseEcn", BooleanValue(m_useEcn));
+    m_flowAqm->SetAttribute("MarkEcnThreshold", DoubleValue(m_markEcnTh));
+    m_flowAqm->SetAttribute("UseDerandomization", BooleanValue(m_useDerandomization));
+    m_flowAqm->SetAttribute("CeThreshold", TimeValue(m_ceThreshold));
+    m_flowAqm->SetAttribute("UseL4s", BooleanValue(m_useL4s));
+    m_flowAqm->SetMarkCallback(MakeCallback(&PieQueueDisc::Mark, this));
 }
 
 void
 PieQueueDisc::CalculateP()
 {
     NS_LOG_FUNCTION(this);
-    Time qDelay;
-    double p = 0.0;
-    bool missingInitFlag = false;
-
-    if (m_useDqRateEstimator)
-    {
-        if (m_avgDqRate > 0)
-        {
-            qDelay = Seconds(GetInternalQueue(0)->GetNBytes() / m_avgDqRate);
-        }
-        else
-        {
-            qDelay = Seconds(0);
-            missingInitFlag = true;
-        }
-        m_qDelay = qDelay;
-    }
-    else
-    {
-        qDelay = m_qDelay;
-    }
-    NS_LOG_DEBUG("Queue delay while calculating probability: " << qDelay.GetMilliSeconds() << "ms");
-
-    if (m_burstAllowance.GetSeconds() > 0)
-    {
-        m_dropProb = 0;
-    }
-    else
-    {
-        p = m_a * (qDelay.GetSeconds() - m_qDelayRef.GetSeconds()) +
-            m_b * (qDelay.GetSeconds() - m_qDelayOld.GetSeconds());
-        if (m_dropProb < 0.000001)
-        {
-            p /= 2048;
-        }
-        else if (m_dropProb < 0.00001)
-        {
-            p /= 512;
-        }
-        else if (m_dropProb < 0.0001)
-        {
-            p /= 128;
-        }
-        else if (m_dropProb < 0.001)
-        {
-            p /= 32;
-        }
-        else if (m_dropProb < 0.01)
-        {
-            p /= 8;
-        }
-        else if (m_dropProb < 0.1)
-        {
-            p /= 2;
-        }
-        else
-        {
-            // The pseudocode in Section 4.2 of RFC 8033 suggests to use this for
-            // assignment of p, but this assignment causes build failure on Mac OS
-            // p = p;
-        }
-
-        // Cap Drop Adjustment (Section 5.5 of RFC 8033)
-        if (m_isCapDropAdjustment && (m_dropProb >= 0.1) && (p > 0.02))
-        {
-            p = 0.02;
-        }
-    }
-
-    p += m_dropProb;
-
-    // For non-linear drop in prob
-    // Decay the drop probability exponentially (Section 4.2 of RFC 8033)
-    if (qDelay.GetSeconds() == 0 && m_qDelayOld.GetSeconds() == 0)
-    {
-        p *= 0.98;
-    }
-
-    // bound the drop probability (Section 4.2 of RFC 8033)
-    if (p < 0)
-    {
-        m_dropProb = 0;
-    }
-    else if (p > 1)
-    {
-        m_dropProb = 1;
-    }
-    else
-    {
-        m_dropProb = p;
-    }
-
-    // Section 4.4 #2
-    if (m_burstAllowance < m_tUpdate)
-    {
-        m_burstAllowance = Seconds(0);
-    }
-    else
-    {
-        m_burstAllowance -= m_tUpdate;
-    }
-
-    auto burstResetLimit = static_cast<uint32_t>(BURST_RESET_TIMEOUT / m_tUpdate.GetSeconds());
-    if ((qDelay.GetSeconds() < 0.5 * m_qDelayRef.GetSeconds()) &&
-        (m_qDelayOld.GetSeconds() < (0.5 * m_qDelayRef.GetSeconds())) && (m_dropProb == 0) &&
-        !missingInitFlag)
-    {
-        m_dqCount = DQCOUNT_INVALID;
-        m_avgDqRate = 0.0;
-    }
-    if ((qDelay.GetSeconds() < 0.5 * m_qDelayRef.GetSeconds()) &&
-        (m_qDelayOld.GetSeconds() < (0.5 * m_qDelayRef.GetSeconds())) && (m_dropProb == 0) &&
-        (m_burstAllowance.GetSeconds() == 0))
-    {
-        if (m_burstState == IN_BURST_PROTECTING)
-        {
-            m_burstState = IN_BURST;
-            m_burstReset = 0;
-        }
-        else if (m_burstState == IN_BURST)
-        {
-            m_burstReset++;
-            if (m_burstReset > burstResetLimit)
-            {
-                m_burstReset = 0;
-                m_burstState = NO_BURST;
-            }
-        }
-    }
-    else if (m_burstState == IN_BURST)
-    {
-        m_burstReset = 0;
-    }
-
-    m_qDelayOld = qDelay;
+    PieFlowAqm::QueueDiscState state{m_dropProb,
+                                     m_accuProb,
+                                     m_avgDqRate,
+                                     m_qDelayOld,
+                                     m_qDelay,
+                                     m_burstAllowance,
+                                     m_dqStart,
+                                     m_dqCount,
+                                     m_burstReset,
+                                     m_burstState,
+                                     m_inMeasurement};
+    m_flowAqm->CalculateP(state, *GetInternalQueue(0));
+    NS_LOG_DEBUG("Queue delay while calculating probability: " << m_qDelay.GetMilliSeconds()
+                                                               << "ms");
     m_rtrsEvent = Simulator::Schedule(m_tUpdate, &PieQueueDisc::CalculateP, this);
 }
 
@@ -477,100 +326,18 @@ Ptr<QueueDiscItem>
 PieQueueDisc::DoDequeue()
 {
     NS_LOG_FUNCTION(this);
-
-    if (GetInternalQueue(0)->IsEmpty())
-    {
-        NS_LOG_LOGIC("Queue empty");
-        return nullptr;
-    }
-
-    Ptr<QueueDiscItem> item = GetInternalQueue(0)->Dequeue();
-    NS_ASSERT_MSG(item, "Dequeue null, but internal queue not empty");
-
-    // If L4S is enabled and packet is ECT1, then check if delay is greater
-    // than CE threshold and if it is then mark the packet,
-    // skip PIE steps, and return the item.
-    if (m_useL4s)
-    {
-        uint8_t tosByte = 0;
-        if (item->GetUint8Value(QueueItem::IP_DSFIELD, tosByte) &&
-            (((tosByte & 0x3) == 1) || (tosByte & 0x3) == 3))
-        {
-            if ((tosByte & 0x3) == 1)
-            {
-                NS_LOG_DEBUG("ECT1 packet " << static_cast<uint16_t>(tosByte & 0x3));
-            }
-            else
-            {
-                NS_LOG_DEBUG("CE packet " << static_cast<uint16_t>(tosByte & 0x3));
-            }
-            if ((Now() - item->GetTimeStamp() > m_ceThreshold) &&
-                Mark(item, CE_THRESHOLD_EXCEEDED_MARK))
-            {
-                NS_LOG_LOGIC("Marking due to CeThreshold " << m_ceThreshold.GetSeconds());
-            }
-            return item;
-        }
-    }
-
-    // if not in a measurement cycle and the queue has built up to dq_threshold,
-    // start the measurement cycle
-    if (m_useDqRateEstimator)
-    {
-        if ((GetInternalQueue(0)->GetNBytes() >= m_dqThreshold) && (!m_inMeasurement))
-        {
-            m_dqStart = Now();
-            m_dqCount = 0;
-            m_inMeasurement = true;
-        }
-
-        if (m_inMeasurement)
-        {
-            m_dqCount += item->GetSize();
-
-            // done with a measurement cycle
-            if (m_dqCount >= m_dqThreshold)
-            {
-                Time dqTime = Now() - m_dqStart;
-                if (dqTime > Seconds(0))
-                {
-                    if (m_avgDqRate == 0)
-                    {
-                        m_avgDqRate = m_dqCount / dqTime.GetSeconds();
-                    }
-                    else
-                    {
-                        m_avgDqRate =
-                            (0.5 * m_avgDqRate) + (0.5 * (m_dqCount / dqTime.GetSeconds()));
-                    }
-                }
-                NS_LOG_DEBUG("Average Dequeue Rate after Dequeue: " << m_avgDqRate);
-
-                // restart a measurement cycle if there is enough data
-                if (GetInternalQueue(0)->GetNBytes() > m_dqThreshold)
-                {
-                    m_dqStart = Now();
-                    m_dqCount = 0;
-                    m_inMeasurement = true;
-                }
-                else
-                {
-                    m_dqCount = 0;
-                    m_inMeasurement = false;
-                }
-            }
-        }
-    }
-    else
-    {
-        m_qDelay = Now() - item->GetTimeStamp();
-
-        if (GetInternalQueue(0)->GetNBytes() == 0)
-        {
-            m_qDelay = Seconds(0);
-        }
-    }
-    return item;
+    PieFlowAqm::QueueDiscState state{m_dropProb,
+                                     m_accuProb,
+                                     m_avgDqRate,
+                                     m_qDelayOld,
+                                     m_qDelay,
+                                     m_burstAllowance,
+                                     m_dqStart,
+                                     m_dqCount,
+                                     m_burstReset,
+                                     m_burstState,
+                                     m_inMeasurement};
+    return m_flowAqm->DoDequeue(state, *GetInternalQueue(0));
 }
 
 bool
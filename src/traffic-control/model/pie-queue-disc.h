@@ -44,7 +44,7 @@ namespace ns3
 {
 
 class TraceContainer;
-class UniformRandomVariable;
+class PieFlowAqm;
 
 /**
  * \ingroup traffic-control
@@ -123,14 +123,6 @@ class PieQueueDisc : public QueueDisc
      */
     void InitializeParams() override;
 
-    /**
-     * \brief Check if a packet needs to be dropped due to probability drop
-     * \param item queue item
-     * \param qSize queue size
-     * \returns 0 for no drop, 1 for drop
-     */
-    bool DropEarly(Ptr<QueueDiscItem> item, uint32_t qSize);
-
     /**
      * Periodically update the drop probability based on the delay samples:
      * not only the current delay sample but also the trend where the delay
@@ -175,9 +167,9 @@ class PieQueueDisc : public QueueDisc
     uint64_t m_dqCount;       //!< Number of bytes departed since current measurement cycle starts
     EventId m_rtrsEvent;      //!< Event used to decide the decision of interval of drop probability
                               //!< calculation
-    Ptr<UniformRandomVariable> m_uv; //!< Rng stream
-    double m_accuProb;               //!< Accumulated drop probability
-    bool m_active;                   //!< Indicates whether PIE is in active state or not
+    double m_accuProb;         //!< Accumulated drop probability
+    bool m_active;             //!< Indicates whether PIE is in active state or not
+    Ptr<PieFlowAqm> m_flowAqm; //!< The control law, run on the variables above
 };
 
 }; // namespace ns3
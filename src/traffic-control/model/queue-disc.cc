@@ -19,16 +19,25 @@
 #include "queue-disc.h"
 
 #include "ns3/abort.h"
+#include "ns3/boolean.h"
 #include "ns3/log.h"
 #include "ns3/net-device-queue-interface.h"
 #include "ns3/object-vector.h"
 #include "ns3/packet.h"
 #include "ns3/pointer.h"
+#include "ns3/queue-limits.h"
 #include "ns3/queue.h"
 #include "ns3/simulator.h"
 #include "ns3/socket.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
 namespace ns3
 {
 
@@ -85,6 +94,109 @@ QueueDiscClass::SetQueueDisc(Ptr<QueueDisc> qd)
     m_queueDisc = qd;
 }
 
+/**
+ * \ingroup traffic-control
+ *
+ * The registry of the interned drop and mark reasons, shared by all the queue discs
+ */
+struct QueueDiscReasonRegistry
+{
+    std::shared_mutex mutex;                       //!< Mutex protecting the registry
+    std::deque<std::string> names;                 //!< Reasons, indexed by identifier
+    std::unordered_map<std::string, uint32_t> ids; //!< Identifiers, indexed by reason
+};
+
+/**
+ * \ingroup traffic-control
+ *
+ * Get the registry of the interned drop and mark reasons
+ *
+ * \return the registry
+ */
+static QueueDiscReasonRegistry&
+GetQueueDiscReasonRegistry()
+{
+    static QueueDiscReasonRegistry registry;
+    return registry;
+}
+
+/**
+ * \ingroup traffic-control
+ *
+ * Add a packet to the counters of the given reason
+ *
+ * \param counters the counters, indexed by reason identifier
+ * \param id the identifier of the reason
+ * \param size the size of the packet
+ */
+static inline void
+AddToReasonCounters(std::vector<QueueDisc::Stats::ReasonCounters>& counters,
+                    uint32_t id,
+                    uint32_t size)
+{
+    if (id >= counters.size())
+    {
+        counters.resize(id + 1);
+    }
+    counters[id].packets++;
+    counters[id].bytes += size;
+}
+
+/**
+ * \ingroup traffic-control
+ *
+ * Fill the per-reason maps of packets and bytes from the flat array of counters
+ *
+ * \param counters the counters, indexed by reason identifier
+ * \param packets the map of the packets for each reason
+ * \param bytes the map of the bytes for each reason
+ */
+template <typename P, typename B>
+static void
+FillReasonMaps(const std::vector<QueueDisc::Stats::ReasonCounters>& counters,
+               std::map<std::string, P, std::less<>>& packets,
+               std::map<std::string, B, std::less<>>& bytes)
+{
+    packets.clear();
+    bytes.clear();
+    for (uint32_t id = 0; id < counters.size(); id++)
+    {
+        if (counters[id].packets > 0)
+        {
+            packets[QueueDisc::GetReasonName(id)] = counters[id].packets;
+            bytes[QueueDisc::GetReasonName(id)] = counters[id].bytes;
+        }
+    }
+}
+
+/**
+ * \ingroup traffic-control
+ *
+ * Print the per-reason counters
+ *
+ * \param os the output stream
+ * \param counters the counters, indexed by reason identifier
+ */
+static void
+PrintReasonCounters(std::ostream& os,
+                    const std::vector<QueueDisc::Stats::ReasonCounters>& counters)
+{
+    // sort the reasons, as the maps they used to be stored in did
+    std::map<std::string, uint32_t> sorted;
+    for (uint32_t id = 0; id < counters.size(); id++)
+    {
+        if (counters[id].packets > 0)
+        {
+            sorted[QueueDisc::GetReasonName(id)] = id;
+        }
+    }
+    for (const auto& [name, id] : sorted)
+    {
+        os << std::endl
+           << "  " << name << ": " << counters[id].packets << " / " << counters[id].bytes;
+    }
+}
+
 QueueDisc::Stats::Stats()
     : nTotalReceivedPackets(0),
       nTotalReceivedBytes(0),
@@ -103,26 +215,30 @@ QueueDisc::Stats::Stats()
       nTotalRequeuedPackets(0),
       nTotalRequeuedBytes(0),
       nTotalMarkedPackets(0),
-      nTotalMarkedBytes(0)
+      nTotalMarkedBytes(0),
+      nTotalFlowHashCollisions(0),
+      nPeakFlowObjects(0)
 {
 }
 
 uint32_t
 QueueDisc::Stats::GetNDroppedPackets(std::string reason) const
 {
+    uint32_t id;
+    if (!QueueDisc::FindReasonId(reason, id))
+    {
+        return 0;
+    }
     uint32_t count = 0;
-    auto it = nDroppedPacketsBeforeEnqueue.find(reason);
 
-    if (it != nDroppedPacketsBeforeEnqueue.end())
+    if (id < nDroppedBeforeEnqueueByReason.size())
     {
-        count += it->second;
+        count += nDroppedBeforeEnqueueByReason[id].packets;
     }
 
-    it = nDroppedPacketsAfterDequeue.find(reason);
-
-    if (it != nDroppedPacketsAfterDequeue.end())
+    if (id < nDroppedAfterDequeueByReason.size())
     {
-        count += it->second;
+        count += nDroppedAfterDequeueByReason[id].packets;
     }
 
     return count;
@@ -131,19 +247,21 @@ QueueDisc::Stats::GetNDroppedPackets(std::string reason) const
 uint64_t
 QueueDisc::Stats::GetNDroppedBytes(std::string reason) const
 {
+    uint32_t id;
+    if (!QueueDisc::FindReasonId(reason, id))
+    {
+        return 0;
+    }
     uint64_t count = 0;
-    auto it = nDroppedBytesBeforeEnqueue.find(reason);
 
-    if (it != nDroppedBytesBeforeEnqueue.end())
+    if (id < nDroppedBeforeEnqueueByReason.size())
     {
-        count += it->second;
+        count += nDroppedBeforeEnqueueByReason[id].bytes;
     }
 
-    it = nDroppedBytesAfterDequeue.find(reason);
-
-    if (it != nDroppedBytesAfterDequeue.end())
+    if (id < nDroppedAfterDequeueByReason.size())
     {
-        count += it->second;
+        count += nDroppedAfterDequeueByReason[id].bytes;
     }
 
     return count;
@@ -152,11 +270,15 @@ QueueDisc::Stats::GetNDroppedBytes(std::string reason) const
 uint32_t
 QueueDisc::Stats::GetNMarkedPackets(std::string reason) const
 {
-    auto it = nMarkedPackets.find(reason);
+    uint32_t id;
+    if (!QueueDisc::FindReasonId(reason, id))
+    {
+        return 0;
+    }
 
-    if (it != nMarkedPackets.end())
+    if (id < nMarkedByReason.size())
     {
-        return it->second;
+        return nMarkedByReason[id].packets;
     }
 
     return 0;
@@ -165,11 +287,15 @@ QueueDisc::Stats::GetNMarkedPackets(std::string reason) const
 uint64_t
 QueueDisc::Stats::GetNMarkedBytes(std::string reason) const
 {
-    auto it = nMarkedBytes.find(reason);
+    uint32_t id;
+    if (!QueueDisc::FindReasonId(reason, id))
+    {
+        return 0;
+    }
 
-    if (it != nMarkedBytes.end())
+    if (id < nMarkedByReason.size())
     {
-        return it->second;
+        return nMarkedByReason[id].bytes;
     }
 
     return 0;
@@ -192,48 +318,33 @@ QueueDisc::Stats::Print(std::ostream& os) const
        << "Packets/Bytes dropped before enqueue: " << nTotalDroppedPacketsBeforeEnqueue << " / "
        << nTotalDroppedBytesBeforeEnqueue;
 
-    auto itp = nDroppedPacketsBeforeEnqueue.begin();
-    auto itb = nDroppedBytesBeforeEnqueue.begin();
-
-    while (itp != nDroppedPacketsBeforeEnqueue.end() && itb != nDroppedBytesBeforeEnqueue.end())
-    {
-        NS_ASSERT(itp->first == itb->first);
-        os << std::endl << "  " << itp->first << ": " << itp->second << " / " << itb->second;
-        itp++;
-        itb++;
-    }
+    PrintReasonCounters(os, nDroppedBeforeEnqueueByReason);
 
     os << std::endl
        << "Packets/Bytes dropped after dequeue: " << nTotalDroppedPacketsAfterDequeue << " / "
        << nTotalDroppedBytesAfterDequeue;
 
-    itp = nDroppedPacketsAfterDequeue.begin();
-    itb = nDroppedBytesAfterDequeue.begin();
-
-    while (itp != nDroppedPacketsAfterDequeue.end() && itb != nDroppedBytesAfterDequeue.end())
-    {
-        NS_ASSERT(itp->first == itb->first);
-        os << std::endl << "  " << itp->first << ": " << itp->second << " / " << itb->second;
-        itp++;
-        itb++;
-    }
+    PrintReasonCounters(os, nDroppedAfterDequeueByReason);
 
     os << std::endl
        << "Packets/Bytes sent: " << nTotalSentPackets << " / " << nTotalSentBytes << std::endl
        << "Packets/Bytes marked: " << nTotalMarkedPackets << " / " << nTotalMarkedBytes;
 
-    itp = nMarkedPackets.begin();
-    itb = nMarkedBytes.begin();
+    PrintReasonCounters(os, nMarkedByReason);
+
+    os << std::endl
+       << "Flow hash collisions: " << nTotalFlowHashCollisions << std::endl
+       << "Peak flow objects in use: " << nPeakFlowObjects << std::endl;
 
-    while (itp != nMarkedPackets.end() && itb != nMarkedBytes.end())
+    if (sojournTime.GetCount())
     {
-        NS_ASSERT(itp->first == itb->first);
-        os << std::endl << "  " << itp->first << ": " << itp->second << " / " << itb->second;
-        itp++;
-        itb++;
+        os << "Sojourn time (ns): " << sojournTime << std::endl;
+    }
+    if (backlogPackets.GetCount())
+    {
+        os << "Backlog at enqueue (packets): " << backlogPackets << std::endl
+           << "Backlog at enqueue (bytes): " << backlogBytes << std::endl;
     }
-
-    os << std::endl;
 }
 
 std::ostream&
@@ -245,6 +356,9 @@ operator<<(std::ostream& os, const QueueDisc::Stats& stats)
 
 NS_OBJECT_ENSURE_REGISTERED(QueueDisc);
 
+thread_local std::vector<QueueDisc::ChildNotification>* QueueDisc::m_stagingNotifications =
+    nullptr;
+
 TypeId
 QueueDisc::GetTypeId()
 {
@@ -257,6 +371,21 @@ QueueDisc::GetTypeId()
                           UintegerValue(DEFAULT_QUOTA),
                           MakeUintegerAccessor(&QueueDisc::SetQuota, &QueueDisc::GetQuota),
                           MakeUintegerChecker<uint32_t>())
+            .AddAttribute("MaxBulkBytes",
+                          "The byte budget of a bulk dequeue, i.e., the packets dequeued "
+                          "and handed to the device in a single batch (0 disables bulk "
+                          "dequeues). The budget is further bounded by the availability "
+                          "of the queue limits (e.g., BQL) of the device queue, if any.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&QueueDisc::m_maxBulkBytes),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("EnableHistograms",
+                          "Whether to record the histograms of the sojourn time of the "
+                          "dequeued packets and of the backlog (in packets and bytes) "
+                          "seen by the enqueued packets in the queue disc statistics.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&QueueDisc::m_enableHistograms),
+                          MakeBooleanChecker())
             .AddAttribute("InternalQueueList",
                           "The list of internal queues.",
                           ObjectVectorValue(),
@@ -319,6 +448,12 @@ QueueDisc::QueueDisc(QueueDiscSizePolicy policy)
     : m_nPackets(0),
       m_nBytes(0),
       m_maxSize(QueueSize("1p")), // to avoid that setting the mode at construction time is ignored
+      m_maxBulkBytes(0),
+      m_enableHistograms(false),
+      m_scheduled(false),
+      m_staged(false),
+      m_nStagedRequeued(0),
+      m_deferChildNotifications(false),
       m_running(false),
       m_peeked(false),
       m_sizePolicy(policy),
@@ -338,25 +473,30 @@ QueueDisc::QueueDisc(QueueDiscSizePolicy policy)
         return DropAfterDequeue(item, INTERNAL_QUEUE_DROP);
     };
 
-    // These lambdas call the DropBeforeEnqueue or DropAfterDequeue methods of this
-    // QueueDisc object. Given that a callback to the operator() of these lambdas
-    // is connected to the DropBeforeEnqueue and DropAfterDequeue traces of the
-    // child queue discs, the concatenation of the CHILD_QUEUE_DISC_DROP constant
-    // and the second argument provided by such traces is passed as the reason why
-    // the packet is dropped.
+    // This lambda calls (through NotifyChild) the PacketDequeued method of this
+    // QueueDisc object when a child queue disc dequeues a packet. Going through
+    // NotifyChild allows to defer the update of the statistics of this QueueDisc
+    // object while the child queue discs are staging a run on other threads.
+    m_childQueueDiscDequeueFunctor = [this](Ptr<const QueueDiscItem> item) {
+        NotifyChild(CHILD_DEQUEUE, item, nullptr);
+    };
+
+    // These lambdas call (through NotifyChild) the DropBeforeEnqueue, DropAfterDequeue
+    // or Mark methods of this QueueDisc object. Given that a callback to the operator()
+    // of these lambdas is connected to the DropBeforeEnqueue, DropAfterDequeue and Mark
+    // traces of the child queue discs, the concatenation of the CHILD_QUEUE_DISC_DROP
+    // (or CHILD_QUEUE_DISC_MARK) constant and the second argument provided by such
+    // traces is passed as the reason why the packet is dropped (or marked). The
+    // concatenation is interned, hence it is only built the first time a child queue
+    // disc provides a given reason.
     m_childQueueDiscDbeFunctor = [this](Ptr<const QueueDiscItem> item, const char* r) {
-        return DropBeforeEnqueue(
-            item,
-            m_childQueueDiscDropMsg.assign(CHILD_QUEUE_DISC_DROP).append(r).data());
+        NotifyChild(CHILD_DROP_BEFORE_ENQUEUE, item, r);
     };
     m_childQueueDiscDadFunctor = [this](Ptr<const QueueDiscItem> item, const char* r) {
-        return DropAfterDequeue(
-            item,
-            m_childQueueDiscDropMsg.assign(CHILD_QUEUE_DISC_DROP).append(r).data());
+        NotifyChild(CHILD_DROP_AFTER_DEQUEUE, item, r);
     };
     m_childQueueDiscMarkFunctor = [this](Ptr<const QueueDiscItem> item, const char* r) {
-        return Mark(const_cast<QueueDiscItem*>(PeekPointer(item)),
-                    m_childQueueDiscMarkMsg.assign(CHILD_QUEUE_DISC_MARK).append(r).data());
+        NotifyChild(CHILD_MARK, item, r);
     };
 }
 
@@ -381,9 +521,15 @@ QueueDisc::DoDispose()
     m_classes.clear();
     m_devQueueIface = nullptr;
     m_send = nullptr;
+    m_sendBatch = nullptr;
+    m_netifSchedule = nullptr;
+    m_batch.clear();
     m_requeued = nullptr;
+    m_requeuedBatch.clear();
+    m_childNotifications.clear();
     m_internalQueueDbeFunctor = nullptr;
     m_internalQueueDadFunctor = nullptr;
+    m_childQueueDiscDequeueFunctor = nullptr;
     m_childQueueDiscDbeFunctor = nullptr;
     m_childQueueDiscDadFunctor = nullptr;
     Object::DoDispose();
@@ -419,15 +565,120 @@ QueueDisc::GetStats()
     // the total number of sent packets is only updated here to avoid to increase it
     // after a dequeue and then having to decrease it if the packet is dropped after
     // dequeue or requeued
+    uint64_t requeuedBytes = (m_requeued ? m_requeued->GetSize() : 0);
+    for (const auto& item : m_requeuedBatch)
+    {
+        requeuedBytes += item->GetSize();
+    }
     m_stats.nTotalSentPackets = m_stats.nTotalDequeuedPackets - (m_requeued ? 1 : 0) -
-                                m_stats.nTotalDroppedPacketsAfterDequeue;
-    m_stats.nTotalSentBytes = m_stats.nTotalDequeuedBytes -
-                              (m_requeued ? m_requeued->GetSize() : 0) -
-                              m_stats.nTotalDroppedBytesAfterDequeue;
+                                m_requeuedBatch.size() - m_stats.nTotalDroppedPacketsAfterDequeue;
+    m_stats.nTotalSentBytes =
+        m_stats.nTotalDequeuedBytes - requeuedBytes - m_stats.nTotalDroppedBytesAfterDequeue;
+
+    // the per-reason maps are only filled here, the counters being stored in flat
+    // arrays indexed by reason identifier
+    FillReasonMaps(m_stats.nDroppedBeforeEnqueueByReason,
+                   m_stats.nDroppedPacketsBeforeEnqueue,
+                   m_stats.nDroppedBytesBeforeEnqueue);
+    FillReasonMaps(m_stats.nDroppedAfterDequeueByReason,
+                   m_stats.nDroppedPacketsAfterDequeue,
+                   m_stats.nDroppedBytesAfterDequeue);
+    FillReasonMaps(m_stats.nMarkedByReason, m_stats.nMarkedPackets, m_stats.nMarkedBytes);
 
     return m_stats;
 }
 
+uint32_t
+QueueDisc::GetReasonId(const std::string& reason)
+{
+    uint32_t id;
+    if (FindReasonId(reason, id))
+    {
+        return id;
+    }
+
+    QueueDiscReasonRegistry& registry = GetQueueDiscReasonRegistry();
+    std::unique_lock<std::shared_mutex> lock(registry.mutex);
+
+    auto [it, inserted] = registry.ids.try_emplace(reason, registry.names.size());
+    if (inserted)
+    {
+        registry.names.push_back(reason);
+    }
+    return it->second;
+}
+
+bool
+QueueDisc::FindReasonId(const std::string& reason, uint32_t& id)
+{
+    QueueDiscReasonRegistry& registry = GetQueueDiscReasonRegistry();
+    std::shared_lock<std::shared_mutex> lock(registry.mutex);
+
+    auto it = registry.ids.find(reason);
+    if (it == registry.ids.end())
+    {
+        return false;
+    }
+    id = it->second;
+    return true;
+}
+
+const char*
+QueueDisc::GetReasonName(uint32_t id)
+{
+    QueueDiscReasonRegistry& registry = GetQueueDiscReasonRegistry();
+    std::shared_lock<std::shared_mutex> lock(registry.mutex);
+
+    NS_ASSERT_MSG(id < registry.names.size(), "Unknown reason identifier " << id);
+    // elements of a deque are not moved when other elements are appended
+    return registry.names[id].c_str();
+}
+
+uint32_t
+QueueDisc::LookupReasonId(const char* reason)
+{
+    for (auto& entry : m_reasonIds)
+    {
+        if (entry.reason == reason)
+        {
+            // the caller may have reused the buffer for another reason
+            if (entry.name != reason && std::strcmp(entry.name, reason) != 0)
+            {
+                entry.id = GetReasonId(reason);
+                entry.name = GetReasonName(entry.id);
+            }
+            return entry.id;
+        }
+    }
+
+    uint32_t id = GetReasonId(reason);
+    m_reasonIds.push_back({reason, GetReasonName(id), id});
+    return id;
+}
+
+const char*
+QueueDisc::GetChildReason(std::vector<std::pair<const char*, const char*>>& cache,
+                          const char* prefix,
+                          const char* reason)
+{
+    for (auto& [ptr, interned] : cache)
+    {
+        if (ptr == reason)
+        {
+            // the child queue disc may have reused the buffer for another reason
+            if (std::strcmp(interned + std::strlen(prefix), reason) != 0)
+            {
+                interned = GetReasonName(GetReasonId(std::string(prefix).append(reason)));
+            }
+            return interned;
+        }
+    }
+
+    const char* interned = GetReasonName(GetReasonId(std::string(prefix).append(reason)));
+    cache.emplace_back(reason, interned);
+    return interned;
+}
+
 uint32_t
 QueueDisc::GetNPackets() const
 {
@@ -555,6 +806,166 @@ QueueDisc::GetSendCallback() const
     return m_send;
 }
 
+void
+QueueDisc::SetSendBatchCallback(SendBatchCallback func)
+{
+    NS_LOG_FUNCTION(this);
+    m_sendBatch = func;
+}
+
+QueueDisc::SendBatchCallback
+QueueDisc::GetSendBatchCallback() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_sendBatch;
+}
+
+void
+QueueDisc::SetNetifScheduleCallback(NetifScheduleCallback func)
+{
+    NS_LOG_FUNCTION(this);
+    m_netifSchedule = func;
+    m_scheduled = false;
+}
+
+void
+QueueDisc::NetifSchedule()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_scheduled && m_netifSchedule)
+    {
+        m_scheduled = true;
+        m_netifSchedule(this);
+    }
+}
+
+void
+QueueDisc::RunScheduled()
+{
+    NS_LOG_FUNCTION(this);
+    m_scheduled = false;
+    Run();
+}
+
+void
+QueueDisc::StageRun(const Ptr<NetDeviceQueue>& txq)
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(m_batch.empty() && m_childNotifications.empty());
+
+    m_scheduled = false;
+    m_staged = false;
+
+    // requeued packets, if any, wait for the device queue to be woken up
+    if ((txq && txq->IsStopped()) || !RunBegin())
+    {
+        return;
+    }
+    m_staged = true;
+    m_nStagedRequeued = 0;
+
+    m_stagingNotifications = &m_childNotifications;
+    while (m_batch.size() < m_quota)
+    {
+        Ptr<QueueDiscItem> item;
+        if (m_requeued)
+        {
+            // as in DequeuePacket, requeued packets already carry their header
+            item = TakeRequeued();
+            if (m_peeked)
+            {
+                m_peeked = false;
+                PacketDequeued(item);
+            }
+            m_nStagedRequeued++;
+        }
+        else
+        {
+            item = Dequeue();
+            if (!item)
+            {
+                break;
+            }
+        }
+        m_batch.push_back(item);
+    }
+    m_stagingNotifications = nullptr;
+}
+
+void
+QueueDisc::TransmitStaged()
+{
+    NS_LOG_FUNCTION(this);
+
+    // deliver the notifications recorded while staging the run, in order
+    std::vector<ChildNotification> notifications;
+    notifications.swap(m_childNotifications);
+    for (const auto& n : notifications)
+    {
+        n.parent->NotifyChild(n.type, n.item, n.reason);
+    }
+
+    if (!m_staged)
+    {
+        return;
+    }
+    m_staged = false;
+
+    if (!m_batch.empty())
+    {
+        // headers are added here because packets may share their buffer with
+        // packets that are not owned by this queue disc
+        for (std::size_t i = m_nStagedRequeued; i < m_batch.size(); i++)
+        {
+            m_batch[i]->AddHeader();
+        }
+        if (Transmit(m_batch) && m_batch.size() >= m_quota)
+        {
+            NetifSchedule();
+        }
+        m_batch.clear();
+    }
+    RunEnd();
+}
+
+void
+QueueDisc::DeferChildNotifications(bool defer)
+{
+    NS_LOG_FUNCTION(this << defer);
+    m_deferChildNotifications = defer;
+}
+
+void
+QueueDisc::NotifyChild(ChildNotificationType type,
+                       Ptr<const QueueDiscItem> item,
+                       const char* reason)
+{
+    NS_LOG_FUNCTION(this << (uint16_t)type << item << reason);
+
+    if (m_deferChildNotifications && m_stagingNotifications)
+    {
+        m_stagingNotifications->push_back({this, type, item, reason});
+        return;
+    }
+
+    switch (type)
+    {
+    case CHILD_DEQUEUE:
+        PacketDequeued(item);
+        break;
+    case CHILD_DROP_BEFORE_ENQUEUE:
+        DropBeforeEnqueue(item, GetChildReason(m_childDropReasons, CHILD_QUEUE_DISC_DROP, reason));
+        break;
+    case CHILD_DROP_AFTER_DEQUEUE:
+        DropAfterDequeue(item, GetChildReason(m_childDropReasons, CHILD_QUEUE_DISC_DROP, reason));
+        break;
+    case CHILD_MARK:
+        Mark(const_cast<QueueDiscItem*>(PeekPointer(item)),
+             GetChildReason(m_childMarkReasons, CHILD_QUEUE_DISC_MARK, reason));
+        break;
+    }
+}
+
 void
 QueueDisc::SetQuota(const uint32_t quota)
 {
@@ -637,7 +1048,7 @@ QueueDisc::AddQueueDiscClass(Ptr<QueueDiscClass> qdClass)
         MakeCallback(&QueueDisc::PacketEnqueued, this));
     qdClass->GetQueueDisc()->TraceConnectWithoutContext(
         "Dequeue",
-        MakeCallback(&QueueDisc::PacketDequeued, this));
+        MakeCallback(&ChildQueueDiscDequeueFunctor::operator(), &m_childQueueDiscDequeueFunctor));
     qdClass->GetQueueDisc()->TraceConnectWithoutContext(
         "DropBeforeEnqueue",
         MakeCallback(&ChildQueueDiscDropFunctor::operator(), &m_childQueueDiscDbeFunctor));
@@ -690,6 +1101,12 @@ QueueDisc::PacketEnqueued(Ptr<const QueueDiscItem> item)
     m_stats.nTotalEnqueuedPackets++;
     m_stats.nTotalEnqueuedBytes += item->GetSize();
 
+    if (m_enableHistograms)
+    {
+        m_stats.backlogPackets.Record(m_nPackets);
+        m_stats.backlogBytes.Record(m_nBytes);
+    }
+
     NS_LOG_LOGIC("m_traceEnqueue (p)");
     m_traceEnqueue(item);
 }
@@ -709,7 +1126,13 @@ QueueDisc::PacketDequeued(Ptr<const QueueDiscItem> item)
         m_stats.nTotalDequeuedPackets++;
         m_stats.nTotalDequeuedBytes += item->GetSize();
 
-        m_sojourn(Simulator::Now() - item->GetTimeStamp());
+        Time sojourn = Simulator::Now() - item->GetTimeStamp();
+        m_sojourn(sojourn);
+
+        if (m_enableHistograms)
+        {
+            m_stats.sojournTime.Record(static_cast<uint64_t>(sojourn.GetNanoSeconds()));
+        }
 
         NS_LOG_LOGIC("m_traceDequeue (p)");
         m_traceDequeue(item);
@@ -726,26 +1149,9 @@ QueueDisc::DropBeforeEnqueue(Ptr<const QueueDiscItem> item, const char* reason)
     m_stats.nTotalDroppedPacketsBeforeEnqueue++;
     m_stats.nTotalDroppedBytesBeforeEnqueue += item->GetSize();
 
-    // update the number of packets dropped for the given reason
-    auto itp = m_stats.nDroppedPacketsBeforeEnqueue.find(reason);
-    if (itp != m_stats.nDroppedPacketsBeforeEnqueue.end())
-    {
-        itp->second++;
-    }
-    else
-    {
-        m_stats.nDroppedPacketsBeforeEnqueue[reason] = 1;
-    }
-    // update the amount of bytes dropped for the given reason
-    auto itb = m_stats.nDroppedBytesBeforeEnqueue.find(reason);
-    if (itb != m_stats.nDroppedBytesBeforeEnqueue.end())
-    {
-        itb->second += item->GetSize();
-    }
-    else
-    {
-        m_stats.nDroppedBytesBeforeEnqueue[reason] = item->GetSize();
-    }
+    AddToReasonCounters(m_stats.nDroppedBeforeEnqueueByReason,
+                        LookupReasonId(reason),
+                        item->GetSize());
 
     NS_LOG_DEBUG("Total packets/bytes dropped before enqueue: "
                  << m_stats.nTotalDroppedPacketsBeforeEnqueue << " / "
@@ -765,26 +1171,9 @@ QueueDisc::DropAfterDequeue(Ptr<const QueueDiscItem> item, const char* reason)
     m_stats.nTotalDroppedPacketsAfterDequeue++;
     m_stats.nTotalDroppedBytesAfterDequeue += item->GetSize();
 
-    // update the number of packets dropped for the given reason
-    auto itp = m_stats.nDroppedPacketsAfterDequeue.find(reason);
-    if (itp != m_stats.nDroppedPacketsAfterDequeue.end())
-    {
-        itp->second++;
-    }
-    else
-    {
-        m_stats.nDroppedPacketsAfterDequeue[reason] = 1;
-    }
-    // update the amount of bytes dropped for the given reason
-    auto itb = m_stats.nDroppedBytesAfterDequeue.find(reason);
-    if (itb != m_stats.nDroppedBytesAfterDequeue.end())
-    {
-        itb->second += item->GetSize();
-    }
-    else
-    {
-        m_stats.nDroppedBytesAfterDequeue[reason] = item->GetSize();
-    }
+    AddToReasonCounters(m_stats.nDroppedAfterDequeueByReason,
+                        LookupReasonId(reason),
+                        item->GetSize());
 
     // if in the context of a peek request a dequeued packet is dropped, we need
     // to update the statistics and fire the dequeue trace before firing the drop
@@ -820,26 +1209,7 @@ QueueDisc::Mark(Ptr<QueueDiscItem> item, const char* reason)
     m_stats.nTotalMarkedPackets++;
     m_stats.nTotalMarkedBytes += item->GetSize();
 
-    // update the number of packets marked for the given reason
-    auto itp = m_stats.nMarkedPackets.find(reason);
-    if (itp != m_stats.nMarkedPackets.end())
-    {
-        itp->second++;
-    }
-    else
-    {
-        m_stats.nMarkedPackets[reason] = 1;
-    }
-    // update the amount of bytes marked for the given reason
-    auto itb = m_stats.nMarkedBytes.find(reason);
-    if (itb != m_stats.nMarkedBytes.end())
-    {
-        itb->second += item->GetSize();
-    }
-    else
-    {
-        m_stats.nMarkedBytes[reason] = item->GetSize();
-    }
+    AddToReasonCounters(m_stats.nMarkedByReason, LookupReasonId(reason), item->GetSize());
 
     NS_LOG_DEBUG("Total packets/bytes marked: " << m_stats.nTotalMarkedPackets << " / "
                                                 << m_stats.nTotalMarkedBytes);
@@ -847,6 +1217,20 @@ QueueDisc::Mark(Ptr<QueueDiscItem> item, const char* reason)
     return true;
 }
 
+void
+QueueDisc::NotifyFlowHashCollision()
+{
+    NS_LOG_FUNCTION(this);
+    m_stats.nTotalFlowHashCollisions++;
+}
+
+void
+QueueDisc::NotifyFlowObjectsInUse(uint32_t nFlowObjects)
+{
+    NS_LOG_FUNCTION(this << nFlowObjects);
+    m_stats.nPeakFlowObjects = std::max(m_stats.nPeakFlowObjects, nFlowObjects);
+}
+
 bool
 QueueDisc::Enqueue(Ptr<QueueDiscItem> item)
 {
@@ -890,11 +1274,10 @@ QueueDisc::Dequeue()
     // The QueueDisc::DoPeek method dequeues a packet and keeps it as a requeued
     // packet. Thus, first check whether a peeked packet exists. Otherwise, call
     // the private DoDequeue method.
-    Ptr<QueueDiscItem> item = m_requeued;
+    Ptr<QueueDiscItem> item = TakeRequeued();
 
     if (item)
     {
-        m_requeued = nullptr;
         if (m_peeked)
         {
             // If the packet was requeued because a peek operation was requested
@@ -948,13 +1331,16 @@ QueueDisc::Run()
 
     if (RunBegin())
     {
-        uint32_t quota = m_quota;
-        while (Restart())
+        int64_t quota = m_quota;
+        uint32_t packets = 0;
+        while (Restart(packets))
         {
-            quota -= 1;
+            quota -= packets;
             if (quota <= 0)
             {
-                /// \todo netif_schedule (q);
+                // defer the next run, so that the remaining packets do not have to
+                // wait for the next enqueue or wake
+                NetifSchedule();
                 break;
             }
         }
@@ -983,9 +1369,10 @@ QueueDisc::RunEnd()
 }
 
 bool
-QueueDisc::Restart()
+QueueDisc::Restart(uint32_t& packets)
 {
     NS_LOG_FUNCTION(this);
+    packets = 0;
     Ptr<QueueDiscItem> item = DequeuePacket();
     if (!item)
     {
@@ -993,7 +1380,22 @@ QueueDisc::Restart()
         return false;
     }
 
-    return Transmit(item);
+    // Bulk dequeues are only performed if the device has a single transmission
+    // queue (as Linux does for queue discs flagged with TCQ_F_ONETXQUEUE), so that
+    // all the packets of a batch are destined to the same device queue
+    if (m_maxBulkBytes == 0 || (m_devQueueIface && m_devQueueIface->GetNTxQueues() > 1))
+    {
+        packets = 1;
+        return Transmit(item);
+    }
+
+    m_batch.clear();
+    m_batch.push_back(item);
+    TryBulkDequeue(m_batch);
+    packets = m_batch.size();
+    bool ret = Transmit(m_batch);
+    m_batch.clear();
+    return ret;
 }
 
 Ptr<QueueDiscItem>
@@ -1012,8 +1414,7 @@ QueueDisc::DequeuePacket()
         if (!m_devQueueIface ||
             !m_devQueueIface->GetTxQueue(m_requeued->GetTxQueueIndex())->IsStopped())
         {
-            item = m_requeued;
-            m_requeued = nullptr;
+            item = TakeRequeued();
             if (m_peeked)
             {
                 // If the packet was requeued because a peek operation was requested
@@ -1040,8 +1441,64 @@ QueueDisc::DequeuePacket()
             {
                 item->AddHeader();
             }
-            // Here, Linux tries bulk dequeues
+            // Bulk dequeues are performed by Restart through TryBulkDequeue
+        }
+    }
+    return item;
+}
+
+void
+QueueDisc::TryBulkDequeue(std::vector<Ptr<QueueDiscItem>>& batch)
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(batch.size() == 1);
+
+    uint32_t budget = m_maxBulkBytes;
+    if (m_devQueueIface)
+    {
+        Ptr<QueueLimits> ql = m_devQueueIface->GetTxQueue(0)->GetQueueLimits();
+        if (ql)
+        {
+            budget = std::min<int64_t>(budget, std::max(ql->Available(), 0));
+        }
+    }
+
+    // As in Linux, the budget may be exceeded by the last packet of the batch
+    uint32_t bytes = batch[0]->GetSize();
+    while (bytes < budget)
+    {
+        Ptr<QueueDiscItem> item;
+        if (m_requeued)
+        {
+            // requeued packets are sent before the packets stored in the queue disc
+            NS_ASSERT(!m_peeked);
+            item = TakeRequeued();
+        }
+        else
+        {
+            item = Dequeue();
+            if (!item)
+            {
+                break;
+            }
+            item->AddHeader();
         }
+        batch.push_back(item);
+        bytes += item->GetSize();
+    }
+    NS_LOG_LOGIC("Bulk dequeued " << batch.size() << " packets, " << bytes << " bytes");
+}
+
+Ptr<QueueDiscItem>
+QueueDisc::TakeRequeued()
+{
+    NS_LOG_FUNCTION(this);
+    Ptr<QueueDiscItem> item = m_requeued;
+    m_requeued = nullptr;
+    if (!m_requeuedBatch.empty())
+    {
+        m_requeued = m_requeuedBatch.front();
+        m_requeuedBatch.pop_front();
     }
     return item;
 }
@@ -1050,8 +1507,15 @@ void
 QueueDisc::Requeue(Ptr<QueueDiscItem> item)
 {
     NS_LOG_FUNCTION(this << item);
-    m_requeued = item;
-    /// \todo netif_schedule (q);
+    if (m_requeued)
+    {
+        m_requeuedBatch.push_back(item);
+    }
+    else
+    {
+        m_requeued = item;
+    }
+    NetifSchedule();
 
     m_stats.nTotalRequeuedPackets++;
     m_stats.nTotalRequeuedBytes += item->GetSize();
@@ -1065,10 +1529,13 @@ QueueDisc::Transmit(Ptr<QueueDiscItem> item)
 {
     NS_LOG_FUNCTION(this << item);
 
+    Ptr<NetDeviceQueue> txq =
+        m_devQueueIface ? m_devQueueIface->GetTxQueue(item->GetTxQueueIndex()) : nullptr;
+
     // if the device queue is stopped, requeue the packet and return false.
     // Note that if the underlying device is tc-unaware, packets are never
     // requeued because the queues of tc-unaware devices are never stopped
-    if (m_devQueueIface && m_devQueueIface->GetTxQueue(item->GetTxQueueIndex())->IsStopped())
+    if (txq && txq->IsStopped())
     {
         Requeue(item);
         return false;
@@ -1100,9 +1567,68 @@ QueueDisc::Transmit(Ptr<QueueDiscItem> item)
 
     // if the queue disc is empty or the device queue is now stopped, return false so
     // that the Run method does not attempt to dequeue other packets and exits
-    return !(
-        GetNPackets() == 0 ||
-        (m_devQueueIface && m_devQueueIface->GetTxQueue(item->GetTxQueueIndex())->IsStopped()));
+    return !(GetNPackets() == 0 || (txq && txq->IsStopped()));
+}
+
+bool
+QueueDisc::Transmit(const std::vector<Ptr<QueueDiscItem>>& batch)
+{
+    NS_LOG_FUNCTION(this << batch.size());
+    NS_ASSERT(!batch.empty());
+
+    // all the packets of a batch are destined to the same device transmission queue
+    Ptr<NetDeviceQueue> txq =
+        m_devQueueIface ? m_devQueueIface->GetTxQueue(batch[0]->GetTxQueueIndex()) : nullptr;
+
+    // if the device queue is stopped, requeue the packets and return false
+    if (txq && txq->IsStopped())
+    {
+        for (const auto& item : batch)
+        {
+            Requeue(item);
+        }
+        return false;
+    }
+
+    // a single queue device makes no use of the priority tag
+    if (!m_devQueueIface || m_devQueueIface->GetNTxQueues() == 1)
+    {
+        SocketPriorityTag priorityTag;
+        for (const auto& item : batch)
+        {
+            item->GetPacket()->RemovePacketTag(priorityTag);
+        }
+    }
+
+    uint32_t sent = 0;
+    if (m_sendBatch)
+    {
+        // the device stops consuming packets as soon as its queue is stopped
+        sent = m_sendBatch(batch);
+    }
+    else
+    {
+        NS_ASSERT_MSG(m_send, "Send callback not set");
+        for (const auto& item : batch)
+        {
+            if (sent > 0 && txq && txq->IsStopped())
+            {
+                break;
+            }
+            m_send(item);
+            sent++;
+        }
+    }
+    NS_ASSERT(sent <= batch.size());
+
+    // unlike the packets sent one at a time, the packets of a batch that the device
+    // did not consume because its queue was stopped are requeued, in order
+    for (std::size_t i = sent; i < batch.size(); i++)
+    {
+        Requeue(batch[i]);
+    }
+
+    return !(sent < batch.size() || GetNPackets() == 0 || (txq && txq->IsStopped()));
 }
 
 } // namespace ns3
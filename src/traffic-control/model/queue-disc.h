@@ -19,6 +19,7 @@
 #ifndef QUEUE_DISC_H
 #define QUEUE_DISC_H
 
+#include "log-histogram.h"
 #include "packet-filter.h"
 
 #include "ns3/object.h"
@@ -28,6 +29,7 @@
 #include "ns3/traced-callback.h"
 #include "ns3/traced-value.h"
 
+#include <deque>
 #include <functional>
 #include <map>
 #include <string>
@@ -37,6 +39,7 @@ namespace ns3
 {
 
 class QueueDisc;
+class NetDeviceQueue;
 class NetDeviceQueueInterface;
 
 /**
@@ -186,6 +189,13 @@ class QueueDisc : public Object
     /// \brief Structure that keeps the queue disc statistics
     struct Stats
     {
+        /// Packet and byte counters for a drop or mark reason
+        struct ReasonCounters
+        {
+            uint32_t packets{0}; //!< Number of packets
+            uint64_t bytes{0};   //!< Number of bytes
+        };
+
         /// Total received packets
         uint32_t nTotalReceivedPackets;
         /// Total received bytes
@@ -206,21 +216,25 @@ class QueueDisc : public Object
         uint32_t nTotalDroppedPackets;
         /// Total packets dropped before enqueue
         uint32_t nTotalDroppedPacketsBeforeEnqueue;
-        /// Packets dropped before enqueue, for each reason
+        /// Packets dropped before enqueue, for each reason -- this value is not kept up to
+        /// date, call GetStats first
         std::map<std::string, uint32_t, std::less<>> nDroppedPacketsBeforeEnqueue;
         /// Total packets dropped after dequeue
         uint32_t nTotalDroppedPacketsAfterDequeue;
-        /// Packets dropped after dequeue, for each reason
+        /// Packets dropped after dequeue, for each reason -- this value is not kept up to
+        /// date, call GetStats first
         std::map<std::string, uint32_t, std::less<>> nDroppedPacketsAfterDequeue;
         /// Total dropped bytes
         uint64_t nTotalDroppedBytes;
         /// Total bytes dropped before enqueue
         uint64_t nTotalDroppedBytesBeforeEnqueue;
-        /// Bytes dropped before enqueue, for each reason
+        /// Bytes dropped before enqueue, for each reason -- this value is not kept up to
+        /// date, call GetStats first
         std::map<std::string, uint64_t, std::less<>> nDroppedBytesBeforeEnqueue;
         /// Total bytes dropped after dequeue
         uint64_t nTotalDroppedBytesAfterDequeue;
-        /// Bytes dropped after dequeue, for each reason
+        /// Bytes dropped after dequeue, for each reason -- this value is not kept up to
+        /// date, call GetStats first
         std::map<std::string, uint64_t, std::less<>> nDroppedBytesAfterDequeue;
         /// Total requeued packets
         uint32_t nTotalRequeuedPackets;
@@ -228,12 +242,33 @@ class QueueDisc : public Object
         uint64_t nTotalRequeuedBytes;
         /// Total marked packets
         uint32_t nTotalMarkedPackets;
-        /// Marked packets, for each reason
+        /// Marked packets, for each reason -- this value is not kept up to date, call
+        /// GetStats first
         std::map<std::string, uint32_t, std::less<>> nMarkedPackets;
         /// Total marked bytes
         uint32_t nTotalMarkedBytes;
-        /// Marked bytes, for each reason
+        /// Marked bytes, for each reason -- this value is not kept up to date, call
+        /// GetStats first
         std::map<std::string, uint64_t, std::less<>> nMarkedBytes;
+        /// Packets/bytes dropped before enqueue, indexed by reason identifier
+        std::vector<ReasonCounters> nDroppedBeforeEnqueueByReason;
+        /// Packets/bytes dropped after dequeue, indexed by reason identifier
+        std::vector<ReasonCounters> nDroppedAfterDequeueByReason;
+        /// Packets/bytes marked, indexed by reason identifier
+        std::vector<ReasonCounters> nMarkedByReason;
+        /// Packets classified into a flow queue in use by a different flow
+        uint32_t nTotalFlowHashCollisions;
+        /// Peak number of flow objects in use (i.e., associated with a flow)
+        uint32_t nPeakFlowObjects;
+        /// Sojourn times (in nanoseconds) of the dequeued packets -- only filled if the
+        /// EnableHistograms attribute is true
+        LogHistogram sojournTime;
+        /// Packets in the queue disc right after each enqueue -- only filled if the
+        /// EnableHistograms attribute is true
+        LogHistogram backlogPackets;
+        /// Bytes in the queue disc right after each enqueue -- only filled if the
+        /// EnableHistograms attribute is true
+        LogHistogram backlogBytes;
 
         /// constructor
         Stats();
@@ -343,6 +378,36 @@ class QueueDisc : public Object
      */
     const Stats& GetStats();
 
+    /**
+     * \brief Get the identifier of a drop or mark reason.
+     *
+     * Reasons are interned the first time they are seen, hence a string is always
+     * mapped to the same small identifier, which indexes the per-reason counters
+     * of the statistics.
+     *
+     * \param reason the reason
+     * \return the identifier of the reason
+     */
+    static uint32_t GetReasonId(const std::string& reason);
+
+    /**
+     * \brief Get the identifier of a drop or mark reason, if it has been interned.
+     *
+     * Unlike GetReasonId, an unknown reason is not added to the interned reasons.
+     *
+     * \param reason the reason
+     * \param id the identifier of the reason, if found
+     * \return true if the reason has been interned, false otherwise
+     */
+    static bool FindReasonId(const std::string& reason, uint32_t& id);
+
+    /**
+     * \brief Get a drop or mark reason given its identifier.
+     * \param id the identifier of the reason
+     * \return the reason, which remains valid until the end of the program
+     */
+    static const char* GetReasonName(uint32_t id);
+
     /**
      * \param ndqi the NetDeviceQueueInterface aggregated to the receiving object.
      *
@@ -378,6 +443,86 @@ class QueueDisc : public Object
      */
     SendCallback GetSendCallback() const;
 
+    /**
+     * Callback invoked to send a batch of packets to the receiving object when Run
+     * is called. The callback returns the number of packets (at the head of the
+     * batch) that have been consumed by the receiving object.
+     */
+    typedef std::function<uint32_t(const std::vector<Ptr<QueueDiscItem>>&)> SendBatchCallback;
+
+    /**
+     * \param func the callback to send a batch of packets to the receiving object.
+     *
+     * Set the callback used by the Transmit method (called eventually by the Run
+     * method) to send a batch of packets built by a bulk dequeue to the receiving
+     * object. If no such callback is set, the packets of a batch are sent one by
+     * one through the send callback.
+     */
+    void SetSendBatchCallback(SendBatchCallback func);
+
+    /**
+     * \return the callback to send a batch of packets to the receiving object.
+     *
+     * Get the callback used by the Transmit method (called eventually by the Run
+     * method) to send a batch of packets to the receiving object.
+     */
+    SendBatchCallback GetSendBatchCallback() const;
+
+    /// Callback invoked to defer a run of the queue disc (see NetifSchedule)
+    typedef std::function<void(Ptr<QueueDisc>)> NetifScheduleCallback;
+
+    /**
+     * \param func the callback to defer a run of the queue disc.
+     *
+     * Set the callback used by the Run method to defer a run of this queue disc
+     * when it exhausts its quota, or when a packet is requeued. The callback is
+     * expected to call RunScheduled later on. Setting the callback resets the
+     * scheduled state of the queue disc.
+     */
+    void SetNetifScheduleCallback(NetifScheduleCallback func);
+
+    /**
+     * Modelled after the part of the Linux function net_tx_action (net/core/dev.c)
+     * that services a scheduled queue disc: clear the scheduled state of the queue
+     * disc, so that it can be scheduled again, and run the queue disc.
+     */
+    void RunScheduled();
+
+    /**
+     * Modelled after the Linux function __netif_schedule (net/core/dev.c)
+     * Defer a run of this queue disc through the NetifSchedule callback, unless
+     * a run has been deferred already.
+     */
+    void NetifSchedule();
+
+    /**
+     * \brief Dequeue the packets to send in a run of this queue disc, without
+     *        sending them to the device
+     *
+     * This is the first half of a parallel run of the child queue discs of a
+     * multi-queue device (see MqQueueDisc). The scheduled state is cleared and,
+     * unless the queue disc is already running or the given device queue is
+     * stopped, up to a quota of packets (requeued packets first) is dequeued and
+     * staged for transmission. The dequeues, drops and marks notified to a parent
+     * queue disc that defers the notifications of its children are recorded, and
+     * delivered by TransmitStaged. Hence, this method only accesses the state of
+     * this queue disc (and of its queues, classes and filters) and can be executed
+     * concurrently on distinct queue discs.
+     *
+     * \param txq the device transmission queue the packets are destined to
+     */
+    void StageRun(const Ptr<NetDeviceQueue>& txq);
+
+    /**
+     * \brief Send the packets staged by StageRun to the device
+     *
+     * This is the second half of a parallel run, which must be executed by the
+     * simulator thread. The recorded notifications are delivered to the parent
+     * queue disc, the staged packets are sent to the device as a batch and a new
+     * run is deferred if the quota has been exhausted.
+     */
+    void TransmitStaged();
+
     /**
      * \brief Set the maximum number of dequeue operations following a packet enqueue
      * \param quota the maximum number of dequeue operations following a packet enqueue.
@@ -543,6 +688,30 @@ class QueueDisc : public Object
      */
     void DoInitialize() override;
 
+    /**
+     * \brief Perform the actions required when the queue disc is notified of
+     *        a packet enqueue
+     * \param item item that was enqueued
+     *
+     * This method is automatically called when a packet is enqueued into an
+     * internal queue or a child queue disc. Subclasses storing packets by
+     * themselves (e.g., in a FlowAqmQueue) must call this method when they
+     * store a packet.
+     */
+    void PacketEnqueued(Ptr<const QueueDiscItem> item);
+
+    /**
+     * \brief Perform the actions required when the queue disc is notified of
+     *        a packet dequeue
+     * \param item item that was dequeued
+     *
+     * This method is automatically called when a packet is dequeued from an
+     * internal queue or a child queue disc. Subclasses storing packets by
+     * themselves must call this method when they remove a packet, including
+     * the packets that are then dropped by means of DropAfterDequeue.
+     */
+    void PacketDequeued(Ptr<const QueueDiscItem> item);
+
     /**
      * \brief Perform the actions required when the queue disc is notified of
      *        a packet dropped before enqueue
@@ -572,7 +741,86 @@ class QueueDisc : public Object
      */
     bool Mark(Ptr<QueueDiscItem> item, const char* reason);
 
+    /**
+     * \brief Record that a packet was classified into a flow queue in use by a
+     *        different flow
+     *
+     * This method is meant to be called by the queue discs that hash flows into
+     * a limited number of flow queues, to help size their flow table.
+     */
+    void NotifyFlowHashCollision();
+
+    /**
+     * \brief Record the number of flow objects (i.e., flow queues) currently
+     *        associated with a flow, to keep track of the peak value
+     * \param nFlowObjects the number of flow objects in use
+     */
+    void NotifyFlowObjectsInUse(uint32_t nFlowObjects);
+
+    /**
+     * \brief Set whether the dequeues, drops and marks notified by the child
+     *        queue discs while they are staging a run (see StageRun) are recorded
+     *        by the child queue discs, rather than processed immediately
+     * \param defer whether to defer the notifications of the child queue discs
+     */
+    void DeferChildNotifications(bool defer);
+
   private:
+    /// Type of the notifications of a child queue disc
+    enum ChildNotificationType : uint8_t
+    {
+        CHILD_DEQUEUE,
+        CHILD_DROP_BEFORE_ENQUEUE,
+        CHILD_DROP_AFTER_DEQUEUE,
+        CHILD_MARK
+    };
+
+    /// A dequeue, drop or mark notified by a child queue disc while staging a run
+    struct ChildNotification
+    {
+        QueueDisc* parent;             //!< the queue disc notified
+        ChildNotificationType type;    //!< the type of notification
+        Ptr<const QueueDiscItem> item; //!< the item dequeued, dropped or marked
+        const char* reason;            //!< the reason provided by the child queue disc, if any
+    };
+
+    /**
+     * \brief Process a dequeue, drop or mark notified by a child queue disc, or
+     *        record it if the notifications of the child queue discs are deferred
+     * \param type the type of notification
+     * \param item the item dequeued, dropped or marked
+     * \param reason the reason provided by the child queue disc (null for dequeues)
+     */
+    void NotifyChild(ChildNotificationType type, Ptr<const QueueDiscItem> item, const char* reason);
+
+    /**
+     * \brief Get the identifier of a drop or mark reason.
+     *
+     * Reasons are looked up by pointer in a small cache, which avoids looking up
+     * the string in the global registry of reasons. As the caller may reuse a
+     * buffer for another reason, the string is compared with the cached reason
+     * when the pointer is found, and looked up again if they differ.
+     *
+     * \param reason the reason
+     * \return the identifier of the reason
+     */
+    uint32_t LookupReasonId(const char* reason);
+
+    /**
+     * \brief Get the reason for a packet dropped or marked by a child queue disc,
+     *        i.e., the concatenation of the given prefix and the reason provided
+     *        by the child queue disc
+     * \param cache the interned reasons, looked up by the pointer to the reason
+     *        provided by the child queue disc (and checked against the string, as
+     *        in LookupReasonId)
+     * \param prefix CHILD_QUEUE_DISC_DROP or CHILD_QUEUE_DISC_MARK
+     * \param reason the reason provided by the child queue disc
+     * \return the interned reason
+     */
+    static const char* GetChildReason(std::vector<std::pair<const char*, const char*>>& cache,
+                                      const char* prefix,
+                                      const char* reason);
+
     /**
      * This function actually enqueues a packet into the queue disc.
      * \param item item to enqueue
@@ -643,10 +891,13 @@ class QueueDisc : public Object
 
     /**
      * Modelled after the Linux function qdisc_restart (net/sched/sch_generic.c)
-     * Dequeue a packet (by calling DequeuePacket) and send it to the device (by calling Transmit).
-     * \return true if a packet is successfully sent to the device.
+     * Dequeue a packet (by calling DequeuePacket), possibly followed by a bulk of
+     * packets (by calling TryBulkDequeue), and send them to the device (by calling
+     * Transmit).
+     * \param packets the number of packets dequeued
+     * \return true if the packets are successfully sent to the device.
      */
-    bool Restart();
+    bool Restart(uint32_t& packets);
 
     /**
      * Modelled after the Linux function dequeue_skb (net/sched/sch_generic.c)
@@ -654,9 +905,26 @@ class QueueDisc : public Object
      */
     Ptr<QueueDiscItem> DequeuePacket();
 
+    /**
+     * Modelled after the Linux function try_bulk_dequeue_skb (net/sched/sch_generic.c)
+     * Append packets to the given batch, which contains the packet returned by
+     * DequeuePacket, until the byte budget of a bulk dequeue is exhausted. The
+     * budget is given by the MaxBulkBytes attribute and is further bounded by the
+     * availability of the queue limits (e.g., BQL) of the device queue, if any.
+     * \param batch the batch of packets to send to the device
+     */
+    void TryBulkDequeue(std::vector<Ptr<QueueDiscItem>>& batch);
+
+    /**
+     * Take the first requeued packet, if any.
+     * \return the first requeued packet, if any, or a null pointer, otherwise.
+     */
+    Ptr<QueueDiscItem> TakeRequeued();
+
     /**
      * Modelled after the Linux function dev_requeue_skb (net/sched/sch_generic.c)
-     * Requeues a packet whose transmission failed.
+     * Requeues a packet whose transmission failed. If other packets have been
+     * requeued already, the packet is requeued after them.
      * \param item the packet to requeue
      */
     void Requeue(Ptr<QueueDiscItem> item);
@@ -671,18 +939,14 @@ class QueueDisc : public Object
     bool Transmit(Ptr<QueueDiscItem> item);
 
     /**
-     * \brief Perform the actions required when the queue disc is notified of
-     *        a packet enqueue
-     * \param item item that was enqueued
-     */
-    void PacketEnqueued(Ptr<const QueueDiscItem> item);
-
-    /**
-     * \brief Perform the actions required when the queue disc is notified of
-     *        a packet dequeue
-     * \param item item that was dequeued
+     * Modelled after the Linux function sch_direct_xmit (net/sched/sch_generic.c)
+     * Sends a batch of packets to the device if the device queue is not stopped,
+     * and requeues the packets that the device did not consume.
+     * \param batch the packets to transmit
+     * \return true if all the packets are consumed by the device, the device queue
+     *         is not stopped and the queue disc is not empty
      */
-    void PacketDequeued(Ptr<const QueueDiscItem> item);
+    bool Transmit(const std::vector<Ptr<QueueDiscItem>>& batch);
 
     /// Default quota (as in /proc/sys/net/core/dev_weight)
     static const uint32_t DEFAULT_QUOTA = 64;
@@ -700,13 +964,43 @@ class QueueDisc : public Object
     uint32_t m_quota; //!< Maximum number of packets dequeued in a qdisc run
     Ptr<NetDeviceQueueInterface> m_devQueueIface; //!< NetDevice queue interface
     SendCallback m_send;           //!< Callback used to send a packet to the receiving object
+    SendBatchCallback m_sendBatch; //!< Callback used to send a batch to the receiving object
+    uint32_t m_maxBulkBytes;       //!< Byte budget of a bulk dequeue (0 to disable)
+    bool m_enableHistograms;       //!< Record sojourn time and backlog histograms
+    std::vector<Ptr<QueueDiscItem>> m_batch; //!< The batch built by a bulk dequeue
+    NetifScheduleCallback m_netifSchedule; //!< Callback used to defer a run
+    bool m_scheduled;              //!< A run of the queue disc has been deferred
+    bool m_staged;                 //!< A run has been staged by StageRun
+    uint32_t m_nStagedRequeued;    //!< Number of staged packets that had been requeued
+    bool m_deferChildNotifications; //!< Defer the notifications of the child queue discs
+    /// Notifications recorded while staging a run
+    std::vector<ChildNotification> m_childNotifications;
+    /// Notifications recorded by the queue disc staging a run on the current thread
+    static thread_local std::vector<ChildNotification>* m_stagingNotifications;
     bool m_running;                //!< The queue disc is performing multiple dequeue operations
     Ptr<QueueDiscItem> m_requeued; //!< The last packet that failed to be transmitted
+    /// The packets of a batch that failed to be transmitted after m_requeued
+    std::deque<Ptr<QueueDiscItem>> m_requeuedBatch;
     bool m_peeked;                 //!< A packet was dequeued because Peek was called
-    std::string m_childQueueDiscDropMsg; //!< Reason why a packet was dropped by a child queue disc
-    std::string m_childQueueDiscMarkMsg; //!< Reason why a packet was marked by a child queue disc
-    QueueDiscSizePolicy m_sizePolicy;    //!< The queue disc size policy
-    bool m_prohibitChangeMode;           //!< True if changing mode is prohibited
+    QueueDiscSizePolicy m_sizePolicy; //!< The queue disc size policy
+    bool m_prohibitChangeMode;        //!< True if changing mode is prohibited
+
+    /// A reason passed to this queue disc, with its interned name and identifier
+    struct ReasonIdEntry
+    {
+        const char* reason; //!< The reason passed to this queue disc
+        const char* name;   //!< The interned reason
+        uint32_t id;        //!< The identifier of the reason
+    };
+
+    /// Identifiers of the reasons passed to this queue disc, looked up by pointer
+    std::vector<ReasonIdEntry> m_reasonIds;
+    /// Interned reasons for the packets dropped by a child queue disc, looked up
+    /// by the pointer to the reason provided by the child queue disc
+    std::vector<std::pair<const char*, const char*>> m_childDropReasons;
+    /// Interned reasons for the packets marked by a child queue disc, looked up
+    /// by the pointer to the reason provided by the child queue disc
+    std::vector<std::pair<const char*, const char*>> m_childMarkReasons;
 
     /// Traced callback: fired when a packet is enqueued
     TracedCallback<Ptr<const QueueDiscItem>> m_traceEnqueue;
@@ -725,6 +1019,8 @@ class QueueDisc : public Object
 
     /// Type for the function objects notifying that a packet has been dropped by an internal queue
     typedef std::function<void(Ptr<const QueueDiscItem>)> InternalQueueDropFunctor;
+    /// Type for the function objects notifying that a packet has been dequeued by a child queue disc
+    typedef std::function<void(Ptr<const QueueDiscItem>)> ChildQueueDiscDequeueFunctor;
     /// Type for the function objects notifying that a packet has been dropped by a child queue disc
     typedef std::function<void(Ptr<const QueueDiscItem>, const char*)> ChildQueueDiscDropFunctor;
     /// Type for the function objects notifying that a packet has been marked by a child queue disc
@@ -734,6 +1030,8 @@ class QueueDisc : public Object
     InternalQueueDropFunctor m_internalQueueDbeFunctor;
     /// Function object called when an internal queue dropped a packet after dequeue
     InternalQueueDropFunctor m_internalQueueDadFunctor;
+    /// Function object called when a child queue disc dequeued a packet
+    ChildQueueDiscDequeueFunctor m_childQueueDiscDequeueFunctor;
     /// Function object called when a child queue disc dropped a packet before enqueue
     ChildQueueDiscDropFunctor m_childQueueDiscDbeFunctor;
     /// Function object called when a child queue disc dropped a packet after dequeue
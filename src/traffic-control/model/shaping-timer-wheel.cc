@@ -0,0 +1,427 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "shaping-timer-wheel.h"
+
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ShapingTimerWheel");
+
+NS_OBJECT_ENSURE_REGISTERED(ShapingTimerWheel);
+
+/// Index of the pseudo-slot storing the timers that are being expired
+static constexpr uint32_t EXPIRED_SLOT = ShapingTimerWheel::LEVELS * ShapingTimerWheel::SLOTS;
+
+/// Tick returned when no timer is armed
+static constexpr uint64_t NO_TICK = std::numeric_limits<uint64_t>::max();
+
+/**
+ * \brief Get the index of the most significant bit set
+ * \param x a non-null value
+ * \return the index of the most significant bit set
+ */
+static inline uint32_t
+MostSignificantBit(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(x);
+#else
+    uint32_t n = 0;
+    while (x >>= 1)
+    {
+        n++;
+    }
+    return n;
+#endif
+}
+
+/**
+ * \brief Get the index of the least significant bit set
+ * \param x a non-null value
+ * \return the index of the least significant bit set
+ */
+static inline uint32_t
+LeastSignificantBit(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    uint32_t n = 0;
+    while (!(x & 1))
+    {
+        x >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+ShapingTimerWheel::Timer::Timer()
+    : m_wheel(nullptr),
+      m_prev(nullptr),
+      m_next(nullptr),
+      m_expiry(0),
+      m_slot(0)
+{
+}
+
+ShapingTimerWheel::Timer::~Timer()
+{
+    if (m_wheel)
+    {
+        m_wheel->Cancel(*this);
+    }
+}
+
+void
+ShapingTimerWheel::Timer::SetFunction(Callback<void> callback)
+{
+    m_callback = callback;
+}
+
+bool
+ShapingTimerWheel::Timer::IsRunning() const
+{
+    return m_wheel != nullptr;
+}
+
+TypeId
+ShapingTimerWheel::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::ShapingTimerWheel")
+            .SetParent<Object>()
+            .SetGroupName("TrafficControl")
+            .AddConstructor<ShapingTimerWheel>()
+            .AddAttribute("Resolution",
+                          "The duration of a tick of the wheel. Timers expire at the first "
+                          "tick not earlier than their expiration time. By default, a tick "
+                          "lasts a simulator time step, so that timers expire exactly at "
+                          "their expiration time",
+                          TimeValue(TimeStep(1)),
+                          MakeTimeAccessor(&ShapingTimerWheel::m_resolution),
+                          MakeTimeChecker(TimeStep(1)));
+    return tid;
+}
+
+ShapingTimerWheel::ShapingTimerWheel()
+    : m_current(0),
+      m_nTimers(0),
+      m_eventTick(NO_TICK),
+      m_expiring(false)
+{
+    NS_LOG_FUNCTION(this);
+    m_slots.fill(nullptr);
+    m_occupied.fill(0);
+}
+
+ShapingTimerWheel::~ShapingTimerWheel()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+ShapingTimerWheel::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    for (auto& head : m_slots)
+    {
+        while (head)
+        {
+            Timer* timer = head;
+            Unlink(timer);
+            timer->m_wheel = nullptr;
+        }
+    }
+    m_occupied.fill(0);
+    m_nTimers = 0;
+    m_event.Cancel();
+    m_eventTick = NO_TICK;
+    Object::DoDispose();
+}
+
+Ptr<ShapingTimerWheel>
+ShapingTimerWheel::GetWheel(Ptr<Node> node)
+{
+    NS_LOG_FUNCTION(node);
+
+    if (!node)
+    {
+        return CreateObject<ShapingTimerWheel>();
+    }
+
+    Ptr<ShapingTimerWheel> wheel = node->GetObject<ShapingTimerWheel>();
+    if (!wheel)
+    {
+        wheel = CreateObject<ShapingTimerWheel>();
+        node->AggregateObject(wheel);
+    }
+    return wheel;
+}
+
+Time
+ShapingTimerWheel::GetResolution() const
+{
+    return m_resolution;
+}
+
+uint32_t
+ShapingTimerWheel::GetNTimers() const
+{
+    return m_nTimers;
+}
+
+void
+ShapingTimerWheel::Schedule(Timer& timer, Time delay)
+{
+    NS_LOG_FUNCTION(this << &timer << delay);
+    NS_ASSERT_MSG(delay.IsPositive(), "The delay of a timer cannot be negative");
+
+    if (timer.m_wheel)
+    {
+        timer.m_wheel->Cancel(timer);
+    }
+
+    int64_t res = m_resolution.GetTimeStep();
+    int64_t at = (Simulator::Now() + delay).GetTimeStep();
+    auto tick = static_cast<uint64_t>(at / res + (at % res != 0));
+
+    if (m_nTimers == 0 && !m_expiring)
+    {
+        // no timer is armed: the last processed tick is the one preceding the
+        // current time, so that timers can expire at the current time
+        int64_t now = Simulator::Now().GetTimeStep();
+        auto nowTick = static_cast<uint64_t>(now / res + (now % res != 0));
+        m_current = (nowTick > 0 ? nowTick - 1 : 0);
+    }
+
+    timer.m_expiry = std::max(tick, m_current + 1);
+    timer.m_wheel = this;
+    m_nTimers++;
+    Insert(&timer);
+
+    if (!m_expiring)
+    {
+        UpdateEvent();
+    }
+}
+
+void
+ShapingTimerWheel::Cancel(Timer& timer)
+{
+    NS_LOG_FUNCTION(this << &timer);
+
+    if (timer.m_wheel != this)
+    {
+        return;
+    }
+    Unlink(&timer);
+    timer.m_wheel = nullptr;
+    m_nTimers--;
+    // the scheduled event is left in place: if no timer expires at its tick,
+    // it only advances the wheel
+}
+
+void
+ShapingTimerWheel::Insert(Timer* timer)
+{
+    NS_ASSERT(timer->m_expiry > m_current);
+
+    uint32_t level = MostSignificantBit(timer->m_expiry ^ m_current) / SLOT_BITS;
+    uint32_t index = (timer->m_expiry >> (level * SLOT_BITS)) & (SLOTS - 1);
+    timer->m_slot = level * SLOTS + index;
+
+    // append the timer to the circular list of the slot
+    Timer*& head = m_slots[timer->m_slot];
+    if (!head)
+    {
+        timer->m_prev = timer;
+        timer->m_next = timer;
+        head = timer;
+        m_occupied[level] |= (1ULL << index);
+    }
+    else
+    {
+        timer->m_prev = head->m_prev;
+        timer->m_next = head;
+        head->m_prev->m_next = timer;
+        head->m_prev = timer;
+    }
+}
+
+void
+ShapingTimerWheel::Unlink(Timer* timer)
+{
+    Timer*& head = m_slots[timer->m_slot];
+    if (timer->m_next == timer)
+    {
+        head = nullptr;
+        if (timer->m_slot != EXPIRED_SLOT)
+        {
+            m_occupied[timer->m_slot / SLOTS] &= ~(1ULL << (timer->m_slot % SLOTS));
+        }
+    }
+    else
+    {
+        timer->m_prev->m_next = timer->m_next;
+        timer->m_next->m_prev = timer->m_prev;
+        if (head == timer)
+        {
+            head = timer->m_next;
+        }
+    }
+    timer->m_prev = nullptr;
+    timer->m_next = nullptr;
+}
+
+uint64_t
+ShapingTimerWheel::GetNextExpiry() const
+{
+    if (m_nTimers == 0)
+    {
+        return NO_TICK;
+    }
+
+    // Timers stored in a level expire later than those stored in lower levels
+    // and, within a level, slots are ordered by expiration tick
+    for (uint32_t level = 0; level < LEVELS; level++)
+    {
+        uint32_t index = (m_current >> (level * SLOT_BITS)) & (SLOTS - 1);
+        uint64_t ahead = (index == SLOTS - 1 ? 0 : m_occupied[level] & (~0ULL << (index + 1)));
+        if (!ahead)
+        {
+            continue;
+        }
+        uint32_t slot = LeastSignificantBit(ahead);
+        if (level == 0)
+        {
+            return (m_current & ~static_cast<uint64_t>(SLOTS - 1)) | slot;
+        }
+        // the timers of a slot of an upper level are not sorted
+        const Timer* head = m_slots[level * SLOTS + slot];
+        uint64_t next = head->m_expiry;
+        for (const Timer* timer = head->m_next; timer != head; timer = timer->m_next)
+        {
+            next = std::min(next, timer->m_expiry);
+        }
+        return next;
+    }
+    return NO_TICK;
+}
+
+void
+ShapingTimerWheel::UpdateEvent()
+{
+    uint64_t next = GetNextExpiry();
+
+    // if the scheduled event is earlier than the next expiry (because timers
+    // have been cancelled), keep it rather than rescheduling it
+    if (next == NO_TICK || (m_event.IsRunning() && m_eventTick <= next))
+    {
+        return;
+    }
+
+    int64_t res = m_resolution.GetTimeStep();
+    if (next > static_cast<uint64_t>(std::numeric_limits<int64_t>::max() / res))
+    {
+        NS_LOG_DEBUG("The next timer expires beyond the end of time");
+        return;
+    }
+
+    m_event.Cancel();
+    m_eventTick = next;
+    Time delay = TimeStep(next * res) - Simulator::Now();
+    m_event = Simulator::Schedule(delay, &ShapingTimerWheel::Expire, this);
+    NS_LOG_LOGIC("Next expiry at tick " << next << " in " << delay.As(Time::S));
+}
+
+void
+ShapingTimerWheel::Expire()
+{
+    NS_LOG_FUNCTION(this);
+
+    uint64_t now = m_eventTick;
+    m_eventTick = NO_TICK;
+    m_current = now;
+    m_expiring = true;
+
+    // No timer expires before the current tick, hence the only slot of each
+    // level which may need to be processed is the one including the current tick
+    for (uint32_t level = 0; level < LEVELS; level++)
+    {
+        uint32_t slot = level * SLOTS + ((now >> (level * SLOT_BITS)) & (SLOTS - 1));
+        if (!m_slots[slot])
+        {
+            continue;
+        }
+        Timer* timer = m_slots[slot];
+        Timer* last = timer->m_prev;
+        m_slots[slot] = nullptr;
+        m_occupied[level] &= ~(1ULL << (slot % SLOTS));
+
+        bool done = false;
+        while (!done)
+        {
+            done = (timer == last);
+            Timer* next = timer->m_next;
+            if (timer->m_expiry <= now)
+            {
+                timer->m_expiry = now;
+                timer->m_slot = EXPIRED_SLOT;
+                Timer*& head = m_slots[EXPIRED_SLOT];
+                if (!head)
+                {
+                    timer->m_prev = timer;
+                    timer->m_next = timer;
+                    head = timer;
+                }
+                else
+                {
+                    timer->m_prev = head->m_prev;
+                    timer->m_next = head;
+                    head->m_prev->m_next = timer;
+                    head->m_prev = timer;
+                }
+            }
+            else
+            {
+                Insert(timer);
+            }
+            timer = next;
+        }
+    }
+
+    // invoke the functions of the expired timers, which may arm or cancel any
+    // timer (including the expired ones)
+    while (Timer* timer = m_slots[EXPIRED_SLOT])
+    {
+        Unlink(timer);
+        timer->m_wheel = nullptr;
+        m_nTimers--;
+        timer->m_callback();
+    }
+
+    m_expiring = false;
+    UpdateEvent();
+}
+
+} // namespace ns3
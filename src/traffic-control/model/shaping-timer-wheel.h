@@ -0,0 +1,195 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef SHAPING_TIMER_WHEEL_H
+#define SHAPING_TIMER_WHEEL_H
+
+#include "ns3/callback.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+
+#include <array>
+#include <cstdint>
+
+namespace ns3
+{
+
+class Node;
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A hierarchical timer wheel shared by the rate limited queue discs of a node
+ *
+ * Rate limited queue discs (such as TBF) have to be woken up when enough tokens
+ * are available to send the packet at the head of the queue. Rather than
+ * scheduling (and often cancelling) a simulator event each, they arm a
+ * ShapingTimerWheel::Timer on the wheel of their node. Expiration times are
+ * rounded up to a multiple of the resolution of the wheel (the tick), and the
+ * wheel keeps a single simulator event scheduled at the earliest tick at which
+ * a timer expires. Hence, any number of timers expiring at the same tick cost a
+ * single simulator event. The resolution defaults to a simulator time step, so
+ * that timers expire at the same time as the simulator events they replace.
+ *
+ * Timers are stored in intrusive doubly linked lists, one for each slot of the
+ * wheel, so that arming and cancelling a timer take constant time and never
+ * allocate memory. The wheel has LEVELS levels of SLOTS slots each: a timer is
+ * stored in the level corresponding to the most significant group of bits in
+ * which its expiration tick differs from the current tick, and it is moved to
+ * lower levels (cascaded) as the current tick approaches its expiration.
+ */
+class ShapingTimerWheel : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * \brief A timer that can be armed on a ShapingTimerWheel
+     *
+     * The timer is owned by its user, which sets the function to invoke upon
+     * expiration. A timer is automatically cancelled when it is destroyed.
+     */
+    class Timer
+    {
+      public:
+        Timer();
+        ~Timer();
+
+        // Delete copy constructor and assignment operator to avoid misuse
+        Timer(const Timer&) = delete;
+        Timer& operator=(const Timer&) = delete;
+
+        /**
+         * \brief Set the function to invoke when the timer expires
+         * \param callback the function to invoke
+         */
+        void SetFunction(Callback<void> callback);
+
+        /**
+         * \brief Check whether the timer is armed
+         * \return true if the timer is armed and has not expired yet
+         */
+        bool IsRunning() const;
+
+      private:
+        friend class ShapingTimerWheel;
+
+        Callback<void> m_callback;  //!< the function to invoke upon expiration
+        ShapingTimerWheel* m_wheel; //!< the wheel the timer is armed on, if any
+        Timer* m_prev;              //!< the previous timer in the slot
+        Timer* m_next;              //!< the next timer in the slot
+        uint64_t m_expiry;          //!< the expiration tick
+        uint16_t m_slot;            //!< the index of the slot storing the timer
+    };
+
+    ShapingTimerWheel();
+    ~ShapingTimerWheel() override;
+
+    /**
+     * \brief Get the wheel shared by the rate limited queue discs of a node,
+     *        which is created (and aggregated to the node) upon the first call
+     * \param node the node (if null, a wheel that is not shared is returned)
+     * \return the wheel of the node
+     */
+    static Ptr<ShapingTimerWheel> GetWheel(Ptr<Node> node);
+
+    /**
+     * \brief Get the resolution (i.e., the duration of a tick) of the wheel
+     * \return the resolution of the wheel
+     */
+    Time GetResolution() const;
+
+    /**
+     * \brief Arm a timer. If the timer is already armed, it is rescheduled
+     *
+     * The timer expires at the first tick not earlier than the given delay
+     * from now and at least one tick after the last processed tick.
+     * \param timer the timer
+     * \param delay the delay after which the timer expires
+     */
+    void Schedule(Timer& timer, Time delay);
+
+    /**
+     * \brief Cancel a timer, if it is armed on this wheel
+     * \param timer the timer
+     */
+    void Cancel(Timer& timer);
+
+    /**
+     * \brief Get the number of armed timers
+     * \return the number of armed timers
+     */
+    uint32_t GetNTimers() const;
+
+    /// Number of bits of the slot index in each level
+    static constexpr uint32_t SLOT_BITS = 6;
+    /// Number of slots in each level
+    static constexpr uint32_t SLOTS = 1 << SLOT_BITS;
+    /// Number of levels, which are enough to cover any 64-bit tick
+    static constexpr uint32_t LEVELS = (64 + SLOT_BITS - 1) / SLOT_BITS;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /**
+     * \brief Store a timer in the slot corresponding to its expiration tick
+     * \param timer the timer
+     */
+    void Insert(Timer* timer);
+
+    /**
+     * \brief Remove a timer from its slot
+     * \param timer the timer
+     */
+    void Unlink(Timer* timer);
+
+    /**
+     * \brief Get the earliest tick at which an armed timer expires
+     * \return the earliest expiration tick (UINT64_MAX if no timer is armed)
+     */
+    uint64_t GetNextExpiry() const;
+
+    /**
+     * \brief Schedule the simulator event at the earliest expiration tick, if
+     *        it is not already scheduled at such a tick
+     */
+    void UpdateEvent();
+
+    /**
+     * \brief Expire the timers of the current tick and cascade the timers that
+     *        are going to expire in the next ticks
+     */
+    void Expire();
+
+    Time m_resolution;  //!< the duration of a tick
+    uint64_t m_current; //!< the last processed tick
+    uint32_t m_nTimers; //!< the number of armed timers
+    /// The first timer in each slot, followed by the first expired timer
+    std::array<Timer*, LEVELS * SLOTS + 1> m_slots;
+    std::array<uint64_t, LEVELS> m_occupied; //!< bitmap of the non-empty slots of each level
+    EventId m_event;                         //!< the event scheduled at the next expiry
+    uint64_t m_eventTick;                    //!< the tick of the scheduled event
+    bool m_expiring;                         //!< true while the expired timers are processed
+};
+
+} // namespace ns3
+
+#endif /* SHAPING_TIMER_WHEEL_H */
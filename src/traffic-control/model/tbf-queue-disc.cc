@@ -33,6 +33,7 @@
 #include "ns3/enum.h"
 #include "ns3/log.h"
 #include "ns3/net-device-queue-interface.h"
+#include "ns3/node.h"
 #include "ns3/object-factory.h"
 #include "ns3/simulator.h"
 #include "ns3/uinteger.h"
@@ -44,6 +45,44 @@ NS_LOG_COMPONENT_DEFINE("TbfQueueDisc");
 
 NS_OBJECT_ENSURE_REGISTERED(TbfQueueDisc);
 
+/**
+ * \brief Add to a bucket the tokens received in the given time interval
+ * \param tokens the tokens in the bucket, in units of 1/TbfQueueDisc::TOKEN_SCALE bytes
+ * \param size the size of the bucket in bytes
+ * \param rate the rate at which tokens enter the bucket, in bps
+ * \param delta the time interval in nanoseconds
+ * \return the tokens in the bucket at the end of the time interval
+ */
+static int64_t
+AddTokens(int64_t tokens, uint32_t size, uint64_t rate, int64_t delta)
+{
+    if (rate == 0)
+    {
+        return tokens;
+    }
+    auto r = static_cast<int64_t>(rate);
+    int64_t capacity = size * TbfQueueDisc::TOKEN_SCALE;
+    // check whether the bucket fills up before multiplying, to avoid overflows
+    if (delta > (capacity - tokens) / r)
+    {
+        return capacity;
+    }
+    return tokens + delta * r;
+}
+
+/**
+ * \brief Get the time needed for a bucket to receive the given amount of tokens
+ * \param tokens the tokens, in units of 1/TbfQueueDisc::TOKEN_SCALE bytes
+ * \param rate the rate at which tokens enter the bucket, in bps
+ * \return the time needed to receive the tokens
+ */
+static Time
+TimeToReceive(int64_t tokens, uint64_t rate)
+{
+    auto r = static_cast<int64_t>(rate);
+    return NanoSeconds((tokens + r - 1) / r);
+}
+
 TypeId
 TbfQueueDisc::GetTypeId()
 {
@@ -106,6 +145,11 @@ void
 TbfQueueDisc::DoDispose()
 {
     NS_LOG_FUNCTION(this);
+    if (m_wheel)
+    {
+        m_wheel->Cancel(m_timer);
+        m_wheel = nullptr;
+    }
     QueueDisc::DoDispose();
 }
 
@@ -210,31 +254,22 @@ TbfQueueDisc::DoDequeue()
         int64_t ptoks = 0;
         Time now = Simulator::Now();
 
-        double delta = (now - m_timeCheckPoint).GetSeconds();
-        NS_LOG_LOGIC("Time Difference delta " << delta);
+        int64_t delta = (now - m_timeCheckPoint).GetNanoSeconds();
+        NS_LOG_LOGIC("Time Difference delta " << delta << "ns");
 
         if (m_peakRate > DataRate("0bps"))
         {
-            ptoks = m_ptokens + round(delta * (m_peakRate.GetBitRate() / 8));
-            if (ptoks > m_mtu)
-            {
-                ptoks = m_mtu;
-            }
-            NS_LOG_LOGIC("Number of ptokens we can consume " << ptoks);
+            ptoks = AddTokens(m_pcredit, m_mtu, m_peakRate.GetBitRate(), delta);
+            NS_LOG_LOGIC("Number of ptokens we can consume " << ptoks / TOKEN_SCALE);
             NS_LOG_LOGIC("Required to dequeue next packet " << pktSize);
-            ptoks -= pktSize;
+            ptoks -= pktSize * TOKEN_SCALE;
         }
 
-        btoks = m_btokens + round(delta * (m_rate.GetBitRate() / 8));
-
-        if (btoks > m_burst)
-        {
-            btoks = m_burst;
-        }
+        btoks = AddTokens(m_bcredit, m_burst, m_rate.GetBitRate(), delta);
 
-        NS_LOG_LOGIC("Number of btokens we can consume " << btoks);
+        NS_LOG_LOGIC("Number of btokens we can consume " << btoks / TOKEN_SCALE);
         NS_LOG_LOGIC("Required to dequeue next packet " << pktSize);
-        btoks -= pktSize;
+        btoks -= pktSize * TOKEN_SCALE;
 
         if ((btoks | ptoks) >= 0) // else packet blocked
         {
@@ -246,8 +281,10 @@ TbfQueueDisc::DoDequeue()
             }
 
             m_timeCheckPoint = now;
-            m_btokens = btoks;
-            m_ptokens = ptoks;
+            m_bcredit = btoks;
+            m_pcredit = ptoks;
+            m_btokens = btoks / TOKEN_SCALE;
+            m_ptokens = ptoks / TOKEN_SCALE;
 
             NS_LOG_LOGIC(m_btokens << " btokens and " << m_ptokens
                                    << " ptokens after packet dequeue");
@@ -261,33 +298,33 @@ TbfQueueDisc::DoDequeue()
         // A packet gets blocked if the above if() condition is not satisfied:
         // either or both btoks and ptoks are negative.  In that case, we have
         // to schedule the waking of queue when enough tokens are available.
-        if (m_id.IsExpired())
+        if (!m_timer.IsRunning())
         {
             NS_ASSERT_MSG(m_rate.GetBitRate() > 0, "Rate must be positive");
             Time requiredDelayTime;
             if (m_peakRate.GetBitRate() == 0)
             {
                 NS_ASSERT_MSG(btoks < 0, "Logic error; btoks must be < 0 here");
-                requiredDelayTime = m_rate.CalculateBytesTxTime(-btoks);
+                requiredDelayTime = TimeToReceive(-btoks, m_rate.GetBitRate());
             }
             else
             {
                 if (btoks < 0 && ptoks >= 0)
                 {
-                    requiredDelayTime = m_rate.CalculateBytesTxTime(-btoks);
+                    requiredDelayTime = TimeToReceive(-btoks, m_rate.GetBitRate());
                 }
                 else if (btoks >= 0 && ptoks < 0)
                 {
-                    requiredDelayTime = m_peakRate.CalculateBytesTxTime(-ptoks);
+                    requiredDelayTime = TimeToReceive(-ptoks, m_peakRate.GetBitRate());
                 }
                 else
                 {
-                    requiredDelayTime = std::max(m_rate.CalculateBytesTxTime(-btoks),
-                                                 m_peakRate.CalculateBytesTxTime(-ptoks));
+                    requiredDelayTime = std::max(TimeToReceive(-btoks, m_rate.GetBitRate()),
+                                                 TimeToReceive(-ptoks, m_peakRate.GetBitRate()));
                 }
             }
             NS_ASSERT_MSG(requiredDelayTime.GetSeconds() >= 0, "Negative time");
-            m_id = Simulator::Schedule(requiredDelayTime, &QueueDisc::Run, this);
+            m_wheel->Schedule(m_timer, requiredDelayTime);
             NS_LOG_LOGIC("Waking Event Scheduled in " << requiredDelayTime.As(Time::S));
         }
     }
@@ -364,6 +401,13 @@ TbfQueueDisc::CheckConfig()
                     << "greater than the size of the second bucket (" << m_mtu << ").");
     }
 
+    if (m_burst > INT64_MAX / TOKEN_SCALE || m_mtu > INT64_MAX / TOKEN_SCALE)
+    {
+        NS_LOG_ERROR("The size of the buckets cannot exceed " << INT64_MAX / TOKEN_SCALE
+                                                               << " bytes");
+        return false;
+    }
+
     if (m_peakRate > DataRate("0bps") && m_peakRate <= m_rate)
     {
         NS_LOG_WARN("The rate for the second bucket ("
@@ -381,9 +425,18 @@ TbfQueueDisc::InitializeParams()
     // Token Buckets are full at the beginning.
     m_btokens = m_burst;
     m_ptokens = m_mtu;
+    m_bcredit = m_burst * TOKEN_SCALE;
+    m_pcredit = m_mtu * TOKEN_SCALE;
     // Initialising other variables to 0.
     m_timeCheckPoint = Seconds(0);
-    m_id = EventId();
+
+    // The queue is woken up by a timer armed on the wheel shared by the
+    // rate limited queue discs of the node (if any)
+    Ptr<NetDeviceQueueInterface> ndqi = GetNetDeviceQueueInterface();
+    Ptr<NetDevice> dev;
+    m_wheel = ShapingTimerWheel::GetWheel(
+        (ndqi && (dev = ndqi->GetObject<NetDevice>())) ? dev->GetNode() : nullptr);
+    m_timer.SetFunction(MakeCallback(&QueueDisc::Run, this));
 }
 
 } // namespace ns3
@@ -29,10 +29,10 @@
 #define TBF_QUEUE_DISC_H
 
 #include "queue-disc.h"
+#include "shaping-timer-wheel.h"
 
 #include "ns3/boolean.h"
 #include "ns3/data-rate.h"
-#include "ns3/event-id.h"
 #include "ns3/nstime.h"
 #include "ns3/random-variable-stream.h"
 #include "ns3/trace-source-accessor.h"
@@ -139,6 +139,12 @@ class TbfQueueDisc : public QueueDisc
      */
     uint32_t GetSecondBucketTokens() const;
 
+    /**
+     * Number of token units per byte. Tokens are accounted for in integer fixed
+     * point: a bucket receives exactly (rate in bps) units per nanosecond.
+     */
+    static constexpr int64_t TOKEN_SCALE = 8000000000;
+
   protected:
     /**
      * \brief Dispose of the object
@@ -158,10 +164,13 @@ class TbfQueueDisc : public QueueDisc
     DataRate m_peakRate; //!< Rate at which tokens enter the second bucket
 
     /* variables stored by TBF Queue Disc */
-    TracedValue<uint32_t> m_btokens; //!< Current number of tokens in first bucket
-    TracedValue<uint32_t> m_ptokens; //!< Current number of tokens in second bucket
-    Time m_timeCheckPoint;           //!< Time check-point
-    EventId m_id; //!< EventId of the scheduled queue waking event when enough tokens are available
+    TracedValue<uint32_t> m_btokens;  //!< Current number of tokens in first bucket
+    TracedValue<uint32_t> m_ptokens;  //!< Current number of tokens in second bucket
+    int64_t m_bcredit;                //!< Tokens in first bucket, in units of 1/TOKEN_SCALE bytes
+    int64_t m_pcredit;                //!< Tokens in second bucket, in units of 1/TOKEN_SCALE bytes
+    Time m_timeCheckPoint;            //!< Time check-point
+    Ptr<ShapingTimerWheel> m_wheel;   //!< The timer wheel shared by the shapers of the node
+    ShapingTimerWheel::Timer m_timer; //!< Timer waking the queue when enough tokens are available
 };
 
 } // namespace ns3
@@ -18,14 +18,17 @@
 
 #include "traffic-control-layer.h"
 
+#include "mq-queue-disc.h"
 #include "queue-disc.h"
 
 #include "ns3/log.h"
 #include "ns3/net-device-queue-interface.h"
 #include "ns3/object-map.h"
 #include "ns3/packet.h"
+#include "ns3/simulator.h"
 #include "ns3/socket.h"
 
+#include <algorithm>
 #include <tuple>
 
 namespace ns3
@@ -82,7 +85,19 @@ TrafficControlLayer::DoDispose()
     NS_LOG_FUNCTION(this);
     m_node = nullptr;
     m_handlers.clear();
+    m_deviceTable.clear();
+    m_deviceTableValid = false;
+    for (auto& ndi : m_netDevices)
+    {
+        for (auto& q : ndi.second.m_queueDiscsToWake)
+        {
+            q->SetNetifScheduleCallback(nullptr);
+        }
+    }
     m_netDevices.clear();
+    m_parallelChildren.clear();
+    m_txAction.Cancel();
+    m_outputQueue.clear();
     Object::DoDispose();
 }
 
@@ -119,6 +134,7 @@ TrafficControlLayer::RegisterProtocolHandler(Node::ProtocolHandler handler,
     entry.promiscuous = false;
 
     m_handlers.push_back(entry);
+    m_deviceTableValid = false;
 
     NS_LOG_DEBUG("Handler for NetDevice: " << device << " registered for protocol " << protocolType
                                            << ".");
@@ -169,8 +185,21 @@ TrafficControlLayer::ScanDevices()
         if (ndi != m_netDevices.end() && ndi->second.m_rootQueueDisc)
         {
             NS_LOG_DEBUG("Setting the wake callbacks on NetDevice queues");
+            for (auto& q : ndi->second.m_queueDiscsToWake)
+            {
+                m_parallelChildren.erase(q);
+            }
             ndi->second.m_queueDiscsToWake.clear();
 
+            // the runs of the child queue discs of a mq queue disc running them in
+            // parallel are always deferred, so that they can be run together
+            Ptr<MqQueueDisc> mq = DynamicCast<MqQueueDisc>(ndi->second.m_rootQueueDisc);
+            if (mq && !mq->IsParallelRunEnabled())
+            {
+                mq = nullptr;
+            }
+            ndi->second.m_deferRuns = (mq != nullptr);
+
             if (ndqi)
             {
                 for (std::size_t i = 0; i < ndqi->GetNTxQueues(); i++)
@@ -195,7 +224,16 @@ TrafficControlLayer::ScanDevices()
                         NS_ABORT_MSG("Invalid wake mode");
                     }
 
-                    ndqi->GetTxQueue(i)->SetWakeCallback(MakeCallback(&QueueDisc::Run, qd));
+                    if (mq && qd != mq)
+                    {
+                        ndqi->GetTxQueue(i)->SetWakeCallback(
+                            MakeCallback(&QueueDisc::NetifSchedule, qd));
+                        m_parallelChildren[qd] = {mq, i};
+                    }
+                    else
+                    {
+                        ndqi->GetTxQueue(i)->SetWakeCallback(MakeCallback(&QueueDisc::Run, qd));
+                    }
                     ndi->second.m_queueDiscsToWake.push_back(qd);
                 }
             }
@@ -204,7 +242,7 @@ TrafficControlLayer::ScanDevices()
                 ndi->second.m_queueDiscsToWake.push_back(ndi->second.m_rootQueueDisc);
             }
 
-            // set the NetDeviceQueueInterface object and the SendCallback on the queue discs
+            // set the NetDeviceQueueInterface object and the SendCallbacks on the queue discs
             // into which packets are enqueued and dequeued by calling Run
             for (auto& q : ndi->second.m_queueDiscsToWake)
             {
@@ -212,9 +250,16 @@ TrafficControlLayer::ScanDevices()
                 q->SetSendCallback([dev](Ptr<QueueDiscItem> item) {
                     dev->Send(item->GetPacket(), item->GetAddress(), item->GetProtocol());
                 });
+                q->SetSendBatchCallback([dev](const std::vector<Ptr<QueueDiscItem>>& items) {
+                    return dev->SendBatch(items);
+                });
+                q->SetNetifScheduleCallback(
+                    [this](Ptr<QueueDisc> qd) { ScheduleQueueDisc(qd); });
             }
         }
     }
+
+    m_deviceTableValid = false;
 }
 
 void
@@ -228,6 +273,7 @@ TrafficControlLayer::SetRootQueueDiscOnDevice(Ptr<NetDevice> device, Ptr<QueueDi
     {
         // No entry found for this device. Create one.
         m_netDevices[device] = {qDisc, nullptr, QueueDiscVector()};
+        m_deviceTableValid = false;
     }
     else
     {
@@ -260,6 +306,140 @@ TrafficControlLayer::GetRootQueueDiscOnDeviceByIndex(uint32_t index) const
     return GetRootQueueDiscOnDevice(m_node->GetDevice(index));
 }
 
+void
+TrafficControlLayer::BuildDeviceTable()
+{
+    NS_LOG_FUNCTION(this);
+
+    m_deviceTable.clear();
+    m_deviceTable.resize(m_node->GetNDevices());
+
+    for (uint32_t i = 0; i < m_node->GetNDevices(); i++)
+    {
+        // if a device has been added to the node more than once, its ifIndex is
+        // the one of its last addition, which is the entry found by LookupDevice
+        Ptr<NetDevice> dev = m_node->GetDevice(i);
+        DeviceTableEntry& entry = m_deviceTable[i];
+        entry.device = dev;
+
+        auto ndi = m_netDevices.find(dev);
+        entry.info = (ndi != m_netDevices.end() ? &ndi->second : nullptr);
+
+        // the protocols for which a handler is registered on this device or on
+        // all the devices have a dedicated list of handlers
+        for (const auto& h : m_handlers)
+        {
+            if (h.protocol != 0 && (!h.device || h.device == dev) &&
+                std::find_if(entry.dispatch.begin(),
+                             entry.dispatch.end(),
+                             [&h](const ProtocolDispatch& pd) {
+                                 return pd.protocol == h.protocol;
+                             }) == entry.dispatch.end())
+            {
+                entry.dispatch.push_back({h.protocol, HandlerVector()});
+            }
+        }
+
+        // handlers are invoked in the order they have been registered
+        for (const auto& h : m_handlers)
+        {
+            if (h.device && h.device != dev)
+            {
+                continue;
+            }
+            for (auto& pd : entry.dispatch)
+            {
+                if (h.protocol == 0 || h.protocol == pd.protocol)
+                {
+                    pd.handlers.push_back(h.handler);
+                }
+            }
+            if (h.protocol == 0)
+            {
+                entry.anyProtocol.push_back(h.handler);
+            }
+        }
+    }
+
+    m_deviceTableValid = true;
+}
+
+const TrafficControlLayer::DeviceTableEntry*
+TrafficControlLayer::LookupDevice(const Ptr<NetDevice>& device)
+{
+    if (!m_node)
+    {
+        return nullptr;
+    }
+
+    if (!m_deviceTableValid || m_deviceTable.size() != m_node->GetNDevices())
+    {
+        BuildDeviceTable();
+    }
+
+    uint32_t ifIndex = device->GetIfIndex();
+    if (ifIndex < m_deviceTable.size() && m_deviceTable[ifIndex].device == device)
+    {
+        return &m_deviceTable[ifIndex];
+    }
+    // the device does not belong to the node
+    return nullptr;
+}
+
+void
+TrafficControlLayer::ScheduleQueueDisc(Ptr<QueueDisc> qDisc)
+{
+    NS_LOG_FUNCTION(this << qDisc);
+
+    m_outputQueue.push_back(qDisc);
+
+    // A single transmit action serves all the queue discs of this node. As the
+    // softirq of Linux, the transmit action runs after the current event
+    if (!m_txAction.IsRunning())
+    {
+        m_txAction = Simulator::ScheduleNow(&TrafficControlLayer::TxAction, this);
+    }
+}
+
+void
+TrafficControlLayer::TxAction()
+{
+    NS_LOG_FUNCTION(this);
+
+    // Queue discs that exhaust their quota again are appended to m_outputQueue
+    // and served by the next transmit action
+    std::deque<Ptr<QueueDisc>> outputQueue;
+    outputQueue.swap(m_outputQueue);
+
+    // The child queue discs to run in parallel are gathered by parent and run
+    // together, in the order of the transmission queues
+    std::vector<Ptr<MqQueueDisc>> parallelRoots;
+    std::map<Ptr<MqQueueDisc>, std::vector<std::size_t>> parallelTxqs;
+
+    for (auto& q : outputQueue)
+    {
+        auto it = m_parallelChildren.find(q);
+        if (it == m_parallelChildren.end())
+        {
+            q->RunScheduled();
+            continue;
+        }
+        auto& txqs = parallelTxqs[it->second.first];
+        if (txqs.empty())
+        {
+            parallelRoots.push_back(it->second.first);
+        }
+        txqs.push_back(it->second.second);
+    }
+
+    for (auto& mq : parallelRoots)
+    {
+        auto& txqs = parallelTxqs[mq];
+        std::sort(txqs.begin(), txqs.end());
+        mq->RunChildren(txqs);
+    }
+}
+
 void
 TrafficControlLayer::DeleteRootQueueDiscOnDevice(Ptr<NetDevice> device)
 {
@@ -276,8 +456,14 @@ TrafficControlLayer::DeleteRootQueueDiscOnDevice(Ptr<NetDevice> device)
     {
         q->SetNetDeviceQueueInterface(nullptr);
         q->SetSendCallback(nullptr);
+        q->SetSendBatchCallback(nullptr);
+        q->SetNetifScheduleCallback(nullptr);
+        m_parallelChildren.erase(q);
+        m_outputQueue.erase(std::remove(m_outputQueue.begin(), m_outputQueue.end(), q),
+                            m_outputQueue.end());
     }
     ndi->second.m_queueDiscsToWake.clear();
+    ndi->second.m_deferRuns = false;
 
     Ptr<NetDeviceQueueInterface> ndqi = ndi->second.m_ndqi;
     if (ndqi)
@@ -292,6 +478,7 @@ TrafficControlLayer::DeleteRootQueueDiscOnDevice(Ptr<NetDevice> device)
     {
         // remove the empty entry
         m_netDevices.erase(ndi);
+        m_deviceTableValid = false;
     }
 }
 
@@ -337,17 +524,41 @@ TrafficControlLayer::Receive(Ptr<NetDevice> device,
 
     bool found = false;
 
-    for (auto i = m_handlers.begin(); i != m_handlers.end(); i++)
+    if (const DeviceTableEntry* entry = LookupDevice(device))
+    {
+        const HandlerVector* handlers = &entry->anyProtocol;
+        for (const auto& pd : entry->dispatch)
+        {
+            if (pd.protocol == protocol)
+            {
+                handlers = &pd.handlers;
+                break;
+            }
+        }
+
+        for (const auto& handler : *handlers)
+        {
+            NS_LOG_DEBUG("Found handler for packet " << p << ", protocol " << protocol
+                                                     << " and NetDevice " << device
+                                                     << ". Send packet up");
+            handler(device, p, protocol, from, to, packetType);
+            found = true;
+        }
+    }
+    else
     {
-        if (!i->device || (i->device == device))
+        for (auto i = m_handlers.begin(); i != m_handlers.end(); i++)
         {
-            if (i->protocol == 0 || i->protocol == protocol)
+            if (!i->device || (i->device == device))
             {
-                NS_LOG_DEBUG("Found handler for packet " << p << ", protocol " << protocol
-                                                         << " and NetDevice " << device
-                                                         << ". Send packet up");
-                i->handler(device, p, protocol, from, to, packetType);
-                found = true;
+                if (i->protocol == 0 || i->protocol == protocol)
+                {
+                    NS_LOG_DEBUG("Found handler for packet " << p << ", protocol " << protocol
+                                                             << " and NetDevice " << device
+                                                             << ". Send packet up");
+                    i->handler(device, p, protocol, from, to, packetType);
+                    found = true;
+                }
             }
         }
     }
@@ -364,12 +575,27 @@ TrafficControlLayer::Send(Ptr<NetDevice> device, Ptr<QueueDiscItem> item)
 
     NS_LOG_DEBUG("Send packet to device " << device << " protocol number " << item->GetProtocol());
 
+    NetDeviceInfo* ndi = nullptr;
+
+    if (const DeviceTableEntry* entry = LookupDevice(device))
+    {
+        ndi = entry->info;
+    }
+    else
+    {
+        // the device does not belong to the node
+        auto it = m_netDevices.find(device);
+        if (it != m_netDevices.end())
+        {
+            ndi = &it->second;
+        }
+    }
+
     Ptr<NetDeviceQueueInterface> devQueueIface;
-    auto ndi = m_netDevices.find(device);
 
-    if (ndi != m_netDevices.end())
+    if (ndi)
     {
-        devQueueIface = ndi->second.m_ndqi;
+        devQueueIface = ndi->m_ndqi;
     }
 
     // determine the transmission queue of the device where the packet will be enqueued
@@ -387,7 +613,7 @@ TrafficControlLayer::Send(Ptr<NetDevice> device, Ptr<QueueDiscItem> item)
 
     NS_ASSERT(!devQueueIface || txq < devQueueIface->GetNTxQueues());
 
-    if (ndi == m_netDevices.end() || !ndi->second.m_rootQueueDisc)
+    if (!ndi || !ndi->m_rootQueueDisc)
     {
         // The device has no attached queue disc, thus add the header to the packet and
         // send it directly to the device if the selected queue is not stopped
@@ -413,10 +639,17 @@ TrafficControlLayer::Send(Ptr<NetDevice> device, Ptr<QueueDiscItem> item)
         // selected for the packet and try to dequeue packets from such queue disc
         item->SetTxQueueIndex(txq);
 
-        Ptr<QueueDisc> qDisc = ndi->second.m_queueDiscsToWake[txq];
+        Ptr<QueueDisc> qDisc = ndi->m_queueDiscsToWake[txq];
         NS_ASSERT(qDisc);
         qDisc->Enqueue(item);
-        qDisc->Run();
+        if (!ndi->m_deferRuns)
+        {
+            qDisc->Run();
+        }
+        else
+        {
+            qDisc->NetifSchedule();
+        }
     }
 }
 
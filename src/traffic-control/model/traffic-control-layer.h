@@ -19,12 +19,14 @@
 #define TRAFFICCONTROLLAYER_H
 
 #include "ns3/address.h"
+#include "ns3/event-id.h"
 #include "ns3/net-device.h"
 #include "ns3/node.h"
 #include "ns3/object.h"
 #include "ns3/queue-item.h"
 #include "ns3/traced-callback.h"
 
+#include <deque>
 #include <map>
 #include <vector>
 
@@ -33,6 +35,7 @@ namespace ns3
 
 class Packet;
 class QueueDisc;
+class MqQueueDisc;
 class NetDeviceQueueInterface;
 
 /**
@@ -87,7 +90,11 @@ class NetDeviceQueueInterface;
  *
  * Discrimination through callbacks (in other words: what is the right upper-layer
  * callback for this packet?) is done through checks over the device and the
- * protocol number.
+ * protocol number. Such checks are performed once and for all, when the handlers are
+ * registered or the devices change, to build a table indexed by the device ifIndex
+ * that stores, for each device, the handlers to invoke for each protocol and the
+ * information needed to send packets. Hence, sending or receiving a packet does
+ * not require to search the device among all the devices of the node.
  */
 class TrafficControlLayer : public Object
 {
@@ -231,6 +238,30 @@ class TrafficControlLayer : public Object
         Ptr<QueueDisc> m_rootQueueDisc;      //!< the root queue disc on the device
         Ptr<NetDeviceQueueInterface> m_ndqi; //!< the netdevice queue interface
         QueueDiscVector m_queueDiscsToWake;  //!< the vector of queue discs to wake
+        bool m_deferRuns{false}; //!< whether the runs of the queue discs are deferred
+    };
+
+    /// Typedef for a list of protocol handlers invoked in order
+    typedef std::vector<Node::ProtocolHandler> HandlerVector;
+
+    /**
+     * \brief The handlers to invoke for the packets of a given protocol
+     */
+    struct ProtocolDispatch
+    {
+        uint16_t protocol;      //!< the protocol number
+        HandlerVector handlers; //!< the handlers, in order of registration
+    };
+
+    /**
+     * \brief Entry of the device table, which is indexed by the device ifIndex
+     */
+    struct DeviceTableEntry
+    {
+        Ptr<NetDevice> device;                  //!< the NetDevice
+        NetDeviceInfo* info;                    //!< the entry of m_netDevices, if any
+        std::vector<ProtocolDispatch> dispatch; //!< the handlers of the registered protocols
+        HandlerVector anyProtocol;              //!< the handlers of the other protocols
     };
 
     /// Typedef for protocol handlers container
@@ -248,11 +279,60 @@ class TrafficControlLayer : public Object
      */
     Ptr<QueueDisc> GetRootQueueDiscOnDeviceByIndex(uint32_t index) const;
 
+    /**
+     * \brief Build the device table, which maps the ifIndex of every device of the
+     *        node to its entry of m_netDevices and to the handlers to invoke for
+     *        each protocol
+     */
+    void BuildDeviceTable();
+
+    /**
+     * \brief Get the entry of the device table for the given device
+     *
+     * The device table is rebuilt if it is not valid or the number of devices
+     * of the node has changed.
+     *
+     * \param device the device
+     * \return the entry of the device table, or a null pointer if the device
+     *         is not a device of the node
+     */
+    const DeviceTableEntry* LookupDevice(const Ptr<NetDevice>& device);
+
+    /**
+     * \brief Add a queue disc to the list of queue discs to run in the next
+     *        transmit action, which is scheduled if needed
+     *
+     * Modelled after the Linux function __netif_reschedule (net/core/dev.c).
+     * This is the callback invoked by the queue discs to defer a run.
+     *
+     * \param qDisc the queue disc to run
+     */
+    void ScheduleQueueDisc(Ptr<QueueDisc> qDisc);
+
+    /**
+     * \brief Run, in turn, the queue discs in the list of queue discs to run
+     *
+     * Modelled after the Linux function net_tx_action (net/core/dev.c).
+     * Every queue disc is run once (i.e., it dequeues at most a quota of packets),
+     * and the queue discs that exhaust their quota again are appended to the list
+     * and served by another transmit action, so that the devices of this node are
+     * served in a round robin fashion. The child queue discs of a mq queue disc
+     * that runs them in parallel are run together by their parent.
+     */
+    void TxAction();
+
     /// The node this TrafficControlLayer object is aggregated to
     Ptr<Node> m_node;
     /// Map storing the required information for each device with a queue disc installed
     std::map<Ptr<NetDevice>, NetDeviceInfo> m_netDevices;
     ProtocolHandlerList m_handlers; //!< List of upper-layer handlers
+    std::vector<DeviceTableEntry> m_deviceTable; //!< Device table, indexed by ifIndex
+    bool m_deviceTableValid{false};              //!< Whether the device table is up to date
+    /// The child queue discs run in parallel by their mq parent, along with the
+    /// mq parent and the index of the associated transmission queue
+    std::map<Ptr<QueueDisc>, std::pair<Ptr<MqQueueDisc>, std::size_t>> m_parallelChildren;
+    std::deque<Ptr<QueueDisc>> m_outputQueue; //!< Queue discs to run in the next transmit action
+    EventId m_txAction;                       //!< The next transmit action
 
     /**
      * The trace source fired when the Traffic Control layer drops a packet because
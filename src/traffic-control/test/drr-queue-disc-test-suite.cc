@@ -24,8 +24,10 @@
  *          Bishakh Dutta <telbdzone@gmail.com>
  */
 
+#include "ns3/boolean.h"
 #include "ns3/drr-queue-disc.h"
 #include "ns3/enum.h"
+#include "ns3/hash.h"
 #include "ns3/ipv4-address.h"
 #include "ns3/ipv4-header.h"
 #include "ns3/ipv4-packet-filter.h"
@@ -34,8 +36,10 @@
 #include "ns3/ipv6-packet-filter.h"
 #include "ns3/ipv6-queue-disc-item.h"
 #include "ns3/log.h"
+#include "ns3/net-device-queue-interface.h"
 #include "ns3/object-factory.h"
 #include "ns3/pointer.h"
+#include "ns3/simple-net-device.h"
 #include "ns3/simulator.h"
 #include "ns3/socket.h"
 #include "ns3/tcp-header.h"
@@ -43,6 +47,8 @@
 #include "ns3/udp-header.h"
 #include "ns3/uinteger.h"
 
+#include <set>
+
 using namespace ns3;
 
 /**
@@ -510,6 +516,906 @@ DRRQueueDiscDeficitVariableSizeDifferentFlow::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Test 3: Active flows emptied by the overlimit drop are removed from the active list
+ */
+class DRRQueueDiscOverlimitEmptiesFlow : public TestCase
+{
+  public:
+    DRRQueueDiscOverlimitEmptiesFlow();
+    ~DRRQueueDiscOverlimitEmptiesFlow() override;
+
+  private:
+    void DoRun() override;
+    /**
+     * Adds packets into the queue
+     * \param queue
+     * \param hdr
+     * \param size
+     */
+    void AddPacket(Ptr<DRRQueueDisc> queue, Ipv4Header hdr, uint32_t size);
+};
+
+DRRQueueDiscOverlimitEmptiesFlow::DRRQueueDiscOverlimitEmptiesFlow()
+    : TestCase("Test flows emptied by overlimit drops")
+{
+}
+
+DRRQueueDiscOverlimitEmptiesFlow::~DRRQueueDiscOverlimitEmptiesFlow()
+{
+}
+
+void
+DRRQueueDiscOverlimitEmptiesFlow::AddPacket(Ptr<DRRQueueDisc> queue,
+                                            Ipv4Header hdr,
+                                            uint32_t size)
+{
+    Ptr<Packet> p = Create<Packet>(size);
+    Address dest;
+    Ptr<Ipv4QueueDiscItem> item = Create<Ipv4QueueDiscItem>(p, dest, 0, hdr);
+    queue->Enqueue(item);
+}
+
+void
+DRRQueueDiscOverlimitEmptiesFlow::DoRun()
+{
+    Ptr<DRRQueueDisc> queueDisc =
+        CreateObjectWithAttributes<DRRQueueDisc>("ByteLimit", UintegerValue(1000));
+    Ptr<DRRIpv4PacketFilter> ipv4Filter = CreateObject<DRRIpv4PacketFilter>();
+    queueDisc->AddPacketFilter(ipv4Filter);
+
+    queueDisc->SetQuantum(600);
+    queueDisc->Initialize();
+
+    Ipv4Header hdr;
+    hdr.SetPayloadSize(500);
+    hdr.SetSource(Ipv4Address("10.10.1.1"));
+    hdr.SetDestination(Ipv4Address("10.10.1.2"));
+    hdr.SetProtocol(7);
+    AddPacket(queueDisc, hdr, 500);
+
+    // the packet of the second flow exceeds the byte limit and is dropped, which
+    // leaves the second flow empty while it is in the list of active flows
+    hdr.SetDestination(Ipv4Address("10.10.1.3"));
+    hdr.SetPayloadSize(600);
+    AddPacket(queueDisc, hdr, 600);
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
+                          1,
+                          "unexpected number of packets in the queue disc");
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetStats().GetNDroppedPackets(DRRQueueDisc::OVERLIMIT_DROP),
+                          1,
+                          "one packet should have been dropped because of the byte limit");
+
+    Ptr<DRRFlow> flow2 = StaticCast<DRRFlow>(queueDisc->GetQueueDiscClass(1));
+    NS_TEST_ASSERT_MSG_EQ(flow2->GetStatus(),
+                          DRRFlow::ACTIVE,
+                          "the second flow is still in the list of active queues");
+
+    Ptr<QueueDiscItem> item = queueDisc->Dequeue();
+    NS_TEST_ASSERT_MSG_EQ((item != nullptr), true, "a packet of the first flow is expected");
+    item = queueDisc->Dequeue();
+    NS_TEST_ASSERT_MSG_EQ((!item), true, "no packet is expected from the emptied flow");
+    NS_TEST_ASSERT_MSG_EQ(flow2->GetStatus(),
+                          DRRFlow::INACTIVE,
+                          "the emptied flow must be in the list of inactive queues");
+
+    // the emptied flow can be activated again
+    AddPacket(queueDisc, hdr, 300);
+    NS_TEST_ASSERT_MSG_EQ(flow2->GetStatus(),
+                          DRRFlow::ACTIVE,
+                          "the second flow must be in the list of active queues");
+    item = queueDisc->Dequeue();
+    NS_TEST_ASSERT_MSG_EQ(item->GetSize(), 320, "unexpected size of the dequeued packet");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Test 4: Overlimit drops from the fat flow, one packet or a batch of packets at a time
+ */
+class DRRQueueDiscFatFlowBatchDrop : public TestCase
+{
+  public:
+    DRRQueueDiscFatFlowBatchDrop();
+    ~DRRQueueDiscFatFlowBatchDrop() override;
+
+  private:
+    void DoRun() override;
+    /**
+     * Adds packets into the queue
+     * \param queue
+     * \param hdr
+     * \param size
+     */
+    void AddPacket(Ptr<DRRQueueDisc> queue, Ipv4Header hdr, uint32_t size);
+    /**
+     * Fill a flow with four packets and exceed the byte limit with a packet of another flow
+     * \param dropBatchSize the value of the DropBatchSize attribute
+     * \return the queue disc
+     */
+    Ptr<DRRQueueDisc> RunScenario(uint32_t dropBatchSize);
+};
+
+DRRQueueDiscFatFlowBatchDrop::DRRQueueDiscFatFlowBatchDrop()
+    : TestCase("Test overlimit drops from the fat flow")
+{
+}
+
+DRRQueueDiscFatFlowBatchDrop::~DRRQueueDiscFatFlowBatchDrop()
+{
+}
+
+void
+DRRQueueDiscFatFlowBatchDrop::AddPacket(Ptr<DRRQueueDisc> queue, Ipv4Header hdr, uint32_t size)
+{
+    Ptr<Packet> p = Create<Packet>(size);
+    Address dest;
+    Ptr<Ipv4QueueDiscItem> item = Create<Ipv4QueueDiscItem>(p, dest, 0, hdr);
+    queue->Enqueue(item);
+}
+
+Ptr<DRRQueueDisc>
+DRRQueueDiscFatFlowBatchDrop::RunScenario(uint32_t dropBatchSize)
+{
+    Ptr<DRRQueueDisc> queueDisc =
+        CreateObjectWithAttributes<DRRQueueDisc>("ByteLimit",
+                                                 UintegerValue(2500),
+                                                 "DropBatchSize",
+                                                 UintegerValue(dropBatchSize));
+    Ptr<DRRIpv4PacketFilter> ipv4Filter = CreateObject<DRRIpv4PacketFilter>();
+    queueDisc->AddPacketFilter(ipv4Filter);
+
+    queueDisc->SetQuantum(600);
+    queueDisc->Initialize();
+
+    Ipv4Header hdr;
+    hdr.SetPayloadSize(500);
+    hdr.SetSource(Ipv4Address("10.10.1.1"));
+    hdr.SetDestination(Ipv4Address("10.10.1.2"));
+    hdr.SetProtocol(7);
+
+    // a small flow, then a fat flow
+    AddPacket(queueDisc, hdr, 500);
+    hdr.SetDestination(Ipv4Address("10.10.1.3"));
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        AddPacket(queueDisc, hdr, 500);
+    }
+    // the fat flow stores 1560 bytes, the queue disc 2080 bytes
+    hdr.SetDestination(Ipv4Address("10.10.1.7"));
+    AddPacket(queueDisc, hdr, 500);
+    return queueDisc;
+}
+
+void
+DRRQueueDiscFatFlowBatchDrop::DoRun()
+{
+    // one packet is dropped from the fat flow
+    Ptr<DRRQueueDisc> queueDisc = RunScenario(1);
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetStats().GetNDroppedPackets(DRRQueueDisc::OVERLIMIT_DROP),
+                          1,
+                          "one packet should have been dropped because of the byte limit");
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+                          2,
+                          "the packet should have been dropped from the fat flow");
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(2)->GetQueueDisc()->GetNPackets(),
+                          1,
+                          "the packet of the last flow should have been enqueued");
+
+    // packets are dropped from the fat flow until half of its backlog is dropped
+    queueDisc = RunScenario(64);
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetStats().GetNDroppedPackets(DRRQueueDisc::OVERLIMIT_DROP),
+                          2,
+                          "half of the backlog of the fat flow should have been dropped");
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+                          1,
+                          "the packets should have been dropped from the fat flow");
+
+    // the first two flows become empty; the first one becomes the fat flow again
+    queueDisc->Dequeue();
+    queueDisc->Dequeue();
+    Ipv4Header hdr;
+    hdr.SetPayloadSize(900);
+    hdr.SetSource(Ipv4Address("10.10.1.1"));
+    hdr.SetDestination(Ipv4Address("10.10.1.2"));
+    hdr.SetProtocol(7);
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        AddPacket(queueDisc, hdr, 900);
+    }
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetStats().GetNDroppedPackets(DRRQueueDisc::OVERLIMIT_DROP),
+                          4,
+                          "two more packets should have been dropped");
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+                          1,
+                          "the packets should have been dropped from the new fat flow");
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(2)->GetQueueDisc()->GetNPackets(),
+                          1,
+                          "no packet should have been dropped from the last flow");
+
+    // the head packet of the fat flow is held by its child queue disc, because
+    // it was peeked when the flow did not have enough deficit to send it
+    queueDisc = CreateObjectWithAttributes<DRRQueueDisc>("ByteLimit", UintegerValue(2500));
+    queueDisc->AddPacketFilter(CreateObject<DRRIpv4PacketFilter>());
+    queueDisc->SetQuantum(100);
+    queueDisc->Initialize();
+    hdr.SetPayloadSize(500);
+    AddPacket(queueDisc, hdr, 500);
+    hdr.SetDestination(Ipv4Address("10.10.1.3"));
+    AddPacket(queueDisc, hdr, 500);
+    Ptr<QueueDiscItem> item = queueDisc->Dequeue();
+    NS_TEST_ASSERT_MSG_EQ(item->GetSize(), 520, "a packet of the first flow is expected");
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        AddPacket(queueDisc, hdr, 500);
+    }
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetStats().GetNDroppedPackets(DRRQueueDisc::OVERLIMIT_DROP),
+                          1,
+                          "one packet should have been dropped because of the byte limit");
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNBytes(),
+                          2080,
+                          "the dropped packet should not be counted in the queue disc");
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNBytes(),
+                          2080,
+                          "the dropped packet should not be counted in the child queue disc");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Test 5: Packets much larger than the quantum
+ */
+class DRRQueueDiscSmallQuantum : public TestCase
+{
+  public:
+    DRRQueueDiscSmallQuantum();
+    ~DRRQueueDiscSmallQuantum() override;
+
+  private:
+    void DoRun() override;
+    /**
+     * Adds packets into the queue
+     * \param queue
+     * \param hdr
+     * \param size
+     */
+    void AddPacket(Ptr<DRRQueueDisc> queue, Ipv4Header hdr, uint32_t size);
+};
+
+DRRQueueDiscSmallQuantum::DRRQueueDiscSmallQuantum()
+    : TestCase("Test packets much larger than the quantum")
+{
+}
+
+DRRQueueDiscSmallQuantum::~DRRQueueDiscSmallQuantum()
+{
+}
+
+void
+DRRQueueDiscSmallQuantum::AddPacket(Ptr<DRRQueueDisc> queue, Ipv4Header hdr, uint32_t size)
+{
+    Ptr<Packet> p = Create<Packet>(size);
+    Address dest;
+    Ptr<Ipv4QueueDiscItem> item = Create<Ipv4QueueDiscItem>(p, dest, 0, hdr);
+    queue->Enqueue(item);
+}
+
+void
+DRRQueueDiscSmallQuantum::DoRun()
+{
+    Ptr<DRRQueueDisc> queueDisc = CreateObjectWithAttributes<DRRQueueDisc>();
+    Ptr<DRRIpv4PacketFilter> ipv4Filter = CreateObject<DRRIpv4PacketFilter>();
+    queueDisc->AddPacketFilter(ipv4Filter);
+
+    queueDisc->SetQuantum(100);
+    queueDisc->Initialize();
+
+    Ipv4Header hdr;
+    hdr.SetPayloadSize(1000);
+    hdr.SetSource(Ipv4Address("10.10.1.1"));
+    hdr.SetDestination(Ipv4Address("10.10.1.2"));
+    hdr.SetProtocol(7);
+    AddPacket(queueDisc, hdr, 1000);
+
+    hdr.SetDestination(Ipv4Address("10.10.1.3"));
+    hdr.SetPayloadSize(500);
+    AddPacket(queueDisc, hdr, 500);
+
+    Ptr<DRRFlow> flow1 = StaticCast<DRRFlow>(queueDisc->GetQueueDiscClass(0));
+    Ptr<DRRFlow> flow2 = StaticCast<DRRFlow>(queueDisc->GetQueueDiscClass(1));
+
+    // the second flow needs 6 visits to send its 520 bytes packet, hence the
+    // first flow is visited 6 times as well
+    Ptr<QueueDiscItem> item = queueDisc->Dequeue();
+    NS_TEST_ASSERT_MSG_EQ(item->GetSize(), 520, "the packet of the second flow is expected");
+    NS_TEST_ASSERT_MSG_EQ(flow1->GetDeficit(), 600, "unexpected deficit for the first flow");
+    NS_TEST_ASSERT_MSG_EQ(flow2->GetStatus(),
+                          DRRFlow::INACTIVE,
+                          "the second flow must be in the list of inactive queues");
+
+    // a new small packet of the second flow is sent after two visits, while the
+    // first flow needs three more visits to send its 1020 bytes packet
+    hdr.SetPayloadSize(100);
+    AddPacket(queueDisc, hdr, 100);
+    item = queueDisc->Dequeue();
+    NS_TEST_ASSERT_MSG_EQ(item->GetSize(), 120, "the packet of the second flow is expected");
+    NS_TEST_ASSERT_MSG_EQ(flow1->GetDeficit(), 800, "unexpected deficit for the first flow");
+    item = queueDisc->Dequeue();
+    NS_TEST_ASSERT_MSG_EQ(item->GetSize(), 1020, "the packet of the first flow is expected");
+    NS_TEST_ASSERT_MSG_EQ(flow1->GetDeficit(), 0, "unexpected deficit for the first flow");
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->QueueDisc::GetNPackets(),
+                          0,
+                          "unexpected number of packets in the queue disc");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Packet filter classifying IPv4 packets based on the last byte of the
+ * destination address, used to identify the tenant a packet belongs to
+ */
+class DRRTenantPacketFilter : public Ipv4PacketFilter
+{
+  private:
+    int32_t DoClassify(Ptr<QueueDiscItem> item) const override;
+};
+
+int32_t
+DRRTenantPacketFilter::DoClassify(Ptr<QueueDiscItem> item) const
+{
+    Ptr<Ipv4QueueDiscItem> ipv4Item = DynamicCast<Ipv4QueueDiscItem>(item);
+    return ipv4Item->GetHeader().GetDestination().Get() & 0xff;
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Test 6: Throughput shares of flows with different quanta
+ */
+class DRRQueueDiscWeightedFlows : public TestCase
+{
+  public:
+    DRRQueueDiscWeightedFlows();
+    ~DRRQueueDiscWeightedFlows() override;
+
+  private:
+    void DoRun() override;
+};
+
+DRRQueueDiscWeightedFlows::DRRQueueDiscWeightedFlows()
+    : TestCase("Test throughput shares of weighted flows")
+{
+}
+
+DRRQueueDiscWeightedFlows::~DRRQueueDiscWeightedFlows()
+{
+}
+
+void
+DRRQueueDiscWeightedFlows::DoRun()
+{
+    Ptr<DRRQueueDisc> queueDisc = CreateObject<DRRQueueDisc>();
+    queueDisc->AddPacketFilter(CreateObject<DRRTenantPacketFilter>());
+    queueDisc->SetChildQueueDisc("ns3::FifoQueueDisc");
+    queueDisc->SetQuantum(600);
+    // the weights of tenants 1, 2 and 3 are 1, 2 and 3
+    queueDisc->SetFlowQuantum(2, 1200);
+    queueDisc->SetFlowQuantum(3, 1800);
+    queueDisc->Initialize();
+
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlowQuantum(1), 600, "unexpected quantum of tenant 1");
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetFlowQuantum(3), 1800, "unexpected quantum of tenant 3");
+
+    Ipv4Header hdr;
+    hdr.SetPayloadSize(500);
+    hdr.SetSource(Ipv4Address("10.10.1.1"));
+    hdr.SetProtocol(7);
+    Address dest;
+
+    for (uint32_t i = 0; i < 400; i++)
+    {
+        for (uint32_t tenant = 1; tenant <= 3; tenant++)
+        {
+            hdr.SetDestination(Ipv4Address(0x0a0a0100 + tenant));
+            queueDisc->Enqueue(Create<Ipv4QueueDiscItem>(Create<Packet>(500), dest, 0, hdr));
+        }
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetNQueueDiscClasses(), 3, "three flows expected");
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetInstanceTypeId(),
+                          TypeId::LookupByName("ns3::FifoQueueDisc"),
+                          "unexpected type of the child queue disc");
+
+    std::map<uint32_t, uint64_t> bytes;
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < 300; i++)
+    {
+        Ptr<QueueDiscItem> item = queueDisc->Dequeue();
+        NS_TEST_ASSERT_MSG_EQ((item != nullptr), true, "a packet should have been dequeued");
+        Ptr<Ipv4QueueDiscItem> ipv4Item = DynamicCast<Ipv4QueueDiscItem>(item);
+        bytes[ipv4Item->GetHeader().GetDestination().Get() & 0xff] += item->GetSize();
+        total += item->GetSize();
+    }
+
+    for (uint32_t tenant = 1; tenant <= 3; tenant++)
+    {
+        NS_TEST_EXPECT_MSG_EQ_TOL(static_cast<double>(bytes[tenant]) / total,
+                                  tenant / 6.0,
+                                  0.02,
+                                  "unexpected throughput share of tenant " << tenant);
+    }
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Test 7: Quantum derived from the device MTU and adaptive quantum
+ */
+class DRRQueueDiscQuantum : public TestCase
+{
+  public:
+    DRRQueueDiscQuantum();
+    ~DRRQueueDiscQuantum() override;
+
+  private:
+    void DoRun() override;
+    /**
+     * Adds packets into the queue
+     * \param queue
+     * \param hdr
+     * \param size
+     */
+    void AddPacket(Ptr<DRRQueueDisc> queue, Ipv4Header hdr, uint32_t size);
+};
+
+DRRQueueDiscQuantum::DRRQueueDiscQuantum()
+    : TestCase("Test the quantum derived from the MTU and the adaptive quantum")
+{
+}
+
+DRRQueueDiscQuantum::~DRRQueueDiscQuantum()
+{
+}
+
+void
+DRRQueueDiscQuantum::AddPacket(Ptr<DRRQueueDisc> queue, Ipv4Header hdr, uint32_t size)
+{
+    Ptr<Packet> p = Create<Packet>(size);
+    Address dest;
+    Ptr<Ipv4QueueDiscItem> item = Create<Ipv4QueueDiscItem>(p, dest, 0, hdr);
+    queue->Enqueue(item);
+}
+
+void
+DRRQueueDiscQuantum::DoRun()
+{
+    // the quantum is set to the MTU of the device
+    Ptr<SimpleNetDevice> dev = CreateObject<SimpleNetDevice>();
+    dev->SetMtu(1400);
+    Ptr<NetDeviceQueueInterface> ndqi = CreateObject<NetDeviceQueueInterface>();
+    dev->AggregateObject(ndqi);
+
+    Ptr<DRRQueueDisc> queueDisc = CreateObject<DRRQueueDisc>();
+    queueDisc->AddPacketFilter(CreateObject<DRRIpv4PacketFilter>());
+    queueDisc->SetNetDeviceQueueInterface(ndqi);
+    queueDisc->Initialize();
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQuantum(), 1400, "the quantum should equal the MTU");
+
+    // the quantum set through the attribute is not overridden
+    queueDisc = CreateObjectWithAttributes<DRRQueueDisc>("Quantum", UintegerValue(900));
+    queueDisc->AddPacketFilter(CreateObject<DRRIpv4PacketFilter>());
+    queueDisc->SetNetDeviceQueueInterface(ndqi);
+    queueDisc->Initialize();
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQuantum(), 900, "unexpected quantum");
+
+    // the adaptive quantum grows at once and shrinks at the end of a window
+    queueDisc = CreateObjectWithAttributes<DRRQueueDisc>("Quantum",
+                                                         UintegerValue(600),
+                                                         "AdaptiveQuantum",
+                                                         BooleanValue(true),
+                                                         "AdaptiveQuantumWindow",
+                                                         UintegerValue(4));
+    queueDisc->AddPacketFilter(CreateObject<DRRIpv4PacketFilter>());
+    queueDisc->Initialize();
+
+    Ipv4Header hdr;
+    hdr.SetPayloadSize(1000);
+    hdr.SetSource(Ipv4Address("10.10.1.1"));
+    hdr.SetDestination(Ipv4Address("10.10.1.2"));
+    hdr.SetProtocol(7);
+    AddPacket(queueDisc, hdr, 1000);
+    hdr.SetPayloadSize(200);
+    for (uint32_t i = 0; i < 7; i++)
+    {
+        AddPacket(queueDisc, hdr, 200);
+    }
+
+    queueDisc->Dequeue();
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQuantum(), 1020, "the quantum should have grown");
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        queueDisc->Dequeue();
+    }
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQuantum(),
+                          1020,
+                          "the quantum should equal the largest packet of the first window");
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        queueDisc->Dequeue();
+    }
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQuantum(),
+                          220,
+                          "the quantum should equal the largest packet of the second window");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Test 8: Flow hash computed by the DRR packet filters with the available hash functions
+ */
+class DRRPacketFilterFlowHash : public TestCase
+{
+  public:
+    DRRPacketFilterFlowHash();
+    ~DRRPacketFilterFlowHash() override;
+
+  private:
+    void DoRun() override;
+};
+
+DRRPacketFilterFlowHash::DRRPacketFilterFlowHash()
+    : TestCase("Test the flow hash computed by the DRR packet filters")
+{
+}
+
+DRRPacketFilterFlowHash::~DRRPacketFilterFlowHash()
+{
+}
+
+void
+DRRPacketFilterFlowHash::DoRun()
+{
+    Ptr<DRRIpv4PacketFilter> ipv4Filter = CreateObject<DRRIpv4PacketFilter>();
+    Ptr<DRRIpv6PacketFilter> ipv6Filter = CreateObject<DRRIpv6PacketFilter>();
+    Address dest;
+
+    TcpHeader tcpHdr;
+    tcpHdr.SetSourcePort(1234);
+    tcpHdr.SetDestinationPort(80);
+
+    // IPv4: the hash is computed on the serialized 5-tuple
+    Ipv4Header ipv4Hdr;
+    ipv4Hdr.SetSource(Ipv4Address("10.10.1.1"));
+    ipv4Hdr.SetDestination(Ipv4Address("10.10.1.2"));
+    ipv4Hdr.SetProtocol(6);
+    Ptr<Packet> p = Create<Packet>(100);
+    p->AddHeader(tcpHdr);
+    Ptr<Ipv4QueueDiscItem> ipv4Item = Create<Ipv4QueueDiscItem>(p, dest, 0, ipv4Hdr);
+
+    uint8_t buf[37] = {10, 10, 1, 1, 10, 10, 1, 2, 6, 1234 >> 8, 1234 & 0xff, 0, 80};
+    uint32_t expected = Hash32((char*)buf, 13);
+    uint32_t hash;
+    NS_TEST_ASSERT_MSG_EQ(ipv4Item->GetFlowHash(hash, DRR_HASH_MURMUR3, 0),
+                          false,
+                          "no flow hash expected");
+    NS_TEST_ASSERT_MSG_EQ(static_cast<uint32_t>(ipv4Filter->Classify(ipv4Item)),
+                          expected,
+                          "unexpected flow hash for the IPv4 packet");
+    NS_TEST_ASSERT_MSG_EQ(ipv4Item->GetFlowHash(hash, DRR_HASH_MURMUR3, 0),
+                          true,
+                          "the flow hash should be cached");
+    NS_TEST_ASSERT_MSG_EQ(hash, expected, "unexpected cached flow hash");
+
+    // a cached flow hash is returned without being computed again
+    ipv4Item = Create<Ipv4QueueDiscItem>(p, dest, 0, ipv4Hdr);
+    ipv4Item->SetFlowHash(42, DRR_HASH_MURMUR3, 0);
+    NS_TEST_ASSERT_MSG_EQ(ipv4Filter->Classify(ipv4Item), 42, "the cached hash should be used");
+
+    // unless it has been computed with a different hash function or perturbation
+    // (e.g., by the filter of a nested queue disc)
+    ipv4Item->SetFlowHash(42, DRR_HASH_JHASH, 0);
+    NS_TEST_ASSERT_MSG_EQ(static_cast<uint32_t>(ipv4Filter->Classify(ipv4Item)),
+                          expected,
+                          "a hash computed with another function should not be used");
+    ipv4Item->SetFlowHash(42, DRR_HASH_MURMUR3, 7);
+    NS_TEST_ASSERT_MSG_EQ(static_cast<uint32_t>(ipv4Filter->Classify(ipv4Item)),
+                          expected,
+                          "a hash computed with another perturbation should not be used");
+
+    // IPv6
+    Ipv6Header ipv6Hdr;
+    ipv6Hdr.SetSource(Ipv6Address("2001:1::1"));
+    ipv6Hdr.SetDestination(Ipv6Address("2001:1::2"));
+    ipv6Hdr.SetNextHeader(6);
+    Ptr<Ipv6QueueDiscItem> ipv6Item = Create<Ipv6QueueDiscItem>(p, dest, 0, ipv6Hdr);
+
+    Ipv6Address("2001:1::1").Serialize(buf);
+    Ipv6Address("2001:1::2").Serialize(buf + 16);
+    buf[32] = 6;
+    buf[33] = 1234 >> 8;
+    buf[34] = 1234 & 0xff;
+    buf[35] = 0;
+    buf[36] = 80;
+    expected = Hash32((char*)buf, 37);
+    NS_TEST_ASSERT_MSG_EQ(static_cast<uint32_t>(ipv6Filter->Classify(ipv6Item)),
+                          expected,
+                          "unexpected flow hash for the IPv6 packet");
+    NS_TEST_ASSERT_MSG_EQ(ipv6Item->GetFlowHash(hash, DRR_HASH_MURMUR3, 0),
+                          true,
+                          "the flow hash should be cached");
+
+    // packets too short to include the ports are hashed with null ports
+    ipv4Item = Create<Ipv4QueueDiscItem>(Create<Packet>(2), dest, 0, ipv4Hdr);
+    buf[0] = 10;
+    buf[1] = 10;
+    buf[2] = 1;
+    buf[3] = 1;
+    buf[4] = 10;
+    buf[5] = 10;
+    buf[6] = 1;
+    buf[7] = 2;
+    buf[8] = 6;
+    buf[9] = buf[10] = buf[11] = buf[12] = 0;
+    NS_TEST_ASSERT_MSG_EQ(static_cast<uint32_t>(ipv4Filter->Classify(ipv4Item)),
+                          Hash32((char*)buf, 13),
+                          "unexpected flow hash for the short IPv4 packet");
+
+    // alternative hash functions and perturbation
+    ipv4Filter->SetAttribute("HashFunction", EnumValue(DRR_HASH_JHASH));
+    ipv4Item = Create<Ipv4QueueDiscItem>(Create<Packet>(2), dest, 0, ipv4Hdr);
+    NS_TEST_ASSERT_MSG_EQ(static_cast<uint32_t>(ipv4Filter->Classify(ipv4Item)),
+                          Hasher(Create<Hash::Function::Jenkins>()).GetHash32((char*)buf, 13),
+                          "unexpected jhash value");
+
+    ipv4Filter->SetAttribute("HashFunction", EnumValue(DRR_HASH_CRC32C));
+    ipv4Filter->SetAttribute("Perturbation", UintegerValue(0x01020304));
+    ipv4Item = Create<Ipv4QueueDiscItem>(Create<Packet>(2), dest, 0, ipv4Hdr);
+    buf[13] = 1;
+    buf[14] = 2;
+    buf[15] = 3;
+    buf[16] = 4;
+    NS_TEST_ASSERT_MSG_EQ(static_cast<uint32_t>(ipv4Filter->Classify(ipv4Item)),
+                          Hasher(Create<Hash::Function::Crc32c>()).GetHash32((char*)buf, 17),
+                          "unexpected CRC32C value with perturbation");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Test 9: Set associative hash and flow hash collisions
+ */
+class DRRQueueDiscSetAssociativeHash : public TestCase
+{
+  public:
+    DRRQueueDiscSetAssociativeHash();
+    ~DRRQueueDiscSetAssociativeHash() override;
+
+  private:
+    void DoRun() override;
+    /**
+     * Enqueue a packet with the given hash (i.e., the last byte of the destination address)
+     * \param queue the queue disc
+     * \param hash the hash of the packet
+     */
+    void AddPacket(Ptr<DRRQueueDisc> queue, uint8_t hash);
+};
+
+DRRQueueDiscSetAssociativeHash::DRRQueueDiscSetAssociativeHash()
+    : TestCase("Test set associative hash and flow hash collisions")
+{
+}
+
+DRRQueueDiscSetAssociativeHash::~DRRQueueDiscSetAssociativeHash()
+{
+}
+
+void
+DRRQueueDiscSetAssociativeHash::AddPacket(Ptr<DRRQueueDisc> queue, uint8_t hash)
+{
+    Ipv4Header hdr;
+    hdr.SetPayloadSize(100);
+    hdr.SetSource(Ipv4Address("10.10.1.1"));
+    hdr.SetDestination(Ipv4Address(0x0a0a0200 | hash));
+    hdr.SetProtocol(7);
+    Address dest;
+    queue->Enqueue(Create<Ipv4QueueDiscItem>(Create<Packet>(100), dest, 0, hdr));
+}
+
+void
+DRRQueueDiscSetAssociativeHash::DoRun()
+{
+    // without set associative hash, hashes 1 and 17 share the same flow queue
+    Ptr<DRRQueueDisc> queueDisc = CreateObjectWithAttributes<DRRQueueDisc>("Flows",
+                                                                           UintegerValue(16));
+    queueDisc->AddPacketFilter(CreateObject<DRRTenantPacketFilter>());
+    queueDisc->Initialize();
+
+    AddPacket(queueDisc, 1);
+    AddPacket(queueDisc, 1);
+    AddPacket(queueDisc, 17);
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetNQueueDiscClasses(), 1, "unexpected number of flows");
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetStats().nTotalFlowHashCollisions,
+                          1,
+                          "unexpected number of collisions");
+
+    // with set associative hash, flows of the same set use distinct flow queues
+    // until the set is full
+    queueDisc = CreateObjectWithAttributes<DRRQueueDisc>("Flows",
+                                                         UintegerValue(16),
+                                                         "EnableSetAssociativeHash",
+                                                         BooleanValue(true),
+                                                         "SetWays",
+                                                         UintegerValue(8));
+    queueDisc->AddPacketFilter(CreateObject<DRRTenantPacketFilter>());
+    queueDisc->Initialize();
+
+    for (uint8_t k = 0; k < 8; k++)
+    {
+        AddPacket(queueDisc, 1 + 16 * k);
+    }
+    // packets of a flow already in the set are enqueued into its flow queue
+    AddPacket(queueDisc, 17);
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetNQueueDiscClasses(), 8, "unexpected number of flows");
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(1)->GetQueueDisc()->GetNPackets(),
+                          2,
+                          "both the packets of the flow should be in the second queue");
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetStats().nTotalFlowHashCollisions,
+                          0,
+                          "unexpected number of collisions");
+
+    // the set is full: a new flow collides with the flow of the first queue
+    AddPacket(queueDisc, 1 + 16 * 8);
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetNQueueDiscClasses(), 8, "unexpected number of flows");
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetQueueDiscClass(0)->GetQueueDisc()->GetNPackets(),
+                          2,
+                          "the packet should be in the first queue of the set");
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetStats().nTotalFlowHashCollisions,
+                          1,
+                          "unexpected number of collisions");
+
+    // flows in another set are not affected
+    AddPacket(queueDisc, 9);
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetNQueueDiscClasses(), 9, "unexpected number of flows");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Test 10: Pool of flows and reclamation of idle flows
+ */
+class DRRQueueDiscFlowPool : public TestCase
+{
+  public:
+    DRRQueueDiscFlowPool();
+    ~DRRQueueDiscFlowPool() override;
+
+  private:
+    void DoRun() override;
+    /**
+     * Enqueue a packet of the given flow (i.e., the last byte of the destination address)
+     * \param queue the queue disc
+     * \param flow the flow of the packet
+     */
+    void AddPacket(Ptr<DRRQueueDisc> queue, uint8_t flow);
+    /**
+     * Check that the packet of the given flow reclaims the idle flow object
+     * \param queue the queue disc
+     */
+    void CheckReclaim(Ptr<DRRQueueDisc> queue);
+};
+
+DRRQueueDiscFlowPool::DRRQueueDiscFlowPool()
+    : TestCase("Test the pool of flows and the reclamation of idle flows")
+{
+}
+
+DRRQueueDiscFlowPool::~DRRQueueDiscFlowPool()
+{
+}
+
+void
+DRRQueueDiscFlowPool::AddPacket(Ptr<DRRQueueDisc> queue, uint8_t flow)
+{
+    Ipv4Header hdr;
+    hdr.SetPayloadSize(100);
+    hdr.SetSource(Ipv4Address("10.10.1.1"));
+    hdr.SetDestination(Ipv4Address(0x0a0a0200 | flow));
+    hdr.SetProtocol(7);
+    Address dest;
+    queue->Enqueue(Create<Ipv4QueueDiscItem>(Create<Packet>(100), dest, 0, hdr));
+}
+
+void
+DRRQueueDiscFlowPool::CheckReclaim(Ptr<DRRQueueDisc> queue)
+{
+    AddPacket(queue, 3);
+    NS_TEST_EXPECT_MSG_EQ(queue->GetNQueueDiscClasses(), 2, "unexpected number of flow objects");
+    std::set<uint32_t> indices;
+    for (std::size_t i = 0; i < queue->GetNQueueDiscClasses(); i++)
+    {
+        indices.insert(StaticCast<DRRFlow>(queue->GetQueueDiscClass(i))->GetIndex());
+    }
+    NS_TEST_EXPECT_MSG_EQ((indices == std::set<uint32_t>{2, 3}),
+                          true,
+                          "the idle flow of the first flow should have been reclaimed");
+}
+
+void
+DRRQueueDiscFlowPool::DoRun()
+{
+    // bounded number of flow objects, all of them preallocated
+    Ptr<DRRQueueDisc> queueDisc = CreateObjectWithAttributes<DRRQueueDisc>("Flows",
+                                                                           UintegerValue(16),
+                                                                           "FlowPoolSize",
+                                                                           UintegerValue(2),
+                                                                           "MaxFlowObjects",
+                                                                           UintegerValue(2));
+    queueDisc->AddPacketFilter(CreateObject<DRRTenantPacketFilter>());
+    queueDisc->SetChildQueueDisc("ns3::FifoQueueDisc");
+    queueDisc->Initialize();
+
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetNQueueDiscClasses(), 2, "the flows should be allocated");
+
+    AddPacket(queueDisc, 1);
+    AddPacket(queueDisc, 2);
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetNQueueDiscClasses(), 2, "unexpected number of flows");
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetStats().nPeakFlowObjects,
+                          2,
+                          "unexpected peak number of flow objects");
+
+    // no flow object available
+    AddPacket(queueDisc, 3);
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetStats().GetNDroppedPackets(DRRQueueDisc::FLOW_LIMIT_DROP),
+                          1,
+                          "the packet should have been dropped");
+
+    // the first flow becomes idle and its flow object is reclaimed
+    queueDisc->Dequeue();
+    CheckReclaim(queueDisc);
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetNPackets(), 2, "unexpected number of packets");
+
+    AddPacket(queueDisc, 1);
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetStats().GetNDroppedPackets(DRRQueueDisc::FLOW_LIMIT_DROP),
+                          2,
+                          "the packet should have been dropped");
+
+    // idle flows are reclaimed after the idle timeout
+    queueDisc = CreateObjectWithAttributes<DRRQueueDisc>("Flows",
+                                                         UintegerValue(16),
+                                                         "FlowIdleTimeout",
+                                                         TimeValue(Seconds(1)));
+    queueDisc->AddPacketFilter(CreateObject<DRRTenantPacketFilter>());
+    queueDisc->SetChildQueueDisc("ns3::FifoQueueDisc");
+    queueDisc->Initialize();
+
+    AddPacket(queueDisc, 1);
+    queueDisc->Dequeue();
+    // the idle timeout has not expired yet
+    AddPacket(queueDisc, 2);
+    NS_TEST_ASSERT_MSG_EQ(queueDisc->GetNQueueDiscClasses(), 2, "unexpected number of flows");
+
+    Simulator::Schedule(Seconds(2), &DRRQueueDiscFlowPool::CheckReclaim, this, queueDisc);
+    Simulator::Run();
+
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup traffic-control-test
  *
@@ -528,6 +1434,14 @@ DRRQueueDiscTestSuite::DRRQueueDiscTestSuite()
     AddTestCase(new DRRQueueDiscIPFlowsSeparationAndByteLimit, TestCase::QUICK);
     AddTestCase(new DRRQueueDiscDeficitVariableSizeSameFlow, TestCase::QUICK);
     AddTestCase(new DRRQueueDiscDeficitVariableSizeDifferentFlow, TestCase::QUICK);
+    AddTestCase(new DRRQueueDiscOverlimitEmptiesFlow, TestCase::QUICK);
+    AddTestCase(new DRRQueueDiscFatFlowBatchDrop, TestCase::QUICK);
+    AddTestCase(new DRRQueueDiscSmallQuantum, TestCase::QUICK);
+    AddTestCase(new DRRQueueDiscWeightedFlows, TestCase::QUICK);
+    AddTestCase(new DRRQueueDiscQuantum, TestCase::QUICK);
+    AddTestCase(new DRRPacketFilterFlowHash, TestCase::QUICK);
+    AddTestCase(new DRRQueueDiscSetAssociativeHash, TestCase::QUICK);
+    AddTestCase(new DRRQueueDiscFlowPool, TestCase::QUICK);
 }
 
 static DRRQueueDiscTestSuite DRRQueueDiscTestSuite;
@@ -0,0 +1,352 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/drop-tail-queue.h"
+#include "ns3/mq-queue-disc.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include "ns3/traffic-control-layer.h"
+#include "ns3/uinteger.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Mq Queue Disc Test Item
+ */
+class MqQueueDiscTestItem : public QueueDiscItem
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param p the packet stored in this item
+     */
+    MqQueueDiscTestItem(Ptr<Packet> p);
+
+    // Delete default constructor, copy constructor and assignment operator to avoid misuse
+    MqQueueDiscTestItem() = delete;
+    MqQueueDiscTestItem(const MqQueueDiscTestItem&) = delete;
+    MqQueueDiscTestItem& operator=(const MqQueueDiscTestItem&) = delete;
+
+    void AddHeader() override;
+    bool Mark() override;
+};
+
+MqQueueDiscTestItem::MqQueueDiscTestItem(Ptr<Packet> p)
+    : QueueDiscItem(p, Mac48Address("00:00:00:00:00:02"), 0)
+{
+}
+
+void
+MqQueueDiscTestItem::AddHeader()
+{
+}
+
+bool
+MqQueueDiscTestItem::Mark()
+{
+    return false;
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Child queue disc used by the Mq queue disc test, which drops the packets
+ *        whose size is a multiple of three after dequeue
+ */
+class MqTestChildQueueDisc : public QueueDisc
+{
+  public:
+    MqTestChildQueueDisc();
+
+    /// Reason for dropping packets
+    static constexpr const char* AFTER_DEQUEUE = "Size multiple of three";
+
+  private:
+    bool DoEnqueue(Ptr<QueueDiscItem> item) override;
+    Ptr<QueueDiscItem> DoDequeue() override;
+    bool CheckConfig() override;
+    void InitializeParams() override;
+};
+
+MqTestChildQueueDisc::MqTestChildQueueDisc()
+    : QueueDisc(QueueDiscSizePolicy::SINGLE_INTERNAL_QUEUE)
+{
+}
+
+bool
+MqTestChildQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
+{
+    return GetInternalQueue(0)->Enqueue(item);
+}
+
+Ptr<QueueDiscItem>
+MqTestChildQueueDisc::DoDequeue()
+{
+    Ptr<QueueDiscItem> item;
+
+    while ((item = GetInternalQueue(0)->Dequeue()))
+    {
+        if (item->GetSize() % 3 != 0)
+        {
+            return item;
+        }
+        DropAfterDequeue(item, AFTER_DEQUEUE);
+    }
+    return nullptr;
+}
+
+bool
+MqTestChildQueueDisc::CheckConfig()
+{
+    if (GetNInternalQueues() == 0)
+    {
+        AddInternalQueue(CreateObjectWithAttributes<DropTailQueue<QueueDiscItem>>(
+            "MaxSize",
+            QueueSizeValue(QueueSize("1000p"))));
+    }
+    return true;
+}
+
+void
+MqTestChildQueueDisc::InitializeParams()
+{
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Test that running the child queue discs of a mq queue disc in
+ *        parallel gives the same results regardless of the number of threads
+ */
+class MqQueueDiscParallelRunTestCase : public TestCase
+{
+  public:
+    MqQueueDiscParallelRunTestCase();
+
+  private:
+    void DoRun() override;
+
+    /// The outcome of a simulation
+    struct Outcome
+    {
+        std::vector<uint32_t> received; //!< Sizes of the received packets, in order
+        uint32_t droppedByChildren;     //!< Packets dropped by the child queue discs
+        uint32_t nPackets;              //!< Packets stored in the mq queue disc
+        uint32_t dequeuedPackets;       //!< Packets dequeued from the mq queue disc
+        uint64_t dequeuedBytes;         //!< Bytes dequeued from the mq queue disc
+    };
+
+    /**
+     * Simulate the transmission of bursts of packets on a device with four
+     * transmission queues
+     * \param parallel whether the child queue discs are run in parallel
+     * \param nThreads the number of threads used for parallel runs
+     * \return the outcome of the simulation
+     */
+    Outcome RunScenario(bool parallel, uint32_t nThreads);
+
+    /**
+     * Send a burst of packets of increasing size
+     * \param node the sending node
+     * \param firstSize the size of the first packet
+     * \param nPackets the number of packets to send
+     */
+    void SendBurst(Ptr<Node> node, uint32_t firstSize, uint32_t nPackets);
+
+    /**
+     * Record the size of a received packet
+     * \param dev the receiving device
+     * \param p the received packet
+     * \param protocol the protocol number
+     * \param from the sender address
+     * \return true
+     */
+    bool Receive(Ptr<NetDevice> dev, Ptr<const Packet> p, uint16_t protocol, const Address& from);
+
+    std::vector<uint32_t> m_received; //!< Sizes of the received packets
+};
+
+MqQueueDiscParallelRunTestCase::MqQueueDiscParallelRunTestCase()
+    : TestCase("Test the parallel run of the child queue discs of a mq queue disc")
+{
+}
+
+void
+MqQueueDiscParallelRunTestCase::SendBurst(Ptr<Node> node, uint32_t firstSize, uint32_t nPackets)
+{
+    Ptr<TrafficControlLayer> tc = node->GetObject<TrafficControlLayer>();
+    for (uint32_t i = 0; i < nPackets; i++)
+    {
+        tc->Send(node->GetDevice(0), Create<MqQueueDiscTestItem>(Create<Packet>(firstSize + i)));
+    }
+}
+
+bool
+MqQueueDiscParallelRunTestCase::Receive(Ptr<NetDevice> dev,
+                                        Ptr<const Packet> p,
+                                        uint16_t protocol,
+                                        const Address& from)
+{
+    m_received.push_back(p->GetSize());
+    return true;
+}
+
+MqQueueDiscParallelRunTestCase::Outcome
+MqQueueDiscParallelRunTestCase::RunScenario(bool parallel, uint32_t nThreads)
+{
+    const uint32_t nTxQueues = 4;
+    m_received.clear();
+
+    NodeContainer n;
+    n.Create(2);
+
+    SimpleNetDeviceHelper simple;
+    simple.DisableFlowControl();
+    NetDeviceContainer devices = simple.Install(n);
+    devices.Get(1)->SetReceiveCallback(
+        MakeCallback(&MqQueueDiscParallelRunTestCase::Receive, this));
+
+    // the transmission queue is selected based on the packet size
+    Ptr<NetDeviceQueueInterface> ndqi =
+        CreateObjectWithAttributes<NetDeviceQueueInterface>("NTxQueues", UintegerValue(nTxQueues));
+    ndqi->SetSelectQueueCallback(
+        [nTxQueues](Ptr<QueueItem> item) { return item->GetPacket()->GetSize() % nTxQueues; });
+    devices.Get(0)->AggregateObject(ndqi);
+
+    Ptr<MqQueueDisc> mq = CreateObjectWithAttributes<MqQueueDisc>("ParallelRun",
+                                                                  BooleanValue(parallel),
+                                                                  "ParallelThreads",
+                                                                  UintegerValue(nThreads));
+    for (uint32_t i = 0; i < nTxQueues; i++)
+    {
+        Ptr<QueueDiscClass> c = CreateObject<QueueDiscClass>();
+        c->SetQueueDisc(CreateObject<MqTestChildQueueDisc>());
+        mq->AddQueueDiscClass(c);
+    }
+
+    Ptr<TrafficControlLayer> tc = CreateObject<TrafficControlLayer>();
+    n.Get(0)->AggregateObject(tc);
+    tc->SetRootQueueDiscOnDevice(devices.Get(0), mq);
+
+    // the device queue is large enough to store a burst of packets
+    for (uint32_t b = 0; b < 5; b++)
+    {
+        Simulator::Schedule(MilliSeconds(b),
+                            &MqQueueDiscParallelRunTestCase::SendBurst,
+                            this,
+                            n.Get(0),
+                            100 + 20 * b,
+                            20);
+    }
+
+    Simulator::Run();
+
+    Outcome outcome;
+    outcome.received = m_received;
+    outcome.droppedByChildren = mq->GetStats().GetNDroppedPackets(
+        std::string(QueueDisc::CHILD_QUEUE_DISC_DROP) + MqTestChildQueueDisc::AFTER_DEQUEUE);
+    outcome.nPackets = mq->GetNPackets();
+    outcome.dequeuedPackets = mq->GetStats().nTotalDequeuedPackets;
+    outcome.dequeuedBytes = mq->GetStats().nTotalDequeuedBytes;
+
+    Simulator::Destroy();
+    return outcome;
+}
+
+void
+MqQueueDiscParallelRunTestCase::DoRun()
+{
+    Outcome serial = RunScenario(false, 1);
+    Outcome oneThread = RunScenario(true, 1);
+    Outcome fourThreads = RunScenario(true, 4);
+
+    // 100 packets of sizes from 100 to 199 are sent, 33 of which have a size
+    // that is a multiple of three
+    NS_TEST_EXPECT_MSG_EQ(serial.received.size(), 67, "Unexpected number of received packets");
+    NS_TEST_EXPECT_MSG_EQ(serial.droppedByChildren, 33, "Unexpected number of dropped packets");
+    NS_TEST_EXPECT_MSG_EQ(oneThread.received.size(),
+                          67,
+                          "Unexpected number of received packets with parallel runs");
+    NS_TEST_EXPECT_MSG_EQ(oneThread.droppedByChildren,
+                          33,
+                          "The drops notified by the children must be delivered to the parent");
+
+    // The dequeues notified by the children must be delivered to the parent
+    NS_TEST_EXPECT_MSG_EQ(serial.nPackets, 0, "Unexpected number of stored packets");
+    NS_TEST_EXPECT_MSG_EQ(serial.dequeuedPackets, 100, "Unexpected number of dequeued packets");
+    NS_TEST_EXPECT_MSG_EQ(oneThread.nPackets,
+                          serial.nPackets,
+                          "Unexpected number of stored packets with parallel runs");
+    NS_TEST_EXPECT_MSG_EQ(oneThread.dequeuedPackets,
+                          serial.dequeuedPackets,
+                          "Unexpected number of dequeued packets with parallel runs");
+    NS_TEST_EXPECT_MSG_EQ(oneThread.dequeuedBytes,
+                          serial.dequeuedBytes,
+                          "Unexpected number of dequeued bytes with parallel runs");
+
+    // The order in which packets are sent only depends on the order of the
+    // transmission queues, not on the number of threads
+    NS_TEST_EXPECT_MSG_EQ(fourThreads.droppedByChildren,
+                          oneThread.droppedByChildren,
+                          "The number of threads must not affect the drops");
+    NS_TEST_EXPECT_MSG_EQ(fourThreads.nPackets,
+                          oneThread.nPackets,
+                          "The number of threads must not affect the stored packets");
+    NS_TEST_EXPECT_MSG_EQ(fourThreads.dequeuedPackets,
+                          oneThread.dequeuedPackets,
+                          "The number of threads must not affect the dequeued packets");
+    NS_TEST_EXPECT_MSG_EQ(fourThreads.dequeuedBytes,
+                          oneThread.dequeuedBytes,
+                          "The number of threads must not affect the dequeued bytes");
+    NS_TEST_ASSERT_MSG_EQ(fourThreads.received.size(),
+                          oneThread.received.size(),
+                          "The number of threads must not affect the received packets");
+    for (std::size_t i = 0; i < oneThread.received.size(); i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(fourThreads.received[i],
+                              oneThread.received[i],
+                              "The number of threads must not affect the order of packets");
+    }
+
+    // Within a burst, the packets are sent grouped by transmission queue
+    NS_TEST_EXPECT_MSG_EQ(oneThread.received[0] % 4, 0, "Unexpected transmission queue");
+    NS_TEST_EXPECT_MSG_EQ(oneThread.received[oneThread.received.size() - 1] % 4,
+                          3,
+                          "Unexpected transmission queue");
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Mq Queue Disc Test Suite
+ */
+static class MqQueueDiscTestSuite : public TestSuite
+{
+  public:
+    MqQueueDiscTestSuite()
+        : TestSuite("mq-queue-disc", UNIT)
+    {
+        AddTestCase(new MqQueueDiscParallelRunTestCase(), TestCase::QUICK);
+    }
+} g_mqQueueDiscTestSuite; ///< the test suite
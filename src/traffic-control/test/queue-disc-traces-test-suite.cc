@@ -18,12 +18,17 @@
  *
  */
 
+#include "ns3/boolean.h"
 #include "ns3/drop-tail-queue.h"
+#include "ns3/fifo-queue-disc.h"
+#include "ns3/log-histogram.h"
 #include "ns3/packet.h"
 #include "ns3/queue-disc.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
 
+#include <algorithm>
+#include <cstring>
 #include <map>
 
 using namespace ns3;
@@ -86,14 +91,32 @@ class TestChildQueueDisc : public QueueDisc
     bool CheckConfig() override;
     void InitializeParams() override;
 
+    /**
+     * Set the reason for the packets dropped before enqueue, which is copied in
+     * the same buffer as the previous reason
+     * \param reason the reason
+     */
+    void SetBeforeEnqueueReason(const char* reason);
+
     // Reasons for dropping packets
     static constexpr const char* BEFORE_ENQUEUE = "Before enqueue"; //!< Drop before enqueue
     static constexpr const char* AFTER_DEQUEUE = "After dequeue";   //!< Drop after dequeue
+
+  private:
+    char m_beforeEnqueueReason[32]; //!< Buffer storing the reason for the drops before enqueue
 };
 
 TestChildQueueDisc::TestChildQueueDisc()
     : QueueDisc(QueueDiscSizePolicy::SINGLE_INTERNAL_QUEUE)
 {
+    SetBeforeEnqueueReason(BEFORE_ENQUEUE);
+}
+
+void
+TestChildQueueDisc::SetBeforeEnqueueReason(const char* reason)
+{
+    std::strncpy(m_beforeEnqueueReason, reason, sizeof(m_beforeEnqueueReason) - 1);
+    m_beforeEnqueueReason[sizeof(m_beforeEnqueueReason) - 1] = '\0';
 }
 
 TestChildQueueDisc::~TestChildQueueDisc()
@@ -106,7 +129,7 @@ TestChildQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
     // Drop the packet if there are already 4 packets queued
     if (GetNPackets() >= 4)
     {
-        DropBeforeEnqueue(item, BEFORE_ENQUEUE);
+        DropBeforeEnqueue(item, m_beforeEnqueueReason);
         return false;
     }
     return GetInternalQueue(0)->Enqueue(item);
@@ -580,6 +603,197 @@ QueueDiscTracesTestCase::DoRun()
     CheckDroppedBeforeEnqueue(child, 1, pktSizeUnit * 5);
     CheckDroppedAfterDequeue(child, 2, pktSizeUnit * 3);
 
+    // Check the per-reason counters. The reasons provided by the child queue disc
+    // are prefixed by CHILD_QUEUE_DISC_DROP in the statistics of the root queue disc
+    std::string rootDbe =
+        std::string(QueueDisc::CHILD_QUEUE_DISC_DROP) + TestChildQueueDisc::BEFORE_ENQUEUE;
+    std::string rootDad =
+        std::string(QueueDisc::CHILD_QUEUE_DISC_DROP) + TestChildQueueDisc::AFTER_DEQUEUE;
+
+    QueueDisc::Stats stats = root->GetStats();
+    NS_TEST_ASSERT_MSG_EQ(stats.GetNDroppedPackets(rootDbe),
+                          1,
+                          "Verify the number of packets dropped before enqueue by the child");
+    NS_TEST_ASSERT_MSG_EQ(stats.GetNDroppedBytes(rootDad),
+                          pktSizeUnit * 3,
+                          "Verify the number of bytes dropped after dequeue by the child");
+    NS_TEST_ASSERT_MSG_EQ(stats.nDroppedPacketsAfterDequeue.at(rootDad),
+                          2,
+                          "Verify that the per-reason maps are filled by GetStats");
+
+    stats = child->GetStats();
+    NS_TEST_ASSERT_MSG_EQ(stats.GetNDroppedPackets(TestChildQueueDisc::BEFORE_ENQUEUE),
+                          1,
+                          "Verify the number of packets dropped before enqueue");
+    uint32_t id = QueueDisc::GetReasonId(TestChildQueueDisc::AFTER_DEQUEUE);
+    NS_TEST_ASSERT_MSG_EQ(stats.nDroppedAfterDequeueByReason.at(id).packets,
+                          2,
+                          "Verify the number of packets dropped after dequeue");
+
+    // Reasons are interned once
+    NS_TEST_ASSERT_MSG_EQ(QueueDisc::GetReasonId(std::string(TestChildQueueDisc::AFTER_DEQUEUE)),
+                          id,
+                          "A reason must always be mapped to the same identifier");
+    NS_TEST_ASSERT_MSG_EQ(std::string(QueueDisc::GetReasonName(id)),
+                          TestChildQueueDisc::AFTER_DEQUEUE,
+                          "Unexpected reason for the given identifier");
+
+    // The reasons are cached by pointer, but a buffer reused for another reason
+    // must not be counted under the previous reason
+    const char* reused = "Reused buffer";
+    DynamicCast<TestChildQueueDisc>(child)->SetBeforeEnqueueReason(reused);
+    for (uint16_t i = 1; i <= 5; i++)
+    {
+        root->Enqueue(Create<QdTestItem>(Create<Packet>(pktSizeUnit), dest));
+    }
+
+    stats = child->GetStats();
+    NS_TEST_ASSERT_MSG_EQ(stats.GetNDroppedPackets(TestChildQueueDisc::BEFORE_ENQUEUE),
+                          1,
+                          "The drops for the new reason were counted under the old reason");
+    NS_TEST_ASSERT_MSG_GT(stats.GetNDroppedPackets(reused),
+                          0,
+                          "The drops for the new reason were not counted");
+    stats = root->GetStats();
+    NS_TEST_ASSERT_MSG_EQ(stats.GetNDroppedPackets(rootDbe),
+                          1,
+                          "The drops for the new reason were counted under the old reason");
+    NS_TEST_ASSERT_MSG_GT(
+        stats.GetNDroppedPackets(std::string(QueueDisc::CHILD_QUEUE_DISC_DROP) + reused),
+        0,
+        "The drops for the new reason were not counted by the root queue disc");
+
+    // Querying the counters of an unknown reason does not intern the reason
+    uint32_t reasonId;
+    NS_TEST_ASSERT_MSG_EQ(stats.GetNDroppedPackets("Never used reason"),
+                          0,
+                          "Unexpected drops for an unknown reason");
+    NS_TEST_ASSERT_MSG_EQ(stats.GetNMarkedBytes("Never used reason"),
+                          0,
+                          "Unexpected marks for an unknown reason");
+    NS_TEST_ASSERT_MSG_EQ(QueueDisc::FindReasonId("Never used reason", reasonId),
+                          false,
+                          "Querying the counters must not intern the reason");
+    NS_TEST_ASSERT_MSG_EQ(QueueDisc::FindReasonId(reused, reasonId),
+                          true,
+                          "A reason used to drop packets should have been interned");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Check the accuracy of the LogHistogram class and the histograms kept
+ * by the QueueDisc class when the EnableHistograms attribute is true
+ */
+class QueueDiscHistogramsTestCase : public TestCase
+{
+  public:
+    QueueDiscHistogramsTestCase();
+    void DoRun() override;
+
+  private:
+    /**
+     * Check that a value returned by a histogram approximates the exact value
+     * within the precision of the histogram
+     * \param value the value returned by the histogram
+     * \param exact the exact value
+     * \param msg the message to print if the check fails
+     */
+    void CheckApprox(uint64_t value, uint64_t exact, std::string msg);
+};
+
+QueueDiscHistogramsTestCase::QueueDiscHistogramsTestCase()
+    : TestCase("Check the sojourn time and backlog histograms")
+{
+}
+
+void
+QueueDiscHistogramsTestCase::CheckApprox(uint64_t value, uint64_t exact, std::string msg)
+{
+    uint64_t tolerance = exact >> LogHistogram::PRECISION_BITS;
+    NS_TEST_ASSERT_MSG_GT_OR_EQ(value, exact, msg);
+    NS_TEST_ASSERT_MSG_LT_OR_EQ(value, exact + tolerance, msg);
+}
+
+void
+QueueDiscHistogramsTestCase::DoRun()
+{
+    // Buckets are contiguous and each value falls in the bucket whose bounds include it
+    for (uint32_t i = 0; i < 60 << LogHistogram::PRECISION_BITS; i++)
+    {
+        uint64_t lower = LogHistogram::GetBucketLowerBound(i);
+        uint64_t upper = LogHistogram::GetBucketUpperBound(i);
+        NS_TEST_ASSERT_MSG_EQ(LogHistogram::GetBucketIndex(lower), i, "Wrong bucket index");
+        NS_TEST_ASSERT_MSG_EQ(LogHistogram::GetBucketIndex(upper), i, "Wrong bucket index");
+        if (upper < std::numeric_limits<uint64_t>::max())
+        {
+            NS_TEST_ASSERT_MSG_EQ(LogHistogram::GetBucketLowerBound(i + 1),
+                                  upper + 1,
+                                  "Buckets are not contiguous");
+        }
+    }
+
+    // Percentiles of uniformly distributed values, recorded in scrambled order
+    LogHistogram h1;
+    LogHistogram h2;
+    const uint64_t n = 100000;
+    for (uint64_t k = 0; k < n; k++)
+    {
+        uint64_t value = (k * 7919) % n + 1;
+        (value % 2 ? h1 : h2).Record(value * 1000);
+    }
+    h1.Merge(h2);
+    NS_TEST_ASSERT_MSG_EQ(h1.GetCount(), n, "Unexpected number of values");
+    NS_TEST_ASSERT_MSG_EQ(h1.GetMin(), 1000, "Unexpected minimum value");
+    NS_TEST_ASSERT_MSG_EQ(h1.GetMax(), n * 1000, "Unexpected maximum value");
+    NS_TEST_ASSERT_MSG_EQ_TOL(h1.GetMean(), (n + 1) * 500., 1e-6, "Unexpected mean");
+    CheckApprox(h1.GetPercentile(50), n / 2 * 1000, "Unexpected 50th percentile");
+    CheckApprox(h1.GetPercentile(99), n * 99 / 100 * 1000, "Unexpected 99th percentile");
+    CheckApprox(h1.GetPercentile(99.9), n * 999 / 1000 * 1000, "Unexpected 99.9th percentile");
+    NS_TEST_ASSERT_MSG_EQ(h1.GetPercentile(100), n * 1000, "Unexpected 100th percentile");
+
+    // Small values are recorded exactly
+    LogHistogram h3;
+    h3.Record(3);
+    h3.Record(7);
+    NS_TEST_ASSERT_MSG_EQ(h3.GetPercentile(50), 3, "Unexpected 50th percentile");
+    NS_TEST_ASSERT_MSG_EQ(h3.GetPercentile(51), 7, "Unexpected 51st percentile");
+
+    // Histograms kept by a queue disc
+    Ptr<QueueDisc> qd = CreateObject<FifoQueueDisc>();
+    Ptr<QueueDisc> noHist = CreateObject<FifoQueueDisc>();
+    qd->SetAttribute("EnableHistograms", BooleanValue(true));
+    qd->Initialize();
+    noHist->Initialize();
+
+    Address dest;
+    for (uint32_t i = 1; i <= 3; i++)
+    {
+        qd->Enqueue(Create<QdTestItem>(Create<Packet>(100), dest));
+        noHist->Enqueue(Create<QdTestItem>(Create<Packet>(100), dest));
+        Simulator::Schedule(MilliSeconds(i), [qd]() { qd->Dequeue(); });
+        Simulator::Schedule(MilliSeconds(i), [noHist]() { noHist->Dequeue(); });
+    }
+    Simulator::Run();
+
+    QueueDisc::Stats stats = qd->GetStats();
+    NS_TEST_ASSERT_MSG_EQ(stats.sojournTime.GetCount(), 3, "Unexpected number of sojourn times");
+    NS_TEST_ASSERT_MSG_EQ(stats.sojournTime.GetMin(), 1000000, "Unexpected minimum sojourn time");
+    NS_TEST_ASSERT_MSG_EQ(stats.sojournTime.GetMax(), 3000000, "Unexpected maximum sojourn time");
+    CheckApprox(stats.sojournTime.GetPercentile(50), 2000000, "Unexpected median sojourn time");
+    NS_TEST_ASSERT_MSG_EQ(stats.backlogPackets.GetCount(), 3, "Unexpected number of backlogs");
+    NS_TEST_ASSERT_MSG_EQ(stats.backlogPackets.GetMin(), 1, "Unexpected minimum backlog");
+    NS_TEST_ASSERT_MSG_EQ(stats.backlogPackets.GetMax(), 3, "Unexpected maximum backlog");
+    NS_TEST_ASSERT_MSG_EQ(stats.backlogBytes.GetMax(), 300, "Unexpected maximum backlog");
+
+    stats = noHist->GetStats();
+    NS_TEST_ASSERT_MSG_EQ(stats.sojournTime.GetCount(), 0, "Histograms are disabled by default");
+    NS_TEST_ASSERT_MSG_EQ(stats.backlogPackets.GetCount(),
+                          0,
+                          "Histograms are disabled by default");
+
     Simulator::Destroy();
 }
 
@@ -595,5 +809,6 @@ static class QueueDiscTracesTestSuite : public TestSuite
         : TestSuite("queue-disc-traces", UNIT)
     {
         AddTestCase(new QueueDiscTracesTestCase(), TestCase::QUICK);
+        AddTestCase(new QueueDiscHistogramsTestCase(), TestCase::QUICK);
     }
 } g_queueDiscTracesTestSuite; ///< the test suite
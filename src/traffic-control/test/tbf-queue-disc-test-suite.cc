@@ -24,6 +24,7 @@
 #include "ns3/log.h"
 #include "ns3/node-container.h"
 #include "ns3/packet.h"
+#include "ns3/shaping-timer-wheel.h"
 #include "ns3/simple-channel.h"
 #include "ns3/simple-net-device.h"
 #include "ns3/simulator.h"
@@ -537,6 +538,111 @@ TbfQueueDiscTestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Test of the timer wheel waking the rate limited queue discs
+ */
+class ShapingTimerWheelTestCase : public TestCase
+{
+  public:
+    ShapingTimerWheelTestCase();
+
+  private:
+    void DoRun() override;
+    /**
+     * Record the expiration of a timer
+     * \param index the index of the timer
+     */
+    void Expire(uint32_t index);
+
+    Ptr<ShapingTimerWheel> m_wheel;       //!< the timer wheel
+    ShapingTimerWheel::Timer m_timers[6]; //!< the timers
+    std::vector<Time> m_expirations[6];   //!< the expiration times of each timer
+    uint32_t m_nRearm;                    //!< number of expirations of timer 5 left
+};
+
+ShapingTimerWheelTestCase::ShapingTimerWheelTestCase()
+    : TestCase("Test the timer wheel shared by the rate limited queue discs"),
+      m_nRearm(3)
+{
+}
+
+void
+ShapingTimerWheelTestCase::Expire(uint32_t index)
+{
+    m_expirations[index].push_back(Simulator::Now());
+    if (index == 1)
+    {
+        // cancel a timer expiring at the same tick and arm another one
+        m_wheel->Cancel(m_timers[2]);
+        m_wheel->Schedule(m_timers[4], MicroSeconds(100));
+    }
+    if (index == 5 && --m_nRearm > 0)
+    {
+        m_wheel->Schedule(m_timers[5], Seconds(1));
+    }
+}
+
+void
+ShapingTimerWheelTestCase::DoRun()
+{
+    m_wheel = CreateObjectWithAttributes<ShapingTimerWheel>("Resolution",
+                                                            TimeValue(MicroSeconds(1)));
+    for (uint32_t i = 0; i < 6; i++)
+    {
+        m_timers[i].SetFunction(MakeCallback(&ShapingTimerWheelTestCase::Expire, this, i));
+    }
+
+    // timers 0 and 1 expire at the same tick (expiration times are rounded up),
+    // timer 2 too but it is cancelled by timer 1, timer 3 is rescheduled and
+    // timer 5 (which expires much later) rearms itself twice
+    m_wheel->Schedule(m_timers[0], NanoSeconds(10500));
+    m_wheel->Schedule(m_timers[1], MicroSeconds(11));
+    m_wheel->Schedule(m_timers[2], NanoSeconds(10001));
+    m_wheel->Schedule(m_timers[3], MicroSeconds(5));
+    m_wheel->Schedule(m_timers[5], Seconds(100) + NanoSeconds(1));
+    m_wheel->Schedule(m_timers[3], MilliSeconds(70));
+    NS_TEST_EXPECT_MSG_EQ(m_wheel->GetNTimers(), 5, "Unexpected number of armed timers");
+
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(m_expirations[0].size(), 1, "Timer 0 should expire once");
+    NS_TEST_EXPECT_MSG_EQ(m_expirations[0][0], MicroSeconds(11), "Timer 0 expired at a wrong time");
+    NS_TEST_ASSERT_MSG_EQ(m_expirations[1].size(), 1, "Timer 1 should expire once");
+    NS_TEST_EXPECT_MSG_EQ(m_expirations[1][0], MicroSeconds(11), "Timer 1 expired at a wrong time");
+    NS_TEST_EXPECT_MSG_EQ(m_expirations[2].size(), 0, "Timer 2 should have been cancelled");
+    NS_TEST_ASSERT_MSG_EQ(m_expirations[3].size(), 1, "Timer 3 should expire once");
+    NS_TEST_EXPECT_MSG_EQ(m_expirations[3][0], MilliSeconds(70), "Timer 3 expired at a wrong time");
+    NS_TEST_ASSERT_MSG_EQ(m_expirations[4].size(), 1, "Timer 4 should expire once");
+    NS_TEST_EXPECT_MSG_EQ(m_expirations[4][0],
+                          MicroSeconds(111),
+                          "Timer 4 expired at a wrong time");
+    NS_TEST_ASSERT_MSG_EQ(m_expirations[5].size(), 3, "Timer 5 should expire three times");
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_expirations[5][i],
+                              Seconds(100 + i) + MicroSeconds(1),
+                              "Timer 5 expired at a wrong time");
+    }
+    NS_TEST_EXPECT_MSG_EQ(m_wheel->GetNTimers(), 0, "No timer should be armed");
+    m_wheel->Dispose();
+
+    // by default, timers expire exactly at their expiration time
+    m_wheel = CreateObject<ShapingTimerWheel>();
+    Time start = Simulator::Now();
+    m_wheel->Schedule(m_timers[0], NanoSeconds(10501));
+    Simulator::Run();
+    NS_TEST_ASSERT_MSG_EQ(m_expirations[0].size(), 2, "Timer 0 should expire twice");
+    NS_TEST_EXPECT_MSG_EQ(m_expirations[0][1],
+                          start + NanoSeconds(10501),
+                          "Timer 0 expired at a wrong time");
+
+    m_wheel->Dispose();
+    m_wheel = nullptr;
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup traffic-control-test
  *
@@ -549,5 +655,6 @@ static class TbfQueueDiscTestSuite : public TestSuite
         : TestSuite("tbf-queue-disc", UNIT)
     {
         AddTestCase(new TbfQueueDiscTestCase(), TestCase::QUICK);
+        AddTestCase(new ShapingTimerWheelTestCase(), TestCase::QUICK);
     }
 } g_tbfQueueTestSuite; ///< the test suite
@@ -98,8 +98,12 @@ class TcFlowControlTestCase : public TestCase
      * \param tt the test type
      * \param deviceQueueLength the queue length of the device
      * \param totalTxPackets the total number of packets to transmit
+     * \param maxBulkBytes the byte budget of a bulk dequeue (0 to disable)
      */
-    TcFlowControlTestCase(QueueSizeUnit tt, uint32_t deviceQueueLength, uint32_t totalTxPackets);
+    TcFlowControlTestCase(QueueSizeUnit tt,
+                          uint32_t deviceQueueLength,
+                          uint32_t totalTxPackets,
+                          uint32_t maxBulkBytes);
     ~TcFlowControlTestCase() override;
 
   private:
@@ -125,7 +129,9 @@ class TcFlowControlTestCase : public TestCase
      */
     void CheckDeviceQueueStopped(Ptr<NetDevice> dev, bool value, const std::string msg);
     /**
-     * Check if the queue disc stores the expected number of packets
+     * Check if the queue disc stores the expected number of packets. If bulk
+     * dequeues are enabled, the packets of a batch that have been requeued
+     * because the device queue was stopped are also accounted for.
      * \param dev the device the queue disc is installed on
      * \param nPackets the expected number of packets stored in the queue disc
      * \param msg the message to print if a different number of packets are stored
@@ -134,15 +140,18 @@ class TcFlowControlTestCase : public TestCase
     QueueSizeUnit m_type;         //!< the test type
     uint32_t m_deviceQueueLength; //!< the queue length of the device
     uint32_t m_totalTxPackets;    //!< the toal number of packets to transmit
+    uint32_t m_maxBulkBytes;      //!< the byte budget of a bulk dequeue
 };
 
 TcFlowControlTestCase::TcFlowControlTestCase(QueueSizeUnit tt,
                                              uint32_t deviceQueueLength,
-                                             uint32_t totalTxPackets)
+                                             uint32_t totalTxPackets,
+                                             uint32_t maxBulkBytes)
     : TestCase("Test the operation of the flow control mechanism"),
       m_type(tt),
       m_deviceQueueLength(deviceQueueLength),
-      m_totalTxPackets(totalTxPackets)
+      m_totalTxPackets(totalTxPackets),
+      m_maxBulkBytes(maxBulkBytes)
 {
 }
 
@@ -188,7 +197,18 @@ TcFlowControlTestCase::CheckPacketsInQueueDisc(Ptr<NetDevice> dev,
 {
     Ptr<TrafficControlLayer> tc = dev->GetNode()->GetObject<TrafficControlLayer>();
     Ptr<QueueDisc> qdisc = tc->GetRootQueueDiscOnDevice(dev);
-    NS_TEST_EXPECT_MSG_EQ(qdisc->GetNPackets(), nPackets, msg);
+    if (m_maxBulkBytes == 0)
+    {
+        NS_TEST_EXPECT_MSG_EQ(qdisc->GetNPackets(), nPackets, msg);
+        return;
+    }
+    // requeued packets are no longer stored in the queue disc, but they have
+    // not been sent to the device yet
+    const QueueDisc::Stats& stats = qdisc->GetStats();
+    NS_TEST_EXPECT_MSG_EQ(stats.nTotalEnqueuedPackets - stats.nTotalDroppedPacketsAfterDequeue -
+                              stats.nTotalSentPackets,
+                          nPackets,
+                          msg);
 }
 
 void
@@ -217,7 +237,8 @@ TcFlowControlTestCase::DoRun()
     txDev->SetMtu(2500);
 
     TrafficControlHelper tch = TrafficControlHelper::Default();
-    tch.Install(txDev);
+    QueueDiscContainer qdiscs = tch.Install(txDev);
+    qdiscs.Get(0)->SetAttribute("MaxBulkBytes", UintegerValue(m_maxBulkBytes));
 
     // transmit 10 packets at time 0
     Simulator::Schedule(Time(Seconds(0)),
@@ -492,6 +513,119 @@ TcFlowControlTestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup traffic-control-test
+ *
+ * \brief Test that a queue disc exhausting its quota defers its next run
+ */
+class TcNetifScheduleTestCase : public TestCase
+{
+  public:
+    TcNetifScheduleTestCase();
+
+  private:
+    void DoRun() override;
+    /**
+     * Instruct a node to send a specified number of packets
+     * \param n the node
+     * \param nPackets the number of packets to send
+     */
+    void SendPackets(Ptr<Node> n, uint16_t nPackets);
+    /**
+     * Check the number of packets stored in the queue disc and in the device queue
+     * \param dev the device
+     * \param qdiscPackets the expected number of packets stored in the queue disc
+     * \param devPackets the expected number of packets stored in the device queue
+     */
+    void CheckPackets(Ptr<NetDevice> dev, uint32_t qdiscPackets, uint32_t devPackets);
+};
+
+TcNetifScheduleTestCase::TcNetifScheduleTestCase()
+    : TestCase("Test the deferred run of a queue disc that exhausts its quota")
+{
+}
+
+void
+TcNetifScheduleTestCase::SendPackets(Ptr<Node> n, uint16_t nPackets)
+{
+    Ptr<TrafficControlLayer> tc = n->GetObject<TrafficControlLayer>();
+    for (uint16_t i = 0; i < nPackets; i++)
+    {
+        tc->Send(n->GetDevice(0), Create<QueueDiscTestItem>(Create<Packet>(1000)));
+    }
+}
+
+void
+TcNetifScheduleTestCase::CheckPackets(Ptr<NetDevice> dev,
+                                      uint32_t qdiscPackets,
+                                      uint32_t devPackets)
+{
+    Ptr<TrafficControlLayer> tc = dev->GetNode()->GetObject<TrafficControlLayer>();
+    Ptr<QueueDisc> qdisc = tc->GetRootQueueDiscOnDevice(dev);
+    NS_TEST_EXPECT_MSG_EQ(qdisc->GetNPackets(),
+                          qdiscPackets,
+                          "Unexpected number of packets in the queue disc");
+
+    PointerValue ptr;
+    dev->GetAttributeFailSafe("TxQueue", ptr);
+    Ptr<Queue<Packet>> queue = ptr.Get<Queue<Packet>>();
+    NS_TEST_EXPECT_MSG_EQ(queue->GetNPackets(),
+                          devPackets,
+                          "Unexpected number of packets in the device queue");
+}
+
+void
+TcNetifScheduleTestCase::DoRun()
+{
+    NodeContainer n;
+    n.Create(2);
+
+    n.Get(0)->AggregateObject(CreateObject<TrafficControlLayer>());
+    n.Get(1)->AggregateObject(CreateObject<TrafficControlLayer>());
+
+    SimpleNetDeviceHelper simple;
+
+    NetDeviceContainer rxDevC = simple.Install(n.Get(1));
+
+    simple.SetDeviceAttribute("DataRate", DataRateValue(DataRate("1Mb/s")));
+    simple.SetQueue("ns3::DropTailQueue", "MaxSize", StringValue("100p"));
+
+    Ptr<NetDevice> txDev;
+    txDev =
+        simple.Install(n.Get(0), DynamicCast<SimpleChannel>(rxDevC.Get(0)->GetChannel())).Get(0);
+
+    TrafficControlHelper tch;
+    tch.SetRootQueueDisc("ns3::FifoQueueDisc");
+    QueueDiscContainer qdiscs = tch.Install(txDev);
+    qdiscs.Get(0)->SetQuota(2);
+
+    // The device queue is stopped while 10 packets are enqueued in the queue disc
+    Ptr<NetDeviceQueue> txq = txDev->GetObject<NetDeviceQueueInterface>()->GetTxQueue(0);
+    Simulator::Schedule(Seconds(0), &NetDeviceQueue::Stop, txq);
+    Simulator::Schedule(Seconds(0), &TcNetifScheduleTestCase::SendPackets, this, n.Get(0), 10);
+    Simulator::Schedule(MilliSeconds(1),
+                        &TcNetifScheduleTestCase::CheckPackets,
+                        this,
+                        txDev,
+                        10,
+                        0);
+
+    // When the device queue is woken up, the queue disc is run and exhausts its
+    // quota after two packets. The remaining packets are sent to the device by
+    // the deferred runs, without waiting for another enqueue or wake. The first
+    // packet is being transmitted, hence it is no longer in the device queue.
+    Simulator::Schedule(MilliSeconds(2), &NetDeviceQueue::Wake, txq);
+    Simulator::Schedule(MilliSeconds(3),
+                        &TcNetifScheduleTestCase::CheckPackets,
+                        this,
+                        txDev,
+                        0,
+                        9);
+
+    Simulator::Run();
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup traffic-control-test
  *
@@ -503,18 +637,29 @@ static class TcFlowControlTestSuite : public TestSuite
     TcFlowControlTestSuite()
         : TestSuite("tc-flow-control", UNIT)
     {
-        AddTestCase(new TcFlowControlTestCase(QueueSizeUnit::PACKETS, 1, 10), TestCase::QUICK);
-        AddTestCase(new TcFlowControlTestCase(QueueSizeUnit::PACKETS, 5, 10), TestCase::QUICK);
-        AddTestCase(new TcFlowControlTestCase(QueueSizeUnit::PACKETS, 9, 10), TestCase::QUICK);
-        AddTestCase(new TcFlowControlTestCase(QueueSizeUnit::PACKETS, 10, 10), TestCase::QUICK);
-        AddTestCase(new TcFlowControlTestCase(QueueSizeUnit::PACKETS, 11, 10), TestCase::QUICK);
-        AddTestCase(new TcFlowControlTestCase(QueueSizeUnit::PACKETS, 15, 10), TestCase::QUICK);
-        AddTestCase(new TcFlowControlTestCase(QueueSizeUnit::PACKETS, 1, 1), TestCase::QUICK);
-        AddTestCase(new TcFlowControlTestCase(QueueSizeUnit::PACKETS, 2, 1), TestCase::QUICK);
-        AddTestCase(new TcFlowControlTestCase(QueueSizeUnit::PACKETS, 5, 1), TestCase::QUICK);
+        AddTestCase(new TcFlowControlTestCase(QueueSizeUnit::PACKETS, 1, 10, 0), TestCase::QUICK);
+        AddTestCase(new TcFlowControlTestCase(QueueSizeUnit::PACKETS, 5, 10, 0), TestCase::QUICK);
+        AddTestCase(new TcFlowControlTestCase(QueueSizeUnit::PACKETS, 9, 10, 0), TestCase::QUICK);
+        AddTestCase(new TcFlowControlTestCase(QueueSizeUnit::PACKETS, 10, 10, 0), TestCase::QUICK);
+        AddTestCase(new TcFlowControlTestCase(QueueSizeUnit::PACKETS, 11, 10, 0), TestCase::QUICK);
+        AddTestCase(new TcFlowControlTestCase(QueueSizeUnit::PACKETS, 15, 10, 0), TestCase::QUICK);
+        AddTestCase(new TcFlowControlTestCase(QueueSizeUnit::PACKETS, 1, 1, 0), TestCase::QUICK);
+        AddTestCase(new TcFlowControlTestCase(QueueSizeUnit::PACKETS, 2, 1, 0), TestCase::QUICK);
+        AddTestCase(new TcFlowControlTestCase(QueueSizeUnit::PACKETS, 5, 1, 0), TestCase::QUICK);
 
         // TODO: Right now, this test only works for 5000B and 10 packets (it's hard coded). Should
         // also be made parametric.
-        AddTestCase(new TcFlowControlTestCase(QueueSizeUnit::BYTES, 5000, 10), TestCase::QUICK);
+        AddTestCase(new TcFlowControlTestCase(QueueSizeUnit::BYTES, 5000, 10, 0), TestCase::QUICK);
+
+        // Bulk dequeues: a batch must not overflow the device queue
+        AddTestCase(new TcFlowControlTestCase(QueueSizeUnit::PACKETS, 1, 10, 3000),
+                    TestCase::QUICK);
+        AddTestCase(new TcFlowControlTestCase(QueueSizeUnit::PACKETS, 5, 10, 3000),
+                    TestCase::QUICK);
+        AddTestCase(new TcFlowControlTestCase(QueueSizeUnit::PACKETS, 15, 10, 3000),
+                    TestCase::QUICK);
+        AddTestCase(new TcFlowControlTestCase(QueueSizeUnit::BYTES, 5000, 10, 3000),
+                    TestCase::QUICK);
+        AddTestCase(new TcNetifScheduleTestCase(), TestCase::QUICK);
     }
 } g_tcFlowControlTestSuite; ///< the test suite
@@ -0,0 +1,179 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to compare the hash functions available to the
+// DRR packet filters, in terms of classification cost and of collision rate,
+// for a number of flows ranging from 'min-flows' to 'max-flows' (each step
+// multiplies the number of flows by 10).
+// Each flow is hashed into a table of 'buckets' buckets (by default, as many
+// buckets as flows) and the fraction of flows that share their bucket with
+// another flow is compared to the one expected for an ideal random hash.
+// Sample usage:  ./ns3 run 'bench-flow-hash --max-flows=1000000'
+
+#include "ns3/command-line.h"
+#include "ns3/enum.h"
+#include "ns3/ipv4-packet-filter.h"
+#include "ns3/ipv4-queue-disc-item.h"
+#include "ns3/packet.h"
+#include "ns3/udp-header.h"
+#include "ns3/uinteger.h"
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <stdlib.h> // for exit ()
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Create one item per flow. Flows have distinct source addresses and ports
+ * and share the destination address and port, as in a server-side bottleneck.
+ *
+ * \param nFlows the number of flows
+ * \return the items
+ */
+static std::vector<Ptr<QueueDiscItem>>
+CreateItems(uint32_t nFlows)
+{
+    std::vector<Ptr<QueueDiscItem>> items;
+    items.reserve(nFlows);
+    Address dest;
+
+    for (uint32_t i = 0; i < nFlows; i++)
+    {
+        UdpHeader udpHdr;
+        udpHdr.SetSourcePort(1024 + (i & 0x3fff));
+        udpHdr.SetDestinationPort(80);
+        Ptr<Packet> p = Create<Packet>(0);
+        p->AddHeader(udpHdr);
+
+        Ipv4Header ipHdr;
+        ipHdr.SetSource(Ipv4Address(0x0a000000 + (i >> 14)));
+        ipHdr.SetDestination(Ipv4Address("10.255.0.1"));
+        ipHdr.SetProtocol(17);
+        items.push_back(Create<Ipv4QueueDiscItem>(p, dest, 0, ipHdr));
+    }
+    return items;
+}
+
+/**
+ * Classify the given number of flows with the given hash function and
+ * print the classification cost and the collision rate.
+ *
+ * \param function the hash function
+ * \param name the name of the hash function
+ * \param nFlows the number of flows
+ * \param buckets the number of buckets (0 means as many as the flows)
+ * \param nPackets the minimum number of packets to classify
+ */
+static void
+RunBench(DRRFlowHashFunction function,
+         const char* name,
+         uint32_t nFlows,
+         uint32_t buckets,
+         uint32_t nPackets)
+{
+    Ptr<DRRIpv4PacketFilter> filter = CreateObject<DRRIpv4PacketFilter>();
+    filter->SetAttribute("HashFunction", EnumValue(function));
+
+    if (buckets == 0)
+    {
+        buckets = nFlows;
+    }
+
+    // the flow hash is cached in the items, hence new items are needed for
+    // every round
+    uint32_t rounds = std::max<uint32_t>(1, nPackets / nFlows);
+    std::chrono::nanoseconds elapsed{0};
+    std::vector<uint32_t> occupancy(buckets, 0);
+
+    for (uint32_t r = 0; r < rounds; r++)
+    {
+        std::vector<Ptr<QueueDiscItem>> items = CreateItems(nFlows);
+        std::vector<uint32_t> hashes(nFlows);
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < nFlows; i++)
+        {
+            hashes[i] = filter->Classify(items[i]);
+        }
+        elapsed += std::chrono::steady_clock::now() - start;
+
+        if (r == 0)
+        {
+            for (auto h : hashes)
+            {
+                occupancy[h % buckets]++;
+            }
+        }
+    }
+
+    uint32_t colliding = 0;
+    for (auto n : occupancy)
+    {
+        if (n > 1)
+        {
+            colliding += n;
+        }
+    }
+
+    // fraction of flows sharing their bucket if the hash was uniformly random
+    double expected = 1 - std::pow(1 - 1.0 / buckets, nFlows - 1);
+
+    std::cout << std::setw(8) << name << std::setw(10) << nFlows << std::setw(10) << buckets
+              << std::setw(12) << std::fixed << std::setprecision(1)
+              << static_cast<double>(elapsed.count()) / rounds / nFlows << std::setw(12)
+              << std::setprecision(2) << 100.0 * colliding / nFlows << std::setw(12)
+              << 100 * expected << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t minFlows = 1000;
+    uint32_t maxFlows = 1000000;
+    uint32_t buckets = 0;
+    uint32_t nPackets = 1000000;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the hash functions of the DRR packet filters");
+    cmd.AddValue("min-flows", "minimum number of flows", minFlows);
+    cmd.AddValue("max-flows", "maximum number of flows", maxFlows);
+    cmd.AddValue("buckets", "number of buckets (0 means as many as the flows)", buckets);
+    cmd.AddValue("n", "minimum number of packets to classify for each number of flows", nPackets);
+    cmd.Parse(argc, argv);
+
+    if (minFlows == 0 || minFlows > maxFlows)
+    {
+        std::cerr << "Error-- min-flows must be positive and not greater than max-flows"
+                  << std::endl;
+        exit(1);
+    }
+
+    std::cout << std::setw(8) << "hash" << std::setw(10) << "flows" << std::setw(10) << "buckets"
+              << std::setw(12) << "ns/packet" << std::setw(12) << "colliding%" << std::setw(12)
+              << "ideal%" << std::endl;
+
+    for (uint64_t nFlows = minFlows; nFlows <= maxFlows; nFlows *= 10)
+    {
+        RunBench(DRR_HASH_MURMUR3, "murmur3", nFlows, buckets, nPackets);
+        RunBench(DRR_HASH_JHASH, "jhash", nFlows, buckets, nPackets);
+        RunBench(DRR_HASH_CRC32C, "crc32c", nFlows, buckets, nPackets);
+    }
+
+    return 0;
+}
@@ -0,0 +1,197 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to compare the serial and the parallel run of the
+// child queue discs of a mq queue disc. A node sends 'rounds' bursts of
+// 'burst' packets per transmission queue over a simple net device having
+// 'queues' transmission queues, each served by a CoDel child queue disc.
+// The wall clock time taken by the simulation is reported for the serial run
+// and for the parallel run with 'threads' threads (0 means as many as the
+// hardware threads), together with the resulting speedup.
+// Sample usage:  ./ns3 run 'bench-mq-parallel --queues=8 --threads=4'
+
+#include "ns3/boolean.h"
+#include "ns3/command-line.h"
+#include "ns3/mq-queue-disc.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/node-container.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/traffic-control-layer.h"
+#include "ns3/uinteger.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <stdlib.h> // for exit ()
+
+using namespace ns3;
+
+/**
+ * Queue disc item used by the benchmark.
+ */
+class BenchItem : public QueueDiscItem
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param p the packet stored in this item
+     */
+    BenchItem(Ptr<Packet> p)
+        : QueueDiscItem(p, Mac48Address("00:00:00:00:00:02"), 0)
+    {
+    }
+
+    void AddHeader() override
+    {
+    }
+
+    bool Mark() override
+    {
+        return false;
+    }
+};
+
+/**
+ * Send a burst of packets on every transmission queue.
+ *
+ * \param node the sending node
+ * \param nQueues the number of transmission queues
+ * \param burst the number of packets per transmission queue
+ */
+static void
+SendBurst(Ptr<Node> node, uint32_t nQueues, uint32_t burst)
+{
+    Ptr<TrafficControlLayer> tc = node->GetObject<TrafficControlLayer>();
+    for (uint32_t i = 0; i < nQueues * burst; i++)
+    {
+        tc->Send(node->GetDevice(0), Create<BenchItem>(Create<Packet>(100 + i)));
+    }
+}
+
+/**
+ * Run the simulation and return the wall clock time it takes.
+ *
+ * \param parallel whether the child queue discs are run in parallel
+ * \param nThreads the number of threads used for parallel runs
+ * \param nQueues the number of transmission queues
+ * \param burst the number of packets per transmission queue in a burst
+ * \param rounds the number of bursts
+ * \param [out] nPackets the number of packets dequeued by the mq queue disc
+ * \return the elapsed time, in seconds
+ */
+static double
+RunBench(bool parallel,
+         uint32_t nThreads,
+         uint32_t nQueues,
+         uint32_t burst,
+         uint32_t rounds,
+         uint32_t& nPackets)
+{
+    NodeContainer n;
+    n.Create(2);
+
+    SimpleNetDeviceHelper simple;
+    simple.DisableFlowControl();
+    simple.SetQueue("ns3::DropTailQueue", "MaxSize", StringValue("1000000p"));
+    NetDeviceContainer devices = simple.Install(n);
+
+    Ptr<NetDeviceQueueInterface> ndqi =
+        CreateObjectWithAttributes<NetDeviceQueueInterface>("NTxQueues", UintegerValue(nQueues));
+    ndqi->SetSelectQueueCallback(
+        [nQueues](Ptr<QueueItem> item) { return item->GetPacket()->GetSize() % nQueues; });
+    devices.Get(0)->AggregateObject(ndqi);
+
+    Ptr<MqQueueDisc> mq = CreateObjectWithAttributes<MqQueueDisc>("ParallelRun",
+                                                                  BooleanValue(parallel),
+                                                                  "ParallelThreads",
+                                                                  UintegerValue(nThreads));
+    ObjectFactory factory("ns3::CoDelQueueDisc");
+    factory.Set("MaxSize", QueueSizeValue(QueueSize(QueueSizeUnit::PACKETS, 2 * burst)));
+    for (uint32_t i = 0; i < nQueues; i++)
+    {
+        Ptr<QueueDiscClass> c = CreateObject<QueueDiscClass>();
+        c->SetQueueDisc(factory.Create<QueueDisc>());
+        mq->AddQueueDiscClass(c);
+    }
+
+    Ptr<TrafficControlLayer> tc = CreateObject<TrafficControlLayer>();
+    n.Get(0)->AggregateObject(tc);
+    tc->SetRootQueueDiscOnDevice(devices.Get(0), mq);
+
+    for (uint32_t r = 0; r < rounds; r++)
+    {
+        Simulator::Schedule(MicroSeconds(r), &SendBurst, n.Get(0), nQueues, burst);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Simulator::Run();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    nPackets = mq->GetStats().nTotalDequeuedPackets;
+    Simulator::Destroy();
+    return elapsed.count();
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t nQueues = 8;
+    uint32_t nThreads = 0;
+    uint32_t burst = 64;
+    uint32_t rounds = 2000;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the parallel run of the child queue discs of a mq queue disc");
+    cmd.AddValue("queues", "number of device transmission queues", nQueues);
+    cmd.AddValue("threads",
+                 "number of threads (0 means as many as the hardware threads)",
+                 nThreads);
+    cmd.AddValue("burst", "number of packets per transmission queue in a burst", burst);
+    cmd.AddValue("rounds", "number of bursts", rounds);
+    cmd.Parse(argc, argv);
+
+    if (nQueues < 2 || burst == 0)
+    {
+        std::cerr << "Error-- queues must be at least 2 and burst must be positive" << std::endl;
+        exit(1);
+    }
+
+    uint32_t serialPackets = 0;
+    uint32_t parallelPackets = 0;
+    double serial = RunBench(false, nThreads, nQueues, burst, rounds, serialPackets);
+    double parallel = RunBench(true, nThreads, nQueues, burst, rounds, parallelPackets);
+
+    if (serialPackets != parallelPackets)
+    {
+        std::cerr << "Error-- the serial and the parallel runs dequeued " << serialPackets
+                  << " and " << parallelPackets << " packets" << std::endl;
+        exit(1);
+    }
+
+    std::cout << std::setw(10) << "mode" << std::setw(12) << "packets" << std::setw(12) << "seconds"
+              << std::setw(12) << "ns/packet" << std::endl;
+    std::cout << std::setw(10) << "serial" << std::setw(12) << serialPackets << std::setw(12)
+              << std::fixed << std::setprecision(3) << serial << std::setw(12)
+              << std::setprecision(1) << 1e9 * serial / serialPackets << std::endl;
+    std::cout << std::setw(10) << "parallel" << std::setw(12) << parallelPackets << std::setw(12)
+              << std::setprecision(3) << parallel << std::setw(12) << std::setprecision(1)
+              << 1e9 * parallel / parallelPackets << std::endl;
+    std::cout << "speedup: " << std::setprecision(2) << serial / parallel << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,227 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to compare the storages of the items of a Queue
+// (std::list, which QueueContainer uses by default, and RingBuffer), for
+// various numbers of operations 'n'. Each benchmark keeps 'depth' packets in
+// the queue and then either alternates enqueue and dequeue operations or
+// enqueues and dequeues bursts of 'burst' packets.
+// Sample usage:  ./ns3 run 'bench-queue-container --n=10000000'
+
+#include "ns3/command-line.h"
+#include "ns3/packet.h"
+#include "ns3/queue.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <list>
+#include <stdlib.h> // for exit ()
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * FIFO queue of packets with a configurable container, used for benchmarking.
+ *
+ * \tparam Container the container storing the packets
+ */
+template <typename Container>
+class BenchQueue : public Queue<Packet, Container>
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId()
+    {
+        // Queue<Packet, Container> is not registered with the TypeId system
+        static TypeId tid = TypeId(std::string("BenchQueue<") + typeid(Container).name() + ">")
+                                .SetParent<QueueBase>()
+                                .SetGroupName("Network");
+        return tid;
+    }
+
+    bool Enqueue(Ptr<Packet> item) override
+    {
+        return this->DoEnqueue(this->GetContainer().end(), item);
+    }
+
+    Ptr<Packet> Dequeue() override
+    {
+        return this->DoDequeue(this->GetContainer().begin());
+    }
+
+    Ptr<Packet> Remove() override
+    {
+        return this->DoRemove(this->GetContainer().begin());
+    }
+
+    Ptr<const Packet> Peek() const override
+    {
+        return this->DoPeek(this->GetContainer().begin());
+    }
+};
+
+/**
+ * Create a queue storing the given number of packets
+ *
+ * \tparam Container the container storing the packets
+ * \param depth the number of packets initially stored in the queue
+ * \param packets the packets to enqueue
+ * \return the queue
+ */
+template <typename Container>
+static Ptr<BenchQueue<Container>>
+CreateQueue(uint32_t depth, const std::vector<Ptr<Packet>>& packets)
+{
+    Ptr<BenchQueue<Container>> queue = CreateObject<BenchQueue<Container>>();
+    queue->SetMaxSize(QueueSize(QueueSizeUnit::PACKETS, std::numeric_limits<uint32_t>::max()));
+    for (uint32_t i = 0; i < depth; i++)
+    {
+        queue->Enqueue(packets[i % packets.size()]);
+    }
+    return queue;
+}
+
+/**
+ * Alternate enqueue and dequeue operations
+ *
+ * \tparam Container the container storing the packets
+ * \param queue the queue
+ * \param n the number of enqueue (and dequeue) operations
+ * \param burst unused
+ */
+template <typename Container>
+static void
+benchSteady(Ptr<BenchQueue<Container>> queue, uint32_t n, uint32_t burst)
+{
+    for (uint32_t i = 0; i < n; i++)
+    {
+        queue->Enqueue(queue->Dequeue());
+    }
+}
+
+/**
+ * Enqueue and dequeue bursts of packets
+ *
+ * \tparam Container the container storing the packets
+ * \param queue the queue
+ * \param n the number of enqueue (and dequeue) operations
+ * \param burst the number of packets in a burst
+ */
+template <typename Container>
+static void
+benchBurst(Ptr<BenchQueue<Container>> queue, uint32_t n, uint32_t burst)
+{
+    std::vector<Ptr<Packet>> packets(burst);
+    for (uint32_t i = 0; i < n; i += burst)
+    {
+        for (uint32_t j = 0; j < burst; j++)
+        {
+            packets[j] = queue->Dequeue();
+        }
+        for (uint32_t j = 0; j < burst; j++)
+        {
+            queue->Enqueue(packets[j]);
+        }
+    }
+}
+
+/**
+ * Run a benchmark and print the number of operations per second
+ *
+ * \tparam Container the container storing the packets
+ * \param bench the benchmark
+ * \param n the number of enqueue (and dequeue) operations
+ * \param depth the number of packets stored in the queue
+ * \param burst the number of packets in a burst
+ * \param minIterations the number of iterations to minimize the elapsed time over
+ * \param name the name of the benchmark
+ */
+template <typename Container>
+static void
+runBench(void (*bench)(Ptr<BenchQueue<Container>>, uint32_t, uint32_t),
+         uint32_t n,
+         uint32_t depth,
+         uint32_t burst,
+         uint32_t minIterations,
+         const char* name)
+{
+    std::vector<Ptr<Packet>> packets;
+    for (uint32_t i = 0; i < std::max(depth, burst); i++)
+    {
+        packets.push_back(Create<Packet>(100));
+    }
+
+    uint64_t minDelay = std::numeric_limits<uint64_t>::max();
+    for (uint32_t i = 0; i < minIterations; i++)
+    {
+        Ptr<BenchQueue<Container>> queue =
+            CreateQueue<Container>(std::max(depth, burst), packets);
+        SystemWallClockMs time;
+        time.Start();
+        (*bench)(queue, n, burst);
+        uint64_t deltaMs = time.End();
+        minDelay = std::min(minDelay, deltaMs);
+    }
+    double ops = n;
+    ops *= 1000;
+    ops /= std::max<uint64_t>(minDelay, 1);
+    std::cout << ops << " packets/s"
+              << " (" << minDelay << " ms elapsed)\t" << name << std::endl;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t n = 0;
+    uint32_t depth = 1000;
+    uint32_t burst = 64;
+    uint32_t minIterations = 1;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the containers of the Queue class");
+    cmd.AddValue("n", "number of enqueue and dequeue operations", n);
+    cmd.AddValue("depth", "number of packets stored in the queue", depth);
+    cmd.AddValue("burst", "number of packets in a burst", burst);
+    cmd.AddValue("min-iterations",
+                 "number of subiterations to minimize iteration time over",
+                 minIterations);
+    cmd.Parse(argc, argv);
+
+    if (n == 0 || depth == 0 || burst == 0)
+    {
+        std::cerr << "Error-- number of operations must be specified "
+                  << "by command-line argument --n=(number of operations)" << std::endl;
+        exit(1);
+    }
+    std::cout << "Running bench-queue-container with n=" << n << ", depth=" << depth
+              << ", burst=" << burst << std::endl;
+
+    using Ring = RingBuffer<Ptr<Packet>>;
+    using List = std::list<Ptr<Packet>>;
+
+    runBench<Ring>(&benchSteady<Ring>, n, depth, burst, minIterations, "RingBuffer, steady");
+    runBench<List>(&benchSteady<List>, n, depth, burst, minIterations, "std::list, steady");
+    runBench<Ring>(&benchBurst<Ring>, n, depth, burst, minIterations, "RingBuffer, bursts");
+    runBench<List>(&benchBurst<List>, n, depth, burst, minIterations, "std::list, bursts");
+
+    return 0;
+}
@@ -0,0 +1,461 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to measure the CPU cost of the queue discs, which
+// are driven directly (i.e., without devices, traffic control layer and
+// sockets) with synthetic IPv4/UDP queue disc items.
+// For every combination of queue disc type, number of flows, packet size
+// distribution and overload ratio, 'packets' packets are offered to the queue
+// disc in steps of 'burst' packets. The queue disc is drained at a constant
+// bit rate, while packets arrive at 'overload' times such a rate; packets
+// belong to flows chosen uniformly at random. The simulation time advances by
+// one step at a time, so that the AQM algorithms and the token bucket filter
+// observe a realistic timing.
+// The program reports, for every combination, the average cost (in ns) of an
+// enqueue and of a dequeue operation, the number of memory allocations per
+// packet performed by the queue disc (the creation of the items is not
+// accounted for), the fraction of dropped packets and the peak resident set
+// size of the process so far.
+// The queue disc types, the numbers of flows, the packet size distributions
+// (fixed, imix and uniform) and the overload ratios are given as comma
+// separated lists.
+// Sample usage:
+//   ./ns3 run 'bench-queue-discs --types=DRR,FqCoDel --flows=1,10000 --sizes=imix'
+
+#include "ns3/command-line.h"
+#include "ns3/drr-queue-disc.h"
+#include "ns3/fq-cobalt-queue-disc.h"
+#include "ns3/fq-codel-queue-disc.h"
+#include "ns3/fq-pie-queue-disc.h"
+#include "ns3/ipv4-packet-filter.h"
+#include "ns3/ipv4-queue-disc-item.h"
+#include "ns3/packet.h"
+#include "ns3/prio-queue-disc.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/tbf-queue-disc.h"
+#include "ns3/udp-header.h"
+#include "ns3/uinteger.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __unix__
+#include <sys/resource.h>
+#endif
+
+using namespace ns3;
+
+/// Number of memory allocations performed by the program so far
+static uint64_t g_nAllocations = 0;
+
+/**
+ * Replacement of the global allocation function that counts the allocations
+ * \param size the number of bytes to allocate
+ * \return a pointer to the allocated memory
+ */
+void*
+operator new(std::size_t size)
+{
+    g_nAllocations++;
+    void* p = std::malloc(size ? size : 1);
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+/**
+ * Replacement of the global deallocation function
+ * \param p a pointer to the memory to deallocate
+ */
+void
+operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+/**
+ * Replacement of the global sized deallocation function
+ * \param p a pointer to the memory to deallocate
+ */
+void
+operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+/**
+ * \return the peak resident set size of the process, in KB (0 if unknown)
+ */
+static long
+GetPeakRss()
+{
+#ifdef __unix__
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+        return usage.ru_maxrss;
+    }
+#endif
+    return 0;
+}
+
+/**
+ * Split a comma separated list
+ * \param list the comma separated list
+ * \return the elements of the list
+ */
+static std::vector<std::string>
+SplitList(const std::string& list)
+{
+    std::vector<std::string> elements;
+    std::istringstream iss(list);
+    std::string element;
+    while (std::getline(iss, element, ','))
+    {
+        if (!element.empty())
+        {
+            elements.push_back(element);
+        }
+    }
+    return elements;
+}
+
+/**
+ * Queue disc benchmark, which runs a single combination of parameters
+ */
+class QueueDiscBench
+{
+  public:
+    /**
+     * Constructor
+     * \param type the queue disc type (DRR, FqCoDel, FqPie, FqCobalt, Prio or Tbf)
+     * \param nFlows the number of flows
+     * \param sizes the packet size distribution (fixed, imix or uniform)
+     * \param overload the ratio between the arrival rate and the service rate
+     * \param nPackets the number of packets offered to the queue disc
+     * \param burst the number of packets that arrive (on average) at each step
+     */
+    QueueDiscBench(std::string type,
+                   uint32_t nFlows,
+                   std::string sizes,
+                   double overload,
+                   uint32_t nPackets,
+                   uint32_t burst);
+
+    /// Run the benchmark and print the results
+    void Run();
+
+  private:
+    /// Create and configure the queue disc
+    void CreateQueueDisc();
+    /// \return the size of the next packet, according to the size distribution
+    uint32_t GetPacketSize();
+    /// \return the mean packet size, according to the size distribution
+    double GetMeanPacketSize() const;
+    /**
+     * Create a queue disc item belonging to the given flow
+     * \param flow the flow
+     * \param size the size of the packet
+     * \return the queue disc item
+     */
+    Ptr<QueueDiscItem> CreateItem(uint32_t flow, uint32_t size) const;
+    /// Offer the packets arriving in a step and drain the queue disc for a step
+    void Step();
+
+    std::string m_type;                        //!< the queue disc type
+    uint32_t m_nFlows;                         //!< the number of flows
+    std::string m_sizes;                       //!< the packet size distribution
+    double m_overload;                         //!< the arrival rate to service rate ratio
+    uint32_t m_nPackets;                       //!< the number of packets to offer
+    uint32_t m_burst;                          //!< the average packets arriving per step
+    Ptr<QueueDisc> m_queueDisc;                //!< the queue disc
+    Ptr<UniformRandomVariable> m_flowRng;      //!< random variable to select flows
+    Ptr<UniformRandomVariable> m_sizeRng;      //!< random variable to select sizes
+    Time m_stepTime;                           //!< the duration of a step
+    double m_stepBytes;                        //!< the bytes served in a step
+    double m_arrivalCredit{0};                 //!< the packets to offer in the next steps
+    double m_serviceCredit{0};                 //!< the bytes to serve in the next steps
+    uint32_t m_nOffered{0};                    //!< the number of packets offered so far
+    uint64_t m_nEnqueueCalls{0};               //!< the number of enqueue operations
+    uint64_t m_nDequeueCalls{0};               //!< the number of dequeue operations
+    uint64_t m_nAllocations{0};                //!< allocations performed by the queue disc
+    std::chrono::nanoseconds m_enqueueTime{0}; //!< time spent enqueuing packets
+    std::chrono::nanoseconds m_dequeueTime{0}; //!< time spent dequeuing packets
+};
+
+QueueDiscBench::QueueDiscBench(std::string type,
+                               uint32_t nFlows,
+                               std::string sizes,
+                               double overload,
+                               uint32_t nPackets,
+                               uint32_t burst)
+    : m_type(type),
+      m_nFlows(nFlows),
+      m_sizes(sizes),
+      m_overload(overload),
+      m_nPackets(nPackets),
+      m_burst(burst)
+{
+    m_flowRng = CreateObject<UniformRandomVariable>();
+    m_sizeRng = CreateObject<UniformRandomVariable>();
+
+    // the queue disc is served at 1 Gbps
+    m_stepBytes = m_burst * GetMeanPacketSize();
+    m_stepTime = NanoSeconds(static_cast<int64_t>(m_stepBytes * 8));
+}
+
+double
+QueueDiscBench::GetMeanPacketSize() const
+{
+    if (m_sizes == "imix")
+    {
+        return (7 * 40 + 4 * 576 + 1 * 1500) / 12.0;
+    }
+    if (m_sizes == "uniform")
+    {
+        return (64 + 1500) / 2.0;
+    }
+    return 1500;
+}
+
+uint32_t
+QueueDiscBench::GetPacketSize()
+{
+    if (m_sizes == "imix")
+    {
+        uint32_t v = m_sizeRng->GetInteger(0, 11);
+        return (v < 7 ? 40 : (v < 11 ? 576 : 1500));
+    }
+    if (m_sizes == "uniform")
+    {
+        return m_sizeRng->GetInteger(64, 1500);
+    }
+    return 1500;
+}
+
+Ptr<QueueDiscItem>
+QueueDiscBench::CreateItem(uint32_t flow, uint32_t size) const
+{
+    UdpHeader udpHdr;
+    udpHdr.SetSourcePort(1024 + (flow & 0x3fff));
+    udpHdr.SetDestinationPort(80);
+    Ptr<Packet> p = Create<Packet>(size - 28);
+    p->AddHeader(udpHdr);
+
+    Ipv4Header ipHdr;
+    ipHdr.SetSource(Ipv4Address(0x0a000000 + (flow >> 14)));
+    ipHdr.SetDestination(Ipv4Address("10.255.0.1"));
+    ipHdr.SetProtocol(17);
+    ipHdr.SetPayloadSize(size - 20);
+    return Create<Ipv4QueueDiscItem>(p, Address(), 0, ipHdr);
+}
+
+void
+QueueDiscBench::CreateQueueDisc()
+{
+    if (m_type == "DRR")
+    {
+        Ptr<DRRQueueDisc> qd = CreateObject<DRRQueueDisc>();
+        qd->AddPacketFilter(CreateObject<DRRIpv4PacketFilter>());
+        qd->SetQuantum(1500);
+        m_queueDisc = qd;
+    }
+    else if (m_type == "FqCoDel")
+    {
+        Ptr<FqCoDelQueueDisc> qd = CreateObject<FqCoDelQueueDisc>();
+        qd->SetQuantum(1500);
+        m_queueDisc = qd;
+    }
+    else if (m_type == "FqPie")
+    {
+        Ptr<FqPieQueueDisc> qd = CreateObject<FqPieQueueDisc>();
+        qd->SetQuantum(1500);
+        m_queueDisc = qd;
+    }
+    else if (m_type == "FqCobalt")
+    {
+        Ptr<FqCobaltQueueDisc> qd = CreateObject<FqCobaltQueueDisc>();
+        qd->SetQuantum(1500);
+        m_queueDisc = qd;
+    }
+    else if (m_type == "Prio")
+    {
+        m_queueDisc = CreateObject<PrioQueueDisc>();
+    }
+    else if (m_type == "Tbf")
+    {
+        m_queueDisc = CreateObjectWithAttributes<TbfQueueDisc>("Rate",
+                                                               StringValue("1Gbps"),
+                                                               "Burst",
+                                                               UintegerValue(100000));
+    }
+    else
+    {
+        std::cerr << "Error-- unknown queue disc type " << m_type << std::endl;
+        exit(1);
+    }
+
+    // the token bucket filter may run itself when enough tokens are available
+    m_queueDisc->SetSendCallback([](Ptr<QueueDiscItem> item) {});
+    m_queueDisc->Initialize();
+}
+
+void
+QueueDiscBench::Step()
+{
+    // offer the packets arriving in this step. Items are created in advance,
+    // so that their creation is not accounted for
+    m_arrivalCredit += m_overload * m_burst;
+    std::vector<Ptr<QueueDiscItem>> items;
+    while (m_arrivalCredit >= 1 && m_nOffered < m_nPackets)
+    {
+        items.push_back(CreateItem(m_flowRng->GetInteger(0, m_nFlows - 1), GetPacketSize()));
+        m_arrivalCredit--;
+        m_nOffered++;
+    }
+
+    uint64_t nAllocations = g_nAllocations;
+    auto start = std::chrono::steady_clock::now();
+    for (auto& item : items)
+    {
+        m_queueDisc->Enqueue(item);
+    }
+    m_enqueueTime += std::chrono::steady_clock::now() - start;
+    m_nAllocations += g_nAllocations - nAllocations;
+    m_nEnqueueCalls += items.size();
+    items.clear();
+
+    // drain the queue disc for a step. Dequeued items are released afterwards,
+    // so that their destruction is not accounted for
+    m_serviceCredit += m_stepBytes;
+    nAllocations = g_nAllocations;
+    start = std::chrono::steady_clock::now();
+    Ptr<QueueDiscItem> item;
+    while (m_serviceCredit > 0 && (item = m_queueDisc->Dequeue()))
+    {
+        m_serviceCredit -= item->GetSize();
+        m_nDequeueCalls++;
+        items.push_back(item);
+    }
+    m_dequeueTime += std::chrono::steady_clock::now() - start;
+    m_nAllocations += g_nAllocations - nAllocations;
+    if (!item)
+    {
+        // an idle link does not accumulate credit
+        m_serviceCredit = std::min(m_serviceCredit, m_stepBytes);
+    }
+    items.clear();
+
+    if (m_nOffered < m_nPackets || m_queueDisc->GetNPackets() > 0)
+    {
+        Simulator::Schedule(m_stepTime, &QueueDiscBench::Step, this);
+    }
+    else
+    {
+        // some queue discs (e.g., those based on PIE) have periodic events
+        Simulator::Stop();
+    }
+}
+
+void
+QueueDiscBench::Run()
+{
+    CreateQueueDisc();
+    Simulator::Schedule(Seconds(0), &QueueDiscBench::Step, this);
+    Simulator::Run();
+
+    QueueDisc::Stats stats = m_queueDisc->GetStats();
+    double nPackets = std::max<double>(stats.nTotalReceivedPackets, 1);
+
+    double enqueueNs =
+        static_cast<double>(m_enqueueTime.count()) / std::max<uint64_t>(m_nEnqueueCalls, 1);
+    double dequeueNs =
+        static_cast<double>(m_dequeueTime.count()) / std::max<uint64_t>(m_nDequeueCalls, 1);
+
+    std::cout << std::setw(9) << m_type << std::setw(8) << m_nFlows << std::setw(8) << m_sizes
+              << std::setw(9) << std::fixed << std::setprecision(2) << m_overload << std::setw(11)
+              << std::setprecision(1) << enqueueNs << std::setw(11) << dequeueNs << std::setw(12)
+              << std::setprecision(3) << m_nAllocations / nPackets << std::setw(9)
+              << std::setprecision(2) << 100.0 * stats.nTotalDroppedPackets / nPackets
+              << std::setw(11) << GetPeakRss() << std::endl;
+
+    m_queueDisc->Dispose();
+    m_queueDisc = nullptr;
+    Simulator::Destroy();
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string types = "DRR,FqCoDel,FqPie,FqCobalt,Prio,Tbf";
+    std::string flows = "1,100,10000";
+    std::string sizes = "fixed,imix,uniform";
+    std::string overloads = "0.9,2";
+    uint32_t nPackets = 100000;
+    uint32_t burst = 32;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the CPU cost of the queue discs");
+    cmd.AddValue("types", "comma separated list of queue disc types", types);
+    cmd.AddValue("flows", "comma separated list of numbers of flows", flows);
+    cmd.AddValue("sizes", "comma separated list of packet size distributions", sizes);
+    cmd.AddValue("overload", "comma separated list of overload ratios", overloads);
+    cmd.AddValue("packets", "number of packets offered to the queue disc", nPackets);
+    cmd.AddValue("burst", "average number of packets arriving at each step", burst);
+    cmd.Parse(argc, argv);
+
+    if (nPackets == 0 || burst == 0)
+    {
+        std::cerr << "Error-- packets and burst must be positive" << std::endl;
+        exit(1);
+    }
+
+    std::cout << std::setw(9) << "type" << std::setw(8) << "flows" << std::setw(8) << "sizes"
+              << std::setw(9) << "overload" << std::setw(11) << "ns/enq" << std::setw(11)
+              << "ns/deq" << std::setw(12) << "allocs/pkt" << std::setw(9) << "drop%"
+              << std::setw(11) << "peakRSS_KB" << std::endl;
+
+    for (const auto& type : SplitList(types))
+    {
+        for (const auto& nFlows : SplitList(flows))
+        {
+            for (const auto& size : SplitList(sizes))
+            {
+                for (const auto& overload : SplitList(overloads))
+                {
+                    QueueDiscBench bench(type,
+                                         std::max<uint32_t>(std::stoul(nFlows), 1),
+                                         size,
+                                         std::stod(overload),
+                                         nPackets,
+                                         burst);
+                    bench.Run();
+                }
+            }
+        }
+    }
+
+    return 0;
+}
@@ -19,10 +19,13 @@
 
 #include "ns3/core-module.h"
 
+#include <atomic>
 #include <cmath> // sqrt
+#include <cstdlib>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <new>
 #include <string.h>
 #include <vector>
 
@@ -47,6 +50,49 @@ std::string g_me;
 /** Output field width for numeric data. */
 int g_fwidth = 6;
 
+/** Flag to report the heap allocations per event. */
+bool g_allocs = false;
+
+/** Number of heap allocations performed by the program. */
+std::atomic<uint64_t> g_nAllocs{0};
+
+/**
+ * Replacement of the global allocation function, which counts the heap
+ * allocations.
+ * \param [in] size The number of bytes to allocate.
+ * \returns A pointer to the allocated memory.
+ */
+void*
+operator new(std::size_t size)
+{
+    g_nAllocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+    {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+/**
+ * Replacement of the global deallocation function.
+ * \param [in] p The pointer to the memory to release.
+ */
+void
+operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+/**
+ * Replacement of the global sized deallocation function.
+ * \param [in] p The pointer to the memory to release.
+ */
+void
+operator delete(void* p, std::size_t /* size */) noexcept
+{
+    std::free(p);
+}
+
 /**
  *  Benchmark instance which can do a single run.
  *
@@ -81,6 +127,16 @@ class Bench
         m_rand = stream;
     }
 
+    /**
+     * Set the scheduler to use in each run.
+     *
+     * \param [in] factory Factory pre-configured to create the desired Scheduler.
+     */
+    void SetScheduler(ObjectFactory factory)
+    {
+        m_factory = factory;
+    }
+
     /**
      * Set the number of events to populate the scheduler with.
      * Each event executed schedules a new event, maintaining the population.
@@ -107,6 +163,7 @@ class Bench
         double simu;     /**< Time (s) for simulation. */
         uint64_t pop;    /**< Event population. */
         uint64_t events; /**< Number of events executed. */
+        uint64_t allocs; /**< Heap allocations during the simulation. */
     };
 
     /**
@@ -123,6 +180,7 @@ class Bench
      */
     void Cb();
 
+    ObjectFactory m_factory;          /**< Factory of the scheduler. */
     Ptr<RandomVariableStream> m_rand; /**< Stream for event delays. */
     uint64_t m_population;            /**< Event population size. */
     uint64_t m_total;                 /**< Total number of events to execute. */
@@ -139,6 +197,8 @@ Bench::Run()
 
     DEB("initializing");
     m_count = 0;
+    // The scheduler has to be set again after the simulator has been destroyed
+    Simulator::SetScheduler(m_factory);
 
     timer.Start();
     for (uint64_t i = 0; i < m_population; ++i)
@@ -150,14 +210,16 @@ Bench::Run()
     DEB("initialization took " << init << "s");
 
     DEB("running");
+    uint64_t allocs = g_nAllocs.load();
     timer.Start();
     Simulator::Run();
     simu = timer.End() / 1000.0;
+    allocs = g_nAllocs.load() - allocs;
     DEB("run took " << simu << "s");
 
     Simulator::Destroy();
 
-    return Result{init, simu, m_population, m_count};
+    return Result{init, simu, m_population, m_count, allocs};
 }
 
 void
@@ -271,8 +333,6 @@ BenchSuite::BenchSuite(ObjectFactory& factory,
                        Ptr<RandomVariableStream> eventStream,
                        bool calRev)
 {
-    Simulator::SetScheduler(factory);
-
     m_scheduler = factory.GetTypeId().GetName();
     if (m_scheduler == "ns3::CalendarScheduler")
     {
@@ -284,6 +344,7 @@ BenchSuite::BenchSuite(ObjectFactory& factory,
     }
 
     Bench bench(pop, total);
+    bench.SetScheduler(factory);
     bench.SetRandomStream(eventStream);
     bench.SetPopulation(pop);
     bench.SetTotal(total);
@@ -304,6 +365,18 @@ BenchSuite::BenchSuite(ObjectFactory& factory,
         m_results.back().Log(i);
     }
 
+    if (g_allocs)
+    {
+        // Compare the allocations with and without the event pools
+        for (bool pool : {false, true})
+        {
+            EventImpl::SetPoolEnabled(pool);
+            auto run = bench.Run();
+            LOG("Heap allocations per event, event pool " << (pool ? "enabled:  " : "disabled: ")
+                                                          << double(run.allocs) / run.events);
+        }
+    }
+
     Simulator::Destroy();
 
 } // BenchSuite::Run
@@ -457,6 +530,7 @@ main(int argc, char* argv[])
     bool allSched = false;
     bool schedCal = false;
     bool schedHeap = false;
+    bool schedLadder = false;
     bool schedList = false;
     bool schedMap = false; // default scheduler
     bool schedPQ = false;
@@ -482,10 +556,12 @@ main(int argc, char* argv[])
     cmd.AddValue("cal", "use CalendarScheduler", schedCal);
     cmd.AddValue("calrev", "reverse ordering in the CalendarScheduler", calRev);
     cmd.AddValue("heap", "use HeapScheduler", schedHeap);
+    cmd.AddValue("ladder", "use LadderScheduler", schedLadder);
     cmd.AddValue("list", "use ListScheduler", schedList);
     cmd.AddValue("map", "use MapScheduler (default)", schedMap);
     cmd.AddValue("pri", "use PriorityQueue", schedPQ);
     cmd.AddValue("debug", "enable debugging output", g_debug);
+    cmd.AddValue("alloc", "report the heap allocations per event", g_allocs);
     cmd.AddValue("pop", "event population size", pop);
     cmd.AddValue("total", "total number of events to run", total);
     cmd.AddValue("runs", "number of runs", runs);
@@ -505,10 +581,10 @@ main(int argc, char* argv[])
 
     if (allSched)
     {
-        schedCal = schedHeap = schedList = schedMap = schedPQ = true;
+        schedCal = schedHeap = schedLadder = schedList = schedMap = schedPQ = true;
     }
     // Set the default case if nothing else is set
-    if (!(schedCal || schedHeap || schedList || schedMap || schedPQ))
+    if (!(schedCal || schedHeap || schedLadder || schedList || schedMap || schedPQ))
     {
         schedMap = true;
     }
@@ -532,6 +608,11 @@ main(int argc, char* argv[])
         factory.SetTypeId("ns3::HeapScheduler");
         BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
     }
+    if (schedLadder)
+    {
+        factory.SetTypeId("ns3::LadderScheduler");
+        BenchSuite(factory, pop, total, runs, eventStream, calRev).Log();
+    }
     if (schedList)
     {
         factory.SetTypeId("ns3::ListScheduler");